@@ -18,10 +18,22 @@
  */
 
 #include <err.h>
+#include <errno.h>
 #include <signal.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/select.h>
+
+#ifdef MODULE_NATIVE_ASYNC_READ_EPOLL
+#ifndef __linux__
+#error "native_async_read_epoll is only available on Linux"
+#endif
+#include <pthread.h>
+#include <sys/epoll.h>
+#endif
 
 #include "async_read.h"
 #include "native_internal.h"
@@ -36,6 +48,87 @@ static pid_t _sigio_child_pids[ASYNC_READ_NUMOF];
 static void _sigio_child(int fd);
 #endif
 
+static void _raise_sigio(void)
+{
+    int sig = SIGIO;
+
+    /* must be called with _native_in_syscall set */
+    real_write(_sig_pipefd[1], &sig, sizeof(int));
+    _native_sigpend++;
+}
+
+#ifdef MODULE_NATIVE_ASYNC_READ_EPOLL
+#if ASYNC_READ_NUMOF > 32
+#error "native_async_read_epoll supports at most 32 file descriptors"
+#endif
+
+static int _epfd = -1;
+/* bit i is set when _fds[i] became readable since the last interrupt */
+static uint32_t _ready;
+
+static void *_epoll_thread(void *arg)
+{
+    struct epoll_event events[ASYNC_READ_NUMOF];
+
+    (void)arg;
+    /* This host thread runs outside of RIOT's emulated CPU: it must neither
+     * touch RIOT state nor call any of the wrapped libc functions. */
+    while (1) {
+        uint32_t ready = 0;
+        int n = epoll_wait(_epfd, events, ASYNC_READ_NUMOF, -1);
+
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            kill(_native_pid, SIGKILL);
+            return NULL;
+        }
+        for (int i = 0; i < n; i++) {
+            ready |= events[i].data.u32;
+        }
+        /* raise the interrupt only once for everything that becomes ready
+         * until the ISR collected the ready-set */
+        if (__atomic_fetch_or(&_ready, ready, __ATOMIC_SEQ_CST) == 0) {
+            kill(_native_pid, SIGIO);
+        }
+    }
+    return NULL;
+}
+
+static void _async_io_isr(void) {
+    uint32_t ready = __atomic_exchange_n(&_ready, 0, __ATOMIC_SEQ_CST);
+
+    for (int i = 0; ready != 0; i++, ready >>= 1) {
+        if (ready & 1) {
+            _native_async_read_callbacks[i](_fds[i], _args[i]);
+        }
+    }
+}
+
+static void _epoll_setup(void)
+{
+    pthread_t thread;
+    sigset_t all, old;
+
+    if (_epfd >= 0) {
+        return;
+    }
+    _native_syscall_enter();
+    if ((_epfd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+        err(EXIT_FAILURE, "native_async_read_setup(): epoll_create1");
+    }
+    /* the thread inherits the signal mask: all signals are handled by the
+     * thread running RIOT */
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    if (pthread_create(&thread, NULL, _epoll_thread, NULL) != 0) {
+        err(EXIT_FAILURE, "native_async_read_setup(): pthread_create");
+    }
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    _native_syscall_leave();
+}
+#else   /* MODULE_NATIVE_ASYNC_READ_EPOLL */
 static void _async_io_isr(void) {
     fd_set rfds;
 
@@ -61,9 +154,13 @@ static void _async_io_isr(void) {
         }
     }
 }
+#endif  /* MODULE_NATIVE_ASYNC_READ_EPOLL */
 
 void native_async_read_setup(void) {
     register_interrupt(SIGIO, _async_io_isr);
+#ifdef MODULE_NATIVE_ASYNC_READ_EPOLL
+    _epoll_setup();
+#endif
 }
 
 void native_async_read_cleanup(void) {
@@ -77,6 +174,37 @@ void native_async_read_cleanup(void) {
     }
 }
 
+void native_async_read_retrigger(int fd) {
+    _native_in_syscall++; /* no switching here */
+#ifdef MODULE_NATIVE_ASYNC_READ_EPOLL
+    /* epoll reports edges only, so just pretend the file descriptor became
+     * readable again. The next read will tell. */
+    for (int i = 0; i < _next_index; i++) {
+        if (_fds[i] == fd) {
+            if (__atomic_fetch_or(&_ready, 1UL << i, __ATOMIC_SEQ_CST) == 0) {
+                _raise_sigio();
+            }
+            break;
+        }
+    }
+#else
+    /* work around lost signals */
+    fd_set rfds;
+    struct timeval t;
+
+    memset(&t, 0, sizeof(t));
+    FD_ZERO(&rfds);
+    FD_SET(fd, &rfds);
+    if (real_select(fd + 1, &rfds, NULL, NULL, &t) == 1) {
+        _raise_sigio();
+    }
+    else {
+        native_async_read_continue(fd);
+    }
+#endif
+    _native_in_syscall--;
+}
+
 void native_async_read_continue(int fd) {
     (void) fd;
 #ifdef __MACH__
@@ -97,7 +225,19 @@ void native_async_read_add_handler(int fd, void *arg, native_async_read_callback
     _args[_next_index] = arg;
     _native_async_read_callbacks[_next_index] = handler;
 
-#ifdef __MACH__
+#if defined(MODULE_NATIVE_ASYNC_READ_EPOLL)
+    struct epoll_event event = {
+        .events = EPOLLIN | EPOLLET,
+        .data = { .u32 = (1UL << _next_index) },
+    };
+
+    if (real_fcntl(fd, F_SETFL, O_NONBLOCK) == -1) {
+        err(EXIT_FAILURE, "native_async_read_add_handler(): fcntl(F_SETFL)");
+    }
+    if (epoll_ctl(_epfd, EPOLL_CTL_ADD, fd, &event) == -1) {
+        err(EXIT_FAILURE, "native_async_read_add_handler(): epoll_ctl");
+    }
+#elif defined(__MACH__)
     /* tuntap signalled IO is not working in OSX,
      * * check http://sourceforge.net/p/tuntaposx/bugs/17/ */
     _sigio_child(_next_index);
@@ -239,6 +239,9 @@ static void _isr(candev_t *candev)
         return;
     }
 
+    /* there might be more frames waiting */
+    native_async_read_retrigger(dev->sock);
+
     if (nbytes < (int)sizeof(struct can_frame)) {
         DEBUG("candev_native _isr: read: incomplete CAN frame\n");
         return;
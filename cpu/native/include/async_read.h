@@ -13,6 +13,16 @@
  * @file
  * @brief       Multiple asynchronus read on file descriptors
  *
+ * By default, the host sends a SIGIO for every file descriptor that becomes
+ * readable and the handler checks all file descriptors with `select()`.
+ *
+ * With the `native_async_read_epoll` module (Linux only), a dedicated host
+ * thread waits for all file descriptors with edge-triggered `epoll` and
+ * raises a single SIGIO for everything that became readable since the last
+ * interrupt. The handler then only calls the callbacks of the ready file
+ * descriptors. Callbacks must read until `EAGAIN` or call
+ * native_async_read_retrigger().
+ *
  * @author      Takuo Yonezawa <Yonezawa-T2@mail.dnp.co.jp>
  */
 #ifndef ASYNC_READ_H
@@ -57,6 +67,21 @@ void native_async_read_cleanup(void);
  */
 void native_async_read_continue(int fd);
 
+/**
+ * @brief   handle a file descriptor again if it is still readable
+ *
+ * Call this function instead of native_async_read_continue() after reading
+ * only a part of the available data (e.g. one datagram) from a file
+ * descriptor. If the file descriptor is still readable, its callback is
+ * called again.
+ *
+ * @note    With the `native_async_read_epoll` module the callback is called
+ *          again unconditionally, so reading might fail with `EAGAIN`.
+ *
+ * @param[in] fd  The file descriptor to handle
+ */
+void native_async_read_retrigger(int fd);
+
 /**
  * @brief   start monitoring of file descriptor
  *
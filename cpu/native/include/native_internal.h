@@ -160,6 +160,7 @@ extern char **_native_argv;
 extern pid_t _native_pid;
 extern pid_t _native_id;
 extern unsigned _native_rng_seed;
+extern unsigned _native_time_scale; /**< virtual time runs this many times faster than host time */
 extern int _native_rng_mode; /**< 0 = /dev/random, 1 = random(3) */
 extern const char *_native_unix_socket_path;
 
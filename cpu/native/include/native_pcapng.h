@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_pcapng
+ * @{
+ *
+ * @file
+ * @brief       pcapng capture into a file on the host of native
+ */
+#ifndef NATIVE_PCAPNG_H
+#define NATIVE_PCAPNG_H
+
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Open the capture file @ref GNRC_PCAPNG_NATIVE_FILE on the host
+ *
+ * @return  0 on success
+ * @return  -1 on error
+ */
+int native_pcapng_open(void);
+
+/**
+ * @brief   Write to the capture file
+ *
+ * @see gnrc_pcapng_write_t
+ */
+ssize_t native_pcapng_write(const void *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NATIVE_PCAPNG_H */
+/** @} */
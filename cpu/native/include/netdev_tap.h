@@ -27,7 +27,7 @@ extern "C" {
 #include <stdint.h>
 #include "net/netdev.h"
 
-#include "net/ethernet/hdr.h"
+#include "net/ethernet.h"
 
 #ifdef __MACH__
 #include "net/if_var.h"
@@ -44,6 +44,8 @@ typedef struct netdev_tap {
     int tap_fd;                         /**< host file descriptor for the TAP */
     uint8_t addr[ETHERNET_ADDR_LEN];    /**< The MAC address of the TAP */
     uint8_t promiscous;                 /**< Flag for promiscous mode */
+    uint16_t rx_len;                    /**< Length of the frame in rx_buf */
+    uint8_t rx_buf[ETHERNET_FRAME_LEN]; /**< Received frame */
 } netdev_tap_t;
 
 /**
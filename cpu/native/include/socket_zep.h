@@ -43,6 +43,7 @@ typedef struct {
      * @brief   Receive buffer
      */
     uint8_t rcv_buf[sizeof(zep_v2_data_hdr_t) + IEEE802154_FRAME_LEN_MAX];
+    uint16_t rcv_len;               /**< length of the frame in rcv_buf */
     /**
      * @brief   Buffer for send header
      */
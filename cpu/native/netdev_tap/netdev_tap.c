@@ -165,116 +165,90 @@ static const netdev_driver_t netdev_driver_tap = {
 };
 
 /* driver implementation */
-static inline bool _is_addr_broadcast(uint8_t *addr)
+static inline bool _is_addr_broadcast(const uint8_t *addr)
 {
     return ((addr[0] == 0xff) && (addr[1] == 0xff) && (addr[2] == 0xff) &&
             (addr[3] == 0xff) && (addr[4] == 0xff) && (addr[5] == 0xff));
 }
 
-static inline bool _is_addr_multicast(uint8_t *addr)
+static inline bool _is_addr_multicast(const uint8_t *addr)
 {
     /* source: http://ieee802.org/secmail/pdfocSP2xXA6d.pdf */
     return (addr[0] & 0x01);
 }
 
-static void _continue_reading(netdev_tap_t *dev)
+static bool _dst_not_me(netdev_tap_t *dev, const ethernet_hdr_t *hdr)
 {
-    /* work around lost signals */
-    fd_set rfds;
-    struct timeval t;
-    memset(&t, 0, sizeof(t));
-    FD_ZERO(&rfds);
-    FD_SET(dev->tap_fd, &rfds);
-
-    _native_in_syscall++; /* no switching here */
-
-    if (real_select(dev->tap_fd + 1, &rfds, NULL, NULL, &t) == 1) {
-        int sig = SIGIO;
-        extern int _sig_pipefd[2];
-        extern ssize_t (*real_write)(int fd, const void * buf, size_t count);
-        real_write(_sig_pipefd[1], &sig, sizeof(int));
-        _native_sigpend++;
-        DEBUG("netdev_tap: sigpend++\n");
-    }
-    else {
-        DEBUG("netdev_tap: native_async_read_continue\n");
-        native_async_read_continue(dev->tap_fd);
-    }
+    return !(dev->promiscous) && !_is_addr_multicast(hdr->dst) &&
+           !_is_addr_broadcast(hdr->dst) &&
+           (memcmp(hdr->dst, dev->addr, ETHERNET_ADDR_LEN) != 0);
+}
 
-    _native_in_syscall--;
+/* reads the next frame for this device into the receive buffer */
+static int _fetch(netdev_tap_t *dev)
+{
+    while (1) {
+        int nread = real_read(dev->tap_fd, dev->rx_buf, sizeof(dev->rx_buf));
+
+        DEBUG("netdev_tap: read %d bytes\n", nread);
+        if (nread >= (int)sizeof(ethernet_hdr_t)) {
+            ethernet_hdr_t *hdr = (ethernet_hdr_t *)dev->rx_buf;
+
+            if (_dst_not_me(dev, hdr)) {
+                DEBUG("netdev_tap: received for %02x:%02x:%02x:%02x:%02x:%02x\n"
+                      "That's not me => Dropped\n",
+                      hdr->dst[0], hdr->dst[1], hdr->dst[2],
+                      hdr->dst[3], hdr->dst[4], hdr->dst[5]);
+                continue;
+            }
+            dev->rx_len = nread;
+            return nread;
+        }
+        else if (nread >= 0) {
+            DEBUG("_native_handle_tap_input: ignoring null-event\n");
+        }
+        else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            return 0;
+        }
+        else {
+            err(EXIT_FAILURE, "netdev_tap: read");
+        }
+    }
 }
 
 static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
 {
     netdev_tap_t *dev = (netdev_tap_t*)netdev;
+    int size;
     (void)info;
 
+    /* The size of a frame is only known after reading it, so it is buffered
+     * until the stack provides a buffer of exactly the right size */
+    if ((dev->rx_len == 0) && (_fetch(dev) == 0)) {
+        return (buf == NULL) ? 0 : -1;
+    }
+    size = dev->rx_len;
     if (!buf) {
         if (len > 0) {
             /* no memory available in pktbuf, discarding the frame */
             DEBUG("netdev_tap: discarding the frame\n");
-
-            /* repeating `real_read` for small size on tap device results in
-             * freeze for some reason. Using a large buffer for now. */
-            /*
-            uint8_t buf[4];
-            while (real_read(dev->tap_fd, buf, sizeof(buf)) > 0) {
-            }
-            */
-
-            static uint8_t nullbuf[ETHERNET_FRAME_LEN];
-
-            real_read(dev->tap_fd, nullbuf, sizeof(nullbuf));
-
-            _continue_reading(dev);
+            dev->rx_len = 0;
+            native_async_read_retrigger(dev->tap_fd);
         }
-
-        /* no way of figuring out packet size without racey buffering,
-         * so we return the maximum possible size */
-        return ETHERNET_FRAME_LEN;
+        return size;
     }
-
-    int nread = real_read(dev->tap_fd, buf, len);
-    DEBUG("netdev_tap: read %d bytes\n", nread);
-
-    if (nread > 0) {
-        ethernet_hdr_t *hdr = (ethernet_hdr_t *)buf;
-        if (!(dev->promiscous) && !_is_addr_multicast(hdr->dst) &&
-            !_is_addr_broadcast(hdr->dst) &&
-            (memcmp(hdr->dst, dev->addr, ETHERNET_ADDR_LEN) != 0)) {
-            DEBUG("netdev_tap: received for %02x:%02x:%02x:%02x:%02x:%02x\n"
-                  "That's not me => Dropped\n",
-                  hdr->dst[0], hdr->dst[1], hdr->dst[2],
-                  hdr->dst[3], hdr->dst[4], hdr->dst[5]);
-
-            native_async_read_continue(dev->tap_fd);
-
-            return 0;
-        }
-
-        _continue_reading(dev);
-
+    dev->rx_len = 0;
+    native_async_read_retrigger(dev->tap_fd);
+    if (len < (size_t)size) {
+        DEBUG("netdev_tap: buffer too small, discarding the frame\n");
+        return -1;
+    }
+    memcpy(buf, dev->rx_buf, size);
 #ifdef MODULE_NETSTATS_L2
-        netdev->stats.rx_count++;
-        netdev->stats.rx_bytes += nread;
+    netdev->stats.rx_count++;
+    netdev->stats.rx_bytes += size;
 #endif
-        return nread;
-    }
-    else if (nread == -1) {
-        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
-        }
-        else {
-            err(EXIT_FAILURE, "netdev_tap: read");
-        }
-    }
-    else if (nread == 0) {
-        DEBUG("_native_handle_tap_input: ignoring null-event\n");
-    }
-    else {
-        errx(EXIT_FAILURE, "internal error _rx_event");
-    }
-
-    return -1;
+    return size;
 }
 
 static int _send(netdev_t *netdev, const iolist_t *iolist)
@@ -341,6 +315,7 @@ static int _init(netdev_t *netdev)
 #endif
     /* initialize device descriptor */
     dev->promiscous = 0;
+    dev->rx_len = 0;
     /* implicitly create the tap interface */
     if ((dev->tap_fd = real_open(clonedev, O_RDWR | O_NONBLOCK)) == -1) {
         err(EXIT_FAILURE, "open(%s)", clonedev);
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_pcapng
+ * @{
+ *
+ * @file
+ * @brief       pcapng capture into a file on the host of native
+ *
+ * @}
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+
+#include "native_internal.h"
+#include "native_pcapng.h"
+#include "net/gnrc/pcapng.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+static int _fd = -1;
+
+int native_pcapng_open(void)
+{
+    char path[64];
+
+    snprintf(path, sizeof(path), GNRC_PCAPNG_NATIVE_FILE, real_getpid());
+    _native_syscall_enter();
+    _fd = real_open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    _native_syscall_leave();
+    if (_fd < 0) {
+        DEBUG("native_pcapng: unable to open %s\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+ssize_t native_pcapng_write(const void *data, size_t len)
+{
+    ssize_t res;
+
+    _native_syscall_enter();
+    res = real_write(_fd, data, len);
+    _native_syscall_leave();
+    return res;
+}
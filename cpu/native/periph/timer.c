@@ -66,7 +66,9 @@ static struct itimerval itv;
 static unsigned long ts2ticks(struct timespec *tp)
 {
     /* TODO: check for overflow */
-    return((tp->tv_sec * NATIVE_TIMER_SPEED) + (tp->tv_nsec / 1000));
+    /* the virtual time runs _native_time_scale times faster */
+    return ((tp->tv_sec * NATIVE_TIMER_SPEED) + (tp->tv_nsec / 1000)) *
+           _native_time_scale;
 }
 
 /**
@@ -109,8 +111,12 @@ static void do_timer_set(unsigned int offset)
 {
     DEBUG("%s\n", __func__);
 
-    if (offset && offset < NATIVE_TIMER_MIN_RES) {
-        offset = NATIVE_TIMER_MIN_RES;
+    /* offset is in virtual time */
+    if (offset) {
+        offset /= _native_time_scale;
+        if (offset < NATIVE_TIMER_MIN_RES) {
+            offset = NATIVE_TIMER_MIN_RES;
+        }
     }
 
     memset(&itv, 0, sizeof(itv));
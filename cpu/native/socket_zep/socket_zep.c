@@ -20,7 +20,6 @@
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
-#include <sys/ioctl.h>
 #include <sys/time.h>
 
 #include "async_read.h"
@@ -129,31 +128,6 @@ static int _send(netdev_t *netdev, const iolist_t *iolist)
     return res - v[0].iov_len - v[n + 1].iov_len;
 }
 
-static void _continue_reading(socket_zep_t *dev)
-{
-    /* work around lost signals */
-    fd_set rfds;
-    struct timeval t;
-    memset(&t, 0, sizeof(t));
-    FD_ZERO(&rfds);
-    FD_SET(dev->sock_fd, &rfds);
-
-    _native_in_syscall++; /* no switching here */
-
-    if (real_select(dev->sock_fd + 1, &rfds, NULL, NULL, &t) == 1) {
-        int sig = SIGIO;
-        extern int _sig_pipefd[2];
-        extern ssize_t (*real_write)(int fd, const void * buf, size_t count);
-        real_write(_sig_pipefd[1], &sig, sizeof(int));
-        _native_sigpend++;
-    }
-    else {
-        native_async_read_continue(dev->sock_fd);
-    }
-
-    _native_in_syscall--;
-}
-
 static inline bool _dst_not_me(socket_zep_t *dev, const void *buf)
 {
     uint8_t dst_addr[IEEE802154_LONG_ADDRESS_LEN] = { 0 };
@@ -173,85 +147,98 @@ static inline bool _dst_not_me(socket_zep_t *dev, const void *buf)
     }
 }
 
-static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
+/* checks if the datagram in the receive buffer is a valid ZEP data frame for
+ * this device and returns the length of its payload without FCS */
+static int _check_frame(socket_zep_t *dev, int size)
 {
-    socket_zep_t *dev = (socket_zep_t *)netdev;
-    int size = 0;
+    zep_v2_data_hdr_t *zep = (zep_v2_data_hdr_t *)dev->rcv_buf;
 
-    DEBUG("socket_zep::recv(%p, %p, %u, %p)\n", (void *)netdev, buf,
-          (unsigned)len, (void *)info);
-    if ((buf == NULL) || (len == 0)) {
-        int res = real_ioctl(dev->sock_fd, FIONREAD, &size);
-#if ENABLE_DEBUG
-        if (res < 0) {
-            DEBUG("socket_zep::recv: error reading FIONREAD: %s",
-                  strerror(errno));
-        }
-#else
-        (void)res;
-#endif
-        return size;
+    if ((size < (int)sizeof(zep_v2_data_hdr_t)) ||
+        (zep->hdr.preamble[0] != 'E') || (zep->hdr.preamble[1] != 'X')) {
+        DEBUG("socket_zep::recv: invalid ZEP header\n");
+        return -1;
+    }
+    if (zep->hdr.version != 2) {
+        DEBUG("socket_zep::recv: unexpected ZEP version\n");
+        return -1;
     }
-    else if (len > 0) {
-        size = real_read(dev->sock_fd, dev->rcv_buf, sizeof(dev->rcv_buf));
+    if (zep->type != ZEP_V2_TYPE_DATA) {
+        DEBUG("socket_zep::recv: unexpect ZEP type\n");
+        /* don't support ACK frames for now*/
+        return -1;
+    }
+    if (((sizeof(zep_v2_data_hdr_t) + zep->length) != (unsigned)size) ||
+        (zep->length < (IEEE802154_MIN_FRAME_LEN + sizeof(uint16_t))) ||
+        (zep->chan != dev->netdev.chan) ||
+        /* TODO promiscous mode */
+        _dst_not_me(dev, &dev->rcv_buf[sizeof(zep_v2_data_hdr_t)])) {
+        /* TODO: check checksum */
+        return -1;
+    }
+    /* don't hand FCS to stack */
+    return zep->length - sizeof(uint16_t);
+}
 
-        if (size > 0) {
-            zep_hdr_t *tmp = (zep_hdr_t *)&dev->rcv_buf;
+/* reads the next frame for this device into the receive buffer */
+static int _fetch(socket_zep_t *dev)
+{
+    while (1) {
+        int size = real_read(dev->sock_fd, dev->rcv_buf, sizeof(dev->rcv_buf));
 
-            if ((tmp->preamble[0] != 'E') || (tmp->preamble[1] != 'X')) {
-                DEBUG("socket_zep::recv: invalid ZEP header");
-                return -1;
-            }
-            switch (tmp->version) {
-                case 2: {
-                    zep_v2_data_hdr_t *zep = (zep_v2_data_hdr_t *)tmp;
-                    void *payload = &dev->rcv_buf[sizeof(zep_v2_data_hdr_t)];
-
-                    if (zep->type != ZEP_V2_TYPE_DATA) {
-                        DEBUG("socket_zep::recv: unexpect ZEP type\n");
-                        /* don't support ACK frames for now*/
-                        return -1;
-                    }
-                    if (((sizeof(zep_v2_data_hdr_t) + zep->length) != (unsigned)size) ||
-                        (zep->length > len) || (zep->chan != dev->netdev.chan) ||
-                        /* TODO promiscous mode */
-                        _dst_not_me(dev, payload)) {
-                        /* TODO: check checksum */
-                        return -1;
-                    }
-                    /* don't hand FCS to stack */
-                    size = zep->length - sizeof(uint16_t);
-                    if (buf != NULL) {
-                        memcpy(buf, payload, size);
-                        if (info != NULL) {
-                            struct netdev_radio_rx_info *rx_info = info;
-                            rx_info->lqi = zep->lqi_val;
-                            rx_info->rssi = UINT8_MAX;
-                        }
-                    }
-                    break;
-                }
-                default:
-                    DEBUG("socket_zep::recv: unexpected ZEP version\n");
-                    return -1;
+        if (size > 0) {
+            if ((size = _check_frame(dev, size)) > 0) {
+                dev->rcv_len = size;
+                return size;
             }
         }
         else if (size == 0) {
             DEBUG("socket_zep::recv: ignoring null-event\n");
-            return -1;
         }
-        else if (size == -1) {
-            if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
-            }
-            else {
-                err(EXIT_FAILURE, "zep: read");
-            }
+        else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            /* nothing left to read */
+            return 0;
         }
         else {
-            errx(EXIT_FAILURE, "internal error _rx_event");
+            err(EXIT_FAILURE, "zep: read");
         }
     }
-    _continue_reading(dev);
+}
+
+static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
+{
+    socket_zep_t *dev = (socket_zep_t *)netdev;
+    zep_v2_data_hdr_t *zep = (zep_v2_data_hdr_t *)dev->rcv_buf;
+    int size;
+
+    DEBUG("socket_zep::recv(%p, %p, %u, %p)\n", (void *)netdev, buf,
+          (unsigned)len, (void *)info);
+    /* The datagram is read on the first call, so the exact length of the
+     * frame is known before the stack allocates a buffer for it */
+    if ((dev->rcv_len == 0) && (_fetch(dev) == 0)) {
+        return (buf == NULL) ? 0 : -1;
+    }
+    size = dev->rcv_len;
+    if (buf == NULL) {
+        if (len > 0) {
+            /* drop frame */
+            dev->rcv_len = 0;
+            native_async_read_retrigger(dev->sock_fd);
+        }
+        return size;
+    }
+    dev->rcv_len = 0;
+    /* there might be more datagrams waiting */
+    native_async_read_retrigger(dev->sock_fd);
+    if (len < (size_t)size) {
+        DEBUG("socket_zep::recv: buffer too small, dropping frame\n");
+        return -1;
+    }
+    memcpy(buf, &dev->rcv_buf[sizeof(zep_v2_data_hdr_t)], size);
+    if (info != NULL) {
+        struct netdev_radio_rx_info *rx_info = info;
+        rx_info->lqi = zep->lqi_val;
+        rx_info->rssi = UINT8_MAX;
+    }
 #ifdef MODULE_NETSTATS_L2
     netdev->stats.rx_count++;
     netdev->stats.rx_bytes += size;
@@ -61,6 +61,7 @@ char **_native_argv;
 pid_t _native_pid;
 pid_t _native_id;
 unsigned _native_rng_seed = 0;
+unsigned _native_time_scale = 1;
 int _native_rng_mode = 0;
 const char *_native_unix_socket_path = NULL;
 
@@ -83,7 +84,7 @@ netdev_tap_params_t netdev_tap_params[NETDEV_TAP_MAX];
 socket_zep_params_t socket_zep_params[SOCKET_ZEP_MAX];
 #endif
 
-static const char short_opts[] = ":hi:s:deEoc:"
+static const char short_opts[] = ":hi:s:deEoc:t:"
 #ifdef MODULE_MTD_NATIVE
     "m:"
 #endif
@@ -104,6 +105,7 @@ static const struct option long_opts[] = {
     { "stderr-noredirect", no_argument, NULL, 'E' },
     { "stdout-pipe", no_argument, NULL, 'o' },
     { "uart-tty", required_argument, NULL, 'c' },
+    { "time-scale", required_argument, NULL, 't' },
 #ifdef MODULE_MTD_NATIVE
     { "mtd", required_argument, NULL, 'm' },
 #endif
@@ -242,7 +244,7 @@ void usage_exit(int status)
         real_printf(" <tap interface %d>", i + 1);
     }
 #endif
-    real_printf(" [-i <id>] [-d] [-e|-E] [-o] [-c <tty>]\n");
+    real_printf(" [-i <id>] [-d] [-e|-E] [-o] [-c <tty>] [-t <factor>]\n");
 #if defined(MODULE_SOCKET_ZEP) && (SOCKET_ZEP_MAX > 0)
     real_printf(" -z [[<laddr>:<lport>,]<raddr>:<rport>]\n");
     for (int i = 0; i < SOCKET_ZEP_MAX - 1; i++) {
@@ -275,6 +277,9 @@ void usage_exit(int status)
 "    -c <tty>, --uart-tty=<tty>\n"
 "        specify TTY device for UART. This argument can be used multiple\n"
 "        times (up to UART_NUMOF)\n"
+"    -t <factor>, --time-scale=<factor>\n"
+"        run the timers <factor> times faster than the host clock, e.g. to\n"
+"        simulate networks of idle nodes faster than real time\n"
 #if defined(MODULE_SOCKET_ZEP) && (SOCKET_ZEP_MAX > 0)
 "    -z [<laddr>:<lport>,]<raddr>:<rport> --zep=[<laddr>:<lport>,]<raddr>:<rport>\n"
 "        provide a ZEP interface with local address and port (<laddr>, <lport>)\n"
@@ -427,6 +432,11 @@ __attribute__((constructor)) static void startup(int argc, char **argv, char **e
             case 'c':
                 tty_uart_setup(uart++, optarg);
                 break;
+            case 't':
+                if ((_native_time_scale = atol(optarg)) == 0) {
+                    usage_exit(EXIT_FAILURE);
+                }
+                break;
 #ifdef MODULE_MTD_NATIVE
             case 'm':
                 ((mtd_native_dev_t *)mtd0)->fname = strndup(optarg, PATH_MAX - 1);
@@ -0,0 +1,609 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/*
+ * ZEP hub: connects native instances using socket_zep to a simulated
+ * IEEE 802.15.4 medium with configurable links.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#define DEFAULT_PORT        "17754"
+#define MAX_NODES           (1024U)
+#define MAX_PENDING         (8192U)
+#define L2ADDR_MAX_LEN      (8U)
+/* ZEPv2 data header */
+#define ZEP_HDR_LEN         (32U)
+#define ZEP_LEN_OFFSET      (31U)
+#define IEEE802154_MAX_LEN  (127U)
+#define FRAME_MAX_LEN       (ZEP_HDR_LEN + IEEE802154_MAX_LEN)
+
+typedef struct {
+    unsigned dst;           /* index of the receiving node */
+    double loss;            /* loss probability */
+    uint64_t delay_us;      /* delay in host time */
+    uint64_t frames;        /* delivered frames */
+    uint64_t bytes;         /* delivered bytes */
+    uint64_t lost;          /* lost frames */
+} link_t;
+
+typedef struct {
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+    uint8_t l2addr[L2ADDR_MAX_LEN];
+    size_t l2addr_len;
+    link_t *links;
+    unsigned links_numof;
+    unsigned links_size;
+} node_t;
+
+typedef struct {
+    uint8_t a[L2ADDR_MAX_LEN];
+    size_t a_len;
+    uint8_t b[L2ADDR_MAX_LEN];
+    size_t b_len;
+    double loss;
+    uint64_t delay_us;      /* delay in virtual time */
+} topo_entry_t;
+
+typedef struct {
+    uint64_t due;           /* in host time */
+    uint64_t seq;           /* keeps the order of frames due at the same time */
+    unsigned dst;
+    size_t len;
+    uint8_t data[FRAME_MAX_LEN];
+} pending_t;
+
+static node_t _nodes[MAX_NODES];
+static unsigned _nodes_numof;
+static topo_entry_t *_topo;
+static unsigned _topo_numof;
+static bool _use_topo;
+/* min-heap of frames in flight ordered by due time */
+static pending_t *_pending[MAX_PENDING];
+static unsigned _pending_numof;
+static uint64_t _pending_seq;
+static uint64_t _overflows;
+
+static double _default_loss;
+static uint64_t _default_delay_us;
+static unsigned _time_scale = 1;
+static volatile sig_atomic_t _print_stats;
+static volatile sig_atomic_t _quit;
+
+static uint64_t _now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000U) + (ts.tv_nsec / 1000U);
+}
+
+static void _print_l2addr(FILE *f, const uint8_t *addr, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        fprintf(f, "%s%02x", (i == 0) ? "" : ":", addr[i]);
+    }
+    if (len == 0) {
+        fprintf(f, "?");
+    }
+}
+
+static int _parse_l2addr(const char *str, uint8_t *addr)
+{
+    size_t len = 0;
+
+    while (*str != '\0') {
+        char *end;
+        unsigned long byte = strtoul(str, &end, 16);
+
+        if ((end == str) || (byte > 0xff) || (len >= L2ADDR_MAX_LEN)) {
+            return -1;
+        }
+        addr[len++] = byte;
+        str = end;
+        if (*str == ':') {
+            str++;
+        }
+        else if (*str != '\0') {
+            return -1;
+        }
+    }
+    return ((len == 2) || (len == 8)) ? (int)len : -1;
+}
+
+/* returns the source address of an IEEE 802.15.4 frame in the byte order
+ * RIOT displays it */
+static size_t _frame_src(const uint8_t *frame, size_t len, uint8_t *addr)
+{
+    static const size_t addr_lens[] = { 0, 0, 2, 8 };
+    size_t pos = 3;     /* frame control field and sequence number */
+    size_t dst_len, src_len;
+
+    if (len < 3) {
+        return 0;
+    }
+    dst_len = addr_lens[(frame[1] >> 2) & 0x3];
+    src_len = addr_lens[(frame[1] >> 6) & 0x3];
+    if (dst_len) {
+        pos += 2 + dst_len;
+    }
+    /* source PAN ID is elided with PAN ID compression */
+    if (src_len && !(dst_len && (frame[0] & 0x40))) {
+        pos += 2;
+    }
+    if ((src_len == 0) || ((pos + src_len) > len)) {
+        return 0;
+    }
+    for (size_t i = 0; i < src_len; i++) {
+        addr[i] = frame[pos + src_len - 1 - i];
+    }
+    return src_len;
+}
+
+static int _read_topology(const char *path)
+{
+    char line[256];
+    unsigned lineno = 0;
+    FILE *f = fopen(path, "r");
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f) != NULL) {
+        char a[64], b[64];
+        double loss = _default_loss * 100;
+        double delay_ms = _default_delay_us / 1000.0;
+        topo_entry_t *entry;
+        int n;
+
+        lineno++;
+        if ((line[0] == '#') || (sscanf(line, " %63s", a) != 1)) {
+            continue;
+        }
+        n = sscanf(line, " %63s %63s %lf %lf", a, b, &loss, &delay_ms);
+        if (n < 2) {
+            fprintf(stderr, "%s:%u: expected <addr> <addr> [<loss %%> [<delay ms>]]\n",
+                    path, lineno);
+            goto error;
+        }
+        entry = realloc(_topo, (_topo_numof + 1) * sizeof(*_topo));
+        if (entry == NULL) {
+            perror("realloc");
+            goto error;
+        }
+        _topo = entry;
+        entry = &_topo[_topo_numof];
+        if ((n = _parse_l2addr(a, entry->a)) < 0) {
+            fprintf(stderr, "%s:%u: invalid address %s\n", path, lineno, a);
+            goto error;
+        }
+        entry->a_len = n;
+        if ((n = _parse_l2addr(b, entry->b)) < 0) {
+            fprintf(stderr, "%s:%u: invalid address %s\n", path, lineno, b);
+            goto error;
+        }
+        entry->b_len = n;
+        entry->loss = loss / 100;
+        entry->delay_us = (uint64_t)(delay_ms * 1000);
+        _topo_numof++;
+    }
+    fclose(f);
+    return 0;
+
+error:
+    fclose(f);
+    return -1;
+}
+
+static bool _l2addr_equal(const uint8_t *a, size_t a_len,
+                          const uint8_t *b, size_t b_len)
+{
+    return (a_len == b_len) && (memcmp(a, b, a_len) == 0);
+}
+
+static int _add_link(unsigned src, unsigned dst, double loss,
+                     uint64_t virt_delay_us)
+{
+    node_t *node = &_nodes[src];
+    link_t *link;
+
+    if (node->links_numof == node->links_size) {
+        unsigned size = node->links_size ? (2 * node->links_size) : 8;
+
+        if ((link = realloc(node->links, size * sizeof(*link))) == NULL) {
+            perror("realloc");
+            return -1;
+        }
+        node->links = link;
+        node->links_size = size;
+    }
+    link = &node->links[node->links_numof++];
+    memset(link, 0, sizeof(*link));
+    link->dst = dst;
+    link->loss = loss;
+    /* nodes run _time_scale times faster than the host */
+    link->delay_us = virt_delay_us / _time_scale;
+    return 0;
+}
+
+/* connects a newly learned node to the known ones */
+static int _connect_node(unsigned idx)
+{
+    node_t *node = &_nodes[idx];
+
+    for (unsigned i = 0; i < _nodes_numof; i++) {
+        node_t *other = &_nodes[i];
+
+        if (i == idx) {
+            continue;
+        }
+        if (!_use_topo) {
+            if ((_add_link(idx, i, _default_loss, _default_delay_us) < 0) ||
+                (_add_link(i, idx, _default_loss, _default_delay_us) < 0)) {
+                return -1;
+            }
+            continue;
+        }
+        for (unsigned t = 0; t < _topo_numof; t++) {
+            topo_entry_t *e = &_topo[t];
+
+            if ((_l2addr_equal(e->a, e->a_len, node->l2addr, node->l2addr_len) &&
+                 _l2addr_equal(e->b, e->b_len, other->l2addr, other->l2addr_len)) ||
+                (_l2addr_equal(e->b, e->b_len, node->l2addr, node->l2addr_len) &&
+                 _l2addr_equal(e->a, e->a_len, other->l2addr, other->l2addr_len))) {
+                if ((_add_link(idx, i, e->loss, e->delay_us) < 0) ||
+                    (_add_link(i, idx, e->loss, e->delay_us) < 0)) {
+                    return -1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+static int _get_node(const struct sockaddr_storage *addr, socklen_t addr_len,
+                     const uint8_t *frame, size_t frame_len)
+{
+    node_t *node;
+
+    for (unsigned i = 0; i < _nodes_numof; i++) {
+        if ((_nodes[i].addr_len == addr_len) &&
+            (memcmp(&_nodes[i].addr, addr, addr_len) == 0)) {
+            return i;
+        }
+    }
+    if (_nodes_numof >= MAX_NODES) {
+        return -1;
+    }
+    node = &_nodes[_nodes_numof];
+    memset(node, 0, sizeof(*node));
+    memcpy(&node->addr, addr, addr_len);
+    node->addr_len = addr_len;
+    node->l2addr_len = _frame_src(frame, frame_len, node->l2addr);
+    if (node->l2addr_len == 0) {
+        /* wait for a frame that tells the address of the node */
+        return -1;
+    }
+    _nodes_numof++;
+    if (_connect_node(_nodes_numof - 1) < 0) {
+        exit(EXIT_FAILURE);
+    }
+    printf("node %u: ", _nodes_numof - 1);
+    _print_l2addr(stdout, node->l2addr, node->l2addr_len);
+    printf(" (%u links)\n", node->links_numof);
+    return _nodes_numof - 1;
+}
+
+static bool _pending_before(unsigned a, unsigned b)
+{
+    return (_pending[a]->due < _pending[b]->due) ||
+           ((_pending[a]->due == _pending[b]->due) &&
+            (_pending[a]->seq < _pending[b]->seq));
+}
+
+static void _pending_swap(unsigned a, unsigned b)
+{
+    pending_t *tmp = _pending[a];
+
+    _pending[a] = _pending[b];
+    _pending[b] = tmp;
+}
+
+static int _pending_push(uint64_t due, unsigned dst, const uint8_t *data,
+                         size_t len)
+{
+    pending_t *p;
+    unsigned i;
+
+    if ((_pending_numof >= MAX_PENDING) ||
+        ((p = malloc(sizeof(*p))) == NULL)) {
+        _overflows++;
+        return -1;
+    }
+    p->due = due;
+    p->seq = _pending_seq++;
+    p->dst = dst;
+    p->len = len;
+    memcpy(p->data, data, len);
+    i = _pending_numof++;
+    _pending[i] = p;
+    while ((i > 0) && _pending_before(i, (i - 1) / 2)) {
+        _pending_swap(i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+    return 0;
+}
+
+static pending_t *_pending_pop(void)
+{
+    pending_t *res = _pending[0];
+    unsigned i = 0;
+
+    _pending[0] = _pending[--_pending_numof];
+    while (1) {
+        unsigned l = (2 * i) + 1, r = l + 1, min = i;
+
+        if ((l < _pending_numof) && _pending_before(l, min)) {
+            min = l;
+        }
+        if ((r < _pending_numof) && _pending_before(r, min)) {
+            min = r;
+        }
+        if (min == i) {
+            break;
+        }
+        _pending_swap(i, min);
+        i = min;
+    }
+    return res;
+}
+
+static void _send_to(int sock, unsigned dst, const uint8_t *data, size_t len)
+{
+    node_t *node = &_nodes[dst];
+
+    if (sendto(sock, data, len, 0, (struct sockaddr *)&node->addr,
+               node->addr_len) < 0) {
+        perror("sendto");
+    }
+}
+
+static void _dispatch(int sock, unsigned src, const uint8_t *data, size_t len)
+{
+    node_t *node = &_nodes[src];
+    uint64_t now = _now_us();
+
+    for (unsigned i = 0; i < node->links_numof; i++) {
+        link_t *link = &node->links[i];
+
+        if ((link->loss > 0) && (drand48() < link->loss)) {
+            link->lost++;
+            continue;
+        }
+        link->frames++;
+        link->bytes += len - ZEP_HDR_LEN;
+        if (link->delay_us == 0) {
+            _send_to(sock, link->dst, data, len);
+        }
+        else if (_pending_push(now + link->delay_us, link->dst, data, len) < 0) {
+            link->frames--;
+            link->bytes -= len - ZEP_HDR_LEN;
+            link->lost++;
+        }
+    }
+}
+
+static void _stats(FILE *f)
+{
+    fprintf(f, "--- %u nodes, %" PRIu64 " frames dropped due to queue overflow\n",
+            _nodes_numof, _overflows);
+    for (unsigned i = 0; i < _nodes_numof; i++) {
+        node_t *node = &_nodes[i];
+
+        for (unsigned j = 0; j < node->links_numof; j++) {
+            link_t *link = &node->links[j];
+
+            if ((link->frames == 0) && (link->lost == 0)) {
+                continue;
+            }
+            _print_l2addr(f, node->l2addr, node->l2addr_len);
+            fprintf(f, " -> ");
+            _print_l2addr(f, _nodes[link->dst].l2addr,
+                          _nodes[link->dst].l2addr_len);
+            fprintf(f, ": %" PRIu64 " frames, %" PRIu64 " bytes, %" PRIu64
+                    " lost\n", link->frames, link->bytes, link->lost);
+        }
+    }
+    fflush(f);
+}
+
+static void _sig_handler(int sig)
+{
+    if (sig == SIGUSR1) {
+        _print_stats = 1;
+    }
+    else {
+        _quit = 1;
+    }
+}
+
+static void _usage(const char *progname)
+{
+    fprintf(stderr,
+"usage: %s [-a <addr>] [-p <port>] [-t <topology>] [-l <loss %%>]\n"
+"       [-d <delay ms>] [-s <time scale>] [-S <stats interval s>] [-r <seed>]\n"
+"\n"
+"    -a <addr>   address to listen on (default: ::)\n"
+"    -p <port>   port to listen on (default: " DEFAULT_PORT ")\n"
+"    -t <file>   topology file with lines of the form\n"
+"                <addr> <addr> [<loss %%> [<delay ms>]]\n"
+"                Only listed node pairs can hear each other.\n"
+"                Without topology, all nodes can hear each other.\n"
+"    -l <loss>   default loss rate of a link in percent (default: 0)\n"
+"    -d <delay>  default delay of a link in ms (default: 0)\n"
+"    -s <scale>  time scale the nodes run with (native option -t)\n"
+"    -S <secs>   print link statistics every <secs> seconds\n"
+"    -r <seed>   seed for the loss model (default: 0)\n"
+"\n"
+"Send SIGUSR1 to print the link statistics.\n", progname);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv)
+{
+    const char *addr = "::", *port = DEFAULT_PORT, *topo = NULL;
+    unsigned stats_interval = 0;
+    uint64_t next_stats = 0;
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_DGRAM,
+                              .ai_flags = AI_PASSIVE };
+    struct addrinfo *ai;
+    struct sigaction sa;
+    long seed = 0;
+    int c, res, sock;
+
+    while ((c = getopt(argc, argv, "a:p:t:l:d:s:S:r:h")) >= 0) {
+        switch (c) {
+            case 'a':
+                addr = optarg;
+                break;
+            case 'p':
+                port = optarg;
+                break;
+            case 't':
+                topo = optarg;
+                break;
+            case 'l':
+                _default_loss = atof(optarg) / 100;
+                break;
+            case 'd':
+                _default_delay_us = (uint64_t)(atof(optarg) * 1000);
+                break;
+            case 's':
+                if ((_time_scale = atoi(optarg)) == 0) {
+                    _usage(argv[0]);
+                }
+                break;
+            case 'S':
+                stats_interval = atoi(optarg);
+                break;
+            case 'r':
+                seed = atol(optarg);
+                break;
+            default:
+                _usage(argv[0]);
+                break;
+        }
+    }
+    srand48(seed);
+    if (topo != NULL) {
+        if (_read_topology(topo) < 0) {
+            return EXIT_FAILURE;
+        }
+        _use_topo = true;
+    }
+    if ((res = getaddrinfo(addr, port, &hints, &ai)) != 0) {
+        fprintf(stderr, "getaddrinfo: %s\n", gai_strerror(res));
+        return EXIT_FAILURE;
+    }
+    if (((sock = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol)) < 0) ||
+        (bind(sock, ai->ai_addr, ai->ai_addrlen) < 0)) {
+        perror("socket");
+        return EXIT_FAILURE;
+    }
+    freeaddrinfo(ai);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = _sig_handler;
+    sigaction(SIGUSR1, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    printf("ZEP hub listening on [%s]:%s\n", addr, port);
+    if (stats_interval) {
+        next_stats = _now_us() + (stats_interval * 1000000ULL);
+    }
+    while (!_quit) {
+        struct pollfd pfd = { .fd = sock, .events = POLLIN };
+        uint64_t now = _now_us();
+        int timeout = -1;
+
+        /* deliver due frames */
+        while ((_pending_numof > 0) && (_pending[0]->due <= now)) {
+            pending_t *p = _pending_pop();
+
+            _send_to(sock, p->dst, p->data, p->len);
+            free(p);
+        }
+        if (stats_interval && (now >= next_stats)) {
+            _print_stats = 1;
+            next_stats = now + (stats_interval * 1000000ULL);
+        }
+        if (_print_stats) {
+            _print_stats = 0;
+            _stats(stdout);
+        }
+        if (_pending_numof > 0) {
+            timeout = (int)((_pending[0]->due - now + 999) / 1000);
+        }
+        if (stats_interval) {
+            int stats_timeout = (int)((next_stats - now + 999) / 1000);
+
+            if ((timeout < 0) || (stats_timeout < timeout)) {
+                timeout = stats_timeout;
+            }
+        }
+        if (poll(&pfd, 1, timeout) < 0) {
+            if (errno != EINTR) {
+                perror("poll");
+                break;
+            }
+            continue;
+        }
+        if (pfd.revents & POLLIN) {
+            uint8_t frame[FRAME_MAX_LEN];
+            struct sockaddr_storage src;
+            socklen_t src_len = sizeof(src);
+            ssize_t len = recvfrom(sock, frame, sizeof(frame), MSG_DONTWAIT,
+                                   (struct sockaddr *)&src, &src_len);
+            int node;
+
+            /* only ZEPv2 data frames are forwarded */
+            if ((len < (ssize_t)ZEP_HDR_LEN) || (frame[0] != 'E') ||
+                (frame[1] != 'X') || (frame[2] != 2) || (frame[3] != 1) ||
+                ((size_t)len != (ZEP_HDR_LEN + frame[ZEP_LEN_OFFSET]))) {
+                continue;
+            }
+            node = _get_node(&src, src_len, &frame[ZEP_HDR_LEN],
+                             len - ZEP_HDR_LEN);
+            if (node >= 0) {
+                _dispatch(sock, node, frame, len);
+            }
+        }
+    }
+    _stats(stdout);
+    close(sock);
+    return EXIT_SUCCESS;
+}
@@ -163,6 +163,16 @@ size_t at86rf2xx_tx_load(at86rf2xx_t *dev, const uint8_t *data,
     return offset + len;
 }
 
+size_t at86rf2xx_tx_load_iolist(at86rf2xx_t *dev, const iolist_t *iolist,
+                                size_t offset)
+{
+    size_t len = iolist_size(iolist);
+
+    dev->tx_frame_len += (uint8_t)len;
+    at86rf2xx_sram_writev(dev, offset + 1, iolist);
+    return offset + len;
+}
+
 void at86rf2xx_tx_exec(const at86rf2xx_t *dev)
 {
     netdev_t *netdev = (netdev_t *)dev;
@@ -59,24 +59,64 @@ uint8_t at86rf2xx_reg_read(const at86rf2xx_t *dev, uint8_t addr)
 void at86rf2xx_sram_read(const at86rf2xx_t *dev, uint8_t offset,
                          uint8_t *data, size_t len)
 {
-    uint8_t reg = (AT86RF2XX_ACCESS_SRAM | AT86RF2XX_ACCESS_READ);
+    uint8_t hdr[] = { AT86RF2XX_ACCESS_SRAM | AT86RF2XX_ACCESS_READ, offset };
+    spi_xfer_t xfer[] = {
+        { .next = &xfer[1], .out = hdr, .len = sizeof(hdr) },
+        { .in = data, .len = len },
+    };
 
     getbus(dev);
-    spi_transfer_byte(SPIDEV, CSPIN, true, reg);
-    spi_transfer_byte(SPIDEV, CSPIN, true, offset);
-    spi_transfer_bytes(SPIDEV, CSPIN, false, NULL, data, len);
+    spi_transfer_chain(SPIDEV, CSPIN, false, xfer, NULL, NULL);
     spi_release(SPIDEV);
 }
 
 void at86rf2xx_sram_write(const at86rf2xx_t *dev, uint8_t offset,
                           const uint8_t *data, size_t len)
 {
-    uint8_t reg = (AT86RF2XX_ACCESS_SRAM | AT86RF2XX_ACCESS_WRITE);
+    uint8_t hdr[] = { AT86RF2XX_ACCESS_SRAM | AT86RF2XX_ACCESS_WRITE, offset };
+    spi_xfer_t xfer[] = {
+        { .next = &xfer[1], .out = hdr, .len = sizeof(hdr) },
+        { .out = data, .len = len },
+    };
 
     getbus(dev);
-    spi_transfer_byte(SPIDEV, CSPIN, true, reg);
-    spi_transfer_byte(SPIDEV, CSPIN, true, offset);
-    spi_transfer_bytes(SPIDEV, CSPIN, false, data, NULL, len);
+    spi_transfer_chain(SPIDEV, CSPIN, false, xfer, NULL, NULL);
+    spi_release(SPIDEV);
+}
+
+void at86rf2xx_sram_writev(const at86rf2xx_t *dev, uint8_t offset,
+                           const iolist_t *iolist)
+{
+    uint8_t hdr[] = { AT86RF2XX_ACCESS_SRAM | AT86RF2XX_ACCESS_WRITE, offset };
+    spi_xfer_t xfer[AT86RF2XX_SPI_CHAIN_LEN];
+    unsigned n = 1;
+
+    xfer[0].next = NULL;
+    xfer[0].out = hdr;
+    xfer[0].in = NULL;
+    xfer[0].len = sizeof(hdr);
+
+    getbus(dev);
+    for (const iolist_t *iol = iolist; iol; iol = iol->iol_next) {
+        if (iol->iol_len == 0) {
+            continue;
+        }
+        if (n == AT86RF2XX_SPI_CHAIN_LEN) {
+            /* out of descriptors: transfer what we have, but keep the device
+             * selected for the rest of the frame */
+            spi_transfer_chain(SPIDEV, CSPIN, true, xfer, NULL, NULL);
+            n = 0;
+        }
+        xfer[n].next = NULL;
+        xfer[n].out = iol->iol_base;
+        xfer[n].in = NULL;
+        xfer[n].len = iol->iol_len;
+        if (n > 0) {
+            xfer[n - 1].next = &xfer[n];
+        }
+        n++;
+    }
+    spi_transfer_chain(SPIDEV, CSPIN, false, xfer, NULL, NULL);
     spi_release(SPIDEV);
 }
 
@@ -94,6 +134,11 @@ void at86rf2xx_fb_read(const at86rf2xx_t *dev,
     spi_transfer_bytes(SPIDEV, CSPIN, true, NULL, data, len);
 }
 
+void at86rf2xx_fb_read_chain(const at86rf2xx_t *dev, const spi_xfer_t *xfer)
+{
+    spi_transfer_chain(SPIDEV, CSPIN, true, xfer, NULL, NULL);
+}
+
 void at86rf2xx_fb_stop(const at86rf2xx_t *dev)
 {
     /* transfer one byte (which we ignore) to release the chip select */
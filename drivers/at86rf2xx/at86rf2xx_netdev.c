@@ -100,21 +100,21 @@ static int _send(netdev_t *netdev, const iolist_t *iolist)
     at86rf2xx_t *dev = (at86rf2xx_t *)netdev;
     size_t len = 0;
 
+    len = iolist_size(iolist);
+    /* current packet data + FCS too long */
+    if ((len + 2) > AT86RF2XX_MAX_PKT_LENGTH) {
+        DEBUG("[at86rf2xx] error: packet too large (%u byte) to be send\n",
+              (unsigned)len + 2);
+        return -EOVERFLOW;
+    }
+
     at86rf2xx_tx_prepare(dev);
 
     /* load packet data into FIFO */
-    for (const iolist_t *iol = iolist; iol; iol = iol->iol_next) {
-        /* current packet data + FCS too long */
-        if ((len + iol->iol_len + 2) > AT86RF2XX_MAX_PKT_LENGTH) {
-            DEBUG("[at86rf2xx] error: packet too large (%u byte) to be send\n",
-                  (unsigned)len + 2);
-            return -EOVERFLOW;
-        }
 #ifdef MODULE_NETSTATS_L2
-        netdev->stats.tx_bytes += len;
+    netdev->stats.tx_bytes += len;
 #endif
-        len = at86rf2xx_tx_load(dev, iol->iol_base, iol->iol_len, len);
-    }
+    len = at86rf2xx_tx_load_iolist(dev, iolist, 0);
 
     /* send data out directly if pre-loading id disabled */
     if (!(dev->flags & AT86RF2XX_OPT_PRELOADING)) {
@@ -171,14 +171,28 @@ static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
     netdev->stats.rx_count++;
     netdev->stats.rx_bytes += pkt_len;
 #endif
-    /* copy payload */
-    at86rf2xx_fb_read(dev, (uint8_t *)buf, pkt_len);
-
-    /* Ignore FCS but advance fb read - we must give a temporary buffer here,
-     * as we are not allowed to issue SPI transfers without any buffer */
+    /* Copy payload, FCS and the LQI and ED values appended by the device in
+     * one chained transfer. The FCS is ignored, but we must give a temporary
+     * buffer, as we are not allowed to issue SPI transfers without any buffer */
     uint8_t tmp[2];
-    at86rf2xx_fb_read(dev, tmp, 2);
-    (void)tmp;
+    uint8_t ed = 0;
+    netdev_ieee802154_rx_info_t *radio_info = info;
+    spi_xfer_t xfer[] = {
+        { .next = &xfer[1], .in = buf, .len = pkt_len },
+        { .next = NULL, .in = tmp, .len = sizeof(tmp) },
+        { .next = NULL, .len = 1 },
+        { .next = NULL, .in = &ed, .len = 1 },
+    };
+
+    if (radio_info != NULL) {
+        xfer[1].next = &xfer[2];
+        xfer[2].in = &(radio_info->lqi);
+#if !defined(MODULE_AT86RF231)
+        xfer[2].next = &xfer[3];
+#endif
+    }
+    at86rf2xx_fb_read_chain(dev, xfer);
+    at86rf2xx_fb_stop(dev);
 
     /* AT86RF212B RSSI_BASE_VAL + 1.03 * ED, base varies for diff. modulation and datarates
      * AT86RF232  RSSI_BASE_VAL + ED, base -91dBm
@@ -195,27 +209,16 @@ static int _recv(netdev_t *netdev, void *buf, size_t len, void *info)
      * value is specified as +/- 5 dB, so it should not matter very much in real
      * life.
      */
-    if (info != NULL) {
-        uint8_t ed = 0;
-        netdev_ieee802154_rx_info_t *radio_info = info;
-        at86rf2xx_fb_read(dev, &(radio_info->lqi), 1);
-
+    if (radio_info != NULL) {
 #if defined(MODULE_AT86RF231)
         /* AT86RF231 does not provide ED at the end of the frame buffer, read
          * from separate register instead */
-        at86rf2xx_fb_stop(dev);
         ed = at86rf2xx_reg_read(dev, AT86RF2XX_REG__PHY_ED_LEVEL);
-#else
-        at86rf2xx_fb_read(dev, &ed, 1);
-        at86rf2xx_fb_stop(dev);
 #endif
         radio_info->rssi = RSSI_BASE_VAL + ed;
         DEBUG("[at86rf2xx] LQI:%d high is good, RSSI:%d high is either good or"
               "too much interference.\n", radio_info->lqi, radio_info->rssi);
     }
-    else {
-        at86rf2xx_fb_stop(dev);
-    }
 
     /* set device back in operation state which was used before last transmission.
      * This state is saved in at86rf2xx.c/at86rf2xx_tx_prepare() e.g RX_AACK_ON */
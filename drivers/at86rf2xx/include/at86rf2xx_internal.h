@@ -73,6 +73,16 @@ extern "C" {
  */
 #define AT86RF2XX_RESET_DELAY           (62U)
 
+/**
+ * @brief   Number of SPI transfer descriptors used to write a frame
+ *
+ * A frame given as I/O vector with more parts is written in several chained
+ * transfers, but still within a single SPI transaction.
+ */
+#ifndef AT86RF2XX_SPI_CHAIN_LEN
+#define AT86RF2XX_SPI_CHAIN_LEN         (4U)
+#endif
+
 /**
  * @brief   Read from a register at address `addr` from device `dev`.
  *
@@ -114,6 +124,18 @@ void at86rf2xx_sram_read(const at86rf2xx_t *dev, uint8_t offset,
 void at86rf2xx_sram_write(const at86rf2xx_t *dev, uint8_t offset,
                           const uint8_t *data, size_t len);
 
+/**
+ * @brief   Write an I/O vector into the SRAM of the given device
+ *
+ * All parts of @p iolist are written in a single SPI transaction.
+ *
+ * @param[in] dev       device to write to
+ * @param[in] offset    address in the SRAM to write to [valid 0x00-0x7f]
+ * @param[in] iolist    data to copy into SRAM
+ */
+void at86rf2xx_sram_writev(const at86rf2xx_t *dev, uint8_t offset,
+                           const iolist_t *iolist);
+
 /**
  * @brief   Start a read transcation internal frame buffer of the given device
  *
@@ -135,6 +157,18 @@ void at86rf2xx_fb_start(const at86rf2xx_t *dev);
  */
 void at86rf2xx_fb_read(const at86rf2xx_t *dev, uint8_t *data, size_t len);
 
+/**
+ * @brief   Read a chain of buffers from the internal frame buffer of the given
+ *          device
+ *
+ * Same as calling at86rf2xx_fb_read() for each descriptor of @p xfer, but with
+ * a single SPI transfer call.
+ *
+ * @param[in]  dev      device to read from
+ * @param[in]  xfer     descriptors of the buffers to read into
+ */
+void at86rf2xx_fb_read_chain(const at86rf2xx_t *dev, const spi_xfer_t *xfer);
+
 /**
  * @brief   Stop a read transcation internal frame buffer of the given device
  *
@@ -509,6 +509,21 @@ void at86rf2xx_tx_prepare(at86rf2xx_t *dev);
 size_t at86rf2xx_tx_load(at86rf2xx_t *dev, const uint8_t *data,
                          size_t len, size_t offset);
 
+/**
+ * @brief   Load an I/O vector into the transmit buffer of the given device
+ *
+ * Unlike calling at86rf2xx_tx_load() for each part of @p iolist, all parts
+ * are written in a single SPI transaction.
+ *
+ * @param[in,out] dev       device to write data to
+ * @param[in] iolist        data to load
+ * @param[in] offset        offset used when writing data to internal buffer
+ *
+ * @return                  offset + number of bytes written
+ */
+size_t at86rf2xx_tx_load_iolist(at86rf2xx_t *dev, const iolist_t *iolist,
+                                size_t offset);
+
 /**
  * @brief   Trigger sending of data previously loaded into transmit buffer
  *
@@ -166,6 +166,27 @@ typedef enum {
 } spi_clk_t;
 #endif
 
+/**
+ * @brief   Descriptor of one part of a chained SPI transfer
+ *
+ * The descriptors only point to the buffers of the caller, no data is copied.
+ * Both buffers must stay valid until the transfer of the chain is complete.
+ */
+typedef struct spi_xfer {
+    struct spi_xfer *next;  /**< next descriptor, NULL for the last one */
+    const void *out;        /**< buffer to send data from, NULL if only
+                                 receiving */
+    void *in;               /**< buffer to read into, NULL if only sending */
+    size_t len;             /**< number of bytes to transfer */
+} spi_xfer_t;
+
+/**
+ * @brief   Signature of the callback called when a chained transfer is done
+ *
+ * @param[in] arg       argument given to spi_transfer_chain()
+ */
+typedef void (*spi_xfer_cb_t)(void *arg);
+
 /**
  * @brief   Basic initialization of the given SPI bus
  *
@@ -318,6 +339,33 @@ uint8_t spi_transfer_reg(spi_t bus, spi_cs_t cs, uint8_t reg, uint8_t out);
 void spi_transfer_regs(spi_t bus, spi_cs_t cs, uint8_t reg,
                        const void *out, void *in, size_t len);
 
+/**
+ * @brief   Transfer a chain of buffers as one transaction on the given SPI bus
+ *
+ * The chip select line stays asserted between the descriptors of @p xfer, so
+ * e.g. a command header and the payload of a frame can be transferred from
+ * separate buffers without copying them together first. The bus must be
+ * acquired as for the other transfer functions.
+ *
+ * The default implementation transfers the descriptors one after the other and
+ * calls @p cb before it returns. Platforms can provide their own implementation
+ * (e.g. using DMA) by defining `PERIPH_SPI_PROVIDES_TRANSFER_CHAIN`. If @p cb
+ * is given, such an implementation may return before the transfer is done and
+ * call @p cb from interrupt context when it is; the bus must then not be
+ * released before @p cb was called. If @p cb is NULL, the function blocks
+ * until the transfer is done.
+ *
+ * @param[in]  bus      SPI device to use
+ * @param[in]  cs       chip select pin/line to use, set to SPI_CS_UNDEF if chip
+ *                      select should not be handled by the SPI driver
+ * @param[in]  cont     if true, keep device selected after the last descriptor
+ * @param[in]  xfer     first descriptor of the chain
+ * @param[in]  cb       callback called when the transfer is done, may be NULL
+ * @param[in]  arg      argument passed to @p cb
+ */
+void spi_transfer_chain(spi_t bus, spi_cs_t cs, bool cont,
+                        const spi_xfer_t *xfer, spi_xfer_cb_t cb, void *arg);
+
 #ifdef __cplusplus
 }
 #endif
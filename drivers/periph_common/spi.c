@@ -70,4 +70,19 @@ void spi_transfer_regs(spi_t bus, spi_cs_t cs,
 }
 #endif
 
+#ifndef PERIPH_SPI_PROVIDES_TRANSFER_CHAIN
+void spi_transfer_chain(spi_t bus, spi_cs_t cs, bool cont,
+                        const spi_xfer_t *xfer, spi_xfer_cb_t cb, void *arg)
+{
+    while (xfer != NULL) {
+        spi_transfer_bytes(bus, cs, (xfer->next != NULL) || cont,
+                           xfer->out, xfer->in, xfer->len);
+        xfer = xfer->next;
+    }
+    if (cb != NULL) {
+        cb(arg);
+    }
+}
+#endif
+
 #endif /* SPI_NUMOF */
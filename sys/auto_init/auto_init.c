@@ -48,6 +48,10 @@
 #include "net/gnrc/pktdump.h"
 #endif
 
+#ifdef MODULE_GNRC_PCAPNG
+#include "net/gnrc/pcapng.h"
+#endif
+
 #ifdef MODULE_GNRC_UDP
 #include "net/gnrc/udp.h"
 #endif
@@ -68,10 +72,18 @@
 #include "net/fib.h"
 #endif
 
+#ifdef MODULE_GNRC_UDP_MUX
+#include "net/gnrc/udp_mux.h"
+#endif
+
 #ifdef MODULE_GCOAP
 #include "net/gcoap.h"
 #endif
 
+#ifdef MODULE_SOCK_DNS_RESOLVER
+#include "net/sock/dns.h"
+#endif
+
 #ifdef MODULE_GNRC_IPV6_NIB
 #include "net/gnrc/ipv6/nib.h"
 #endif
@@ -117,6 +129,10 @@ void auto_init(void)
     DEBUG("Auto init gnrc_pktdump module.\n");
     gnrc_pktdump_init();
 #endif
+#ifdef MODULE_GNRC_PCAPNG
+    DEBUG("Auto init gnrc_pcapng module.\n");
+    gnrc_pcapng_init();
+#endif
 #ifdef MODULE_GNRC_SIXLOWPAN
     DEBUG("Auto init gnrc_sixlowpan module.\n");
     gnrc_sixlowpan_init();
@@ -141,10 +157,18 @@ void auto_init(void)
     extern void openthread_bootstrap(void);
     openthread_bootstrap();
 #endif
+#ifdef MODULE_GNRC_UDP_MUX
+    DEBUG("Auto init UDP multiplexer.\n");
+    gnrc_udp_mux_init();
+#endif
 #ifdef MODULE_GCOAP
     DEBUG("Auto init gcoap module.\n");
     gcoap_init();
 #endif
+#ifdef MODULE_SOCK_DNS_RESOLVER
+    DEBUG("Auto init DNS resolver\n");
+    sock_dns_resolver_init();
+#endif
 #ifdef MODULE_DEVFS
     DEBUG("Mounting /dev\n");
     extern void auto_init_devfs(void);
@@ -163,6 +187,11 @@ void auto_init(void)
     extern void cord_common_init(void);
     cord_common_init();
 #endif
+#ifdef MODULE_CORD_RD
+    DEBUG("Auto init cord_rd module\n");
+    extern void cord_rd_init(void);
+    cord_rd_init();
+#endif
 #ifdef MODULE_CORD_EP_STANDALONE
     DEBUG("Auto init cord_ep_standalone\n");
     extern void cord_ep_standalone_run(void);
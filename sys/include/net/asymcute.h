@@ -23,16 +23,27 @@
  * - Connecting to multiple gateways simultaneously
  * - Registration of topic names
  * - Publishing of data (QoS 0 and QoS 1)
- * - Subscription to topics
+ * - Pipelined publishing with a window of QoS 1 messages in flight
+ * - Subscription to topics, also with wildcard characters
  * - Pre-defined topic IDs as well as short and normal topic names
  *
  * Missing features:
  * - Gateway discovery process not implemented
  * - Last will feature not implemented
  * - No support for QoS level 2
- * - No support for wildcard characters in topic names when subscribing
  * - Actual granted QoS level on subscription is ignored
  *
+ * # Pipelining
+ * A connection sends up to @ref ASYMCUTE_PUBLISH_WINDOW QoS 1 PUBLISH messages
+ * before it waits for the first PUBACK, so the uplink is not limited to one
+ * message per round trip. Further PUBLISH requests are queued in the
+ * connection and sent in order as PUBACKs arrive, so asymcute_publish() does
+ * not fail when the window is full. asymcute_register_batch() sends the
+ * REGISTER messages for several topics at once.
+ *
+ * All pending requests of a connection share a single retransmission timer,
+ * which is set for the earliest retransmission of any of them.
+ *
  * @{
  * @file
  * @brief       Asymcute MQTT-SN interface definition
@@ -51,6 +62,7 @@
 #include "event/timeout.h"
 #include "event/callback.h"
 #include "net/mqttsn.h"
+#include "net/mqttsn_topics.h"
 #include "net/sock/udp.h"
 #include "net/sock/util.h"
 
@@ -152,6 +164,16 @@ extern "C" {
 #define ASYMCUTE_N_RETRY            (3U)
 #endif
 
+#ifndef ASYMCUTE_PUBLISH_WINDOW
+/**
+ * @brief   Number of QoS 1 PUBLISH messages a connection keeps in flight
+ *
+ * Further PUBLISH requests wait in the connection until a PUBACK arrives. Set
+ * to 1 to wait for each PUBACK before sending the next message.
+ */
+#define ASYMCUTE_PUBLISH_WINDOW     (4U)
+#endif
+
 /**
  * @brief   Return values used by public Asymcute functions
  */
@@ -248,8 +270,7 @@ struct asymcute_req {
     asymcute_con_t *con;            /**< connection the request is using */
     asymcute_to_cb_t cb;            /**< internally used callback */
     void *arg;                      /**< internally used additional state */
-    event_callback_t to_evt;        /**< timeout event */
-    event_timeout_t to_timer;       /**< timeout timer */
+    uint32_t timeout;               /**< time of the next retransmission */
     uint8_t data[ASYMCUTE_BUFSIZE]; /**< buffer holding the request's data */
     size_t data_len;                /**< length of the request packet in byte */
     uint16_t msg_id;                /**< used message id for this request */
@@ -264,13 +285,22 @@ struct asymcute_con {
     sock_udp_t sock;                    /**< socket used by a connections */
     sock_udp_ep_t server_ep;            /**< the gateway's UDP endpoint */
     asymcute_req_t *pending;            /**< list holding pending requests */
+    asymcute_req_t *queue;              /**< PUBLISH requests waiting for the
+                                         *   window */
     asymcute_sub_t *subscriptions;      /**< list holding active subscriptions */
+    mqttsn_tid_map_t tids;              /**< topic IDs of the subscriptions */
+    mqttsn_trie_t filters;              /**< topic names of the subscriptions */
     asymcute_evt_cb_t user_cb;          /**< event callback provided by user */
     event_callback_t keepalive_evt;     /**< keep alive event */
     event_timeout_t keepalive_timer;    /**< keep alive timer */
+    event_callback_t retry_evt;         /**< retransmission event */
+    event_timeout_t retry_timer;        /**< retransmission timer, shared by
+                                         *   all pending requests */
     uint16_t last_id;                   /**< last used message ID for this
                                          *   connection */
     uint8_t keepalive_retry_cnt;        /**< keep alive transmission counter */
+    uint8_t inflight;                   /**< QoS 1 PUBLISH messages waiting
+                                         *   for a PUBACK */
     uint8_t state;                      /**< connection state */
     uint8_t rxbuf[ASYMCUTE_BUFSIZE];    /**< connection specific receive buf */
     char cli_id[ASYMCUTE_ID_MAXLEN + 1];/**< buffer to store client ID */
@@ -494,9 +524,32 @@ int asymcute_disconnect(asymcute_con_t *con, asymcute_req_t *req);
 int asymcute_register(asymcute_con_t *con, asymcute_req_t *req,
                       asymcute_topic_t *topic);
 
+/**
+ * @brief   Register several topics with the connected gateway at once
+ *
+ * Sends the REGISTER messages for all topics without waiting for the REGACKs
+ * in between. The event callback of the connection reports the result for
+ * each request.
+ *
+ * @param[in] con       connection to use
+ * @param[in,out] reqs  one request context for each topic
+ * @param[in,out] topics topics to register
+ * @param[in] numof     number of topics
+ *
+ * @return  ASYMCUTE_OK if all REGISTER messages have been sent
+ * @return  ASYMCUTE_REGERR if a topic is already registered
+ * @return  ASYMCUTE_GWERR if not connected to a gateway
+ * @return  ASYMCUTE_BUSY if one of the request contexts is already in use
+ */
+int asymcute_register_batch(asymcute_con_t *con, asymcute_req_t *reqs,
+                            asymcute_topic_t *topics, size_t numof);
+
 /**
  * @brief   Publish the given data to the given topic
  *
+ * With QoS 1, the message is queued if @ref ASYMCUTE_PUBLISH_WINDOW messages
+ * are already waiting for a PUBACK. It is sent as soon as the window allows.
+ *
  * @param[in] con       connection to use
  * @param[in,out] req   request context used for PUBLISH procedure
  * @param[in] topic     publish data to this topic
@@ -504,7 +557,7 @@ int asymcute_register(asymcute_con_t *con, asymcute_req_t *req,
  * @param[in] data_len  size of @p data in bytes
  * @param[in] flags     additional flags (QoS level, DUP, and RETAIN)
  *
- * @return  ASYMCUTE_OK if PUBLISH message has been sent
+ * @return  ASYMCUTE_OK if PUBLISH message has been sent or queued
  * @return  ASYMCUTE_NOTSUP if unsupported flags have been set
  * @return  ASYMCUTE_OVERFLOW if data does not fit into transmit buffer
  * @return  ASYMCUTE_REGERR if given topic is not registered
@@ -518,6 +571,11 @@ int asymcute_publish(asymcute_con_t *con, asymcute_req_t *req,
 /**
  * @brief   Subscribe to a given topic
  *
+ * The topic name may contain the wildcards `+` and `#`. The gateway registers
+ * each topic name matching it before publishing on it. On incoming data,
+ * @p topic->id is the topic ID of the message. If several subscriptions match
+ * a name, the most specific one receives it.
+ *
  * @param[in] con       connection to use
  * @param[in,out] req   request context used for SUBSCRIBE procedure
  * @param[out] sub      subscription context to store subscription state
@@ -528,6 +586,8 @@ int asymcute_publish(asymcute_con_t *con, asymcute_req_t *req,
  * @param[in] flags     additional flags (QoS level and DUP)
  *
  * @return  ASYMCUTE_OK if SUBSCRIBE message has been sent
+ * @return  ASYMCUTE_OVERFLOW if there is no space left for the topic name, see
+ *          @ref MQTTSN_TRIE_SIZE
  * @return  ASYMCUTE_NOTSUP if invalid or unsupported flags have been set
  * @return  ASYMCUTE_REGERR if topic is not initialized
  * @return  ASYMCUTE_GWERR if not connected to a gateway
@@ -22,6 +22,7 @@
 #define NET_CORD_COMMON_H
 
 #include "net/cord/config.h"
+#include "net/nanocoap.h"
 
 #ifdef __cplusplus
 extern "C" {
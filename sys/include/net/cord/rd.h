@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_cord_rd CoRE RD Server
+ * @ingroup     net_cord
+ * @brief       CoRE Resource Directory server with indexed lookups
+ *
+ * This module implements the registration and lookup interfaces of a CoRE
+ * Resource Directory as defined in draft-ietf-core-resource-directory-15 on
+ * top of gcoap, e.g. for gateways that keep the directory of the nodes in
+ * their network.
+ * @see https://tools.ietf.org/html/draft-ietf-core-resource-directory-15
+ *
+ * # Interfaces
+ * - `POST /rd?ep=..[&d=..][&lt=..]` with a link-format payload registers an
+ *   endpoint, the RD responds with the location of the registration, e.g.
+ *   `/rd/42`. A registration with the name and sector of an existing one
+ *   replaces it, and keeps its location.
+ * - `POST /rd/42[?lt=..]` updates a registration, a link-format payload
+ *   replaces its links.
+ * - `DELETE /rd/42` removes a registration.
+ * - `GET /rd-lookup/ep` and `GET /rd-lookup/res` look up registrations and
+ *   resources. They filter by the `ep`, `d`, `rt`, `if` and `href` query
+ *   parameters, a value ending in `*` matches as prefix. `page` and `count`
+ *   select a part of the result, which is transferred block-wise if it does
+ *   not fit into a PDU.
+ *
+ * The same operations are available as functions, e.g. for endpoints that
+ * register by other means than CoAP.
+ *
+ * # Design Decisions
+ * - all storage is static: @ref CORD_RD_EP_NUMOF registrations share
+ *   @ref CORD_RD_RES_NUMOF links
+ * - registrations are found by name with a hash table, links by the values
+ *   of their `rt` and `if` attributes with an inverted index. Other filters,
+ *   and prefix filters, scan all registrations.
+ * - of the target attributes of a link, only `rt`, `if`, `ct` and `obs` are
+ *   stored. The base URI of a registration is the source address of the
+ *   request, the `base` and `con` parameters are not supported.
+ * - expired registrations are dropped lazily: lookups skip them, and they
+ *   are reclaimed when no space is left for a registration
+ * - cord_ep discovers the first resource of the listeners as registration
+ *   interface, so auto_init registers the `/rd` resource right after gcoap
+ *   starts, before the listeners of the application
+ *
+ * @{
+ *
+ * @file
+ * @brief       CoRE Resource Directory server interface
+ */
+
+#ifndef NET_CORD_RD_H
+#define NET_CORD_RD_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "net/sock/udp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Maximum number of registrations
+ */
+#ifndef CORD_RD_EP_NUMOF
+#define CORD_RD_EP_NUMOF        (16U)
+#endif
+
+/**
+ * @brief   Maximum number of links of all registrations
+ */
+#ifndef CORD_RD_RES_NUMOF
+#define CORD_RD_RES_NUMOF       (64U)
+#endif
+
+/**
+ * @brief   Number of buckets of the hash table of endpoint names
+ *
+ * Must be a power of two.
+ */
+#ifndef CORD_RD_HASH_SIZE
+#define CORD_RD_HASH_SIZE       (16U)
+#endif
+
+/**
+ * @brief   Maximum number of distinct `rt` and `if` values of all links
+ */
+#ifndef CORD_RD_ATTR_NUMOF
+#define CORD_RD_ATTR_NUMOF      (32U)
+#endif
+
+/**
+ * @brief   Maximum number of `rt` and `if` values of a link
+ */
+#ifndef CORD_RD_RES_ATTRS
+#define CORD_RD_RES_ATTRS       (4U)
+#endif
+
+/**
+ * @brief   Maximum length of an endpoint name
+ */
+#ifndef CORD_RD_EP_LEN
+#define CORD_RD_EP_LEN          (32U)
+#endif
+
+/**
+ * @brief   Maximum length of a sector
+ */
+#ifndef CORD_RD_D_LEN
+#define CORD_RD_D_LEN           (16U)
+#endif
+
+/**
+ * @brief   Maximum length of the path of a link
+ */
+#ifndef CORD_RD_PATH_LEN
+#define CORD_RD_PATH_LEN        (32U)
+#endif
+
+/**
+ * @brief   Maximum length of an `rt` or `if` value
+ */
+#ifndef CORD_RD_ATTR_LEN
+#define CORD_RD_ATTR_LEN        (24U)
+#endif
+
+/**
+ * @brief   Lifetime of a registration without `lt` parameter, in seconds
+ */
+#ifndef CORD_RD_LT_DEFAULT
+#define CORD_RD_LT_DEFAULT      (90000UL)
+#endif
+
+/**
+ * @brief   Filter of a lookup
+ *
+ * Fields that are NULL or 0 do not filter. A string ending in `*` matches
+ * as prefix.
+ */
+typedef struct {
+    const char *ep;         /**< endpoint name */
+    const char *d;          /**< sector */
+    const char *rt;         /**< resource type of a link */
+    const char *iface;      /**< interface description (`if`) of a link */
+    const char *href;       /**< location of a registration for endpoint
+                                 lookups, path of a link for resource
+                                 lookups */
+    unsigned page;          /**< page of the result, in units of @p count */
+    unsigned count;         /**< maximum number of entries of the result */
+} cord_rd_filter_t;
+
+/**
+ * @brief   Registers the resources of the RD with gcoap
+ *
+ * Called once by auto_init.
+ */
+void cord_rd_init(void);
+
+/**
+ * @brief   Registers an endpoint
+ *
+ * Replaces the registration with the same @p ep and @p d, if there is one.
+ *
+ * @param[in] ep        name of the endpoint
+ * @param[in] d         sector of the endpoint, or NULL
+ * @param[in] lt        lifetime of the registration in seconds, 0 for
+ *                      @ref CORD_RD_LT_DEFAULT
+ * @param[in] base      address of the endpoint
+ * @param[in] links     links of the endpoint in link-format
+ * @param[in] len       length of @p links
+ *
+ * @return  ID of the registration, its location is `/rd/<ID>`
+ * @return  -EINVAL if @p ep is empty, or @p links is malformed
+ * @return  -ENOSPC if a name, path or attribute is too long, or a link has
+ *          too many attributes
+ * @return  -ENOMEM if no space is left for the registration
+ */
+int cord_rd_register(const char *ep, const char *d, uint32_t lt,
+                     const sock_udp_ep_t *base, const char *links,
+                     size_t len);
+
+/**
+ * @brief   Updates a registration
+ *
+ * Extends the lifetime, and replaces the links if @p links is not NULL. On
+ * error, the registration is unchanged.
+ *
+ * @param[in] id        ID of the registration
+ * @param[in] lt        new lifetime in seconds, 0 to keep the lifetime
+ * @param[in] links     new links in link-format, or NULL
+ * @param[in] len       length of @p links
+ *
+ * @return  0 on success
+ * @return  -ENOENT if there is no registration with @p id
+ * @return  other negative errno as cord_rd_register()
+ */
+int cord_rd_update(unsigned id, uint32_t lt, const char *links, size_t len);
+
+/**
+ * @brief   Removes a registration
+ *
+ * @param[in] id        ID of the registration
+ *
+ * @return  0 on success
+ * @return  -ENOENT if there is no registration with @p id
+ */
+int cord_rd_remove(unsigned id);
+
+/**
+ * @brief   Looks up registrations
+ *
+ * Writes the part of the result in link-format at @p offset, e.g.
+ * `</rd/42>;ep="node";base="coap://[2001:db8::1]:5683";lt=90000`.
+ * The resource filters select the registrations with a matching link.
+ *
+ * @param[in] filter    filter of the lookup
+ * @param[in] offset    offset in the result to write from
+ * @param[out] buf      buffer for the result
+ * @param[in] len       length of @p buf
+ *
+ * @return  number of bytes written, less than @p len only at the end of the
+ *          result
+ */
+ssize_t cord_rd_lookup_ep(const cord_rd_filter_t *filter, size_t offset,
+                          char *buf, size_t len);
+
+/**
+ * @brief   Looks up links
+ *
+ * Writes the part of the result in link-format at @p offset, with absolute
+ * targets, e.g. `<coap://[2001:db8::1]:5683/temp>;rt="temperature";
+ * anchor="coap://[2001:db8::1]:5683"`.
+ *
+ * @param[in] filter    filter of the lookup
+ * @param[in] offset    offset in the result to write from
+ * @param[out] buf      buffer for the result
+ * @param[in] len       length of @p buf
+ *
+ * @return  number of bytes written, less than @p len only at the end of the
+ *          result
+ */
+ssize_t cord_rd_lookup_res(const cord_rd_filter_t *filter, size_t offset,
+                           char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_CORD_RD_H */
+/** @} */
@@ -29,9 +29,8 @@
  * Further know restrictions are:
  * - ASCII topic names only (no support for UTF8 names, yet)
  * - topic length is restricted to fit in a single length byte (248 byte max)
- * - no support for wildcards in topic names. This feature requires more
- *   elaborate internal memory management, supposedly at the cost of quite
- *   increased ROM and RAM usage
+ * - the number of topic IDs and of topic filter levels of all subscriptions is
+ *   limited by @ref MQTTSN_TID_MAP_SIZE and @ref MQTTSN_TRIE_SIZE
  * - no retransmit when receiving a REJ_CONG (reject, reason congestion). when
  *   getting a REJ_CONG (reject, reason congestion), the spec tells us to resend
  *   the original message after T_WAIT (default: >5min). This is not supported,
@@ -222,7 +221,8 @@ typedef void(*emcute_cb_t)(const emcute_topic_t *topic, void *data, size_t len);
  * @brief   Data-structure for keeping track of topics we register to
  */
 typedef struct emcute_sub {
-    struct emcute_sub *next;    /**< next subscription (saved in a list) */
+    struct emcute_sub *next;    /**< unused, subscriptions are kept in
+                                 *   @ref net_mqttsn_topics */
     emcute_topic_t topic;       /**< topic we subscribe to */
     emcute_cb_t cb;             /**< function called when receiving messages */
     void *arg;                  /**< optional custom argument */
@@ -299,6 +299,11 @@ int emcute_pub(emcute_topic_t *topic, const void *buf, size_t len,
  * When calling this function, @p sub->topic.name and @p sub->cb **must** be
  * set.
  *
+ * The topic name may contain the wildcards `+` and `#`. The gateway registers
+ * each topic name matching it before publishing on it, and @p sub->cb is
+ * called with @p sub->topic.id set to the topic ID of the message. If several
+ * subscriptions match a name, the most specific one receives it.
+ *
  * @param[in,out] sub   subscription context, @p sub->topic.name and @p sub->cb
  *                      **must** not be NULL.
  * @param[in] flags     flags used when subscribing, allowed are QoS, DUP, and
@@ -307,7 +312,8 @@ int emcute_pub(emcute_topic_t *topic, const void *buf, size_t len,
  * @return  EMCUTE_OK on success
  * @return  EMCUTE_NOGW if not connected to a gateway
  * @return  EMCUTE_OVERFLOW if length of topic name exceeds
- *          @ref EMCUTE_TOPIC_MAXLEN
+ *          @ref EMCUTE_TOPIC_MAXLEN, if another subscription has the same
+ *          topic name or if there is no space left for the subscription
  * @return  EMCUTE_TIMEOUT on connection timeout
  */
 int emcute_sub(emcute_sub_t *sub, unsigned flags);
@@ -35,6 +35,7 @@
  * - Server Operation
  * - Client Operation
  * - Observe Server Operation
+ * - Block-wise Transfers
  * - Implementation Notes
  * - Implementation Status
  *
@@ -81,6 +82,59 @@
  * described above. In fact, the gcoap_response() function is inline, and uses
  * those two functions.
  *
+ * ### Creating a separate response ###
+ *
+ * gcoap handles one request at a time in its thread, so a callback that takes
+ * long, e.g. to read a slow sensor, delays all other requests. Instead, the
+ * callback may defer the response and complete it later from another thread:
+ *
+ * -# In the callback, call gcoap_resp_defer() and return its result. For a
+ *    confirmable request, gcoap acknowledges the request with an empty ACK.
+ *    If all @ref GCOAP_REQ_CTX_MAX request contexts are in use, the function
+ *    fails, and the callback may respond immediately instead, e.g. with
+ *    5.03 (Service Unavailable).
+ * -# Pass the request context to the thread completing the request.
+ * -# In that thread, call gcoap_resp_init_deferred() to initialize the
+ *    response, write the payload and call gcoap_finish() as above.
+ * -# Call gcoap_resp_send_deferred(), which sends the response and releases
+ *    the request context. The response to a confirmable request is
+ *    confirmable, and is resent until the client acknowledges it, if a resend
+ *    buffer is available (see @ref GCOAP_RESEND_BUFS_MAX).
+ *
+ * A request for an Observe registration must not be deferred.
+ *
+ * ### Caching responses ###
+ *
+ * With the `gcoap_resp_cache` module, gcoap keeps up to
+ * @ref GCOAP_RESP_CACHE_SIZE responses to GET requests and answers the same
+ * request from the cache without calling the resource callback again, until
+ * the response is no longer fresh. As in RFC 7252, section 5.6, requests are
+ * the same if they have the same method and options, except for the ETag
+ * option and options not part of the cache key, so e.g. the Uri-Path,
+ * Uri-Query and Accept options must match. Requests with Observe or with a
+ * payload are not answered from the cache.
+ *
+ * A resource opts in by adding a Max-Age option to a 2.05 (Content)
+ * response; the response is fresh for Max-Age seconds. As Max-Age follows
+ * Content-Format, the callback adds both options itself:
+ *
+ * @code
+ * gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+ * coap_opt_add_uint(pdu, COAP_OPT_CONTENT_FORMAT, COAP_FORMAT_TEXT);
+ * coap_opt_add_uint(pdu, COAP_OPT_MAX_AGE, 30);
+ * memcpy(pdu->payload, "data", 4);
+ * return gcoap_finish(pdu, 4, COAP_FORMAT_NONE);
+ * @endcode
+ *
+ * A response from the cache has the remaining time as Max-Age. If the
+ * response has an ETag option and the request includes the same ETag, gcoap
+ * answers with 2.03 (Valid) without payload instead.
+ *
+ * If the cache is full, the least recently used response is replaced. A
+ * successful request with another method than GET removes the responses for
+ * its path; an application changing a resource by other means calls
+ * gcoap_resp_cache_invalidate().
+ *
  * ## Client Operation ##
  *
  * Client operation includes two phases:  creating and sending a request, and
@@ -130,8 +184,9 @@
  *
  * A CoAP client may register for Observe notifications for any resource that
  * an application has registered with gcoap. An application does not need to
- * take any action to support Observe client registration. However, gcoap
- * limits registration for a given resource to a _single_ observer.
+ * take any action to support Observe client registration. A resource may have
+ * several observers, up to @ref GCOAP_OBS_REGISTRATIONS_MAX registrations from
+ * @ref GCOAP_OBS_CLIENTS_MAX clients in total.
  *
  * An Observe notification is considered a response to the original client
  * registration request. So, the Observe server only needs to create and send
@@ -153,6 +208,26 @@
  *
  * Finally, call gcoap_obs_send() for the resource.
  *
+ * gcoap_obs_init() and gcoap_obs_send() notify only the first observer of a
+ * resource. To notify all of them, use gcoap_obs_init_all() and
+ * gcoap_obs_send_all() in the same way. The notification is encoded only
+ * once; for each observer gcoap only rewrites the header with the token of
+ * the observer in front of the encoded options and payload.
+ *
+ * gcoap_obs_send_all() limits the rate of notifications for each client to
+ * one per @ref GCOAP_OBS_NOTIFY_INTERVAL_MS, as RFC 7641, section 4.5.1
+ * requires for non-confirmable notifications without an estimate of the
+ * round-trip time. A client notified too recently is skipped, and its
+ * registration is marked pending. When the interval has expired, gcoap sends
+ * the current state of the resource to the client. gcoap encodes this
+ * notification itself, with the GET handler of the resource as for the
+ * response to the registration, so the handler must not rely on options of
+ * the request other than Observe. If a notification can't be sent, for
+ * example because the packet buffer is full, the registration stays pending
+ * and the interval for the client doubles, up to
+ * @ref GCOAP_OBS_NOTIFY_BACKOFF_MAX times. Each notification sent halves it
+ * again.
+ *
  * ### Other considerations ###
  *
  * By default, the value for the Observe option in a notification is three
@@ -169,6 +244,28 @@
  * the Observe option value set to 1. The server does not support cancellation
  * via a reset (RST) response to a non-confirmable notification.
  *
+ * ## Block-wise Transfers ##
+ *
+ * gcoap transfers representations larger than a PDU in blocks (RFC 7959).
+ * The representation is never held in memory as a whole: a
+ * @ref gcoap_block_read_t callback provides the data at a given offset, a
+ * @ref gcoap_block_write_t callback stores a received block at its offset.
+ * gcoap_block_vfs_read() and gcoap_block_vfs_write() are such callbacks for
+ * a file descriptor of the @ref sys_vfs "VFS".
+ *
+ * As a server, a resource callback answers a GET request with
+ * gcoap_block2_resp(), which reads only the requested block, and accepts a
+ * PUT or POST request in blocks with gcoap_block1_resp().
+ *
+ * As a client, gcoap_block_xfer() downloads a representation with GET, or
+ * uploads one with PUT or POST. It blocks until the transfer is complete.
+ * The first block is sent alone to agree on the block size with the server,
+ * then up to `window` blocks are in flight at the same time (NSTART > 1),
+ * limited by @ref GCOAP_REQ_WAITING_MAX. A block without a response is
+ * requested again up to @ref GCOAP_BLOCK_RETRIES times. A transfer may be
+ * resumed at an offset, e.g. after an interruption. Only one transfer runs
+ * at a time.
+ *
  * ## Implementation Notes ##
  *
  * ### Building a packet ###
@@ -190,12 +287,22 @@
  * times out. We track the response with an entry in the
  * `_coap_state.open_reqs` array.
  *
+ * ### Sharing a thread with other protocols ###
+ *
+ * With the @ref net_gnrc_udp_mux module, gcoap does not run a thread and
+ * sock of its own. It registers its port with the multiplexer instead, and
+ * handles messages and response timeouts on the event queue of the
+ * multiplexer thread. Responses and empty messages are parsed where they are
+ * in the packet buffer; requests are copied to a buffer of
+ * `GCOAP_PDU_BUF_SIZE` bytes, as the response is written over the request.
+ *
  * ## Implementation Status ##
  * gcoap includes server and client capability. Available features include:
  *
  * - Message Type: Supports non-confirmable (NON) messaging. Additionally
- *   provides a callback on timeout. Provides piggybacked ACK response to a
- *   confirmable (CON) request.
+ *   provides a callback on timeout. Provides piggybacked ACK response and
+ *   separate response to a confirmable (CON) request. As a client, accepts
+ *   a separate response to a confirmable request.
  * - Observe extension: Provides server-side registration and notifications.
  * - Server and Client provide helper functions for writing the
  *   response/request. See the CoAP topic in the source documentation for
@@ -207,6 +314,10 @@
  *   in a user provided callback.
  * - Client generates token; length defined at compile time.
  * - Options: Supports Content-Format for payload.
+ * - Block-wise transfers: Provides Block2 and Block1 for a server, and
+ *   downloads and uploads with several blocks in flight for a client.
+ * - Server may answer requests from a cache of responses, with the
+ *   `gcoap_resp_cache` module.
  *
  * @{
  *
@@ -226,6 +337,9 @@
 #include "net/sock/udp.h"
 #include "net/nanocoap.h"
 #include "xtimer.h"
+#ifdef MODULE_GNRC_UDP_MUX
+#include "event.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -264,6 +378,47 @@ extern "C" {
 #ifndef GCOAP_REQ_WAITING_MAX
 #define GCOAP_REQ_WAITING_MAX   (2)
 #endif
+
+/**
+ * @brief   Maximum number of requests with a deferred response
+ *
+ * @see gcoap_resp_defer()
+ */
+#ifndef GCOAP_REQ_CTX_MAX
+#define GCOAP_REQ_CTX_MAX       (2)
+#endif
+
+/**
+ * @brief   Number of times a client requests a block again in a block-wise
+ *          transfer, if there is no response
+ */
+#ifndef GCOAP_BLOCK_RETRIES
+#define GCOAP_BLOCK_RETRIES     (4)
+#endif
+
+/**
+ * @brief   Number of responses in the response cache
+ *
+ * Only used with the `gcoap_resp_cache` module.
+ */
+#ifndef GCOAP_RESP_CACHE_SIZE
+#define GCOAP_RESP_CACHE_SIZE   (4)
+#endif
+
+/**
+ * @brief   Maximum length of a cached response, without header and token
+ */
+#ifndef GCOAP_RESP_CACHE_PDU_SIZE
+#define GCOAP_RESP_CACHE_PDU_SIZE   (64)
+#endif
+
+/**
+ * @brief   Maximum length of the cache key of a request, i.e. of its method
+ *          and options with 3 bytes overhead per option
+ */
+#ifndef GCOAP_RESP_CACHE_KEY_SIZE
+#define GCOAP_RESP_CACHE_KEY_SIZE   (32)
+#endif
 /** @} */
 
 /**
@@ -338,6 +493,12 @@ extern "C" {
  */
 #define GCOAP_MSG_TYPE_INTR     (0x1502)
 
+/**
+ * @brief   Identifies the end of the interval for a pending Observe
+ *          notification
+ */
+#define GCOAP_MSG_TYPE_OBS      (0x1503)
+
 /**
  * @ingroup net_gcoap_conf
  * @brief   Maximum number of Observe clients
@@ -354,6 +515,37 @@ extern "C" {
 #define GCOAP_OBS_REGISTRATIONS_MAX     (2)
 #endif
 
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Number of hash buckets to find Observe clients and registrations
+ *
+ * Must be a power of 2.
+ */
+#ifndef GCOAP_OBS_HASH_SIZE
+#define GCOAP_OBS_HASH_SIZE     (8)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Minimum interval in milliseconds between two notifications sent to
+ *          a client with gcoap_obs_send_all()
+ *
+ * The default follows RFC 7641, section 4.5.1 for a server without an
+ * estimate of the round-trip time to the client. 0 disables the limit.
+ */
+#ifndef GCOAP_OBS_NOTIFY_INTERVAL_MS
+#define GCOAP_OBS_NOTIFY_INTERVAL_MS    (3U * MS_PER_SEC)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Maximum number of times the interval between two notifications to
+ *          a client is doubled, after notifications to it couldn't be sent
+ */
+#ifndef GCOAP_OBS_NOTIFY_BACKOFF_MAX
+#define GCOAP_OBS_NOTIFY_BACKOFF_MAX    (3U)
+#endif
+
 /**
  * @name    States for the memo used to track Observe registrations
  * @{
@@ -409,6 +601,9 @@ extern "C" {
 
 /**
  * @brief Stack size for module thread
+ *
+ * Not used with the @ref net_gnrc_udp_mux module, see
+ * @ref GNRC_UDP_MUX_STACK_SIZE.
  */
 #ifndef GCOAP_STACK_SIZE
 #define GCOAP_STACK_SIZE (THREAD_STACKSIZE_DEFAULT + DEBUG_EXTRA_STACKSIZE \
@@ -467,6 +662,10 @@ typedef struct {
     gcoap_resp_handler_t resp_handler;  /**< Callback for the response */
     xtimer_t response_timer;            /**< Limits wait for response */
     msg_t timeout_msg;                  /**< For response timer */
+#if defined(MODULE_GNRC_UDP_MUX) || defined(DOXYGEN)
+    event_t timeout_event;              /**< For response timer, posted to
+                                             the multiplexer's event queue */
+#endif
 } gcoap_request_memo_t;
 
 /**
@@ -477,8 +676,23 @@ typedef struct {
     const coap_resource_t *resource;    /**< Entity being observed */
     uint8_t token[GCOAP_TOKENLEN_MAX];  /**< Client token for notifications */
     unsigned token_len;                 /**< Actual length of token attribute */
+    uint8_t next;                       /**< Next memo in the hash bucket of
+                                             the resource */
+    uint8_t state;                      /**< State of this memo, a
+                                             GCOAP_OBS_MEMO... */
 } gcoap_observe_memo_t;
 
+/**
+ * @brief   Context of a request with a deferred response
+ */
+typedef struct {
+    sock_udp_ep_t remote;               /**< Client endpoint */
+    uint8_t token[GCOAP_TOKENLEN_MAX];  /**< Token of the request */
+    uint8_t token_len;                  /**< Actual length of token attribute */
+    uint8_t type;                       /**< Message type of the request */
+    bool in_use;                        /**< Context is in use */
+} gcoap_req_ctx_t;
+
 /**
  * @brief   Initializes the gcoap thread and device
  *
@@ -622,6 +836,67 @@ static inline ssize_t gcoap_response(coap_pkt_t *pdu, uint8_t *buf,
                 : -1;
 }
 
+/**
+ * @brief   Defers the response to a request
+ *
+ * Must be called from a resource callback only. The callback returns the
+ * result of this function.
+ *
+ * @param[in] pdu       Request metadata
+ * @param[out] buf      Buffer containing the PDU
+ * @param[in] len       Length of the buffer
+ * @param[out] ctx      Context to complete the request with
+ *
+ * @return  size of the empty ACK within the buffer for a confirmable request
+ * @return  0 for a non-confirmable request
+ * @return  -ENOMEM, if all request contexts are in use
+ */
+ssize_t gcoap_resp_defer(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                         gcoap_req_ctx_t **ctx);
+
+/**
+ * @brief   Gets the sender of the request in handling
+ *
+ * Must be called from a resource callback only.
+ *
+ * @return  the remote endpoint of the request, valid until the callback
+ *          returns
+ */
+const sock_udp_ep_t *gcoap_req_remote(void);
+
+/**
+ * @brief   Initializes a deferred CoAP response packet on a buffer
+ *
+ * May be called from any thread.
+ *
+ * @param[in] ctx       Context of the request, from gcoap_resp_defer()
+ * @param[out] pdu      Response metadata
+ * @param[out] buf      Buffer containing the PDU
+ * @param[in] len       Length of the buffer
+ * @param[in] code      Response code
+ *
+ * @return  0 on success
+ * @return  < 0 on error
+ */
+int gcoap_resp_init_deferred(const gcoap_req_ctx_t *ctx, coap_pkt_t *pdu,
+                             uint8_t *buf, size_t len, unsigned code);
+
+/**
+ * @brief   Sends a deferred response and releases the request context
+ *
+ * May be called from any thread.
+ *
+ * @param[in] ctx       Context of the request, from gcoap_resp_defer()
+ * @param[in] buf       Buffer containing the PDU, @ref GCOAP_PDU_BUF_SIZE
+ *                      bytes long
+ * @param[in] len       Length of the PDU
+ *
+ * @return  length of the packet
+ * @return  0 if cannot send
+ */
+size_t gcoap_resp_send_deferred(gcoap_req_ctx_t *ctx, const uint8_t *buf,
+                                size_t len);
+
 /**
  * @brief   Initializes a CoAP Observe notification packet on a buffer, for the
  *          observer registered for a resource
@@ -656,6 +931,43 @@ int gcoap_obs_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
 size_t gcoap_obs_send(const uint8_t *buf, size_t len,
                       const coap_resource_t *resource);
 
+/**
+ * @brief   Initializes a CoAP Observe notification packet on a buffer, for
+ *          all observers registered for a resource
+ *
+ * The header is written with room for the longest token, so the buffer must
+ * be sent with gcoap_obs_send_all().
+ *
+ * @param[out] pdu      Notification metadata
+ * @param[out] buf      Buffer containing the PDU
+ * @param[in] len       Length of the buffer
+ * @param[in] resource  Resource for the notification
+ *
+ * @return  GCOAP_OBS_INIT_OK     on success
+ * @return  GCOAP_OBS_INIT_ERR    on error
+ * @return  GCOAP_OBS_INIT_UNUSED if no observer for resource
+ */
+int gcoap_obs_init_all(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                       const coap_resource_t *resource);
+
+/**
+ * @brief   Sends a notification initialized with gcoap_obs_init_all() to all
+ *          observers of a resource
+ *
+ * Rewrites the header in @p buf for each observer and restores it afterwards.
+ * Observers notified less than @ref GCOAP_OBS_NOTIFY_INTERVAL_MS ago are
+ * skipped; gcoap sends them the current state of the resource when the
+ * interval has expired.
+ *
+ * @param[in,out] buf   Buffer containing the PDU
+ * @param[in] len       Length of the PDU
+ * @param[in] resource  Resource to send
+ *
+ * @return  number of observers notified
+ */
+unsigned gcoap_obs_send_all(uint8_t *buf, size_t len,
+                            const coap_resource_t *resource);
+
 /**
  * @brief   Provides important operational statistics
  *
@@ -665,6 +977,158 @@ size_t gcoap_obs_send(const uint8_t *buf, size_t len,
  */
 uint8_t gcoap_op_state(void);
 
+/**
+ * @brief   Reads a part of a representation for a block-wise transfer
+ *
+ * @param[in] arg       argument given with the callback
+ * @param[in] offset    offset of the part in the representation
+ * @param[out] buf      buffer for the part
+ * @param[in] len       length of the part
+ *
+ * @return  number of bytes read, less than @p len only at the end of the
+ *          representation
+ * @return  negative errno on error
+ */
+typedef ssize_t (*gcoap_block_read_t)(void *arg, size_t offset, uint8_t *buf,
+                                      size_t len);
+
+/**
+ * @brief   Writes a block of a block-wise transfer
+ *
+ * Blocks may be written out of order, if several are in flight.
+ *
+ * @param[in] arg       argument given with the callback
+ * @param[in] offset    offset of the block in the representation
+ * @param[in] data      the block
+ * @param[in] len       length of the block
+ * @param[in] more      false for the last block
+ *
+ * @return  0 on success
+ * @return  negative errno on error, e.g. if the block does not fit
+ */
+typedef int (*gcoap_block_write_t)(void *arg, size_t offset,
+                                   const uint8_t *data, size_t len, bool more);
+
+/**
+ * @brief   A block-wise transfer of a client
+ */
+typedef struct {
+    sock_udp_ep_t remote;           /**< server */
+    const char *path;               /**< path of the resource */
+    unsigned method;                /**< COAP_METHOD_GET to download,
+                                         COAP_METHOD_PUT or COAP_METHOD_POST
+                                         to upload */
+    unsigned format;                /**< Content-Format of an upload, or
+                                         COAP_FORMAT_NONE */
+    size_t offset;                  /**< offset to start at, rounded down to a
+                                         block */
+    unsigned window;                /**< maximum number of blocks in flight */
+    gcoap_block_read_t read;        /**< source of an upload */
+    gcoap_block_write_t write;      /**< sink of a download */
+    void *arg;                      /**< argument for @p read or @p write */
+} gcoap_block_xfer_t;
+
+/**
+ * @brief   Responds to a GET request with a block of a representation
+ *
+ * To be called from a resource callback. Reads only the block requested with
+ * the Block2 option, or the first one.
+ *
+ * @param[in,out] pdu   request metadata, then response metadata
+ * @param[in,out] buf   buffer containing the request, then the response
+ * @param[in] len       length of @p buf
+ * @param[in] format    Content-Format of the representation, or
+ *                      COAP_FORMAT_NONE
+ * @param[in] read      source of the representation
+ * @param[in] arg       argument for @p read
+ *
+ * @return  length of the response
+ */
+ssize_t gcoap_block2_resp(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                          unsigned format, gcoap_block_read_t read, void *arg);
+
+/**
+ * @brief   Accepts a block of a PUT or POST request
+ *
+ * To be called from a resource callback. Writes the payload at the offset
+ * given by the Block1 option, or at offset 0 without it, and responds with
+ * 2.31 (Continue) if more blocks follow. If @p write fails, it responds with
+ * 4.08 (Request Entity Incomplete).
+ *
+ * @param[in,out] pdu   request metadata, then response metadata
+ * @param[in,out] buf   buffer containing the request, then the response
+ * @param[in] len       length of @p buf
+ * @param[in] code      response code after the last block, e.g.
+ *                      COAP_CODE_CHANGED
+ * @param[in] write     sink of the representation
+ * @param[in] arg       argument for @p write
+ *
+ * @return  length of the response
+ */
+ssize_t gcoap_block1_resp(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                          unsigned code, gcoap_block_write_t write, void *arg);
+
+/**
+ * @brief   Downloads or uploads a representation block-wise
+ *
+ * Blocks until the transfer is complete. Must not be called from a resource
+ * or response callback.
+ *
+ * @param[in] xfer      the transfer
+ *
+ * @return  number of bytes transferred
+ * @return  -EINVAL, if @p xfer is invalid
+ * @return  -ENOMEM, if no request could be sent
+ * @return  -ETIMEDOUT, if a block was not answered
+ * @return  -EIO, if the server answered with an error
+ * @return  other negative errno from the callbacks
+ */
+ssize_t gcoap_block_xfer(const gcoap_block_xfer_t *xfer);
+
+#if defined(MODULE_VFS) || defined(DOXYGEN)
+/**
+ * @brief   @ref gcoap_block_read_t for a file of the VFS
+ *
+ * @p arg is a pointer to the file descriptor, an `int`.
+ */
+ssize_t gcoap_block_vfs_read(void *arg, size_t offset, uint8_t *buf,
+                             size_t len);
+
+/**
+ * @brief   @ref gcoap_block_write_t for a file of the VFS
+ *
+ * @p arg is a pointer to the file descriptor, an `int`.
+ */
+int gcoap_block_vfs_write(void *arg, size_t offset, const uint8_t *data,
+                          size_t len, bool more);
+#endif
+
+#if defined(MODULE_GCOAP_RESP_CACHE) || defined(DOXYGEN)
+/**
+ * @brief   Statistics of the response cache
+ */
+typedef struct {
+    uint32_t hits;          /**< requests answered from the cache */
+    uint32_t validated;     /**< hits answered with 2.03 (Valid) */
+    uint32_t misses;        /**< cacheable requests passed to the resource */
+    uint32_t evictions;     /**< fresh responses replaced by another one */
+} gcoap_resp_cache_stats_t;
+
+/**
+ * @brief   Get the statistics of the response cache
+ *
+ * @param[out] stats    the statistics
+ */
+void gcoap_resp_cache_get_stats(gcoap_resp_cache_stats_t *stats);
+
+/**
+ * @brief   Remove cached responses for a path
+ *
+ * @param[in] path      path of the resource, NULL to remove all responses
+ */
+void gcoap_resp_cache_invalidate(const char *path);
+#endif
+
 /**
  * @brief   Get the resource list, currently only `CoRE Link Format`
  *          (COAP_FORMAT_LINK) supported
@@ -123,6 +123,25 @@ extern "C" {
 #define GNRC_GOMACH_CP_DURATION_MAX_US        (5LU * GNRC_GOMACH_CP_DURATION_US)
 #endif
 
+/**
+ * @brief The maximum duration GoMacH's adaptive wake-up period (WP) starts
+ *        with.
+ *
+ * The superframe duration is shared by all nodes, as they track each other's
+ * phase, so GoMacH adapts the length of its WP to the traffic instead:
+ * A node starts its WP with a listen window between
+ * @ref GNRC_GOMACH_CP_DURATION_US and @ref GNRC_GOMACH_CP_DURATION_ADAPT_MAX_US.
+ * The window is doubled after a cycle in which the node received packets in
+ * its WP and shrinks by half a @ref GNRC_GOMACH_CP_DURATION_US in each idle
+ * cycle. Thus, senders of bursty traffic find the receiver awake, while idle
+ * nodes fall back to the minimum duty-cycle.
+ * Note that, this value should not be longer than
+ * @ref GNRC_GOMACH_CP_DURATION_MAX_US.
+ */
+#ifndef GNRC_GOMACH_CP_DURATION_ADAPT_MAX_US
+#define GNRC_GOMACH_CP_DURATION_ADAPT_MAX_US  (3LU * GNRC_GOMACH_CP_DURATION_US)
+#endif
+
 /**
  * @brief The maximum time for waiting the receiver's beacon in GoMacH.
  *
@@ -71,6 +71,16 @@ extern "C" {
  */
 #define GNRC_GOMACH_SLOSCH_UNIT_COUNT           (11U)
 
+/**
+ * @brief Weight of the newest queue-length indicator in the traffic history
+ *        of a sender, i.e., the history moves by 1/GNRC_GOMACH_SLOSCH_HISTORY_WEIGHT
+ *        towards the newest indicator in each cycle.
+ *
+ * The history @ref gnrc_gomach_slosch_unit_t::history is kept in units of
+ * 1/GNRC_GOMACH_SLOSCH_HISTORY_WEIGHT slots.
+ */
+#define GNRC_GOMACH_SLOSCH_HISTORY_WEIGHT       (4U)
+
 /**
  * @brief MAC type of unknown in GoMacH for indicating that
  *        the node's phase is unknown.
@@ -206,6 +216,9 @@ typedef struct {
 typedef struct {
     gnrc_gomach_l2_addr_t node_addr;    /**< Node's address. */
     uint8_t queue_indicator;            /**< Node's queue-length indicator. */
+    uint8_t history;                    /**< Moving average of the node's
+                                             queue-length indicator over the
+                                             past cycles. */
 } gnrc_gomach_slosch_unit_t;
 
 /**
@@ -284,6 +297,10 @@ typedef struct gomach {
     uint16_t pub_channel_2;                                     /**< Public channel 2. */
     uint16_t cur_pub_channel;                                   /**< Current public channel. */
     uint8_t cp_extend_count;                                    /**< CP extend count. */
+    uint8_t cp_rx_count;                                        /**< Packets received
+                                                                     in the current CP. */
+    uint32_t cp_duration_us;                                    /**< Current (adaptive)
+                                                                     CP duration. */
     uint32_t last_wakeup;                                       /**< Last wake-up timing. */
     uint32_t backoff_phase_us;                                  /**< Phase backoff time. */
     uint16_t gomach_info;                                       /**< GoMacH's internal
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_ipv6_flowcache IPv6 flow cache
+ * @ingroup     net_gnrc_ipv6
+ * @brief       Fast-forwarding of established flows on IPv6 routers
+ *
+ * When a router forwards a packet, the outgoing interface and the interface
+ * header to the next hop are stored in the flow cache, keyed by the flow's
+ * 5-tuple (source and destination address, upper layer protocol and the UDP
+ * or TCP ports). Subsequent packets of the same flow are sent directly to the
+ * outgoing interface without extension header processing, next-hop
+ * determination, or building a new interface header.
+ *
+ * All entries are invalidated on changes to the neighbor cache or the
+ * forwarding table and when an address is added to an interface.
+ *
+ * @{
+ *
+ * @file
+ * @brief   IPv6 flow cache definitions
+ */
+#ifndef NET_GNRC_IPV6_FLOWCACHE_H
+#define NET_GNRC_IPV6_FLOWCACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kernel_types.h"
+#include "net/gnrc/ipv6/nib/conf.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/ipv6/hdr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup    net_gnrc_ipv6_flowcache_conf GNRC IPv6 flow cache compile configurations
+ * @ingroup     net_gnrc_ipv6_flowcache
+ * @ingroup     config
+ * @{
+ */
+/**
+ * @brief   Number of entries in the flow cache
+ *
+ * @note    Must be a power of 2
+ */
+#ifndef GNRC_IPV6_FLOWCACHE_SIZE
+#define GNRC_IPV6_FLOWCACHE_SIZE    (8)
+#endif
+/** @} */
+
+/**
+ * @brief   Maximum length of a stored interface header
+ */
+#define GNRC_IPV6_FLOWCACHE_NETIF_HDR_LEN   (sizeof(gnrc_netif_hdr_t) + \
+                                             GNRC_IPV6_NIB_L2ADDR_MAX_LEN)
+
+/**
+ * @brief   Identifies a flow
+ */
+typedef struct {
+    ipv6_addr_t src;        /**< source address */
+    ipv6_addr_t dst;        /**< destination address */
+    uint16_t sport;         /**< source port (UDP and TCP only) */
+    uint16_t dport;         /**< destination port (UDP and TCP only) */
+    uint8_t nh;             /**< upper layer protocol */
+    /**
+     * @brief   Generation of the cache when the key was created
+     *
+     * An entry added with this key is discarded if the cache was invalidated
+     * in the meantime.
+     */
+    uint32_t gen;
+} gnrc_ipv6_flowcache_key_t;
+
+/**
+ * @brief   A flow cache entry
+ */
+typedef struct {
+    gnrc_ipv6_flowcache_key_t key;  /**< key of the flow */
+    kernel_pid_t iface;             /**< outgoing interface */
+    uint8_t netif_hdr_len;          /**< length of gnrc_ipv6_flowcache_entry_t::netif_hdr */
+    /**
+     * @brief   Interface header to the next hop
+     */
+    uint8_t netif_hdr[GNRC_IPV6_FLOWCACHE_NETIF_HDR_LEN];
+} gnrc_ipv6_flowcache_entry_t;
+
+/**
+ * @brief   Initializes the key of the flow of a packet
+ *
+ * @param[out] key          The key.
+ * @param[in] hdr           IPv6 header of the packet.
+ * @param[in] payload       The payload following @p hdr.
+ * @param[in] payload_len   Length of @p payload.
+ */
+void gnrc_ipv6_flowcache_key(gnrc_ipv6_flowcache_key_t *key,
+                             const ipv6_hdr_t *hdr, const void *payload,
+                             size_t payload_len);
+
+/**
+ * @brief   Looks up a flow
+ *
+ * @param[in] key   Key of the flow.
+ *
+ * @return  The cache entry of the flow.
+ * @return  NULL, if the flow is not in the cache.
+ */
+const gnrc_ipv6_flowcache_entry_t *gnrc_ipv6_flowcache_get(const gnrc_ipv6_flowcache_key_t *key);
+
+/**
+ * @brief   Adds a flow to the cache
+ *
+ * Replaces the entry previously stored in the slot of the flow.
+ *
+ * @param[in] key       Key of the flow.
+ * @param[in] iface     Outgoing interface of the flow.
+ * @param[in] netif_hdr Interface header to the next hop.
+ * @param[in] len       Length of @p netif_hdr.
+ */
+void gnrc_ipv6_flowcache_add(const gnrc_ipv6_flowcache_key_t *key,
+                             kernel_pid_t iface,
+                             const gnrc_netif_hdr_t *netif_hdr, size_t len);
+
+#if defined(MODULE_GNRC_IPV6_FLOWCACHE) || defined(DOXYGEN)
+/**
+ * @brief   Invalidates all entries of the flow cache
+ *
+ * Must be called whenever the next hop or the link-layer address to a
+ * destination might have changed.
+ *
+ * @note    Can be called from any thread.
+ */
+void gnrc_ipv6_flowcache_invalidate(void);
+#else
+static inline void gnrc_ipv6_flowcache_invalidate(void)
+{
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_IPV6_FLOWCACHE_H */
+/** @} */
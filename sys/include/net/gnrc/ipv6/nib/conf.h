@@ -226,6 +226,20 @@ extern "C" {
 #define GNRC_IPV6_NIB_CONF_NO_RTR_SOL       (0)
 #endif
 
+/**
+ * @brief   Maximum ETX of the link to a default router
+ *
+ * Default routers with a higher ETX in their @ref net_netstats_neighbor
+ * entry are treated like unreachable ones when the primary default router is
+ * selected. The ETX is multiplied by @ref NETSTATS_NB_ETX_DIVISOR.
+ *
+ * @note    Only used with module `netstats_neighbor` and
+ *          @ref GNRC_IPV6_NIB_CONF_ARSM != 0.
+ */
+#ifndef GNRC_IPV6_NIB_CONF_MAX_DR_ETX
+#define GNRC_IPV6_NIB_CONF_MAX_DR_ETX       (4 * 128U)
+#endif
+
 /**
  * @brief   Maximum link-layer address length (aligned)
  */
@@ -256,11 +256,34 @@ extern "C" {
  * following pending packets.
  * In short, in burst transmission mode, the sender doesn't tolerate no-WA event. ALl the
  * pending data packets should be sent with only one WR cost for leading the transmission.
+ *
+ * With @ref GNRC_LWMAC_ENABLE_PACKET_TRAIN, step (2) is skipped: the following data
+ * packets are sent right after the acknowledgement of the previous one, so the whole
+ * burst only costs the WR/WA handshake of the first data packet.
  */
 #ifndef GNRC_LWMAC_MAX_TX_BURST_PKT_NUM
 #define GNRC_LWMAC_MAX_TX_BURST_PKT_NUM      (GNRC_LWMAC_WAKEUP_INTERVAL_US / GNRC_LWMAC_WAKEUP_DURATION_US)
 #endif
 
+/**
+ * @brief Enable packet trains for burst transmissions.
+ *
+ * If enabled, a sender with pending packets for the same receiver transmits them as a
+ * train after a single WR/WA handshake: each data packet announces the next one with
+ * the pending-bit (FRAMETYPE_DATA_PENDING) and the receiver keeps waiting for data for
+ * @ref GNRC_LWMAC_DATA_DELAY_US after each of them, instead of going back to listening
+ * for the next WR. The train ends with the first data packet without pending-bit, a
+ * missing acknowledgement or after @ref GNRC_LWMAC_MAX_TX_BURST_PKT_NUM packets. A
+ * packet of the train that is not acknowledged is queued again and sent with a WR
+ * stream in a following cycle.
+ *
+ * This saves the WR stream and the WA of each following packet, i.e., radio-on time of
+ * both nodes and latency of the burst. All nodes of a network must use the same setting.
+ */
+#ifndef GNRC_LWMAC_ENABLE_PACKET_TRAIN
+#define GNRC_LWMAC_ENABLE_PACKET_TRAIN       (1U)
+#endif
+
 /**
  * @brief MAX bad Listen period extensions a node can tolerate.
  *
@@ -44,6 +44,12 @@
 #ifdef MODULE_GNRC_MAC
 #include "net/gnrc/netif/mac.h"
 #endif
+#ifdef MODULE_GNRC_NETIF_TXQ
+#include "net/gnrc/netif/txq.h"
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+#include "net/netstats/neighbor.h"
+#endif
 #include "net/ndp.h"
 #include "net/netdev.h"
 #include "rmutex.h"
@@ -94,6 +100,33 @@ typedef struct {
 #endif
 #if defined(MODULE_GNRC_SIXLOWPAN) || DOXYGEN
     gnrc_netif_6lo_t sixlo;                 /**< 6Lo component */
+#endif
+#if defined(MODULE_GNRC_NETIF_TXQ) || DOXYGEN
+    gnrc_netif_txq_t txq;                   /**< @ref net_gnrc_netif_txq component */
+#endif
+#if defined(MODULE_NETSTATS_NEIGHBOR) || DOXYGEN
+    /**
+     * @brief   Link statistics of the neighbors
+     *
+     * @note    Only available with module
+     *          @ref net_netstats_neighbor "netstats_neighbor".
+     */
+    netstats_nb_t nb_stats[NETSTATS_NB_SIZE];
+    /**
+     * @brief   Destination of the unicast frame in transmission
+     *
+     * @note    Only available with module
+     *          @ref net_netstats_neighbor "netstats_neighbor".
+     */
+    uint8_t nb_tx_addr[NETSTATS_NB_L2ADDR_MAXLEN];
+    /**
+     * @brief   Length of gnrc_netif_t::nb_tx_addr, 0 if no unicast frame is
+     *          in transmission
+     *
+     * @note    Only available with module
+     *          @ref net_netstats_neighbor "netstats_neighbor".
+     */
+    uint8_t nb_tx_addr_len;
 #endif
     uint8_t cur_hl;                         /**< Current hop-limit for out-going packets */
     uint8_t device_type;                    /**< Device type */
@@ -94,6 +94,17 @@ extern "C" {
                                         GNRC_NETIF_IPV6_RTR_ADDR + 1)
 #endif
 
+/**
+ * @brief   Number of destinations per interface for which the selected source
+ *          address is cached
+ *
+ * Source address selection (RFC 6724) is only run for destinations not
+ * found in the cache. Set to 0 to disable the cache.
+ */
+#ifndef GNRC_NETIF_IPV6_SRC_CACHE_SIZE
+#define GNRC_NETIF_IPV6_SRC_CACHE_SIZE (4)
+#endif
+
 /**
  * @brief   Maximum length of the link-layer address.
  *
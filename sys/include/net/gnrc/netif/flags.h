@@ -122,6 +122,13 @@ enum {
  * @brief   Network interface is configured in raw mode
  */
 #define GNRC_NETIF_FLAGS_RAWMODE                   (0x00010000U)
+
+/**
+ * @brief   Device calculates and verifies upper layer checksums
+ *
+ * @see @ref NETOPT_CSUM_OFFLOAD
+ */
+#define GNRC_NETIF_FLAGS_CSUM_OFFLOAD              (0x00020000U)
 /** @} */
 
 #ifdef __cplusplus
@@ -88,6 +88,25 @@ extern "C" {
  *          @ref IEEE802154_FCF_FRAME_PEND
  */
 #define GNRC_NETIF_HDR_FLAGS_MORE_DATA  (0x10)
+
+/**
+ * @brief   Send packet before packets without a priority flag
+ *
+ * @details Set by the network layer for network control traffic, as the
+ *          header the priority is derived from might be compressed by the
+ *          time the packet reaches the @ref net_gnrc_netif_txq
+ *          "transmission queue".
+ */
+#define GNRC_NETIF_HDR_FLAGS_PRIO_HIGH  (0x08)
+
+/**
+ * @brief   Send packet after packets without a priority flag
+ *
+ * @details Set by the network layer for lower effort traffic.
+ *
+ * @see     @ref GNRC_NETIF_HDR_FLAGS_PRIO_HIGH
+ */
+#define GNRC_NETIF_HDR_FLAGS_PRIO_LOW   (0x04)
 /**
  * @}
  */
@@ -332,6 +351,20 @@ int gnrc_netif_hdr_get_dstaddr(gnrc_pktsnip_t* pkt, uint8_t** pointer_to_addr);
  */
 int gnrc_netif_hdr_get_srcaddr(gnrc_pktsnip_t* pkt, uint8_t** pointer_to_addr);
 
+/**
+ * @brief   Checks if a received gnrc packet was already checksum-verified
+ *          by the device
+ *
+ * @see @ref GNRC_NETIF_FLAGS_CSUM_OFFLOAD
+ *
+ * @param[in]   pkt     gnrc packet to check
+ *
+ * @return  true, if @p pkt was received on an interface with checksum
+ *          offloading
+ * @return  false, otherwise or if no netif header is present in @p pkt
+ */
+bool gnrc_netif_hdr_csum_offloaded(gnrc_pktsnip_t *pkt);
+
 #ifdef __cplusplus
 }
 #endif
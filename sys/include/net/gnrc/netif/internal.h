@@ -54,6 +54,69 @@ void gnrc_netif_acquire(gnrc_netif_t *netif);
  */
 void gnrc_netif_release(gnrc_netif_t *netif);
 
+#if defined(MODULE_GNRC_NETIF_TXQ) || DOXYGEN
+/**
+ * @brief   Initializes the transmission queue of the interface
+ *
+ * @param[in] netif the network interface
+ *
+ * @internal
+ */
+void gnrc_netif_txq_init(gnrc_netif_t *netif);
+
+/**
+ * @brief   Puts a packet into the transmission queue of the interface
+ *
+ * If the queue is full, @p pkt is released and `ENOBUFS` is reported to the
+ * @ref net_gnrc_neterr "error subscribers" of @p pkt.
+ *
+ * @param[in] netif the network interface
+ * @param[in] pkt   the packet to send
+ *
+ * @internal
+ */
+void gnrc_netif_txq_push(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt);
+
+/**
+ * @brief   Sends the next packet(s) of the transmission queue
+ *
+ * @pre gnrc_netif_txq_ready(netif)
+ *
+ * @param[in] netif the network interface
+ *
+ * @internal
+ */
+void gnrc_netif_txq_send(gnrc_netif_t *netif);
+
+/**
+ * @brief   Handles @ref GNRC_NETIF_TXQ_MSG_TYPE_RETRY
+ *
+ * @param[in] netif the network interface
+ *
+ * @internal
+ */
+static inline void gnrc_netif_txq_retry(gnrc_netif_t *netif)
+{
+    netif->txq.wait = false;
+}
+
+/**
+ * @brief   Checks if the interface can send a packet of the transmission
+ *          queue
+ *
+ * @param[in] netif the network interface
+ *
+ * @return  true, if the queue is not empty and not waiting for the device
+ * @return  false, otherwise
+ *
+ * @internal
+ */
+static inline bool gnrc_netif_txq_ready(const gnrc_netif_t *netif)
+{
+    return (netif->txq.queue.first != NULL) && !netif->txq.wait;
+}
+#endif  /* MODULE_GNRC_NETIF_TXQ */
+
 #if defined(MODULE_GNRC_IPV6) || DOXYGEN
 /**
  * @brief   Adds an IPv6 address to the interface
@@ -70,6 +70,22 @@ extern "C" {
 #define GNRC_NETIF_IPV6_ADDRS_FLAGS_ANYCAST                (0x20U)
 /** @} */
 
+#if (GNRC_NETIF_IPV6_SRC_CACHE_SIZE > 0) || DOXYGEN
+/**
+ * @brief   Source address selection cache entry
+ */
+typedef struct {
+    ipv6_addr_t dst;    /**< destination address */
+    /**
+     * @brief   Index of the selected source address in
+     *          gnrc_netif_ipv6_t::addrs, -1 if there is none
+     */
+    int8_t idx;
+    bool ll_only;       /**< selection was restricted to link-local addresses */
+    bool valid;         /**< entry is in use */
+} gnrc_netif_ipv6_src_cache_t;
+#endif
+
 /**
  * @brief   IPv6 component for @ref gnrc_netif_t
  *
@@ -98,6 +114,26 @@ typedef struct {
      * @note    Only available with module @ref net_gnrc_ipv6 "gnrc_ipv6".
      */
     ipv6_addr_t groups[GNRC_NETIF_IPV6_GROUPS_NUMOF];
+#if (GNRC_NETIF_IPV6_SRC_CACHE_SIZE > 0) || DOXYGEN
+    /**
+     * @brief   Cache of selected source addresses per destination
+     *
+     * @note    Only available with module @ref net_gnrc_ipv6 "gnrc_ipv6" and
+     *          if @ref GNRC_NETIF_IPV6_SRC_CACHE_SIZE > 0
+     */
+    gnrc_netif_ipv6_src_cache_t src_cache[GNRC_NETIF_IPV6_SRC_CACHE_SIZE];
+    /**
+     * @brief   gnrc_netif_ipv6_t::addrs_flags at the time
+     *          gnrc_netif_ipv6_t::src_cache was filled
+     *
+     * Address state changes (e.g. after DAD or when an address becomes
+     * deprecated) invalidate the cache.
+     *
+     * @note    Only available with module @ref net_gnrc_ipv6 "gnrc_ipv6" and
+     *          if @ref GNRC_NETIF_IPV6_SRC_CACHE_SIZE > 0
+     */
+    uint8_t src_cache_addrs_flags[GNRC_NETIF_IPV6_ADDRS_NUMOF];
+#endif
 #ifdef MODULE_NETSTATS_IPV6
     /**
      * @brief IPv6 packet statistics
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_netif_txq Transmission queue
+ * @ingroup     net_gnrc_netif
+ * @brief       Per-interface transmission queue with priority classes
+ *
+ * Without this module, @ref net_gnrc_netif sends every packet as soon as it
+ * receives it, so a burst of packets fills up the message queue of the
+ * interface thread and the device is blocked until the burst was sent.
+ *
+ * With the `gnrc_netif_txq` module, packets are put into a
+ * @ref net_gnrc_priority_pktqueue "priority packet queue" instead and sent
+ * one by one while no other message (e.g. a device event) is pending.
+ *
+ * - Packets are sorted into the classes @ref GNRC_NETIF_TXQ_PRIO_HIGH,
+ *   @ref GNRC_NETIF_TXQ_PRIO_NORMAL and @ref GNRC_NETIF_TXQ_PRIO_LOW by the
+ *   traffic class of their IPv6 header. ICMPv6 packets always go into
+ *   @ref GNRC_NETIF_TXQ_PRIO_HIGH. The IPv6 layer stores the class in the
+ *   @ref net_gnrc_netif_hdr "interface header" (see
+ *   @ref GNRC_NETIF_HDR_FLAGS_PRIO_HIGH), so it is kept after header
+ *   compression.
+ * - If the device reports `-EBUSY`, the packet is sent again after
+ *   @ref GNRC_NETIF_TXQ_RETRY_DELAY.
+ * - If the queue is full, the packet is released with `ENOBUFS` which is
+ *   reported to the sender via @ref net_gnrc_neterr.
+ * - Ethernet devices send up to @ref GNRC_NETIF_TXQ_BURST packets at once.
+ *
+ * The statistics of the queue are available via @ref NETOPT_STATS with
+ * @ref NETSTATS_TXQ.
+ *
+ * @{
+ *
+ * @file
+ * @brief   Transmission queue definitions for @ref net_gnrc_netif
+ */
+#ifndef NET_GNRC_NETIF_TXQ_H
+#define NET_GNRC_NETIF_TXQ_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "net/gnrc/pkt.h"
+#include "net/gnrc/priority_pktqueue.h"
+#include "net/ipv6/hdr.h"
+#include "net/netstats.h"
+#include "xtimer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Maximum number of packets in the queue of an interface
+ */
+#ifndef GNRC_NETIF_TXQ_SIZE
+#define GNRC_NETIF_TXQ_SIZE         (8U)
+#endif
+
+/**
+ * @brief   Delay in microseconds before a packet is sent again if the
+ *          device was busy
+ */
+#ifndef GNRC_NETIF_TXQ_RETRY_DELAY
+#define GNRC_NETIF_TXQ_RETRY_DELAY  (1000U)
+#endif
+
+/**
+ * @brief   Maximum number of times a packet is sent again if the device was
+ *          busy
+ */
+#ifndef GNRC_NETIF_TXQ_RETRIES
+#define GNRC_NETIF_TXQ_RETRIES      (8U)
+#endif
+
+/**
+ * @brief   Maximum number of packets an Ethernet interface sends before it
+ *          handles other messages again
+ */
+#ifndef GNRC_NETIF_TXQ_BURST
+#define GNRC_NETIF_TXQ_BURST        (4U)
+#endif
+
+/**
+ * @brief   Message type to send the head of the queue again
+ */
+#define GNRC_NETIF_TXQ_MSG_TYPE_RETRY   (0x0230)
+
+/**
+ * @name    Priority classes
+ * @{
+ */
+#define GNRC_NETIF_TXQ_PRIO_HIGH    (0U)    /**< network control */
+#define GNRC_NETIF_TXQ_PRIO_NORMAL  (1U)    /**< default */
+#define GNRC_NETIF_TXQ_PRIO_LOW     (2U)    /**< lower effort, background */
+/** @} */
+
+/**
+ * @brief   Node of the transmission queue
+ */
+typedef struct {
+    gnrc_priority_pktqueue_node_t node; /**< queue node */
+    uint32_t time;                      /**< time the packet was queued */
+} gnrc_netif_txq_node_t;
+
+/**
+ * @brief   Transmission queue component of @ref gnrc_netif_t
+ */
+typedef struct {
+    gnrc_priority_pktqueue_t queue;     /**< the queued packets */
+    gnrc_netif_txq_node_t nodes[GNRC_NETIF_TXQ_SIZE];   /**< node pool */
+    xtimer_t retry_timer;               /**< timer to send a packet again */
+    msg_t retry_msg;                    /**< message of gnrc_netif_txq_t::retry_timer */
+    netstats_txq_t stats;               /**< queue statistics */
+    uint8_t retries;                    /**< attempts to send the head */
+    bool wait;                          /**< waiting for the retry timer */
+} gnrc_netif_txq_t;
+
+/**
+ * @brief   Classifies an IPv6 packet for the transmission queue
+ *
+ * @param[in] hdr   IPv6 header of the packet
+ *
+ * @return  @ref GNRC_NETIF_HDR_FLAGS_PRIO_HIGH, @ref GNRC_NETIF_HDR_FLAGS_PRIO_LOW
+ *          or 0 for @ref GNRC_NETIF_TXQ_PRIO_NORMAL
+ */
+uint8_t gnrc_netif_txq_hdr_flags(const ipv6_hdr_t *hdr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_NETIF_TXQ_H */
+/** @} */
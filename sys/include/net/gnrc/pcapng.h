@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_pcapng Capture Network Packets as pcapng
+ * @ingroup     net_gnrc
+ * @brief       Capture network packets into a pcapng file
+ *
+ * In contrast to @ref net_gnrc_pktdump this module does not format the
+ * packets, but writes them as [pcapng](https://github.com/pcapng/pcapng)
+ * blocks, so the traffic can be analyzed with e.g. Wireshark afterwards.
+ *
+ * Packets are captured
+ * - as raw frames of a network interface, if the `gnrc_pcapng` module is
+ *   used together with the IEEE 802.15.4 or Ethernet netif, and
+ * - as packets of the @ref net_gnrc_netreg "registry", by registering
+ *   @ref gnrc_pcapng_pid for a @ref net_gnrc_nettype "type" as with
+ *   @ref net_gnrc_pktdump.
+ *
+ * Each combination of network interface and link type is written as a pcapng
+ * interface, each packet with a timestamp in microseconds.
+ *
+ * Capturing only copies the packet into a ring buffer of
+ * @ref GNRC_PCAPNG_BUFSIZE bytes. The pcapng thread, running with a low
+ * priority, writes the ring buffer to the output. If the ring buffer is full,
+ * packets are dropped and counted instead of delaying the network stack.
+ *
+ * On `native` the output is a file on the host, see
+ * @ref GNRC_PCAPNG_NATIVE_FILE. On other platforms an output must be set
+ * with gnrc_pcapng_set_output().
+ *
+ * @{
+ *
+ * @file
+ * @brief       pcapng capture definitions
+ */
+#ifndef NET_GNRC_PCAPNG_H
+#define NET_GNRC_PCAPNG_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "iolist.h"
+#include "kernel_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Size of the ring buffer in bytes, must be a power of 2
+ */
+#ifndef GNRC_PCAPNG_BUFSIZE
+#define GNRC_PCAPNG_BUFSIZE             (4096U)
+#endif
+
+/**
+ * @brief   Maximum number of bytes captured of a packet
+ */
+#ifndef GNRC_PCAPNG_SNAPLEN
+#define GNRC_PCAPNG_SNAPLEN             (256U)
+#endif
+
+/**
+ * @brief   Maximum number of pcapng interfaces, i.e. combinations of network
+ *          interface and link type
+ */
+#ifndef GNRC_PCAPNG_IF_NUMOF
+#define GNRC_PCAPNG_IF_NUMOF            (4U)
+#endif
+
+/**
+ * @brief   Interval in microseconds in which the ring buffer is written to the
+ *          output
+ *
+ * The ring buffer is also written, when it is half full.
+ */
+#ifndef GNRC_PCAPNG_FLUSH_INTERVAL_US
+#define GNRC_PCAPNG_FLUSH_INTERVAL_US   (100U * US_PER_MS)
+#endif
+
+/**
+ * @brief   Name of the file on the host the packets are written to on
+ *          `native`
+ *
+ * `%d` is replaced by the process ID of the native instance, so several
+ * instances started in the same directory do not overwrite each other's
+ * capture.
+ */
+#ifndef GNRC_PCAPNG_NATIVE_FILE
+#define GNRC_PCAPNG_NATIVE_FILE         "riot-%d.pcapng"
+#endif
+
+/**
+ * @brief   Message queue size for the pcapng thread
+ */
+#ifndef GNRC_PCAPNG_MSG_QUEUE_SIZE
+#define GNRC_PCAPNG_MSG_QUEUE_SIZE      (8U)
+#endif
+
+/**
+ * @brief   Priority of the pcapng thread
+ */
+#ifndef GNRC_PCAPNG_PRIO
+#define GNRC_PCAPNG_PRIO                (THREAD_PRIORITY_MIN - 1)
+#endif
+
+/**
+ * @brief   Stack size used for the pcapng thread
+ */
+#ifndef GNRC_PCAPNG_STACKSIZE
+#define GNRC_PCAPNG_STACKSIZE           (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+/**
+ * @name    Link types of the captured packets
+ * @see     http://www.tcpdump.org/linktypes.html
+ * @{
+ */
+#define GNRC_PCAPNG_LINKTYPE_ETHERNET               (1U)
+#define GNRC_PCAPNG_LINKTYPE_USER0                  (147U)  /**< packets
+                                                                 of other
+                                                                 types */
+#define GNRC_PCAPNG_LINKTYPE_IPV6                   (229U)
+#define GNRC_PCAPNG_LINKTYPE_IEEE802_15_4_NOFCS     (230U)
+/** @} */
+
+/**
+ * @brief   Statistics of the capture
+ */
+typedef struct {
+    uint32_t captured;      /**< packets written to the ring buffer */
+    uint32_t dropped;       /**< packets dropped, because the ring buffer was
+                                 full */
+} gnrc_pcapng_stats_t;
+
+/**
+ * @brief   Output function of the capture
+ *
+ * @param[in] data      data to write
+ * @param[in] len       length of @p data
+ *
+ * @return  number of bytes written
+ * @return  negative value on error
+ */
+typedef ssize_t (*gnrc_pcapng_write_t)(const void *data, size_t len);
+
+/**
+ * @brief   The PID of the pcapng thread
+ */
+extern kernel_pid_t gnrc_pcapng_pid;
+
+/**
+ * @brief   Start the pcapng thread
+ *
+ * @return  PID of the pcapng thread
+ * @return  negative value on error
+ */
+kernel_pid_t gnrc_pcapng_init(void);
+
+/**
+ * @brief   Set the output of the capture
+ *
+ * Packets not yet written to the old output are discarded. The new output
+ * starts with a new pcapng section. Blocks until the pcapng thread switched
+ * the output.
+ *
+ * @param[in] write     output function, NULL to stop writing
+ */
+void gnrc_pcapng_set_output(gnrc_pcapng_write_t write);
+
+/**
+ * @brief   Capture a packet
+ *
+ * Can be called from any thread.
+ *
+ * @param[in] if_pid    network interface the packet belongs to,
+ *                      KERNEL_PID_UNDEF if unknown
+ * @param[in] linktype  link type of the packet
+ * @param[in] iolist    the packet
+ *
+ * @return  0 on success
+ * @return  -ENOBUFS, if the ring buffer is full
+ * @return  -ENOSPC, if there are already @ref GNRC_PCAPNG_IF_NUMOF interfaces
+ */
+int gnrc_pcapng_capture(kernel_pid_t if_pid, uint16_t linktype,
+                        const iolist_t *iolist);
+
+/**
+ * @brief   Capture a packet in a single buffer
+ *
+ * @see gnrc_pcapng_capture()
+ *
+ * @param[in] if_pid    network interface the packet belongs to,
+ *                      KERNEL_PID_UNDEF if unknown
+ * @param[in] linktype  link type of the packet
+ * @param[in] data      the packet
+ * @param[in] len       length of @p data
+ *
+ * @return  see gnrc_pcapng_capture()
+ */
+static inline int gnrc_pcapng_capture_buf(kernel_pid_t if_pid,
+                                          uint16_t linktype,
+                                          const void *data, size_t len)
+{
+    const iolist_t iolist = {
+        .iol_next = NULL,
+        .iol_base = (void *)data,
+        .iol_len = len,
+    };
+
+    return gnrc_pcapng_capture(if_pid, linktype, &iolist);
+}
+
+/**
+ * @brief   Write all captured packets to the output
+ *
+ * Blocks until the pcapng thread wrote the ring buffer.
+ */
+void gnrc_pcapng_flush(void);
+
+/**
+ * @brief   Get the statistics of the capture
+ *
+ * @param[out] stats    the statistics
+ */
+void gnrc_pcapng_get_stats(gnrc_pcapng_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_PCAPNG_H */
+/** @} */
@@ -29,6 +29,14 @@
  *   USEMODULE += auto_init_gnrc_rpl
  *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  *
+ * - Minimum Rank with Hysteresis Objective Function (MRHOF, RFC 6719) in
+ *   addition to OF0. The ETX of a link is taken from the per-neighbor link
+ *   statistics when `netstats_neighbor` is used, or derived from the
+ *   link-layer statistics of the interface when `netstats_l2` is used.
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
+ *   USEMODULE += gnrc_rpl_mrhof
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
  * Auto-Initialization
  * -------------------
  *
@@ -68,6 +76,11 @@
  *   CFLAGS += -DGNRC_RPL_DODAG_CONF_OPTIONAL_ON_JOIN
  *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  *
+ * - Use MRHOF when operating as root (requires `gnrc_rpl_mrhof`)
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
+ *   CFLAGS += -DGNRC_RPL_DEFAULT_OCP=1
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
  * - Set interface for auto-initialization if more than one
  *   interface exists (`GNRC_NETIF_NUMOF > 1`)
  *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
@@ -193,12 +206,20 @@ extern "C" {
 /**
  * @brief   Number of implemented Objective Functions
  */
+#ifdef MODULE_GNRC_RPL_MRHOF
+#define GNRC_RPL_IMPLEMENTED_OFS_NUMOF (2)
+#else
 #define GNRC_RPL_IMPLEMENTED_OFS_NUMOF (1)
+#endif
 
 /**
  * @brief   Default Objective Code Point (OF0)
+ *
+ * Set to `1` to announce MRHOF as a root (requires module `gnrc_rpl_mrhof`).
  */
+#ifndef GNRC_RPL_DEFAULT_OCP
 #define GNRC_RPL_DEFAULT_OCP (0)
+#endif
 
 /**
  * @brief   Default Instance ID
@@ -23,6 +23,8 @@
 #ifndef NET_GNRC_RPL_SRH_H
 #define NET_GNRC_RPL_SRH_H
 
+#include <stddef.h>
+
 #include "net/ipv6/hdr.h"
 #include "net/ipv6/addr.h"
 
@@ -30,6 +32,61 @@
 extern "C" {
 #endif
 
+/**
+ * @name    Source route table configuration
+ *
+ * A DODAG root in non-storing mode records the parent of every node from the
+ * Transit Information option of the DAOs it receives. The resulting
+ * parent-pointer tree allows to build the source route to any node in
+ * O(depth).
+ * @{
+ */
+/**
+ * @brief   Maximum number of nodes in the source route table
+ */
+#ifndef GNRC_RPL_SRH_TABLE_SIZE
+#define GNRC_RPL_SRH_TABLE_SIZE         (16U)
+#endif
+
+/**
+ * @brief   Number of hash buckets of the source route table
+ *
+ * @note    Must be a power of 2
+ */
+#ifndef GNRC_RPL_SRH_TABLE_BUCKETS
+#define GNRC_RPL_SRH_TABLE_BUCKETS      (8U)
+#endif
+
+/**
+ * @brief   Maximum number of hops of a source route
+ */
+#ifndef GNRC_RPL_SRH_MAX_HOPS
+#define GNRC_RPL_SRH_MAX_HOPS           (16U)
+#endif
+
+/**
+ * @brief   Maximum length of a source routing header
+ */
+#define GNRC_RPL_SRH_MAX_LEN            (sizeof(gnrc_rpl_srh_t) + \
+                                         (GNRC_RPL_SRH_MAX_HOPS * sizeof(ipv6_addr_t)))
+
+/**
+ * @brief   Number of entries in the cache of built source routing headers
+ *
+ * Set to 0 to disable the cache.
+ */
+#ifndef GNRC_RPL_SRH_CACHE_SIZE
+#define GNRC_RPL_SRH_CACHE_SIZE         (4U)
+#endif
+
+/**
+ * @brief   Maximum length of a source routing header held in the cache
+ */
+#ifndef GNRC_RPL_SRH_CACHE_HDR_LEN
+#define GNRC_RPL_SRH_CACHE_HDR_LEN      (64U)
+#endif
+/** @} */
+
 /**
  * @brief   The RPL Source routing header.
  *
@@ -69,6 +126,64 @@ typedef struct __attribute__((packed)) {
  */
 int gnrc_rpl_srh_process(ipv6_hdr_t *ipv6, gnrc_rpl_srh_t *rh, void **err_ptr);
 
+/**
+ * @brief   Set the parent of a node in the source route table.
+ *
+ * Unknown nodes and parents are added to the table. A node with an unknown
+ * parent is kept in the table but unreachable until its own parent is known.
+ *
+ * @param[in] addr      Address of the node (DAO target).
+ * @param[in] parent    Address of the parent of @p addr. NULL if the parent is
+ *                      the DODAG root itself.
+ *
+ * @return  0, on success
+ * @return  -ENOMEM, if the table is full
+ */
+int gnrc_rpl_srh_table_add(const ipv6_addr_t *addr, const ipv6_addr_t *parent);
+
+/**
+ * @brief   Remove a node from the source route table.
+ *
+ * The children of @p addr become unreachable until they are added again.
+ *
+ * @param[in] addr      Address of the node.
+ *
+ * @return  0, on success
+ * @return  -ENOENT, if @p addr is not in the table
+ */
+int gnrc_rpl_srh_table_del(const ipv6_addr_t *addr);
+
+/**
+ * @brief   Remove all nodes from the source route table.
+ */
+void gnrc_rpl_srh_table_flush(void);
+
+/**
+ * @brief   Build the source routing header to a node in the source route
+ *          table.
+ *
+ * The addresses in the header are compressed against the first hop (CmprI
+ * and CmprE) as described in RFC 6554, section 3. gnrc_rpl_srh_t::nh is left
+ * for the caller to fill.
+ *
+ * @param[in] dst           The final destination.
+ * @param[out] first_hop    The first hop, i.e. the destination address the
+ *                          IPv6 header needs to carry.
+ * @param[out] srh          Buffer for the source routing header. May be
+ *                          NULL to only get the length of the header.
+ * @param[in] srh_len       Length of @p srh.
+ *
+ * @return  Length of the source routing header in @p srh, on success.
+ * @return  0, if @p dst is a child of the root and no source routing header
+ *          is needed. @p first_hop is set to @p dst.
+ * @return  -ENOENT, if there is no route to @p dst.
+ * @return  -ELOOP, if the route to @p dst exceeds
+ *          @ref GNRC_RPL_SRH_MAX_HOPS (e.g. due to a loop).
+ * @return  -ENOBUFS, if @p srh_len is too small.
+ */
+int gnrc_rpl_srh_build(const ipv6_addr_t *dst, ipv6_addr_t *first_hop,
+                       gnrc_rpl_srh_t *srh, size_t srh_len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -243,7 +243,8 @@ struct gnrc_rpl_parent {
     uint8_t dtsn;                   /**< last seen dtsn of this parent */
     uint16_t rank;                  /**< rank of the parent */
     gnrc_rpl_dodag_t *dodag;        /**< DODAG the parent belongs to */
-    double link_metric;             /**< metric of the link */
+    uint16_t link_metric;           /**< cached metric of the link, as maintained
+                                         by @ref gnrc_rpl_of_t::update_link_metric */
     uint8_t link_metric_type;       /**< type of the metric */
     /**
      * @brief Parent timeout events (see @ref GNRC_RPL_MSG_TYPE_PARENT_TIMEOUT)
@@ -267,8 +268,8 @@ typedef struct {
      *
      * Compares two parents based on the rank calculated by the objective
      * function. This function is used to determine the parent list order. The
-     * parents are ordered from the preferred parent to the least preferred
-     * parent.
+     * preferred parent heads the list, the other parents follow ordered from
+     * the most to the least preferred parent.
      *
      * @param[in] parent1 First parent to compare.
      * @param[in] parent2 Second parent to compare.
@@ -283,6 +284,20 @@ typedef struct {
     void (*parent_state_callback)(gnrc_rpl_parent_t *, int, int); /**< retrieves the state of a parent*/
     void (*init)(void);  /**< OF specific init function */
     void (*process_dio)(void);  /**< DIO processing callback (acc. to OF0 spec, chpt 5) */
+
+    /**
+     * @brief   Refresh the cached link metric of a parent.
+     *
+     * Called once for a parent every time one of its DIOs was processed,
+     * before the parent is re-sorted into the parent set. @ref
+     * gnrc_rpl_of_t::calc_rank and @ref gnrc_rpl_of_t::parent_cmp are
+     * expected to work on gnrc_rpl_parent_t::link_metric only, so the
+     * (possibly expensive) metric acquisition happens once per DIO and not
+     * on every comparison. May be NULL if the OF does not use link metrics.
+     *
+     * @param[in] parent    The parent to update.
+     */
+    void (*update_link_metric)(gnrc_rpl_parent_t *parent);
 } gnrc_rpl_of_t;
 
 /**
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_udp_mux UDP endpoint multiplexer
+ * @ingroup     net_gnrc
+ * @brief       Shares one receive thread between the UDP ports of several
+ *              application protocols
+ *
+ * Without this module, each application protocol creates its own
+ * @ref sock_udp_t, and often its own thread and receive buffer. With it, the
+ * protocols register an endpoint (@ref gnrc_udp_mux_ep_t) per port. A single
+ * thread receives the packets of all endpoints from GNRC's UDP thread and
+ * posts an event to the event queue of the endpoint. The event handler passes
+ * each packet to the handler of the endpoint, pointing into the packet buffer,
+ * and releases the packet afterwards.
+ *
+ * The thread of the multiplexer runs an event queue itself
+ * (@ref gnrc_udp_mux_queue()). Handlers of endpoints on this queue run right
+ * after the packet is received, without another thread and context switch.
+ * gcoap and the SNTP client use it when this module is used.
+ *
+ * @{
+ *
+ * @file
+ * @brief       UDP endpoint multiplexer definitions
+ */
+
+#ifndef NET_GNRC_UDP_MUX_H
+#define NET_GNRC_UDP_MUX_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "cib.h"
+#include "event.h"
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/pkt.h"
+#include "net/sock/udp.h"
+#include "thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Priority of the multiplexer thread
+ */
+#ifndef GNRC_UDP_MUX_PRIO
+#define GNRC_UDP_MUX_PRIO           (THREAD_PRIORITY_MAIN - 1)
+#endif
+
+/**
+ * @brief   Stack size of the multiplexer thread
+ *
+ * The handlers of the endpoints on @ref gnrc_udp_mux_queue() run on it, so
+ * it leaves room for them to print.
+ */
+#ifndef GNRC_UDP_MUX_STACK_SIZE
+#define GNRC_UDP_MUX_STACK_SIZE     (THREAD_STACKSIZE_DEFAULT + \
+                                     THREAD_EXTRA_STACKSIZE_PRINTF)
+#endif
+
+/**
+ * @brief   Message queue size of the multiplexer thread
+ */
+#ifndef GNRC_UDP_MUX_MSG_QUEUE_SIZE
+#define GNRC_UDP_MUX_MSG_QUEUE_SIZE (8U)
+#endif
+
+/**
+ * @brief   Number of packets an endpoint holds until its handler runs
+ *
+ * Must be a power of two.
+ */
+#ifndef GNRC_UDP_MUX_EP_QUEUE_SIZE
+#define GNRC_UDP_MUX_EP_QUEUE_SIZE  (4U)
+#endif
+
+/**
+ * @brief   UDP endpoint
+ */
+typedef struct gnrc_udp_mux_ep gnrc_udp_mux_ep_t;
+
+/**
+ * @brief   Handler for the packets received by an endpoint
+ *
+ * @param[in] ep        the endpoint
+ * @param[in] data      payload of the packet, in the packet buffer. It may be
+ *                      written to, but is only valid during the call.
+ * @param[in] len       length of @p data
+ * @param[in] remote    sender of the packet
+ */
+typedef void (*gnrc_udp_mux_handler_t)(gnrc_udp_mux_ep_t *ep, uint8_t *data,
+                                       size_t len,
+                                       const sock_udp_ep_t *remote);
+
+/**
+ * @brief   UDP endpoint
+ *
+ * All fields are internal, except for @p arg.
+ */
+struct gnrc_udp_mux_ep {
+    gnrc_udp_mux_ep_t *next;        /**< next registered endpoint */
+    event_t event;                  /**< handles the received packets */
+    gnrc_netreg_entry_t reg;        /**< registration of the port */
+    event_queue_t *queue;           /**< queue the handler runs on */
+    gnrc_udp_mux_handler_t handler; /**< handler for the packets */
+    void *arg;                      /**< user supplied argument */
+    cib_t cib;                      /**< index of @p pkts */
+    gnrc_pktsnip_t *pkts[GNRC_UDP_MUX_EP_QUEUE_SIZE];   /**< received packets */
+    unsigned dropped;               /**< packets dropped as @p pkts was full */
+};
+
+/**
+ * @brief   Start the multiplexer thread
+ *
+ * Called by auto_init, and by the protocols that use the multiplexer. Does
+ * nothing if the thread is running already.
+ *
+ * @return  PID of the multiplexer thread
+ */
+kernel_pid_t gnrc_udp_mux_init(void);
+
+/**
+ * @brief   Get the event queue run by the multiplexer thread
+ *
+ * @return  the event queue
+ */
+event_queue_t *gnrc_udp_mux_queue(void);
+
+/**
+ * @brief   Register an endpoint for a port
+ *
+ * @param[out] ep       endpoint to register
+ * @param[in] port      port to receive on, 0 for an ephemeral port
+ * @param[in] queue     event queue to run @p handler on, e.g.
+ *                      @ref gnrc_udp_mux_queue()
+ * @param[in] handler   handler for the received packets
+ * @param[in] arg       user supplied argument, stored in @p ep
+ *
+ * @return  0 on success
+ * @return  -EADDRINUSE if another receiver is registered for @p port
+ */
+int gnrc_udp_mux_add(gnrc_udp_mux_ep_t *ep, uint16_t port,
+                     event_queue_t *queue, gnrc_udp_mux_handler_t handler,
+                     void *arg);
+
+/**
+ * @brief   Unregister an endpoint
+ *
+ * Drops the packets its handler did not get yet. Must not be called while
+ * the handler of @p ep runs on another thread.
+ *
+ * @param[in] ep        endpoint to unregister
+ */
+void gnrc_udp_mux_remove(gnrc_udp_mux_ep_t *ep);
+
+/**
+ * @brief   Get the port of an endpoint
+ *
+ * @param[in] ep        the endpoint
+ *
+ * @return  the port
+ */
+static inline uint16_t gnrc_udp_mux_port(const gnrc_udp_mux_ep_t *ep)
+{
+    return (uint16_t)ep->reg.demux_ctx;
+}
+
+/**
+ * @brief   Send a packet from an endpoint
+ *
+ * @param[in] ep        endpoint to send from
+ * @param[in] data      payload to send
+ * @param[in] len       length of @p data
+ * @param[in] remote    receiver of the packet
+ *
+ * @return  number of bytes sent on success
+ * @return  -EINVAL if @p remote has no address or port
+ * @return  -EAFNOSUPPORT if the address family of @p remote is not supported
+ * @return  -ENOMEM if there is no space in the packet buffer
+ * @return  other negative values as @ref sock_udp_send()
+ */
+ssize_t gnrc_udp_mux_send(const gnrc_udp_mux_ep_t *ep, const void *data,
+                          size_t len, const sock_udp_ep_t *remote);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_UDP_MUX_H */
+/** @} */
@@ -73,6 +73,40 @@ static inline uint16_t inet_csum(uint16_t sum, const uint8_t *buf, uint16_t len)
     return inet_csum_slice(sum, buf, len, 0);
 }
 
+/**
+ * @brief   Incrementally updates an Internet Checksum after a 16-bit word of
+ *          its domain changed
+ *
+ * @see <a href="https://tools.ietf.org/html/rfc1624#section-3">
+ *          RFC 1624, section 3
+ *      </a>
+ *
+ * @details Calculates HC' = ~(~HC + ~m + m'), so the checksum of e.g. a header
+ *          field rewritten while forwarding does not need to be calculated
+ *          over the whole domain again. Changes of larger fields can be
+ *          applied by calling this function once for every 16-bit word.
+ *          Protocols that transmit a 0 checksum as 0xffff (like UDP) need to
+ *          take care of this themselves.
+ *
+ * @param[in] csum      The normalized checksum (i. e. as in the header) in
+ *                      host byte order.
+ * @param[in] old_word  The old value of the changed word in host byte order.
+ * @param[in] new_word  The new value of the changed word in host byte order.
+ *
+ * @return  The updated normalized checksum in host byte order.
+ */
+static inline uint16_t inet_csum_update(uint16_t csum, uint16_t old_word,
+                                        uint16_t new_word)
+{
+    uint32_t sum = (uint16_t)~csum;
+
+    sum += (uint16_t)~old_word;
+    sum += new_word;
+    sum = (sum & 0xffff) + (sum >> 16);
+    sum = (sum & 0xffff) + (sum >> 16);
+    return (uint16_t)~sum;
+}
+
 #ifdef __cplusplus
 }
 #endif
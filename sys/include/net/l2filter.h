@@ -21,6 +21,12 @@
  * The actual memory for the filter lists should be allocated for every network
  * device. This is done centrally in netdev_t type.
  *
+ * The list is kept as a hash table, so adding, removing and looking up an
+ * address takes constant time on average, independent of
+ * @ref L2FILTER_LISTSIZE. Lookups stay fast as long as the list is not filled
+ * up completely, so choose @ref L2FILTER_LISTSIZE about a quarter larger than
+ * the number of addresses you want to filter.
+ *
  * @{
  * @file
  * @brief       Link layer address filter interface definition
@@ -49,6 +55,8 @@ extern "C" {
 
 /**
  * @brief   Number of slots in each filter list (filter entries per device)
+ *
+ * @note    A power of two makes finding the slot of an address cheaper
  */
 #ifndef L2FILTER_LISTSIZE
 #define L2FILTER_LISTSIZE               (8U)
@@ -64,8 +72,21 @@ extern "C" {
 typedef struct {
     uint8_t addr[L2FILTER_ADDR_MAXLEN];     /**< link layer address */
     size_t addr_len;                        /**< address length in byte */
+    uint16_t hash;                          /**< hash of the address */
 } l2filter_t;
 
+/**
+ * @brief   Clear a filter list
+ *
+ * Filter lists in zero-initialized memory (like the one in netdev_t) don't
+ * need to be cleared.
+ *
+ * @param[out] list     pointer to the filter list
+ *
+ * @pre     @p list != NULL
+ */
+void l2filter_init(l2filter_t *list);
+
 /**
  * @brief   Add an entry to a devices filter list
  *
@@ -77,7 +98,7 @@ typedef struct {
  * @pre     @p addr != NULL
  * @pre     @p addr_maxlen <= @ref L2FILTER_ADDR_MAXLEN
  *
- * @return  0 on success
+ * @return  0 on success, also if @p addr is already in @p list
  * @return  -ENOMEM if no empty slot left in list
  */
 int l2filter_add(l2filter_t *list, const void *addr, size_t addr_len);
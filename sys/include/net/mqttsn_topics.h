@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_mqttsn_topics MQTT-SN topic dispatch
+ * @ingroup     net
+ * @brief       Topic ID map and topic filter trie for MQTT-SN clients
+ *
+ * This module gives emCute and Asymcute constant time dispatching of incoming
+ * PUBLISH messages, and matching of topic names against subscriptions with
+ * wildcards.
+ *
+ * A topic ID map (@ref mqttsn_tid_map_t) maps the topic ID of an incoming
+ * PUBLISH message to the subscription it belongs to. It is an open addressing
+ * hash table of @ref MQTTSN_TID_MAP_SIZE slots.
+ *
+ * A topic filter trie (@ref mqttsn_trie_t) holds the topic names of all
+ * subscriptions, split into their levels. A subscription with the wildcards
+ * `+` (one level) or `#` (all remaining levels) receives a topic ID of 0 from
+ * the gateway. The gateway registers each topic name matching it with a
+ * REGISTER message before it publishes on that name. The client matches the
+ * name against the trie and adds the topic ID to the map. If several filters
+ * match a name, the most specific one is used: a level of the name matches a
+ * filter level of the same name before `+`, and `+` before `#`.
+ *
+ * Both structures store a `void *` context per entry, e.g. the subscription.
+ * They do not allocate memory. The trie refers to the topic filter strings,
+ * which must stay valid while they are in the trie.
+ *
+ * @{
+ * @file
+ * @brief       MQTT-SN topic ID map and topic filter trie
+ */
+
+#ifndef NET_MQTTSN_TOPICS_H
+#define NET_MQTTSN_TOPICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MQTTSN_TID_MAP_SIZE
+/**
+ * @brief   Number of topic IDs a topic ID map holds
+ */
+#define MQTTSN_TID_MAP_SIZE     (16U)
+#endif
+
+#ifndef MQTTSN_TRIE_SIZE
+/**
+ * @brief   Number of nodes of a topic filter trie
+ *
+ * A filter needs a node for each of its levels that it does not share with
+ * another filter.
+ */
+#define MQTTSN_TRIE_SIZE        (16U)
+#endif
+
+/**
+ * @brief   Slot of a topic ID map
+ */
+typedef struct {
+    void *ctx;                  /**< context of the topic ID */
+    uint16_t id;                /**< topic ID, 0 for a free slot */
+} mqttsn_tid_slot_t;
+
+/**
+ * @brief   Topic ID map
+ */
+typedef struct {
+    mqttsn_tid_slot_t slots[MQTTSN_TID_MAP_SIZE];   /**< the slots */
+} mqttsn_tid_map_t;
+
+/**
+ * @brief   Node of a topic filter trie, holding a single level of a filter
+ */
+typedef struct {
+    const char *level;          /**< the level, not null terminated, NULL
+                                 *   for a free node */
+    void *ctx;                  /**< context of the filter ending here */
+    uint16_t len;               /**< length of @p level */
+    uint16_t child;             /**< first node of the next level */
+    uint16_t sibling;           /**< next node of the same level */
+} mqttsn_trie_node_t;
+
+/**
+ * @brief   Topic filter trie
+ */
+typedef struct {
+    mqttsn_trie_node_t nodes[MQTTSN_TRIE_SIZE]; /**< the nodes, the first one
+                                                 *   is the root */
+} mqttsn_trie_t;
+
+/**
+ * @brief   Initialize an empty topic ID map
+ *
+ * @param[out] map      map to initialize
+ */
+void mqttsn_tid_map_init(mqttsn_tid_map_t *map);
+
+/**
+ * @brief   Map a topic ID to a context
+ *
+ * Replaces the context if the topic ID is already mapped.
+ *
+ * @param[in,out] map   map to add to
+ * @param[in] id        topic ID, must not be 0
+ * @param[in] ctx       context of the topic ID
+ *
+ * @return  0 on success
+ * @return  -ENOMEM if the map is full
+ */
+int mqttsn_tid_map_add(mqttsn_tid_map_t *map, uint16_t id, void *ctx);
+
+/**
+ * @brief   Get the context of a topic ID
+ *
+ * @param[in] map       map to search
+ * @param[in] id        topic ID
+ *
+ * @return  the context
+ * @return  NULL if the topic ID is not mapped
+ */
+void *mqttsn_tid_map_get(const mqttsn_tid_map_t *map, uint16_t id);
+
+/**
+ * @brief   Remove all topic IDs mapped to a context
+ *
+ * @param[in,out] map   map to remove from
+ * @param[in] ctx       context to remove
+ */
+void mqttsn_tid_map_del_ctx(mqttsn_tid_map_t *map, const void *ctx);
+
+/**
+ * @brief   Initialize an empty topic filter trie
+ *
+ * @param[out] trie     trie to initialize
+ */
+void mqttsn_trie_init(mqttsn_trie_t *trie);
+
+/**
+ * @brief   Add a topic filter to a trie
+ *
+ * @param[in,out] trie  trie to add to
+ * @param[in] filter    topic filter, may contain wildcards. Must stay valid
+ *                      until it is removed again.
+ * @param[in] ctx       context of the filter, must not be NULL
+ *
+ * @return  0 on success
+ * @return  -EALREADY if the filter is already in the trie with @p ctx
+ * @return  -EEXIST if the filter is already in the trie with another context
+ * @return  -ENOMEM if there are not enough free nodes
+ */
+int mqttsn_trie_add(mqttsn_trie_t *trie, const char *filter, void *ctx);
+
+/**
+ * @brief   Remove a topic filter from a trie
+ *
+ * @param[in,out] trie  trie to remove from
+ * @param[in] filter    topic filter
+ */
+void mqttsn_trie_del(mqttsn_trie_t *trie, const char *filter);
+
+/**
+ * @brief   Find the most specific filter matching a topic name
+ *
+ * @param[in] trie      trie to search
+ * @param[in] name      topic name, without wildcards
+ * @param[in] len       length of @p name
+ *
+ * @return  context of the matching filter
+ * @return  NULL if no filter matches
+ */
+void *mqttsn_trie_match(const mqttsn_trie_t *trie, const char *name,
+                        size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_MQTTSN_TOPICS_H */
+/** @} */
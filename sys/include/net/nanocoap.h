@@ -24,7 +24,9 @@
  * `coap_resources_numof`. The array contents must be ordered by the resource
  * path, specifically the ASCII encoding of the path characters (digit and
  * capital precede lower case). nanocoap provides the
- * COAP_WELL_KNOWN_CORE_DEFAULT_HANDLER entry for `/.well-known/core`.
+ * COAP_WELL_KNOWN_CORE_DEFAULT_HANDLER entry for `/.well-known/core`. A
+ * resource with the @ref COAP_MATCH_SUBTREE flag handles the paths below its
+ * own path as well, e.g. resources created at runtime.
  *
  * ### Handler functions ###
  *
@@ -39,6 +41,14 @@
  * by data type. If the pkt _payload_len_ attribute is a positive value, start
  * to read it at the _payload_ pointer attribute.
  *
+ * coap_parse() decodes each option only once, into the _options_ array of the
+ * pkt, with the position and length of its value. As a message encodes its
+ * options in order of their number, the array is sorted, and the instances of
+ * a repeatable option follow each other. coap_opt_find() looks up the first
+ * instance of an option with a binary search, coap_opt_next() returns the
+ * next instance. coap_cmp_uri_path() compares the path of a request with a
+ * string without copying the path.
+ *
  * If a response does not require specific CoAP options, use
  * coap_reply_simple(). If there is a payload, it writes a Content-Format
  * option with the provided value.
@@ -172,6 +182,14 @@ extern "C" {
 #define COAP_DELETE             (0x8)
 /** @} */
 
+/**
+ * @brief   Flag for coap_resource_t::methods of a resource that also handles
+ *          the paths below its own, e.g. "/rd/5" for "/rd"
+ *
+ * The handler reads the full path of the request, see coap_get_uri_path().
+ */
+#define COAP_MATCH_SUBTREE      (0x8000)
+
 /**
  * @brief   Nanocoap-specific value to indicate no format specified
  */
@@ -183,9 +201,17 @@ extern "C" {
  * @ingroup  config
  * @{
  */
-/** @brief   Maximum number of Options in a message */
+/**
+ * @brief   Maximum number of Options in a message, counting each instance of
+ *          a repeatable option
+ *
+ * A request needs an option for each segment of its path and of its query.
+ * The default leaves room for about 24 segments next to the other options of
+ * a typical request. coap_parse() rejects a message with more options with
+ * -ENOMEM. Each option takes 8 bytes in @ref coap_pkt_t.
+ */
 #ifndef NANOCOAP_NOPTS_MAX
-#define NANOCOAP_NOPTS_MAX          (16)
+#define NANOCOAP_NOPTS_MAX          (32)
 #endif
 
 /**
@@ -238,6 +264,8 @@ typedef struct __attribute__((packed)) {
 typedef struct {
     uint16_t opt_num;           /**< full CoAP option number    */
     uint16_t offset;            /**< offset in packet           */
+    uint16_t value;             /**< offset of the value in packet */
+    uint16_t len;               /**< length of the value        */
 } coap_optpos_t;
 
 /**
@@ -313,7 +341,9 @@ extern const unsigned coap_resources_numof;
  * @param[in]   len     length of packet at @p buf
  *
  * @returns     0 on success
- * @returns     <0 on error
+ * @returns     -EBADMSG if the packet is malformed
+ * @returns     -ENOMEM if the packet has more than @ref NANOCOAP_NOPTS_MAX
+ *              options
  */
 int coap_parse(coap_pkt_t *pkt, uint8_t *buf, size_t len);
 
@@ -674,6 +704,111 @@ size_t coap_opt_put_block2(uint8_t *buf, uint16_t lastonum, coap_block_slicer_t
  */
 unsigned coap_get_content_type(coap_pkt_t *pkt);
 
+/**
+ * @brief   Look up the first instance of an option in a packet
+ *
+ * Searches the sorted option array of @p pkt, without decoding the options
+ * again.
+ *
+ * @param[in]   pkt         packet to work on
+ * @param[in]   opt_num     absolute option number
+ *
+ * @returns     the option
+ * @returns     NULL if the option is not included
+ */
+const coap_optpos_t *coap_opt_find(const coap_pkt_t *pkt, unsigned opt_num);
+
+/**
+ * @brief   Get the next instance of a repeatable option
+ *
+ * @param[in]   pkt         packet to work on
+ * @param[in]   opt         an instance of the option from coap_opt_find()
+ *
+ * @returns     the next instance
+ * @returns     NULL after the last instance
+ */
+static inline const coap_optpos_t *coap_opt_next(const coap_pkt_t *pkt,
+                                                 const coap_optpos_t *opt)
+{
+    const coap_optpos_t *next = opt + 1;
+
+    if ((next < &pkt->options[pkt->options_len]) &&
+        (next->opt_num == opt->opt_num)) {
+        return next;
+    }
+    return NULL;
+}
+
+/**
+ * @brief   Get the value of an option
+ *
+ * @param[in]   pkt         packet to work on
+ * @param[in]   opt         the option
+ *
+ * @returns     pointer to the value, of length `opt->len`
+ */
+static inline uint8_t *coap_opt_value(const coap_pkt_t *pkt,
+                                      const coap_optpos_t *opt)
+{
+    return (uint8_t *)pkt->hdr + opt->value;
+}
+
+/**
+ * @brief   Get the value of an opaque option
+ *
+ * @param[in]   pkt         packet to work on
+ * @param[in]   opt_num     absolute option number
+ * @param[out]  value       pointer to the value of the first instance
+ *
+ * @returns     length of the value
+ * @returns     -ENOENT if the option is not included
+ */
+ssize_t coap_opt_get_opaque(const coap_pkt_t *pkt, unsigned opt_num,
+                            uint8_t **value);
+
+/**
+ * @brief   Find the first instance of an option in a packet
+ *
+ * @param[in]   pkt         packet to work on
+ * @param[in]   opt_num     absolute option number
+ *
+ * @returns     pointer to the start of the option, i.e. its option byte
+ * @returns     NULL if the option is not included
+ */
+uint8_t *coap_find_option(const coap_pkt_t *pkt, unsigned opt_num);
+
+/**
+ * @brief   Iterate over the instances of a repeatable option
+ *
+ * Start with @p optpos from coap_find_option() and @p first set, then call
+ * again with @p first unset for the next instance.
+ *
+ * @param[in]     pkt       packet to work on
+ * @param[in,out] optpos    position of the option; updated to the next one,
+ *                          NULL after the last instance
+ * @param[out]    opt_len   length of the option value
+ * @param[in]     first     non-zero for the first instance of the option
+ *
+ * @returns     pointer to the value of the option
+ * @returns     NULL if there is no further instance
+ */
+uint8_t *coap_iterate_option(const coap_pkt_t *pkt, uint8_t **optpos,
+                             int *opt_len, int first);
+
+/**
+ * @brief   Get the value of a uint option
+ *
+ * @param[in]   pkt         packet to work on
+ * @param[in]   opt_num     absolute option number
+ * @param[out]  target      value of the option
+ *
+ * @returns     0 on success
+ * @returns     -ENOSPC if the option is longer than 4 bytes
+ * @returns     -EBADMSG if the option is malformed
+ * @returns     -1 if the option is not included
+ */
+int coap_get_option_uint(coap_pkt_t *pkt, unsigned opt_num, uint32_t *target);
+
 /**
  * @brief   Read a full option as null terminated string into the target buffer
  *
@@ -694,6 +829,80 @@ unsigned coap_get_content_type(coap_pkt_t *pkt);
 ssize_t coap_opt_get_string(const coap_pkt_t *pkt, uint16_t optnum,
                             uint8_t *target, size_t max_len, char separator);
 
+/**
+ * @brief   Compare a full option with a string
+ *
+ * Compares like strcmp() the string coap_opt_get_string() would read, without
+ * copying the option.
+ *
+ * @param[in]   pkt         packet to read from
+ * @param[in]   optnum      absolute option number
+ * @param[in]   string      null terminated string to compare with
+ * @param[in]   separator   character separating the option parts
+ *
+ * @return      0 if the option equals @p string
+ * @return      a negative or positive value, if the option sorts before or
+ *              after @p string
+ */
+int coap_opt_cmp_string(const coap_pkt_t *pkt, uint16_t optnum,
+                        const char *string, char separator);
+
+/**
+ * @brief   Compare the packet's URI_PATH with a path
+ *
+ * @param[in]   pkt     pkt to work on
+ * @param[in]   path    "/"-separated path to compare with
+ *
+ * @return      0 if the path of @p pkt equals @p path
+ * @return      a negative or positive value, if the path of @p pkt sorts
+ *              before or after @p path
+ */
+static inline int coap_cmp_uri_path(const coap_pkt_t *pkt, const char *path)
+{
+    return coap_opt_cmp_string(pkt, COAP_OPT_URI_PATH, path, '/');
+}
+
+/**
+ * @brief   Compare the leading parts of a multi-part option with a string
+ *
+ * Compares like coap_opt_cmp_string(), but the option also equals @p string
+ * if it continues with more parts after those in @p string.
+ *
+ * @param[in]   pkt         packet to read from
+ * @param[in]   optnum      absolute option number
+ * @param[in]   string      null terminated string to compare with
+ * @param[in]   separator   character separating the option parts
+ *
+ * @return      0 if the option equals or starts with the parts of @p string
+ * @return      a negative or positive value, if the option sorts before or
+ *              after @p string
+ */
+int coap_opt_cmp_prefix(const coap_pkt_t *pkt, uint16_t optnum,
+                        const char *string, char separator);
+
+/**
+ * @brief   Compare the packet's URI_PATH with a resource
+ *
+ * Matches the paths below the path of @p resource as well, if it has the
+ * @ref COAP_MATCH_SUBTREE flag.
+ *
+ * @param[in]   pkt         pkt to work on
+ * @param[in]   resource    resource to compare with
+ *
+ * @return      0 if @p resource handles the path of @p pkt
+ * @return      a negative or positive value, if the path of @p pkt sorts
+ *              before or after the path of @p resource
+ */
+static inline int coap_match_path(const coap_pkt_t *pkt,
+                                  const coap_resource_t *resource)
+{
+    if (resource->methods & COAP_MATCH_SUBTREE) {
+        return coap_opt_cmp_prefix(pkt, COAP_OPT_URI_PATH, resource->path,
+                                   '/');
+    }
+    return coap_cmp_uri_path(pkt, resource->path);
+}
+
 /**
  * @brief   Convenience function for getting the packet's URI_PATH
  *
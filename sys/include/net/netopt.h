@@ -564,6 +564,16 @@ typedef enum {
      */
     NETOPT_PHY_BUSY,
 
+    /**
+     * @brief   (@ref netopt_enable_t) upper layer checksum offloading
+     *
+     * If enabled, the device calculates the checksums of outgoing and
+     * verifies the checksums of incoming UDP, TCP, and ICMPv6 packets, so
+     * the network stack can skip them. Packets with an invalid checksum must
+     * be dropped by the device.
+     */
+    NETOPT_CSUM_OFFLOAD,
+
     /* add more options if needed */
 
     /**
@@ -34,6 +34,8 @@ extern "C" {
 #define NETSTATS_LAYER2     (0x01)
 #define NETSTATS_IPV6       (0x02)
 #define NETSTATS_RPL        (0x03)
+#define NETSTATS_TXQ        (0x04)
+#define NETSTATS_NEIGHBOR   (0x08)
 #define NETSTATS_ALL        (0xFF)
 /** @} */
 
@@ -53,6 +55,23 @@ typedef struct {
     uint32_t rx_bytes;          /**< received bytes */
 } netstats_t;
 
+/**
+ * @brief       Statistics of a transmission queue
+ */
+typedef struct {
+    uint32_t enqueued;          /**< packets put into the queue */
+    uint32_t overflows;         /**< packets rejected because the queue was
+                                     full */
+    uint32_t retries;           /**< sending operations repeated because the
+                                     device was busy */
+    uint16_t depth;             /**< packets currently in the queue */
+    uint16_t depth_max;         /**< maximum number of packets in the queue */
+    uint32_t latency_avg;       /**< moving average of the time in
+                                     microseconds packets spent in the queue */
+    uint32_t latency_max;       /**< maximum time in microseconds a packet
+                                     spent in the queue */
+} netstats_txq_t;
+
 #ifdef __cplusplus
 }
 #endif
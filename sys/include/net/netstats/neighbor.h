@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_netstats_neighbor Per-neighbor link statistics
+ * @ingroup     net_netstats
+ * @brief       Link quality estimation for each neighbor of an interface
+ *
+ * The network interface updates an entry for a neighbor
+ * - with the RSSI and LQI of every frame received from it and
+ * - with the number of transmissions of every unicast frame sent to it.
+ *
+ * From the transmissions the expected transmission count (ETX) of the link is
+ * estimated. RSSI, LQI and ETX are kept as exponentially weighted moving
+ * averages. Routing protocols can use the ETX as link metric, e.g.
+ * @ref net_gnrc_rpl "RPL" with MRHOF.
+ *
+ * The table of an interface is available via @ref NETOPT_STATS with
+ * @ref NETSTATS_NEIGHBOR.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Per-neighbor link statistics definitions
+ */
+#ifndef NET_NETSTATS_NEIGHBOR_H
+#define NET_NETSTATS_NEIGHBOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of neighbors per interface
+ */
+#ifndef NETSTATS_NB_SIZE
+#define NETSTATS_NB_SIZE                (8U)
+#endif
+
+/**
+ * @brief   Maximum length of the link-layer address of a neighbor
+ */
+#ifndef NETSTATS_NB_L2ADDR_MAXLEN
+#define NETSTATS_NB_L2ADDR_MAXLEN       (8U)
+#endif
+
+/**
+ * @brief   Fixed point divisor of netstats_nb_t::etx
+ *
+ * Same as the divisor of the ETX metric in RPL (RFC 6551, section 4.3.2).
+ */
+#define NETSTATS_NB_ETX_DIVISOR         (128U)
+
+/**
+ * @brief   ETX sample for a frame that was not acknowledged
+ */
+#ifndef NETSTATS_NB_ETX_NOACK_PENALTY
+#define NETSTATS_NB_ETX_NOACK_PENALTY   (12U)
+#endif
+
+/**
+ * @brief   Weight of the old value in percent for the moving average of ETX
+ */
+#ifndef NETSTATS_NB_ETX_ALPHA
+#define NETSTATS_NB_ETX_ALPHA           (90U)
+#endif
+
+/**
+ * @brief   Weight of the old value in percent for the moving averages of
+ *          RSSI and LQI
+ */
+#ifndef NETSTATS_NB_RX_ALPHA
+#define NETSTATS_NB_RX_ALPHA            (80U)
+#endif
+
+/**
+ * @brief   Number of ETX samples needed before an entry is fresh
+ */
+#ifndef NETSTATS_NB_FRESHNESS_TARGET
+#define NETSTATS_NB_FRESHNESS_TARGET    (3U)
+#endif
+
+/**
+ * @brief   Time in seconds after which an entry without updates is no longer
+ *          fresh
+ */
+#ifndef NETSTATS_NB_FRESHNESS_EXPIRATION
+#define NETSTATS_NB_FRESHNESS_EXPIRATION    (300U)
+#endif
+
+/**
+ * @brief   Result of a transmission to a neighbor
+ */
+typedef enum {
+    NETSTATS_NB_SUCCESS = 0,    /**< frame was acknowledged */
+    NETSTATS_NB_NOACK,          /**< frame was not acknowledged */
+} netstats_nb_result_t;
+
+/**
+ * @brief   Link statistics of a neighbor
+ */
+typedef struct {
+    uint8_t l2_addr[NETSTATS_NB_L2ADDR_MAXLEN]; /**< link-layer address */
+    uint8_t l2_addr_len;        /**< length of netstats_nb_t::l2_addr, 0 if
+                                     the entry is unused */
+    uint8_t freshness;          /**< number of ETX samples, saturating */
+    uint16_t etx;               /**< ETX multiplied by
+                                     @ref NETSTATS_NB_ETX_DIVISOR, 0 without
+                                     samples */
+    int16_t rssi;               /**< average RSSI of received frames in dBm */
+    uint8_t lqi;                /**< average LQI of received frames */
+    uint16_t tx_count;          /**< unicast frames sent */
+    uint16_t tx_failed;         /**< unicast frames not acknowledged */
+    uint16_t rx_count;          /**< frames received */
+    uint32_t last_updated;      /**< time of the last update in seconds */
+} netstats_nb_t;
+
+/**
+ * @brief   Clear a neighbor table
+ *
+ * @param[out] table    table of @ref NETSTATS_NB_SIZE entries
+ */
+void netstats_nb_init(netstats_nb_t *table);
+
+/**
+ * @brief   Find the entry of a neighbor
+ *
+ * @param[in] table     table of @ref NETSTATS_NB_SIZE entries
+ * @param[in] l2_addr   link-layer address of the neighbor
+ * @param[in] len       length of @p l2_addr
+ *
+ * @return  the entry of the neighbor
+ * @return  NULL, if the neighbor is not in @p table
+ */
+netstats_nb_t *netstats_nb_get(netstats_nb_t *table, const uint8_t *l2_addr,
+                               uint8_t len);
+
+/**
+ * @brief   Record a frame received from a neighbor
+ *
+ * If the neighbor is not in the table, the least recently updated entry is
+ * replaced.
+ *
+ * @param[in] table     table of @ref NETSTATS_NB_SIZE entries
+ * @param[in] l2_addr   link-layer address of the neighbor
+ * @param[in] len       length of @p l2_addr
+ * @param[in] rssi      RSSI of the frame in dBm
+ * @param[in] lqi       LQI of the frame
+ *
+ * @return  the entry of the neighbor
+ * @return  NULL, if @p len is too long
+ */
+netstats_nb_t *netstats_nb_update_rx(netstats_nb_t *table,
+                                     const uint8_t *l2_addr, uint8_t len,
+                                     int16_t rssi, uint8_t lqi);
+
+/**
+ * @brief   Record the result of a unicast transmission to a neighbor
+ *
+ * If the neighbor is not in the table, the least recently updated entry is
+ * replaced.
+ *
+ * @param[in] table         table of @ref NETSTATS_NB_SIZE entries
+ * @param[in] l2_addr       link-layer address of the neighbor
+ * @param[in] len           length of @p l2_addr
+ * @param[in] result        result of the transmission
+ * @param[in] transmissions number of times the frame was sent (1 if it was
+ *                          acknowledged without retransmission)
+ *
+ * @return  the entry of the neighbor
+ * @return  NULL, if @p len is too long
+ */
+netstats_nb_t *netstats_nb_update_tx(netstats_nb_t *table,
+                                     const uint8_t *l2_addr, uint8_t len,
+                                     netstats_nb_result_t result,
+                                     uint8_t transmissions);
+
+/**
+ * @brief   Check if the ETX of an entry is backed by enough recent samples
+ *
+ * @param[in] entry     an entry of a neighbor table
+ *
+ * @return  true, if the entry is fresh
+ * @return  false, otherwise
+ */
+bool netstats_nb_isfresh(const netstats_nb_t *entry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_NETSTATS_NEIGHBOR_H */
+/** @} */
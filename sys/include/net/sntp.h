@@ -37,10 +37,14 @@ extern "C" {
 /**
  * @brief Synchronize with time server
  *
+ * With the @ref net_gnrc_udp_mux module, the response is handled on the
+ * thread of the multiplexer instead of a sock of its own.
+ *
  * @param[in] server    The time server
  * @param[in] timeout   Timeout for the server response in microseconds
  *
  * @return 0 on success
+ * @return -ETIMEDOUT, if the server did not respond in time
  * @return Negative number on error
  */
 int sntp_sync(sock_udp_ep_t *server, uint32_t timeout);
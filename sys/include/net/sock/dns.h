@@ -12,6 +12,24 @@
  *
  * @brief       Sock DNS client
  *
+ * With the `sock_dns_resolver` module, queries go through a resolver thread
+ * that caches the answers and queries asynchronously:
+ *
+ * - positive answers are cached for the TTL of their records, negative
+ *   answers (the name or the record does not exist) for the TTL of the SOA
+ *   record of the reply, at most for its MINIMUM field and
+ *   @ref SOCK_DNS_CACHE_NEG_TTL seconds. Negative answers without an SOA
+ *   record are not cached.
+ * - requests for a name and record type that is already queried wait for the
+ *   same query, so a server sees each query once
+ * - @ref sock_dns_query_async() returns at once and reports the result to a
+ *   callback, @ref sock_dns_query() waits for it
+ * - queries for AF_UNSPEC send the queries for the AAAA and the A record in
+ *   parallel
+ * - a query that is not answered within @ref SOCK_DNS_TIMEOUT is repeated to
+ *   the next server of @ref sock_dns_server and @ref sock_dns_fallback, for
+ *   @ref SOCK_DNS_RETRIES rounds over all servers
+ *
  * @{
  *
  * @file
@@ -28,6 +46,9 @@
 #include <unistd.h>
 
 #include "net/sock/udp.h"
+#ifdef MODULE_SOCK_DNS_RESOLVER
+#include "thread.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -61,6 +82,136 @@ typedef struct {
 #define SOCK_DNS_QUERYBUF_LEN   (sizeof(sock_dns_hdr_t) + 4 + SOCK_DNS_MAX_NAME_LEN)
 /** @} */
 
+#if defined(MODULE_SOCK_DNS_RESOLVER) || defined(DOXYGEN)
+/**
+ * @name Resolver configuration
+ * @{
+ */
+#ifndef SOCK_DNS_TIMEOUT
+/**
+ * @brief   Time to wait for the answer of a server in microseconds
+ */
+#define SOCK_DNS_TIMEOUT            (1000000U)
+#endif
+
+#ifndef SOCK_DNS_FALLBACK_NUMOF
+/**
+ * @brief   Number of fallback servers in @ref sock_dns_fallback
+ */
+#define SOCK_DNS_FALLBACK_NUMOF     (1U)
+#endif
+
+#ifndef SOCK_DNS_CACHE_SIZE
+/**
+ * @brief   Number of answers the cache holds
+ *
+ * An answer is the address of a single name and record type.
+ */
+#define SOCK_DNS_CACHE_SIZE         (8U)
+#endif
+
+#ifndef SOCK_DNS_CACHE_NEG_TTL
+/**
+ * @brief   Maximum time to cache negative answers in seconds
+ */
+#define SOCK_DNS_CACHE_NEG_TTL      (60U)
+#endif
+
+#ifndef SOCK_DNS_QUERIES_NUMOF
+/**
+ * @brief   Number of queries in flight
+ *
+ * A request for AF_UNSPEC needs two queries.
+ */
+#define SOCK_DNS_QUERIES_NUMOF      (4U)
+#endif
+
+#ifndef SOCK_DNS_RESOLVER_PRIO
+/**
+ * @brief   Priority of the resolver thread
+ */
+#define SOCK_DNS_RESOLVER_PRIO      (THREAD_PRIORITY_MAIN - 1)
+#endif
+
+#ifndef SOCK_DNS_RESOLVER_STACKSIZE
+/**
+ * @brief   Stack size of the resolver thread, the callbacks run on it
+ */
+#define SOCK_DNS_RESOLVER_STACKSIZE (THREAD_STACKSIZE_DEFAULT)
+#endif
+/** @} */
+
+/**
+ * @brief   Request of an asynchronous query
+ */
+typedef struct sock_dns_req sock_dns_req_t;
+
+/**
+ * @brief   Callback for the result of an asynchronous query
+ *
+ * @param[in] req       the request
+ * @param[in] res       length of @p addr (4 or 16) on success,
+ *                      -ENOENT if the name has no address of the requested
+ *                      family, -ETIMEDOUT if no server answered
+ * @param[in] addr      the address, only valid during the callback
+ */
+typedef void (*sock_dns_cb_t)(sock_dns_req_t *req, int res, const void *addr);
+
+/**
+ * @brief   Request of an asynchronous query
+ *
+ * All fields are internal, except for @p arg.
+ */
+struct sock_dns_req {
+    sock_dns_req_t *next;   /**< next pending request */
+    sock_dns_cb_t cb;       /**< callback for the result */
+    void *arg;              /**< user supplied argument */
+    int res4;               /**< result of the A query */
+    int res6;               /**< result of the AAAA query */
+    uint8_t addr[16];       /**< address to report */
+    uint8_t q4;             /**< A query waited for, 0 for none */
+    uint8_t q6;             /**< AAAA query waited for, 0 for none */
+};
+
+/**
+ * @brief   Start the resolver thread
+ *
+ * Called by auto_init.
+ *
+ * @return  PID of the resolver thread
+ */
+kernel_pid_t sock_dns_resolver_init(void);
+
+/**
+ * @brief   Get the IP address for a DNS name asynchronously
+ *
+ * Calls @p cb from the resolver thread when the address is known. If the
+ * answer is cached, @p cb is called before this function returns. If both A
+ * and AAAA records are requested, AAAA records are preferred.
+ *
+ * @param[out] req          request, must stay valid until @p cb is called
+ * @param[in] domain_name   DNS name to resolve
+ * @param[in] family        AF_INET, AF_INET6 or AF_UNSPEC
+ * @param[in] cb            callback for the result
+ * @param[in] arg           user supplied argument, stored in @p req
+ *
+ * @return  0 if @p cb is or will be called
+ * @return  -ENOTCONN if the resolver thread is not running
+ * @return  -ECONNREFUSED if no DNS server is configured
+ * @return  -ENOSPC if @p domain_name is too long
+ * @return  -EINVAL if @p domain_name is not a valid name
+ * @return  -EAFNOSUPPORT if @p family is not supported
+ * @return  -ENOMEM if there are not enough free query slots
+ */
+int sock_dns_query_async(sock_dns_req_t *req, const char *domain_name,
+                         int family, sock_dns_cb_t cb, void *arg);
+
+/**
+ * @brief   Remove all answers from the cache
+ */
+void sock_dns_cache_flush(void);
+#endif /* MODULE_SOCK_DNS_RESOLVER || DOXYGEN */
+
 /**
  * @brief Get IP address for DNS name
  *
@@ -73,6 +224,10 @@ typedef struct {
  * This function will return the first DNS record it receives. IF both A and
  * AAAA are requested, AAAA will be preferred.
  *
+ * With the `sock_dns_resolver` module, the answer is taken from the cache if
+ * possible. This function must not be called from the callback of
+ * @ref sock_dns_query_async().
+ *
  * @note @p addr_out needs to provide space for any possible result!
  *       (4byte when family==AF_INET, 16byte otherwise)
  *
@@ -80,8 +235,8 @@ typedef struct {
  * @param[out]  addr_out        buffer to write result into
  * @param[in]   family          Either AF_INET, AF_INET6 or AF_UNSPEC
  *
- * @return      0 on success
- * @return      !=0 otherwise
+ * @return      length of the address (4 or 16) on success
+ * @return      <0 otherwise
  */
 int sock_dns_query(const char *domain_name, void *addr_out, int family);
 
@@ -90,6 +245,15 @@ int sock_dns_query(const char *domain_name, void *addr_out, int family);
  */
 extern sock_udp_ep_t sock_dns_server;
 
+#if defined(MODULE_SOCK_DNS_RESOLVER) || defined(DOXYGEN)
+/**
+ * @brief   DNS servers to ask if @ref sock_dns_server does not answer
+ *
+ * Entries with port 0 are not used.
+ */
+extern sock_udp_ep_t sock_dns_fallback[SOCK_DNS_FALLBACK_NUMOF];
+#endif
+
 #ifdef __cplusplus
 }
 #endif
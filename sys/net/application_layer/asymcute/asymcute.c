@@ -18,11 +18,13 @@
  * @}
  */
 
+#include <errno.h>
 #include <limits.h>
 
 #include "log.h"
 #include "random.h"
 #include "byteorder.h"
+#include "xtimer.h"
 
 #include "net/asymcute.h"
 
@@ -65,7 +67,7 @@ static event_queue_t _queue;
 static char _stack[ASYMCUTE_HANDLER_STACKSIZE];
 
 /* necessary forward function declarations */
-static void _on_req_timeout(void *arg);
+static unsigned _on_pub_timeout(asymcute_con_t *con, asymcute_req_t *req);
 
 static size_t _len_set(uint8_t *buf, size_t len)
 {
@@ -132,7 +134,6 @@ static asymcute_req_t *_req_preprocess(asymcute_con_t *con,
 
     if (res) {
         res->con = NULL;
-        event_timeout_clear(&res->to_timer);
     }
     return res;
 }
@@ -168,9 +169,10 @@ static void _compile_sub_unsub(asymcute_req_t *req, asymcute_con_t *con,
     req->arg = (void *)sub;
 }
 
+/* @pre con is locked */
 static void _req_resend(asymcute_req_t *req, asymcute_con_t *con)
 {
-    event_timeout_set(&req->to_timer, RETRY_TO);
+    req->timeout = xtimer_now_usec() + RETRY_TO;
     sock_udp_send(&con->sock, req->data, req->data_len, &con->server_ep);
 }
 
@@ -182,8 +184,11 @@ static void _req_send(asymcute_req_t *req, asymcute_con_t *con,
     req->con = con;
     req->cb = cb;
     req->retry_cnt = ASYMCUTE_N_RETRY;
-    event_callback_init(&req->to_evt, _on_req_timeout, (void *)req);
-    event_timeout_init(&req->to_timer, &_queue, &req->to_evt.super);
+    /* the retransmission timer is already set for an earlier request, if
+     * there is any pending */
+    if (con->pending == NULL) {
+        event_timeout_set(&con->retry_timer, RETRY_TO);
+    }
     /* add request to the pending queue (if non-con request) */
     req->next = con->pending;
     con->pending = req;
@@ -191,6 +196,38 @@ static void _req_send(asymcute_req_t *req, asymcute_con_t *con,
     _req_resend(req, con);
 }
 
+/* @pre con is locked */
+static void _pub_send(asymcute_req_t *req, asymcute_con_t *con)
+{
+    con->inflight++;
+    _req_send(req, con, _on_pub_timeout);
+}
+
+/* send queued PUBLISH messages as far as the window allows
+ * @pre con is locked */
+static void _pub_next(asymcute_con_t *con)
+{
+    while (con->queue && (con->inflight < ASYMCUTE_PUBLISH_WINDOW)) {
+        asymcute_req_t *req = con->queue;
+        con->queue = req->next;
+        _pub_send(req, con);
+    }
+}
+
+/* @pre con is locked */
+static void _pub_enqueue(asymcute_req_t *req, asymcute_con_t *con)
+{
+    asymcute_req_t **tail = &con->queue;
+
+    /* keep the order of the messages */
+    while (*tail) {
+        tail = &(*tail)->next;
+    }
+    req->con = con;
+    req->next = NULL;
+    *tail = req;
+}
+
 static void _req_send_once(asymcute_req_t *req, asymcute_con_t *con)
 {
     sock_udp_send(&con->sock, req->data, req->data_len, &con->server_ep);
@@ -200,12 +237,25 @@ static void _req_send_once(asymcute_req_t *req, asymcute_con_t *con)
 static void _req_cancel(asymcute_req_t *req)
 {
     asymcute_con_t *con = req->con;
-    event_timeout_clear(&req->to_timer);
     req->con = NULL;
     mutex_unlock(&req->lock);
     con->user_cb(req, ASYMCUTE_CANCELED);
 }
 
+static inline bool _sub_has_filter(const asymcute_sub_t *sub)
+{
+    return ((sub->topic->flags & MQTTSN_TIT_MASK) == MQTTSN_TIT_NORMAL);
+}
+
+/* @pre con is locked */
+static void _sub_forget(asymcute_con_t *con, asymcute_sub_t *sub)
+{
+    if (_sub_has_filter(sub)) {
+        mqttsn_trie_del(&con->filters, sub->topic->name);
+    }
+    mqttsn_tid_map_del_ctx(&con->tids, sub);
+}
+
 static void _sub_cancel(asymcute_sub_t *sub)
 {
     sub->cb(sub, ASYMCUTE_CANCELED, NULL, 0, sub->arg);
@@ -216,38 +266,70 @@ static void _sub_cancel(asymcute_sub_t *sub)
 static void _disconnect(asymcute_con_t *con, uint8_t state)
 {
     if (con->state == CONNECTED) {
-        /* cancel all pending requests */
+        /* cancel all pending and queued requests */
         event_timeout_clear(&con->keepalive_timer);
+        event_timeout_clear(&con->retry_timer);
         for (asymcute_req_t *req = con->pending; req; req = req->next) {
             _req_cancel(req);
         }
         con->pending = NULL;
+        for (asymcute_req_t *req = con->queue; req; req = req->next) {
+            _req_cancel(req);
+        }
+        con->queue = NULL;
+        con->inflight = 0;
         for (asymcute_sub_t *sub = con->subscriptions; sub; sub = sub->next) {
             _sub_cancel(sub);
         }
         con->subscriptions = NULL;
+        mqttsn_tid_map_init(&con->tids);
+        mqttsn_trie_init(&con->filters);
     }
     con->state = state;
 }
 
-static void _on_req_timeout(void *arg)
+/* resend all requests that are due and find the time until the next one is,
+ * returns a request that timed out after its last retransmission
+ * @pre con is locked */
+static asymcute_req_t *_retry_due(asymcute_con_t *con, uint32_t *next)
 {
-    asymcute_req_t *req = (asymcute_req_t *)arg;
+    uint32_t now = xtimer_now_usec();
 
-    /* only process the timeout, if the request is still active */
-    if (req->con == NULL) {
-        return;
-    }
+    *next = RETRY_TO;
+    for (asymcute_req_t *req = con->pending; req; req = req->next) {
+        int32_t left = (int32_t)(req->timeout - now);
 
-    if (req->retry_cnt--) {
-        /* resend the packet */
-        _req_resend(req, req->con);
-        return;
+        if (left > 0) {
+            if ((uint32_t)left < *next) {
+                *next = left;
+            }
+        }
+        else if (req->retry_cnt) {
+            /* resend the packet, marked as duplicate if it is a PUBLISH */
+            size_t len;
+            size_t pos = _len_get(req->data, &len);
+            if (req->data[pos] == MQTTSN_PUBLISH) {
+                req->data[pos + 1] |= MQTTSN_DUP;
+            }
+            req->retry_cnt--;
+            _req_resend(req, con);
+        }
+        else {
+            _req_remove(con, req);
+            return req;
+        }
     }
-    else {
-        asymcute_con_t *con = req->con;
-        mutex_lock(&con->lock);
-        _req_remove(con, req);
+    return NULL;
+}
+
+static void _on_retry_evt(void *arg)
+{
+    asymcute_con_t *con = (asymcute_con_t *)arg;
+    asymcute_req_t *req;
+    uint32_t next;
+
+    mutex_lock(&con->lock);
+    while ((req = _retry_due(con, &next))) {
         /* communicate timeout to outer world */
         unsigned ret = ASYMCUTE_TIMEOUT;
         if (req->cb) {
@@ -256,7 +338,13 @@ static void _on_req_timeout(void *arg)
         mutex_unlock(&req->lock);
         mutex_unlock(&con->lock);
         con->user_cb(req, ret);
+        mutex_lock(&con->lock);
     }
+    /* one timer for all pending requests, set for the earliest */
+    if (con->pending) {
+        event_timeout_set(&con->retry_timer, next);
+    }
+    mutex_unlock(&con->lock);
 }
 
 static unsigned _on_con_timeout(asymcute_con_t *con, asymcute_req_t *req)
@@ -275,12 +363,21 @@ static unsigned _on_discon_timeout(asymcute_con_t *con, asymcute_req_t *req)
     return ASYMCUTE_DISCONNECTED;
 }
 
-static unsigned _on_suback_timeout(asymcute_con_t *con, asymcute_req_t *req)
+static unsigned _on_pub_timeout(asymcute_con_t *con, asymcute_req_t *req)
 {
-    (void)con;
+    (void)req;
+
+    /* the message leaves the window */
+    con->inflight--;
+    _pub_next(con);
+    return ASYMCUTE_TIMEOUT;
+}
 
+static unsigned _on_suback_timeout(asymcute_con_t *con, asymcute_req_t *req)
+{
     /* reset the subscription context */
     asymcute_sub_t *sub = (asymcute_sub_t *)req->arg;
+    _sub_forget(con, sub);
     sub->topic = NULL;
     return ASYMCUTE_TIMEOUT;
 }
@@ -411,12 +508,10 @@ static void _on_publish(asymcute_con_t *con, uint8_t *data,
 
     /* find any subscription for that topic */
     mutex_lock(&con->lock);
-    asymcute_sub_t *sub = NULL;
-    for (asymcute_sub_t *cur = con->subscriptions; cur; cur = cur->next) {
-        if (cur->topic->id == topic_id) {
-            sub = cur;
-            break;
-        }
+    asymcute_sub_t *sub = mqttsn_tid_map_get(&con->tids, topic_id);
+    if (sub) {
+        /* a subscription with wildcards gets the topic ID of the message */
+        sub->topic->id = topic_id;
     }
 
     /* send PUBACK if needed (QoS > 0 or on invalid topic ID) */
@@ -436,6 +531,34 @@ static void _on_publish(asymcute_con_t *con, uint8_t *data,
     }
 }
 
+static void _on_register(asymcute_con_t *con, const uint8_t *data,
+                         size_t pos, size_t len)
+{
+    /* verify message length */
+    if (len < (pos + 6)) {
+        return;
+    }
+
+    uint16_t topic_id = byteorder_bebuftohs(&data[pos + 1]);
+    uint8_t pkt[7] = { 7, MQTTSN_REGACK, 0, 0, 0, 0, MQTTSN_ACCEPTED };
+    /* copy topic and message id */
+    memcpy(&pkt[2], &data[pos + 1], 4);
+
+    /* the gateway registers names matching a subscription with wildcards */
+    mutex_lock(&con->lock);
+    asymcute_sub_t *sub = mqttsn_trie_match(&con->filters,
+                                            (const char *)&data[pos + 5],
+                                            (len - (pos + 5)));
+    if ((sub == NULL) || (topic_id == 0)) {
+        pkt[6] = MQTTSN_REJ_INV_TOPIC_ID;
+    }
+    else if (mqttsn_tid_map_add(&con->tids, topic_id, sub) < 0) {
+        pkt[6] = MQTTSN_REJ_CONGESTION;
+    }
+    sock_udp_send(&con->sock, pkt, 7, &con->server_ep);
+    mutex_unlock(&con->lock);
+}
+
 static void _on_puback(asymcute_con_t *con, const uint8_t *data, size_t len)
 {
     mutex_lock(&con->lock);
@@ -448,6 +571,10 @@ static void _on_puback(asymcute_con_t *con, const uint8_t *data, size_t len)
 
     unsigned ret = (data[6] == MQTTSN_ACCEPTED) ?
                     ASYMCUTE_PUBLISHED : ASYMCUTE_REJECTED;
+    if (req->cb == _on_pub_timeout) {
+        con->inflight--;
+        _pub_next(con);
+    }
     mutex_unlock(&req->lock);
     mutex_unlock(&con->lock);
     con->user_cb(req, ret);
@@ -464,16 +591,24 @@ static void _on_suback(asymcute_con_t *con, const uint8_t *data, size_t len)
     }
 
     unsigned ret = ASYMCUTE_REJECTED;
-    if (data[7] == MQTTSN_ACCEPTED) {
-        /* parse and apply assigned topic id */
-        asymcute_sub_t *sub = (asymcute_sub_t *)req->arg;
-        sub->topic->id = byteorder_bebuftohs(&data[3]);
+    asymcute_sub_t *sub = (asymcute_sub_t *)req->arg;
+    uint16_t topic_id = byteorder_bebuftohs(&data[3]);
+    /* the topic ID is 0 for topic names with wildcards */
+    if ((data[7] == MQTTSN_ACCEPTED) &&
+        ((topic_id == 0) ||
+         (mqttsn_tid_map_add(&con->tids, topic_id, sub) == 0))) {
+        /* apply assigned topic id */
+        sub->topic->id = topic_id;
         sub->topic->con = con;
         /* insert subscription to connection context */
         sub->next = con->subscriptions;
         con->subscriptions = sub;
         ret = ASYMCUTE_SUBSCRIBED;
     }
+    else {
+        _sub_forget(con, sub);
+        sub->topic = NULL;
+    }
 
     /* notify the user */
     mutex_unlock(&req->lock);
@@ -506,6 +641,7 @@ static void _on_unsuback(asymcute_con_t *con, const uint8_t *data, size_t len)
     }
 
     /* reset subscription context */
+    _sub_forget(con, sub);
     sub->topic = NULL;
 
     /* notify user */
@@ -548,6 +684,9 @@ static void _on_data(asymcute_con_t *con, size_t pkt_len, sock_udp_ep_t *remote)
         case MQTTSN_REGACK:
             _on_regack(con, con->rxbuf, len);
             break;
+        case MQTTSN_REGISTER:
+            _on_register(con, con->rxbuf, pos, len);
+            break;
         case MQTTSN_PUBLISH:
             _on_publish(con, con->rxbuf, pos, len);
             break;
@@ -620,6 +759,10 @@ int asymcute_listener_run(asymcute_con_t *con, char *stack, size_t stacksize,
     random_bytes((uint8_t *)&con->last_id, 2);
     event_callback_init(&con->keepalive_evt, _on_keepalive_evt, con);
     event_timeout_init(&con->keepalive_timer, &_queue, &con->keepalive_evt.super);
+    event_callback_init(&con->retry_evt, _on_retry_evt, con);
+    event_timeout_init(&con->retry_timer, &_queue, &con->retry_evt.super);
+    mqttsn_tid_map_init(&con->tids);
+    mqttsn_trie_init(&con->filters);
     con->keepalive_retry_cnt = ASYMCUTE_N_RETRY;
     con->state = NOTCON;
     con->user_cb = callback;
@@ -779,6 +922,27 @@ end:
     return ret;
 }
 
+/* @pre con and req are locked */
+static void _register(asymcute_con_t *con, asymcute_req_t *req,
+                      asymcute_topic_t *topic)
+{
+    /* prepare topic */
+    req->arg = (void *)topic;
+    size_t topic_len = strlen(topic->name);
+
+    /* prepare registration request */
+    req->msg_id = _msg_id_next(con);
+    size_t pos = _len_set(req->data, (topic_len + 5));
+    req->data[pos] = MQTTSN_REGISTER;
+    byteorder_htobebufs(&req->data[pos + 1], 0);
+    byteorder_htobebufs(&req->data[pos + 3], req->msg_id);
+    memcpy(&req->data[pos + 5], topic->name, topic_len);
+    req->data_len = (pos + 5 + topic_len);
+
+    /* send the request */
+    _req_send(req, con, NULL);
+}
+
 int asymcute_register(asymcute_con_t *con, asymcute_req_t *req,
                       asymcute_topic_t *topic)
 {
@@ -804,21 +968,49 @@ int asymcute_register(asymcute_con_t *con, asymcute_req_t *req,
         goto end;
     }
 
-    /* prepare topic */
-    req->arg = (void *)topic;
-    size_t topic_len = strlen(topic->name);
+    _register(con, req, topic);
 
-    /* prepare registration request */
-    req->msg_id = _msg_id_next(con);
-    size_t pos = _len_set(req->data, (topic_len + 5));
-    req->data[pos] = MQTTSN_REGISTER;
-    byteorder_htobebufs(&req->data[pos + 1], 0);
-    byteorder_htobebufs(&req->data[pos + 3], req->msg_id);
-    memcpy(&req->data[pos + 5], topic->name, topic_len);
-    req->data_len = (pos + 5 + topic_len);
+end:
+    mutex_unlock(&con->lock);
+    return ret;
+}
 
-    /* send the request */
-    _req_send(req, con, NULL);
+int asymcute_register_batch(asymcute_con_t *con, asymcute_req_t *reqs,
+                            asymcute_topic_t *topics, size_t numof)
+{
+    assert(con);
+    assert(reqs || (numof == 0));
+    assert(topics || (numof == 0));
+
+    int ret = ASYMCUTE_OK;
+    size_t locked = 0;
+
+    /* test if any topic is already registered */
+    for (size_t i = 0; i < numof; i++) {
+        if (asymcute_topic_is_reg(&topics[i])) {
+            return ASYMCUTE_REGERR;
+        }
+    }
+    /* make sure we are connected */
+    mutex_lock(&con->lock);
+    if (!asymcute_is_connected(con)) {
+        ret = ASYMCUTE_GWERR;
+        goto end;
+    }
+    /* get mutual access to all request contexts before sending anything */
+    for (; locked < numof; locked++) {
+        if (mutex_trylock(&reqs[locked].lock) != 1) {
+            while (locked--) {
+                mutex_unlock(&reqs[locked].lock);
+            }
+            ret = ASYMCUTE_BUSY;
+            goto end;
+        }
+    }
+
+    for (size_t i = 0; i < numof; i++) {
+        _register(con, &reqs[i], &topics[i]);
+    }
 
 end:
     mutex_unlock(&con->lock);
@@ -872,9 +1064,15 @@ int asymcute_publish(asymcute_con_t *con, asymcute_req_t *req,
     memcpy(&req->data[pos + 6], data, data_len);
     req->data_len = (pos + 6 + data_len);
 
-    /* publish selected data */
+    /* publish selected data, QoS 1 messages only as the window allows */
     if (flags & MQTTSN_QOS_1) {
-        _req_send(req, con, NULL);
+        if ((con->queue == NULL) &&
+            (con->inflight < ASYMCUTE_PUBLISH_WINDOW)) {
+            _pub_send(req, con);
+        }
+        else {
+            _pub_enqueue(req, con);
+        }
     }
     else {
         _req_send_once(req, con);
@@ -911,9 +1109,11 @@ int asymcute_subscribe(asymcute_con_t *con, asymcute_req_t *req,
         ret = ASYMCUTE_GWERR;
         goto end;
     }
-    /* check if we are already subscribed to the given topic */
+    /* check if we are already subscribed to the given topic, the filters
+     * catch this for topic names */
     for (asymcute_sub_t *sub = con->subscriptions; sub; sub = sub->next) {
-        if (asymcute_topic_equal(topic, sub->topic)) {
+        if (((topic->flags & MQTTSN_TIT_MASK) != MQTTSN_TIT_NORMAL) &&
+            asymcute_topic_equal(topic, sub->topic)) {
             ret = ASYMCUTE_SUBERR;
             goto end;
         }
@@ -924,6 +1124,16 @@ int asymcute_subscribe(asymcute_con_t *con, asymcute_req_t *req,
         goto end;
     }
 
+    /* add the filter first, so no REGISTER for it gets lost */
+    if ((topic->flags & MQTTSN_TIT_MASK) == MQTTSN_TIT_NORMAL) {
+        int res = mqttsn_trie_add(&con->filters, topic->name, sub);
+        if (res < 0) {
+            mutex_unlock(&req->lock);
+            ret = (res == -ENOMEM) ? ASYMCUTE_OVERFLOW : ASYMCUTE_SUBERR;
+            goto end;
+        }
+    }
+
     /* prepare subscription context */
     sub->cb = callback;
     sub->arg = arg;
@@ -0,0 +1,1215 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_cord_rd
+ * @{
+ *
+ * @file
+ * @brief       CoRE Resource Directory server implementation
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fmt.h"
+#include "mutex.h"
+#include "net/cord/rd.h"
+#include "net/gcoap.h"
+#include "net/ipv6/addr.h"
+#include "xtimer.h"
+
+#define ENABLE_DEBUG        (0)
+#include "debug.h"
+
+/* end of a list of indices */
+#define NIL                 (UINT16_MAX)
+#define TAGS_NUMOF          (CORD_RD_RES_NUMOF * CORD_RD_RES_ATTRS)
+
+#if (CORD_RD_EP_NUMOF >= UINT16_MAX) || (TAGS_NUMOF >= UINT16_MAX)
+#error "cord_rd: too many registrations or links for 16-bit indices"
+#endif
+#if (CORD_RD_HASH_SIZE & (CORD_RD_HASH_SIZE - 1)) != 0
+#error "cord_rd: CORD_RD_HASH_SIZE must be a power of two"
+#endif
+
+/* location of a registration, the prefix and an ID */
+#define LOC_PREFIX          "/rd/"
+#define LOC_PREFIX_LEN      (sizeof(LOC_PREFIX) - 1)
+#define LOC_LEN             (LOC_PREFIX_LEN + 11)
+
+enum {
+    ATTR_RT,
+    ATTR_IF,
+};
+
+/* an rt or if value, with the list of the links that have it */
+typedef struct {
+    char value[CORD_RD_ATTR_LEN + 1];
+    uint16_t refs;          /* links that have the value, 0 if unused */
+    uint16_t head;          /* first tag of the list */
+    uint8_t type;
+} _attr_t;
+
+/* an rt or if value of a link, in the list of its value */
+typedef struct {
+    uint16_t attr;          /* NIL if unused */
+    uint16_t prev;
+    uint16_t next;
+} _tag_t;
+
+typedef struct {
+    char path[CORD_RD_PATH_LEN + 1];
+    uint16_t ep;
+    uint16_t next;          /* next link of the endpoint, or next free one */
+    uint16_t ct;
+    bool obs;
+} _res_t;
+
+typedef struct {
+    char name[CORD_RD_EP_LEN + 1];
+    char d[CORD_RD_D_LEN + 1];
+    sock_udp_ep_t base;
+    uint32_t lt;
+    uint32_t expires;       /* in seconds */
+    uint16_t gen;           /* part of the ID, changes when the slot is reused */
+    uint16_t next;          /* next in the bucket, or next free one */
+    uint16_t res;           /* first link */
+    uint16_t mark;          /* last lookup that listed it */
+    bool used;
+} _ep_t;
+
+typedef ssize_t (*_lookup_t)(const cord_rd_filter_t *filter, size_t offset,
+                             char *buf, size_t len);
+
+/* a lookup request, copied out of the request for gcoap_block2_resp() */
+typedef struct {
+    cord_rd_filter_t filter;
+    _lookup_t lookup;
+    /* values of the filter, with room for a trailing '*' */
+    char ep[CORD_RD_EP_LEN + 2];
+    char d[CORD_RD_D_LEN + 2];
+    char rt[CORD_RD_ATTR_LEN + 2];
+    char iface[CORD_RD_ATTR_LEN + 2];
+    char href[CORD_RD_PATH_LEN + 2];
+} _query_t;
+
+/* result of a lookup, of which the part at offset is written to buf */
+typedef struct {
+    char *buf;
+    size_t offset;
+    size_t len;
+    size_t pos;             /* position in the result */
+    unsigned skip;          /* entries before the page */
+    unsigned left;          /* entries left to write */
+} _out_t;
+
+static ssize_t _rd_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                           void *ctx);
+static ssize_t _lookup_ep_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                                  void *ctx);
+static ssize_t _lookup_res_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                                   void *ctx);
+
+/* in alphabetical order, "/rd" first for the discovery by cord_ep */
+static const coap_resource_t _resources[] = {
+    { "/rd", COAP_POST | COAP_DELETE | COAP_MATCH_SUBTREE, _rd_handler, NULL },
+    { "/rd-lookup/ep", COAP_GET, _lookup_ep_handler, NULL },
+    { "/rd-lookup/res", COAP_GET, _lookup_res_handler, NULL },
+};
+
+static gcoap_listener_t _listener = {
+    &_resources[0],
+    sizeof(_resources) / sizeof(_resources[0]),
+    NULL
+};
+
+static _ep_t _eps[CORD_RD_EP_NUMOF];
+static _res_t _res[CORD_RD_RES_NUMOF];
+/* the tags of link i are at i * CORD_RD_RES_ATTRS */
+static _tag_t _tags[TAGS_NUMOF];
+static _attr_t _attrs[CORD_RD_ATTR_NUMOF];
+static uint16_t _buckets[CORD_RD_HASH_SIZE];
+static uint16_t _ep_free;
+static uint16_t _res_free;
+static uint16_t _mark;
+static mutex_t _lock = MUTEX_INIT;
+
+static uint32_t _now(void)
+{
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC);
+}
+
+static uint32_t _expires(uint32_t now, uint32_t lt)
+{
+    return (lt > (UINT32_MAX - now)) ? UINT32_MAX : now + lt;
+}
+
+static unsigned _hash(const char *name)
+{
+    unsigned hash = 5381;
+
+    while (*name) {
+        hash = (hash * 33) ^ (uint8_t)*name++;
+    }
+    return hash & (CORD_RD_HASH_SIZE - 1);
+}
+
+static unsigned _id(uint16_t ep)
+{
+    return (_eps[ep].gen * CORD_RD_EP_NUMOF) + ep;
+}
+
+static bool _expired(const _ep_t *ep, uint32_t now)
+{
+    return now >= ep->expires;
+}
+
+/*
+ * Attributes and their lists of links
+ */
+
+static uint16_t _attr_find(uint8_t type, const char *value, size_t len)
+{
+    for (uint16_t i = 0; i < CORD_RD_ATTR_NUMOF; i++) {
+        _attr_t *attr = &_attrs[i];
+
+        if ((attr->refs > 0) && (attr->type == type) &&
+            (strlen(attr->value) == len) &&
+            (memcmp(attr->value, value, len) == 0)) {
+            return i;
+        }
+    }
+    return NIL;
+}
+
+static uint16_t _attr_get(uint8_t type, const char *value, size_t len)
+{
+    uint16_t i = _attr_find(type, value, len);
+
+    if (i != NIL) {
+        return i;
+    }
+    for (i = 0; i < CORD_RD_ATTR_NUMOF; i++) {
+        _attr_t *attr = &_attrs[i];
+
+        if (attr->refs == 0) {
+            memcpy(attr->value, value, len);
+            attr->value[len] = '\0';
+            attr->type = type;
+            attr->head = NIL;
+            return i;
+        }
+    }
+    return NIL;
+}
+
+static void _tag_add(uint16_t tag, uint16_t attr)
+{
+    _tag_t *t = &_tags[tag];
+
+    t->attr = attr;
+    t->prev = NIL;
+    t->next = _attrs[attr].head;
+    if (t->next != NIL) {
+        _tags[t->next].prev = tag;
+    }
+    _attrs[attr].head = tag;
+    _attrs[attr].refs++;
+}
+
+static void _tag_del(uint16_t tag)
+{
+    _tag_t *t = &_tags[tag];
+    _attr_t *attr = &_attrs[t->attr];
+
+    if (t->prev != NIL) {
+        _tags[t->prev].next = t->next;
+    }
+    else {
+        attr->head = t->next;
+    }
+    if (t->next != NIL) {
+        _tags[t->next].prev = t->prev;
+    }
+    attr->refs--;
+    t->attr = NIL;
+}
+
+/*
+ * Links
+ */
+
+static void _free_links(uint16_t res)
+{
+    while (res != NIL) {
+        uint16_t next = _res[res].next;
+
+        for (unsigned i = 0; i < CORD_RD_RES_ATTRS; i++) {
+            if (_tags[(res * CORD_RD_RES_ATTRS) + i].attr != NIL) {
+                _tag_del((res * CORD_RD_RES_ATTRS) + i);
+            }
+        }
+        _res[res].next = _res_free;
+        _res_free = res;
+        res = next;
+    }
+}
+
+static bool _name_is(const char *name, size_t len, const char *str)
+{
+    return (strlen(str) == len) && (memcmp(name, str, len) == 0);
+}
+
+/* adds the space separated values of an rt or if attribute to a link */
+static int _add_attrs(uint16_t res, uint8_t type, const char *value,
+                      size_t len)
+{
+    const char *end = value + len;
+    _tag_t *tags = &_tags[res * CORD_RD_RES_ATTRS];
+
+    while (value < end) {
+        const char *token = value;
+        unsigned slot = CORD_RD_RES_ATTRS;
+        uint16_t attr;
+
+        while ((value < end) && (*value != ' ')) {
+            value++;
+        }
+        len = value - token;
+        if (value < end) {
+            value++;
+        }
+        if (len == 0) {
+            continue;
+        }
+        if (len > CORD_RD_ATTR_LEN) {
+            return -ENOSPC;
+        }
+        attr = _attr_get(type, token, len);
+        if (attr == NIL) {
+            return -ENOMEM;
+        }
+        for (unsigned i = 0; i < CORD_RD_RES_ATTRS; i++) {
+            if (tags[i].attr == attr) {
+                /* a value only once */
+                slot = CORD_RD_RES_ATTRS + 1;
+                break;
+            }
+            if ((tags[i].attr == NIL) && (slot == CORD_RD_RES_ATTRS)) {
+                slot = i;
+            }
+        }
+        if (slot == CORD_RD_RES_ATTRS) {
+            return -ENOSPC;
+        }
+        if (slot < CORD_RD_RES_ATTRS) {
+            _tag_add((res * CORD_RD_RES_ATTRS) + slot, attr);
+        }
+    }
+    return 0;
+}
+
+static int _add_param(uint16_t res, const char *name, size_t name_len,
+                      const char *value, size_t len)
+{
+    if (_name_is(name, name_len, "rt")) {
+        return _add_attrs(res, ATTR_RT, value, len);
+    }
+    if (_name_is(name, name_len, "if")) {
+        return _add_attrs(res, ATTR_IF, value, len);
+    }
+    if (_name_is(name, name_len, "ct") && (len > 0) &&
+        (*value >= '0') && (*value <= '9')) {
+        /* the first of several formats */
+        uint32_t ct = 0;
+
+        while ((len-- > 0) && (*value >= '0') && (*value <= '9')) {
+            ct = (ct * 10) + (*value++ - '0');
+        }
+        _res[res].ct = (ct < COAP_FORMAT_NONE) ? ct : COAP_FORMAT_NONE;
+    }
+    else if (_name_is(name, name_len, "obs")) {
+        _res[res].obs = true;
+    }
+    return 0;
+}
+
+static uint16_t _res_alloc(void);
+
+/*
+ * Parses links in link-format (RFC 6690) into a new list of links of ep. On
+ * error, head holds the links parsed so far.
+ */
+static int _parse_links(uint16_t ep, const char *pos, const char *end,
+                        uint16_t *head)
+{
+    uint16_t *tail = head;
+
+    *head = NIL;
+    while (pos < end) {
+        const char *path;
+        size_t len;
+        uint16_t res;
+
+        if (*pos != '<') {
+            return -EINVAL;
+        }
+        path = ++pos;
+        pos = memchr(pos, '>', end - pos);
+        if (pos == NULL) {
+            return -EINVAL;
+        }
+        len = pos++ - path;
+        if (len > CORD_RD_PATH_LEN) {
+            return -ENOSPC;
+        }
+        res = _res_alloc();
+        if (res == NIL) {
+            return -ENOMEM;
+        }
+        memcpy(_res[res].path, path, len);
+        _res[res].path[len] = '\0';
+        _res[res].ep = ep;
+        _res[res].next = NIL;
+        _res[res].ct = COAP_FORMAT_NONE;
+        _res[res].obs = false;
+        *tail = res;
+        tail = &_res[res].next;
+
+        while ((pos < end) && (*pos == ';')) {
+            const char *name = ++pos;
+            const char *value = NULL;
+            size_t name_len;
+            int err;
+
+            while ((pos < end) && (*pos != '=') && (*pos != ';') &&
+                   (*pos != ',')) {
+                pos++;
+            }
+            name_len = pos - name;
+            len = 0;
+            if ((pos < end) && (*pos == '=')) {
+                if ((++pos < end) && (*pos == '"')) {
+                    value = ++pos;
+                    pos = memchr(pos, '"', end - pos);
+                    if (pos == NULL) {
+                        return -EINVAL;
+                    }
+                    len = pos++ - value;
+                }
+                else {
+                    value = pos;
+                    while ((pos < end) && (*pos != ';') && (*pos != ',')) {
+                        pos++;
+                    }
+                    len = pos - value;
+                }
+            }
+            err = _add_param(res, name, name_len, value, len);
+            if (err < 0) {
+                return err;
+            }
+        }
+        if (pos < end) {
+            if (*pos != ',') {
+                return -EINVAL;
+            }
+            pos++;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Registrations
+ */
+
+static void _ep_free_slot(uint16_t ep)
+{
+    _ep_t *e = &_eps[ep];
+
+    for (uint16_t *prev = &_buckets[_hash(e->name)]; *prev != NIL;
+         prev = &_eps[*prev].next) {
+        if (*prev == ep) {
+            *prev = e->next;
+            break;
+        }
+    }
+    _free_links(e->res);
+    e->res = NIL;
+    e->used = false;
+    e->gen++;
+    e->next = _ep_free;
+    _ep_free = ep;
+}
+
+/* reclaims the expired registrations */
+static void _expire(void)
+{
+    uint32_t now = _now();
+
+    for (uint16_t i = 0; i < CORD_RD_EP_NUMOF; i++) {
+        if (_eps[i].used && _expired(&_eps[i], now)) {
+            DEBUG("cord_rd: registration %u expired\n", _id(i));
+            _ep_free_slot(i);
+        }
+    }
+}
+
+static uint16_t _ep_alloc(void)
+{
+    if (_ep_free == NIL) {
+        _expire();
+    }
+    uint16_t ep = _ep_free;
+    if (ep != NIL) {
+        _ep_free = _eps[ep].next;
+    }
+    return ep;
+}
+
+static uint16_t _res_alloc(void)
+{
+    if (_res_free == NIL) {
+        _expire();
+    }
+    uint16_t res = _res_free;
+    if (res != NIL) {
+        _res_free = _res[res].next;
+    }
+    return res;
+}
+
+static uint16_t _ep_find(const char *name, const char *d)
+{
+    for (uint16_t ep = _buckets[_hash(name)]; ep != NIL; ep = _eps[ep].next) {
+        if ((strcmp(_eps[ep].name, name) == 0) &&
+            (strcmp(_eps[ep].d, d) == 0)) {
+            return ep;
+        }
+    }
+    return NIL;
+}
+
+static uint16_t _ep_from_id(unsigned id, uint32_t now)
+{
+    uint16_t ep = id % CORD_RD_EP_NUMOF;
+
+    if (!_eps[ep].used || (_eps[ep].gen != (id / CORD_RD_EP_NUMOF)) ||
+        _expired(&_eps[ep], now)) {
+        return NIL;
+    }
+    return ep;
+}
+
+void cord_rd_init(void)
+{
+    mutex_lock(&_lock);
+    for (uint16_t i = 0; i < CORD_RD_EP_NUMOF; i++) {
+        _eps[i].used = false;
+        _eps[i].next = ((i + 1U) < CORD_RD_EP_NUMOF) ? (i + 1) : NIL;
+    }
+    for (uint16_t i = 0; i < CORD_RD_RES_NUMOF; i++) {
+        _res[i].next = ((i + 1U) < CORD_RD_RES_NUMOF) ? (i + 1) : NIL;
+    }
+    for (uint16_t i = 0; i < TAGS_NUMOF; i++) {
+        _tags[i].attr = NIL;
+    }
+    for (uint16_t i = 0; i < CORD_RD_ATTR_NUMOF; i++) {
+        _attrs[i].refs = 0;
+    }
+    for (unsigned i = 0; i < CORD_RD_HASH_SIZE; i++) {
+        _buckets[i] = NIL;
+    }
+    _ep_free = 0;
+    _res_free = 0;
+    mutex_unlock(&_lock);
+
+    gcoap_register_listener(&_listener);
+}
+
+int cord_rd_register(const char *ep, const char *d, uint32_t lt,
+                     const sock_udp_ep_t *base, const char *links,
+                     size_t len)
+{
+    assert((ep != NULL) && (base != NULL));
+    assert((links != NULL) || (len == 0));
+
+    uint32_t now = _now();
+    uint16_t i, head;
+    bool created = false;
+    int res;
+
+    if (d == NULL) {
+        d = "";
+    }
+    if (*ep == '\0') {
+        return -EINVAL;
+    }
+    if ((strlen(ep) > CORD_RD_EP_LEN) || (strlen(d) > CORD_RD_D_LEN)) {
+        return -ENOSPC;
+    }
+    if (lt == 0) {
+        lt = CORD_RD_LT_DEFAULT;
+    }
+
+    mutex_lock(&_lock);
+    i = _ep_find(ep, d);
+    if ((i != NIL) && _expired(&_eps[i], now)) {
+        _ep_free_slot(i);
+        i = NIL;
+    }
+    if (i == NIL) {
+        i = _ep_alloc();
+        if (i == NIL) {
+            mutex_unlock(&_lock);
+            return -ENOMEM;
+        }
+        created = true;
+        strcpy(_eps[i].name, ep);
+        strcpy(_eps[i].d, d);
+        /* not expired while its links are parsed */
+        _eps[i].expires = _expires(now, lt);
+        _eps[i].res = NIL;
+        _eps[i].mark = _mark;
+        _eps[i].used = true;
+        _eps[i].next = _buckets[_hash(ep)];
+        _buckets[_hash(ep)] = i;
+    }
+
+    res = _parse_links(i, links, links + len, &head);
+    if (res < 0) {
+        _free_links(head);
+        if (created) {
+            _ep_free_slot(i);
+        }
+        mutex_unlock(&_lock);
+        return res;
+    }
+    _free_links(_eps[i].res);
+    _eps[i].res = head;
+    _eps[i].base = *base;
+    _eps[i].lt = lt;
+    _eps[i].expires = _expires(now, lt);
+    res = _id(i);
+    mutex_unlock(&_lock);
+
+    DEBUG("cord_rd: registered %s as %d\n", ep, res);
+    return res;
+}
+
+int cord_rd_update(unsigned id, uint32_t lt, const char *links, size_t len)
+{
+    uint32_t now = _now();
+    uint16_t ep, head;
+
+    mutex_lock(&_lock);
+    ep = _ep_from_id(id, now);
+    if (ep == NIL) {
+        mutex_unlock(&_lock);
+        return -ENOENT;
+    }
+    if (links != NULL) {
+        int res = _parse_links(ep, links, links + len, &head);
+
+        if (res < 0) {
+            _free_links(head);
+            mutex_unlock(&_lock);
+            return res;
+        }
+        _free_links(_eps[ep].res);
+        _eps[ep].res = head;
+    }
+    if (lt != 0) {
+        _eps[ep].lt = lt;
+    }
+    _eps[ep].expires = _expires(now, _eps[ep].lt);
+    mutex_unlock(&_lock);
+    return 0;
+}
+
+int cord_rd_remove(unsigned id)
+{
+    uint16_t ep;
+
+    mutex_lock(&_lock);
+    ep = _ep_from_id(id, _now());
+    if (ep != NIL) {
+        _ep_free_slot(ep);
+    }
+    mutex_unlock(&_lock);
+    return (ep != NIL) ? 0 : -ENOENT;
+}
+
+/*
+ * Lookups
+ */
+
+/* matches like strcmp(), or as prefix if pattern ends in '*' */
+static bool _match(const char *pattern, const char *value)
+{
+    if (pattern == NULL) {
+        return true;
+    }
+    size_t len = strlen(pattern);
+    if ((len > 0) && (pattern[len - 1] == '*')) {
+        return strncmp(pattern, value, len - 1) == 0;
+    }
+    return strcmp(pattern, value) == 0;
+}
+
+static bool _exact(const char *pattern)
+{
+    size_t len = (pattern != NULL) ? strlen(pattern) : 0;
+
+    return (len > 0) && (pattern[len - 1] != '*');
+}
+
+static bool _res_has(uint16_t res, uint8_t type, const char *pattern)
+{
+    if (pattern == NULL) {
+        return true;
+    }
+    for (unsigned i = 0; i < CORD_RD_RES_ATTRS; i++) {
+        uint16_t attr = _tags[(res * CORD_RD_RES_ATTRS) + i].attr;
+
+        if ((attr != NIL) && (_attrs[attr].type == type) &&
+            _match(pattern, _attrs[attr].value)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool _res_match(const cord_rd_filter_t *filter, uint16_t res)
+{
+    return _res_has(res, ATTR_RT, filter->rt) &&
+           _res_has(res, ATTR_IF, filter->iface);
+}
+
+static size_t _loc(char *loc, unsigned id)
+{
+    size_t len = LOC_PREFIX_LEN;
+
+    memcpy(loc, LOC_PREFIX, len);
+    len += fmt_u32_dec(&loc[len], id);
+    loc[len] = '\0';
+    return len;
+}
+
+static bool _ep_match(const cord_rd_filter_t *filter, uint16_t ep,
+                      uint32_t now)
+{
+    const _ep_t *e = &_eps[ep];
+
+    return e->used && !_expired(e, now) && _match(filter->ep, e->name) &&
+           _match(filter->d, e->d);
+}
+
+/* an endpoint for an endpoint lookup: filters the location, and its links */
+static bool _ep_lookup_match(const cord_rd_filter_t *filter, uint16_t ep,
+                             uint32_t now)
+{
+    if (!_ep_match(filter, ep, now)) {
+        return false;
+    }
+    if (filter->href != NULL) {
+        char loc[LOC_LEN];
+
+        _loc(loc, _id(ep));
+        if (!_match(filter->href, loc)) {
+            return false;
+        }
+    }
+    if ((filter->rt == NULL) && (filter->iface == NULL)) {
+        return true;
+    }
+    for (uint16_t res = _eps[ep].res; res != NIL; res = _res[res].next) {
+        if (_res_match(filter, res)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* picks a value of the filter from the inverted index, returns false if the
+ * filter has none */
+static bool _index(const cord_rd_filter_t *filter, uint16_t *head)
+{
+    uint16_t attr;
+
+    if (_exact(filter->rt)) {
+        attr = _attr_find(ATTR_RT, filter->rt, strlen(filter->rt));
+    }
+    else if (_exact(filter->iface)) {
+        attr = _attr_find(ATTR_IF, filter->iface, strlen(filter->iface));
+    }
+    else {
+        return false;
+    }
+    /* no link has an unknown value */
+    *head = (attr != NIL) ? _attrs[attr].head : NIL;
+    return true;
+}
+
+static void _out_init(_out_t *out, const cord_rd_filter_t *filter,
+                      size_t offset, char *buf, size_t len)
+{
+    out->buf = buf;
+    out->offset = offset;
+    out->len = len;
+    out->pos = 0;
+    out->skip = filter->page * filter->count;
+    out->left = (filter->count > 0) ? filter->count : UINT_MAX;
+}
+
+static bool _out_full(const _out_t *out)
+{
+    return (out->left == 0) || (out->pos >= (out->offset + out->len));
+}
+
+static size_t _out_written(const _out_t *out)
+{
+    if (out->pos <= out->offset) {
+        return 0;
+    }
+    return ((out->pos - out->offset) < out->len) ? (out->pos - out->offset)
+                                                 : out->len;
+}
+
+/* writes the part of str in the window of buf */
+static void _put(_out_t *out, const char *str, size_t len)
+{
+    size_t end = out->offset + out->len;
+
+    if (((out->pos + len) > out->offset) && (out->pos < end)) {
+        size_t from = (out->pos < out->offset) ? (out->offset - out->pos) : 0;
+        size_t to = ((out->pos + len) > end) ? (end - out->pos) : len;
+
+        memcpy(&out->buf[out->pos + from - out->offset], &str[from],
+               to - from);
+    }
+    out->pos += len;
+}
+
+static void _puts(_out_t *out, const char *str)
+{
+    _put(out, str, strlen(str));
+}
+
+static void _put_u32(_out_t *out, uint32_t val)
+{
+    char num[10];
+
+    _put(out, num, fmt_u32_dec(num, val));
+}
+
+static void _put_base(_out_t *out, const sock_udp_ep_t *base)
+{
+    char addr[IPV6_ADDR_MAX_STR_LEN];
+
+    ipv6_addr_to_str(addr, (const ipv6_addr_t *)&base->addr, sizeof(addr));
+    _puts(out, "coap://[");
+    _puts(out, addr);
+    _puts(out, "]:");
+    _put_u32(out, base->port);
+}
+
+/* starts an entry of the result, returns false if it is not on the page */
+static bool _put_entry(_out_t *out)
+{
+    if (out->skip > 0) {
+        out->skip--;
+        return false;
+    }
+    if (out->left != UINT_MAX) {
+        out->left--;
+    }
+    if (out->pos > 0) {
+        _put(out, ",", 1);
+    }
+    return true;
+}
+
+static void _put_ep(_out_t *out, uint16_t ep)
+{
+    const _ep_t *e = &_eps[ep];
+    char loc[LOC_LEN];
+
+    if (!_put_entry(out)) {
+        return;
+    }
+    _put(out, "<", 1);
+    _put(out, loc, _loc(loc, _id(ep)));
+    _puts(out, ">;ep=\"");
+    _puts(out, e->name);
+    if (e->d[0] != '\0') {
+        _puts(out, "\";d=\"");
+        _puts(out, e->d);
+    }
+    _puts(out, "\";base=\"");
+    _put_base(out, &e->base);
+    _puts(out, "\";lt=");
+    _put_u32(out, e->lt);
+}
+
+static void _put_attrs(_out_t *out, uint16_t res, uint8_t type,
+                       const char *name)
+{
+    bool first = true;
+
+    for (unsigned i = 0; i < CORD_RD_RES_ATTRS; i++) {
+        uint16_t attr = _tags[(res * CORD_RD_RES_ATTRS) + i].attr;
+
+        if ((attr == NIL) || (_attrs[attr].type != type)) {
+            continue;
+        }
+        _puts(out, first ? name : " ");
+        _puts(out, _attrs[attr].value);
+        first = false;
+    }
+    if (!first) {
+        _put(out, "\"", 1);
+    }
+}
+
+static void _put_res(_out_t *out, uint16_t res)
+{
+    const _res_t *r = &_res[res];
+    const sock_udp_ep_t *base = &_eps[r->ep].base;
+
+    if (!_put_entry(out)) {
+        return;
+    }
+    _put(out, "<", 1);
+    _put_base(out, base);
+    _puts(out, r->path);
+    _put(out, ">", 1);
+    _put_attrs(out, res, ATTR_RT, ";rt=\"");
+    _put_attrs(out, res, ATTR_IF, ";if=\"");
+    if (r->ct != COAP_FORMAT_NONE) {
+        _puts(out, ";ct=");
+        _put_u32(out, r->ct);
+    }
+    if (r->obs) {
+        _puts(out, ";obs");
+    }
+    _puts(out, ";anchor=\"");
+    _put_base(out, base);
+    _put(out, "\"", 1);
+}
+
+/* a new mark for the endpoints listed by a lookup */
+static uint16_t _next_mark(void)
+{
+    if (++_mark == 0) {
+        for (uint16_t i = 0; i < CORD_RD_EP_NUMOF; i++) {
+            _eps[i].mark = 0;
+        }
+        _mark = 1;
+    }
+    return _mark;
+}
+
+ssize_t cord_rd_lookup_ep(const cord_rd_filter_t *filter, size_t offset,
+                          char *buf, size_t len)
+{
+    assert((filter != NULL) && ((buf != NULL) || (len == 0)));
+
+    uint32_t now = _now();
+    uint16_t tag;
+    _out_t out;
+
+    _out_init(&out, filter, offset, buf, len);
+    mutex_lock(&_lock);
+    if (_exact(filter->ep)) {
+        for (uint16_t ep = _buckets[_hash(filter->ep)];
+             (ep != NIL) && !_out_full(&out); ep = _eps[ep].next) {
+            if (_ep_lookup_match(filter, ep, now)) {
+                _put_ep(&out, ep);
+            }
+        }
+    }
+    else if (_index(filter, &tag)) {
+        /* an endpoint may have several links with the value */
+        uint16_t mark = _next_mark();
+
+        for (; (tag != NIL) && !_out_full(&out); tag = _tags[tag].next) {
+            uint16_t ep = _res[tag / CORD_RD_RES_ATTRS].ep;
+
+            if ((_eps[ep].mark != mark) &&
+                _ep_lookup_match(filter, ep, now)) {
+                _eps[ep].mark = mark;
+                _put_ep(&out, ep);
+            }
+        }
+    }
+    else {
+        for (uint16_t ep = 0; (ep < CORD_RD_EP_NUMOF) && !_out_full(&out);
+             ep++) {
+            if (_ep_lookup_match(filter, ep, now)) {
+                _put_ep(&out, ep);
+            }
+        }
+    }
+    mutex_unlock(&_lock);
+    return _out_written(&out);
+}
+
+static void _put_links(_out_t *out, const cord_rd_filter_t *filter,
+                       uint16_t ep)
+{
+    for (uint16_t res = _eps[ep].res; (res != NIL) && !_out_full(out);
+         res = _res[res].next) {
+        if (_res_match(filter, res) && _match(filter->href, _res[res].path)) {
+            _put_res(out, res);
+        }
+    }
+}
+
+ssize_t cord_rd_lookup_res(const cord_rd_filter_t *filter, size_t offset,
+                           char *buf, size_t len)
+{
+    assert((filter != NULL) && ((buf != NULL) || (len == 0)));
+
+    uint32_t now = _now();
+    uint16_t tag;
+    _out_t out;
+
+    _out_init(&out, filter, offset, buf, len);
+    mutex_lock(&_lock);
+    if (_exact(filter->ep)) {
+        for (uint16_t ep = _buckets[_hash(filter->ep)];
+             (ep != NIL) && !_out_full(&out); ep = _eps[ep].next) {
+            if (_ep_match(filter, ep, now)) {
+                _put_links(&out, filter, ep);
+            }
+        }
+    }
+    else if (_index(filter, &tag)) {
+        for (; (tag != NIL) && !_out_full(&out); tag = _tags[tag].next) {
+            uint16_t res = tag / CORD_RD_RES_ATTRS;
+
+            if (_ep_match(filter, _res[res].ep, now) &&
+                _res_match(filter, res) &&
+                _match(filter->href, _res[res].path)) {
+                _put_res(&out, res);
+            }
+        }
+    }
+    else {
+        for (uint16_t ep = 0; (ep < CORD_RD_EP_NUMOF) && !_out_full(&out);
+             ep++) {
+            if (_ep_match(filter, ep, now)) {
+                _put_links(&out, filter, ep);
+            }
+        }
+    }
+    mutex_unlock(&_lock);
+    return _out_written(&out);
+}
+
+/*
+ * CoAP interface
+ */
+
+/* copies the value of a query parameter, returns its length, -ENOENT if there
+ * is none, or -ENOSPC if it does not fit into value */
+static int _query(const coap_pkt_t *pdu, const char *key, char *value,
+                  size_t len)
+{
+    size_t key_len = strlen(key);
+
+    for (const coap_optpos_t *opt = coap_opt_find(pdu, COAP_OPT_URI_QUERY);
+         opt != NULL; opt = coap_opt_next(pdu, opt)) {
+        const char *param = (const char *)coap_opt_value(pdu, opt);
+
+        if ((opt->len > key_len) && (memcmp(param, key, key_len) == 0) &&
+            (param[key_len] == '=')) {
+            size_t param_len = opt->len - key_len - 1;
+
+            if (param_len >= len) {
+                return -ENOSPC;
+            }
+            memcpy(value, &param[key_len + 1], param_len);
+            value[param_len] = '\0';
+            return param_len;
+        }
+    }
+    return -ENOENT;
+}
+
+static uint32_t _query_u32(const coap_pkt_t *pdu, const char *key)
+{
+    char num[11];
+
+    if (_query(pdu, key, num, sizeof(num)) <= 0) {
+        return 0;
+    }
+    return strtoul(num, NULL, 10);
+}
+
+static ssize_t _error(coap_pkt_t *pdu, uint8_t *buf, size_t len, int res)
+{
+    unsigned code;
+
+    switch (res) {
+        case -ENOENT:
+            code = COAP_CODE_PATH_NOT_FOUND;
+            break;
+        case -ENOSPC:
+            code = COAP_CODE_REQUEST_ENTITY_TOO_LARGE;
+            break;
+        case -ENOMEM:
+            code = COAP_CODE_SERVICE_UNAVAILABLE;
+            break;
+        default:
+            code = COAP_CODE_BAD_REQUEST;
+            break;
+    }
+    return gcoap_response(pdu, buf, len, code);
+}
+
+static ssize_t _register(coap_pkt_t *pdu, uint8_t *buf, size_t len)
+{
+    char ep[CORD_RD_EP_LEN + 1];
+    char d[CORD_RD_D_LEN + 1];
+    char loc[LOC_LEN];
+    int res;
+
+    if (_query(pdu, "ep", ep, sizeof(ep)) <= 0) {
+        return gcoap_response(pdu, buf, len, COAP_CODE_BAD_REQUEST);
+    }
+    res = _query(pdu, "d", d, sizeof(d));
+    if (res == -ENOSPC) {
+        return gcoap_response(pdu, buf, len, COAP_CODE_BAD_REQUEST);
+    }
+    if (res < 0) {
+        d[0] = '\0';
+    }
+    res = cord_rd_register(ep, d, _query_u32(pdu, "lt"), gcoap_req_remote(),
+                           (const char *)pdu->payload, pdu->payload_len);
+    if (res < 0) {
+        return _error(pdu, buf, len, res);
+    }
+
+    _loc(loc, res);
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CREATED);
+    coap_opt_add_string(pdu, COAP_OPT_LOCATION_PATH, loc, '/');
+    return coap_opt_finish(pdu, COAP_OPT_FINISH_NONE);
+}
+
+static ssize_t _rd_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                           void *ctx)
+{
+    (void)ctx;
+    unsigned method = coap_get_code_detail(pdu);
+    unsigned ct = coap_get_content_type(pdu);
+    char path[NANOCOAP_URI_MAX];
+    unsigned long id;
+    char *end;
+    int res;
+
+    if ((ct != COAP_FORMAT_NONE) && (ct != COAP_FORMAT_LINK)) {
+        return gcoap_response(pdu, buf, len,
+                              COAP_CODE_UNSUPPORTED_CONTENT_FORMAT);
+    }
+    if (coap_cmp_uri_path(pdu, "/rd") == 0) {
+        if (method != COAP_METHOD_POST) {
+            return gcoap_response(pdu, buf, len,
+                                  COAP_CODE_METHOD_NOT_ALLOWED);
+        }
+        return _register(pdu, buf, len);
+    }
+
+    /* the location of a registration, "/rd/<ID>" */
+    if (coap_get_uri_path(pdu, (uint8_t *)path) < 0) {
+        return gcoap_response(pdu, buf, len, COAP_CODE_PATH_NOT_FOUND);
+    }
+    id = strtoul(&path[LOC_PREFIX_LEN], &end, 10);
+    if ((path[LOC_PREFIX_LEN] < '0') || (path[LOC_PREFIX_LEN] > '9') ||
+        (*end != '\0')) {
+        return gcoap_response(pdu, buf, len, COAP_CODE_PATH_NOT_FOUND);
+    }
+    if (method == COAP_METHOD_DELETE) {
+        res = cord_rd_remove(id);
+        return (res < 0) ? _error(pdu, buf, len, res)
+                         : gcoap_response(pdu, buf, len, COAP_CODE_DELETED);
+    }
+    res = cord_rd_update(id, _query_u32(pdu, "lt"),
+                         (pdu->payload_len > 0) ? (const char *)pdu->payload
+                                                : NULL,
+                         pdu->payload_len);
+    return (res < 0) ? _error(pdu, buf, len, res)
+                     : gcoap_response(pdu, buf, len, COAP_CODE_CHANGED);
+}
+
+static ssize_t _read(void *arg, size_t offset, uint8_t *buf, size_t len)
+{
+    _query_t *query = arg;
+
+    return query->lookup(&query->filter, offset, (char *)buf, len);
+}
+
+static int _query_filter(const coap_pkt_t *pdu, const char *key,
+                         char *value, size_t len, const char **filter)
+{
+    int res = _query(pdu, key, value, len);
+
+    if (res >= 0) {
+        *filter = value;
+    }
+    return (res == -ENOSPC) ? res : 0;
+}
+
+static ssize_t _lookup(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                       _lookup_t lookup)
+{
+    _query_t query;
+
+    /* the response overwrites the request */
+    memset(&query.filter, 0, sizeof(query.filter));
+    query.lookup = lookup;
+    if ((_query_filter(pdu, "ep", query.ep, sizeof(query.ep),
+                       &query.filter.ep) < 0) ||
+        (_query_filter(pdu, "d", query.d, sizeof(query.d),
+                       &query.filter.d) < 0) ||
+        (_query_filter(pdu, "rt", query.rt, sizeof(query.rt),
+                       &query.filter.rt) < 0) ||
+        (_query_filter(pdu, "if", query.iface, sizeof(query.iface),
+                       &query.filter.iface) < 0) ||
+        (_query_filter(pdu, "href", query.href, sizeof(query.href),
+                       &query.filter.href) < 0)) {
+        return gcoap_response(pdu, buf, len, COAP_CODE_BAD_REQUEST);
+    }
+    query.filter.page = _query_u32(pdu, "page");
+    query.filter.count = _query_u32(pdu, "count");
+
+    return gcoap_block2_resp(pdu, buf, len, COAP_FORMAT_LINK, _read, &query);
+}
+
+static ssize_t _lookup_ep_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                                  void *ctx)
+{
+    (void)ctx;
+    return _lookup(pdu, buf, len, cord_rd_lookup_ep);
+}
+
+static ssize_t _lookup_res_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                                   void *ctx)
+{
+    (void)ctx;
+    return _lookup(pdu, buf, len, cord_rd_lookup_res);
+}
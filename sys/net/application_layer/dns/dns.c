@@ -31,6 +31,9 @@
 /* global DNS server UDP endpoint */
 sock_udp_ep_t sock_dns_server;
 
+/* the resolver provides its own sock_dns_query() */
+#ifndef MODULE_SOCK_DNS_RESOLVER
+
 static ssize_t _enc_domain_name(uint8_t *out, const char *domain_name)
 {
     /*
@@ -195,3 +198,4 @@ out:
     sock_udp_close(&sock_dns);
     return res;
 }
+#endif /* MODULE_SOCK_DNS_RESOLVER */
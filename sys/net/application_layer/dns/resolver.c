@@ -0,0 +1,754 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup net_sock_dns
+ * @{
+ * @file
+ * @brief   Caching DNS resolver with asynchronous queries
+ * @}
+ */
+
+#include <assert.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <string.h>
+#include <strings.h>
+
+#include "byteorder.h"
+#include "msg.h"
+#include "mutex.h"
+#include "net/sock/dns.h"
+#include "net/sock/udp.h"
+#include "net/sock/util.h"
+#include "random.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+/* result of a record type a request does not need */
+#define NOT_REQUESTED       (INT_MIN)
+
+#define FLAGS_QUERY         (0x0100)    /* standard query, recursion desired */
+#define FLAG_RESPONSE       (0x8000)
+#define RCODE_MASK          (0x000f)
+#define RCODE_NOERROR       (0)
+#define RCODE_NXDOMAIN      (3)
+
+#define DNS_TYPE_CNAME      (5)
+#define DNS_TYPE_SOA        (6)
+
+/* a length byte per label and the terminating zero */
+#define NAME_ENC_LEN        (SOCK_DNS_MAX_NAME_LEN + 2)
+#define QUERY_LEN           (sizeof(sock_dns_hdr_t) + NAME_ENC_LEN + 4)
+#define REPLY_LEN           (512U)
+#define LABEL_MAX_LEN       (63U)
+/* TTLs with the most significant bit set count as 0 (RFC 2181) */
+#define TTL_MAX             (INT32_MAX)
+#define QUEUE_SIZE          (4U)
+
+typedef struct {
+    char name[SOCK_DNS_MAX_NAME_LEN + 1];   /* "" for a free slot */
+    uint32_t deadline;                      /* of the current try in us */
+    uint16_t id;
+    uint16_t type;
+    uint8_t tries;
+} _query_t;
+
+typedef struct {
+    char name[SOCK_DNS_MAX_NAME_LEN + 1];
+    uint8_t addr[16];
+    uint32_t expires;                       /* in s */
+    uint16_t type;                          /* 0 for a free entry */
+    uint8_t len;                            /* 0 for a negative answer */
+} _cache_entry_t;
+
+typedef struct {
+    sock_dns_req_t req;
+    mutex_t done;
+    void *addr_out;
+    int res;
+} _sync_t;
+
+sock_udp_ep_t sock_dns_fallback[SOCK_DNS_FALLBACK_NUMOF];
+
+static sock_udp_t _sock;
+static kernel_pid_t _pid = KERNEL_PID_UNDEF;
+static char _stack[SOCK_DNS_RESOLVER_STACKSIZE];
+static msg_t _queue[QUEUE_SIZE];
+static uint8_t _reply[REPLY_LEN];
+
+/* guards the queries, the cache and the pending requests */
+static mutex_t _lock = MUTEX_INIT;
+static _query_t _queries[SOCK_DNS_QUERIES_NUMOF];
+static _cache_entry_t _cache[SOCK_DNS_CACHE_SIZE];
+static sock_dns_req_t *_reqs;
+
+static inline uint32_t _now_s(void)
+{
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC);
+}
+
+static inline uint32_t _get_u32(const uint8_t *buf)
+{
+    return ((uint32_t)byteorder_bebuftohs(buf) << 16) |
+           byteorder_bebuftohs(buf + 2);
+}
+
+static inline uint32_t _min(uint32_t a, uint32_t b)
+{
+    return (a < b) ? a : b;
+}
+
+/* the n-th configured server, NULL if there is none */
+static const sock_udp_ep_t *_server(unsigned n)
+{
+    if (sock_dns_server.port != 0) {
+        if (n-- == 0) {
+            return &sock_dns_server;
+        }
+    }
+    for (unsigned i = 0; i < SOCK_DNS_FALLBACK_NUMOF; i++) {
+        if ((sock_dns_fallback[i].port != 0) && (n-- == 0)) {
+            return &sock_dns_fallback[i];
+        }
+    }
+    return NULL;
+}
+
+static unsigned _servers_numof(void)
+{
+    unsigned numof = 0;
+
+    while (_server(numof)) {
+        numof++;
+    }
+    return numof;
+}
+
+static bool _is_server(const sock_udp_ep_t *ep)
+{
+    const sock_udp_ep_t *server;
+
+    for (unsigned n = 0; (server = _server(n)); n++) {
+        if (sock_udp_ep_equal(server, ep)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* copies name without a trailing dot, returns its length */
+static int _norm_name(char *out, const char *name)
+{
+    size_t len = strlen(name);
+
+    if ((len > 0) && (name[len - 1] == '.')) {
+        len--;
+    }
+    if (len > SOCK_DNS_MAX_NAME_LEN) {
+        return -ENOSPC;
+    }
+    memcpy(out, name, len);
+    out[len] = '\0';
+    return len;
+}
+
+/* encodes name as labels, e.g. "example.org" as "\7example\3org\0" */
+static int _enc_name(uint8_t *out, const char *name)
+{
+    uint8_t *label = out;
+    uint8_t *pos = out + 1;
+
+    for (;; name++) {
+        if ((*name == '.') || (*name == '\0')) {
+            size_t len = pos - label - 1;
+
+            if ((len == 0) || (len > LABEL_MAX_LEN)) {
+                return -EINVAL;
+            }
+            *label = len;
+            label = pos++;
+            if (*name == '\0') {
+                break;
+            }
+        }
+        else {
+            *pos++ = *name;
+        }
+    }
+    *label = 0;
+    return pos - out;
+}
+
+static bool _enc_name_equal(const uint8_t *a, const uint8_t *b, size_t len)
+{
+    /* label lengths are below 'A', so they compare as they are */
+    for (size_t i = 0; i < len; i++) {
+        if (tolower(a[i]) != tolower(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* returns the position after the name at pos, NULL if it exceeds end */
+static const uint8_t *_skip_name(const uint8_t *pos, const uint8_t *end)
+{
+    while (pos < end) {
+        if (*pos == 0) {
+            return pos + 1;
+        }
+        if ((*pos & 0xc0) == 0xc0) {
+            /* compressed: the rest of the name is elsewhere */
+            return ((end - pos) >= 2) ? (pos + 2) : NULL;
+        }
+        if (*pos & 0xc0) {
+            return NULL;
+        }
+        /* the label and at least the terminating byte must follow */
+        if ((size_t)(end - pos) <= (size_t)(*pos + 1)) {
+            return NULL;
+        }
+        pos += *pos + 1;
+    }
+    return NULL;
+}
+
+static uint32_t _remaining(const _cache_entry_t *e, uint32_t now)
+{
+    int32_t left = e->expires - now;
+
+    return ((e->type == 0) || (left <= 0)) ? 0 : (uint32_t)left;
+}
+
+/* returns the length of the cached address, -ENOENT for a cached negative
+ * answer, 0 if nothing is cached */
+static int _cache_get(const char *name, uint16_t type, uint8_t *addr)
+{
+    uint32_t now = _now_s();
+
+    for (unsigned i = 0; i < SOCK_DNS_CACHE_SIZE; i++) {
+        _cache_entry_t *e = &_cache[i];
+
+        if ((e->type != type) || (strcasecmp(e->name, name) != 0)) {
+            continue;
+        }
+        if (_remaining(e, now) == 0) {
+            e->type = 0;
+            return 0;
+        }
+        if (e->len == 0) {
+            return -ENOENT;
+        }
+        memcpy(addr, e->addr, e->len);
+        return e->len;
+    }
+    return 0;
+}
+
+static void _cache_put(const char *name, uint16_t type, const uint8_t *addr,
+                       int len, uint32_t ttl)
+{
+    uint32_t now = _now_s();
+    _cache_entry_t *e = &_cache[0];
+
+    if (ttl == 0) {
+        return;
+    }
+    for (unsigned i = 0; i < SOCK_DNS_CACHE_SIZE; i++) {
+        _cache_entry_t *c = &_cache[i];
+
+        if ((c->type == type) && (strcasecmp(c->name, name) == 0)) {
+            e = c;
+            break;
+        }
+        /* replace a free or expired entry, else the one expiring first */
+        if (_remaining(c, now) < _remaining(e, now)) {
+            e = c;
+        }
+    }
+    strcpy(e->name, name);
+    e->type = type;
+    e->expires = now + ttl;
+    e->len = (len > 0) ? len : 0;
+    if (len > 0) {
+        memcpy(e->addr, addr, len);
+    }
+}
+
+static void _send(_query_t *q)
+{
+    uint8_t buf[QUERY_LEN];
+    uint8_t *pos = buf + sizeof(sock_dns_hdr_t);
+    unsigned numof = _servers_numof();
+
+    memset(buf, 0, sizeof(sock_dns_hdr_t));
+    byteorder_htobebufs(&buf[0], q->id);
+    byteorder_htobebufs(&buf[2], FLAGS_QUERY);
+    byteorder_htobebufs(&buf[4], 1);        /* qdcount */
+    pos += _enc_name(pos, q->name);
+    byteorder_htobebufs(pos, q->type);
+    byteorder_htobebufs(pos + 2, DNS_CLASS_IN);
+    pos += 4;
+
+    q->deadline = xtimer_now_usec() + SOCK_DNS_TIMEOUT;
+    if (numof == 0) {
+        /* the servers were removed meanwhile, let the query time out */
+        q->tries = UINT8_MAX;
+        return;
+    }
+    /* each try goes to the next server */
+    const sock_udp_ep_t *server = _server(q->tries % numof);
+
+    q->tries++;
+    if (sock_udp_send(&_sock, buf, pos - buf, server) < 0) {
+        DEBUG("sock_dns: unable to send query for %s\n", q->name);
+    }
+}
+
+static int _query_find(const char *name, uint16_t type)
+{
+    for (unsigned i = 0; i < SOCK_DNS_QUERIES_NUMOF; i++) {
+        _query_t *q = &_queries[i];
+
+        if ((q->name[0] != '\0') && (q->type == type) &&
+            (strcasecmp(q->name, name) == 0)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static _query_t *_query_by_id(uint16_t id)
+{
+    for (unsigned i = 0; i < SOCK_DNS_QUERIES_NUMOF; i++) {
+        if ((_queries[i].name[0] != '\0') && (_queries[i].id == id)) {
+            return &_queries[i];
+        }
+    }
+    return NULL;
+}
+
+/* returns the number of the query for name and type, starting one if there
+ * is none; there must be a free slot */
+static uint8_t _query(const char *name, uint16_t type)
+{
+    int i = _query_find(name, type);
+
+    if (i >= 0) {
+        return i + 1;
+    }
+    for (i = 0; _queries[i].name[0] != '\0'; i++) {
+        assert(i < (int)SOCK_DNS_QUERIES_NUMOF);
+    }
+
+    _query_t *q = &_queries[i];
+    uint16_t id;
+
+    /* random IDs make forged answers harder */
+    do {
+        id = random_uint32();
+    } while (_query_by_id(id));
+    strcpy(q->name, name);
+    q->id = id;
+    q->type = type;
+    q->tries = 0;
+    _send(q);
+    return i + 1;
+}
+
+static unsigned _queries_missing(const sock_dns_req_t *req, const char *name)
+{
+    return ((req->res6 == 0) && (_query_find(name, DNS_TYPE_AAAA) < 0)) +
+           ((req->res4 == 0) && (_query_find(name, DNS_TYPE_A) < 0));
+}
+
+static unsigned _queries_free(void)
+{
+    unsigned numof = 0;
+
+    for (unsigned i = 0; i < SOCK_DNS_QUERIES_NUMOF; i++) {
+        numof += (_queries[i].name[0] == '\0');
+    }
+    return numof;
+}
+
+static inline bool _done(const sock_dns_req_t *req)
+{
+    /* AAAA records are preferred, so A records count once the AAAA query
+     * failed */
+    return (req->res6 > 0) || ((req->res6 != 0) && (req->res4 != 0));
+}
+
+static inline int _result(const sock_dns_req_t *req)
+{
+    if (req->res6 > 0) {
+        return req->res6;
+    }
+    return (req->res4 != NOT_REQUESTED) ? req->res4 : req->res6;
+}
+
+/* ends a query, moves the requests it completes to done */
+static void _finish(_query_t *q, int res, const uint8_t *addr,
+                    sock_dns_req_t **done)
+{
+    uint8_t num = (q - _queries) + 1;
+    bool aaaa = (q->type == DNS_TYPE_AAAA);
+    sock_dns_req_t **link = &_reqs;
+
+    while (*link) {
+        sock_dns_req_t *req = *link;
+
+        if ((aaaa ? req->q6 : req->q4) != num) {
+            link = &req->next;
+            continue;
+        }
+        if (aaaa) {
+            req->q6 = 0;
+            req->res6 = res;
+        }
+        else {
+            req->q4 = 0;
+            req->res4 = res;
+        }
+        if (res > 0) {
+            memcpy(req->addr, addr, res);
+        }
+        if (!_done(req)) {
+            link = &req->next;
+            continue;
+        }
+        req->q4 = 0;
+        *link = req->next;
+        req->next = *done;
+        *done = req;
+    }
+    q->name[0] = '\0';
+}
+
+static void _deliver(sock_dns_req_t *done)
+{
+    while (done) {
+        sock_dns_req_t *req = done;
+
+        /* the callback may reuse the request */
+        done = req->next;
+        req->cb(req, _result(req), req->addr);
+    }
+}
+
+/* repeats or ends the queries due, returns the time until the next one is
+ * due, 0 if there are no queries */
+static uint32_t _tick(sock_dns_req_t **done)
+{
+    uint32_t now = xtimer_now_usec();
+    uint32_t timeout = 0;
+    unsigned tries = SOCK_DNS_RETRIES * _servers_numof();
+
+    for (unsigned i = 0; i < SOCK_DNS_QUERIES_NUMOF; i++) {
+        _query_t *q = &_queries[i];
+
+        if (q->name[0] == '\0') {
+            continue;
+        }
+        int32_t left = q->deadline - now;
+
+        if (left <= 0) {
+            if (q->tries >= tries) {
+                DEBUG("sock_dns: no answer for %s\n", q->name);
+                _finish(q, -ETIMEDOUT, NULL, done);
+                continue;
+            }
+            _send(q);
+            left = SOCK_DNS_TIMEOUT;
+        }
+        if ((timeout == 0) || ((uint32_t)left < timeout)) {
+            timeout = left;
+        }
+    }
+    return timeout;
+}
+
+/* returns the length of the address, -ENOENT for a negative answer,
+ * -EAGAIN if the server failed, -EBADMSG if the reply is malformed or
+ * belongs to another query */
+static int _parse(const uint8_t *buf, size_t len, const _query_t *q,
+                  uint8_t *addr, uint32_t *ttl)
+{
+    const uint8_t *end = buf + len;
+    const uint8_t *pos = buf + sizeof(sock_dns_hdr_t);
+    uint16_t rcode = byteorder_bebuftohs(&buf[2]) & RCODE_MASK;
+    unsigned ancount = byteorder_bebuftohs(&buf[6]);
+    unsigned numof = ancount + byteorder_bebuftohs(&buf[8]);
+    unsigned addrlen = (q->type == DNS_TYPE_AAAA) ? 16 : 4;
+    uint8_t enc[NAME_ENC_LEN];
+    int enc_len = _enc_name(enc, q->name);
+    uint32_t min_ttl = TTL_MAX;
+    int res = -ENOENT;
+    bool soa = false;
+
+    if ((byteorder_bebuftohs(&buf[4]) != 1) || ((end - pos) < (enc_len + 4)) ||
+        !_enc_name_equal(pos, enc, enc_len) ||
+        (byteorder_bebuftohs(pos + enc_len) != q->type)) {
+        return -EBADMSG;
+    }
+    if ((rcode != RCODE_NOERROR) && (rcode != RCODE_NXDOMAIN)) {
+        return -EAGAIN;
+    }
+    pos += enc_len + 4;
+
+    /* the answer and the authority section */
+    for (unsigned n = 0; n < numof; n++) {
+        pos = _skip_name(pos, end);
+        if ((pos == NULL) || ((end - pos) < 10)) {
+            return -EBADMSG;
+        }
+        uint16_t type = byteorder_bebuftohs(pos);
+        uint16_t class = byteorder_bebuftohs(pos + 2);
+        uint32_t rttl = _get_u32(pos + 4);
+        uint16_t rdlen = byteorder_bebuftohs(pos + 8);
+        const uint8_t *rdata = pos + 10;
+
+        if ((end - rdata) < rdlen) {
+            return -EBADMSG;
+        }
+        pos = rdata + rdlen;
+        if (rttl > TTL_MAX) {
+            rttl = 0;
+        }
+        if (class != DNS_CLASS_IN) {
+            continue;
+        }
+        if (n < ancount) {
+            /* an alias lives as long as the record it leads to */
+            if (type == DNS_TYPE_CNAME) {
+                min_ttl = _min(min_ttl, rttl);
+            }
+            else if ((type == q->type) && (rdlen == addrlen) && (res < 0)) {
+                memcpy(addr, rdata, addrlen);
+                min_ttl = _min(min_ttl, rttl);
+                res = addrlen;
+            }
+        }
+        else if ((type == DNS_TYPE_SOA) && (res < 0)) {
+            /* negative answers live for the TTL of the SOA record, at most
+             * for its MINIMUM field (RFC 2308, section 5) */
+            const uint8_t *rdend = rdata + rdlen;
+            const uint8_t *fields = _skip_name(rdata, rdend);
+
+            fields = (fields) ? _skip_name(fields, rdend) : NULL;
+            if (fields && ((rdend - fields) >= 20)) {
+                min_ttl = _min(min_ttl, _min(rttl, _get_u32(fields + 16)));
+                soa = true;
+            }
+        }
+    }
+    if (res < 0) {
+        /* negative answers without an SOA record are not cached
+         * (RFC 2308, section 5) */
+        min_ttl = (soa) ? _min(min_ttl, SOCK_DNS_CACHE_NEG_TTL) : 0;
+    }
+    *ttl = min_ttl;
+    return res;
+}
+
+static void _on_reply(const uint8_t *buf, size_t len, sock_dns_req_t **done)
+{
+    uint8_t addr[16];
+    uint32_t ttl;
+    _query_t *q;
+
+    if ((len < sizeof(sock_dns_hdr_t)) ||
+        !(byteorder_bebuftohs(&buf[2]) & FLAG_RESPONSE) ||
+        ((q = _query_by_id(byteorder_bebuftohs(&buf[0]))) == NULL)) {
+        return;
+    }
+
+    int res = _parse(buf, len, q, addr, &ttl);
+
+    if (res == -EBADMSG) {
+        DEBUG("sock_dns: ignoring reply for %s\n", q->name);
+        return;
+    }
+    if (res == -EAGAIN) {
+        /* ask the next server at once */
+        q->deadline = xtimer_now_usec();
+        return;
+    }
+    _cache_put(q->name, q->type, addr, res, ttl);
+    _finish(q, res, addr, done);
+}
+
+static void _wakeup(void)
+{
+    msg_t msg = { .type = 0 };
+
+    /* the resolver thread checks its queries before it waits again */
+    if (thread_getpid() != _pid) {
+        msg_try_send(&msg, _pid);
+    }
+}
+
+static void *_run(void *arg)
+{
+    (void)arg;
+    msg_init_queue(_queue, QUEUE_SIZE);
+
+    while (1) {
+        sock_dns_req_t *done = NULL;
+        sock_udp_ep_t remote;
+        msg_t msg;
+
+        mutex_lock(&_lock);
+        uint32_t timeout = _tick(&done);
+        mutex_unlock(&_lock);
+        if (done) {
+            /* the callbacks may start queries */
+            _deliver(done);
+            continue;
+        }
+        if (timeout == 0) {
+            /* wait for a query */
+            msg_receive(&msg);
+            continue;
+        }
+
+        ssize_t res = sock_udp_recv(&_sock, _reply, sizeof(_reply), timeout,
+                                    &remote);
+
+        if ((res > 0) && _is_server(&remote)) {
+            mutex_lock(&_lock);
+            _on_reply(_reply, res, &done);
+            mutex_unlock(&_lock);
+            _deliver(done);
+        }
+        /* queries started meanwhile were sent by their callers */
+        while (msg_try_receive(&msg) == 1) {}
+    }
+    return NULL;
+}
+
+kernel_pid_t sock_dns_resolver_init(void)
+{
+#ifdef SOCK_HAS_IPV6
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+#else
+    sock_udp_ep_t local = SOCK_IPV4_EP_ANY;
+#endif
+
+    if (_pid != KERNEL_PID_UNDEF) {
+        return _pid;
+    }
+    /* created here, so callers can send on it before the thread runs */
+    if (sock_udp_create(&_sock, &local, NULL, 0) < 0) {
+        DEBUG("sock_dns: unable to create sock\n");
+        return KERNEL_PID_UNDEF;
+    }
+    _pid = thread_create(_stack, sizeof(_stack), SOCK_DNS_RESOLVER_PRIO,
+                         THREAD_CREATE_STACKTEST, _run, NULL, "dns");
+    return _pid;
+}
+
+int sock_dns_query_async(sock_dns_req_t *req, const char *domain_name,
+                         int family, sock_dns_cb_t cb, void *arg)
+{
+    char name[SOCK_DNS_MAX_NAME_LEN + 1];
+    uint8_t enc[NAME_ENC_LEN];
+    int res;
+
+    assert(req && domain_name && cb);
+    if ((res = _norm_name(name, domain_name)) < 0) {
+        return res;
+    }
+    if (_enc_name(enc, name) < 0) {
+        return -EINVAL;
+    }
+    if ((family != AF_INET) && (family != AF_INET6) && (family != AF_UNSPEC)) {
+        return -EAFNOSUPPORT;
+    }
+    req->cb = cb;
+    req->arg = arg;
+    req->res4 = (family == AF_INET6) ? NOT_REQUESTED : 0;
+    req->res6 = (family == AF_INET) ? NOT_REQUESTED : 0;
+    req->q4 = 0;
+    req->q6 = 0;
+
+    mutex_lock(&_lock);
+    if (req->res6 == 0) {
+        req->res6 = _cache_get(name, DNS_TYPE_AAAA, req->addr);
+    }
+    if ((req->res4 == 0) && (req->res6 <= 0)) {
+        req->res4 = _cache_get(name, DNS_TYPE_A, req->addr);
+    }
+    if (_done(req)) {
+        mutex_unlock(&_lock);
+        cb(req, _result(req), req->addr);
+        return 0;
+    }
+    if (_pid == KERNEL_PID_UNDEF) {
+        res = -ENOTCONN;
+    }
+    else if (_servers_numof() == 0) {
+        res = -ECONNREFUSED;
+    }
+    else if (_queries_missing(req, name) > _queries_free()) {
+        res = -ENOMEM;
+    }
+    else {
+        if (req->res6 == 0) {
+            req->q6 = _query(name, DNS_TYPE_AAAA);
+        }
+        if (req->res4 == 0) {
+            req->q4 = _query(name, DNS_TYPE_A);
+        }
+        req->next = _reqs;
+        _reqs = req;
+        res = 0;
+    }
+    mutex_unlock(&_lock);
+    if (res == 0) {
+        _wakeup();
+    }
+    return res;
+}
+
+static void _sync_cb(sock_dns_req_t *req, int res, const void *addr)
+{
+    _sync_t *sync = req->arg;
+
+    if (res > 0) {
+        memcpy(sync->addr_out, addr, res);
+    }
+    sync->res = res;
+    mutex_unlock(&sync->done);
+}
+
+int sock_dns_query(const char *domain_name, void *addr_out, int family)
+{
+    _sync_t sync = { .done = MUTEX_INIT_LOCKED, .addr_out = addr_out };
+    int res = sock_dns_query_async(&sync.req, domain_name, family, _sync_cb,
+                                   &sync);
+
+    if (res < 0) {
+        return res;
+    }
+    mutex_lock(&sync.done);
+    return sync.res;
+}
+
+void sock_dns_cache_flush(void)
+{
+    mutex_lock(&_lock);
+    memset(_cache, 0, sizeof(_cache));
+    mutex_unlock(&_lock);
+}
@@ -18,6 +18,7 @@
  * @}
  */
 
+#include <errno.h>
 #include <string.h>
 
 #include "log.h"
@@ -28,6 +29,7 @@
 #include "thread_flags.h"
 
 #include "net/emcute.h"
+#include "net/mqttsn_topics.h"
 #include "emcute_internal.h"
 
 #define ENABLE_DEBUG        (0)
@@ -50,7 +52,10 @@ static sock_udp_ep_t gateway;
 static uint8_t rbuf[EMCUTE_BUFSIZE];
 static uint8_t tbuf[EMCUTE_BUFSIZE];
 
-static emcute_sub_t *subs = NULL;
+/* topic IDs and topic filters of the subscriptions */
+static mqttsn_tid_map_t tids;
+static mqttsn_trie_t filters;
+static mutex_t sublock = MUTEX_INIT;
 
 static mutex_t txlock;
 
@@ -171,7 +176,9 @@ static void on_publish(size_t len, size_t pos)
     }
 
     /* find the registered topic */
-    for (sub = subs; sub && (sub->topic.id != tid); sub = sub->next) {}
+    mutex_lock(&sublock);
+    sub = mqttsn_tid_map_get(&tids, tid);
+    mutex_unlock(&sublock);
     if (sub == NULL) {
         buf[6] = REJ_INVTID;
         sock_udp_send(&sock, &buf, 7, &gateway);
@@ -184,10 +191,38 @@ static void on_publish(size_t len, size_t pos)
         DEBUG("[emcute] on pub: got %i bytes of data\n", (int)(len - pos - 6));
         size_t dat_len = (len - pos - 6);
         void *dat = (dat_len > 0) ? &rbuf[pos + 6] : NULL;
+        /* a subscription with wildcards gets the topic ID of the message */
+        sub->topic.id = tid;
         sub->cb(&sub->topic, dat, dat_len);
     }
 }
 
+static void on_register(size_t len, size_t pos)
+{
+    /* make sure packet length is valid - if not, drop packet silently */
+    if (len < (pos + 6)) {
+        return;
+    }
+
+    uint16_t tid = byteorder_bebuftohs(&rbuf[pos + 1]);
+    uint8_t buf[7] = { 7, REGACK, 0, 0, 0, 0, ACCEPT };
+    memcpy(&buf[2], &rbuf[pos + 1], 4);
+
+    /* the gateway registers names matching a subscription with wildcards */
+    mutex_lock(&sublock);
+    emcute_sub_t *sub = mqttsn_trie_match(&filters, (char *)&rbuf[pos + 5],
+                                          (len - pos - 5));
+    if ((sub == NULL) || (tid == 0)) {
+        buf[6] = REJ_INVTID;
+    }
+    else if (mqttsn_tid_map_add(&tids, tid, sub) < 0) {
+        buf[6] = REJ_CONG;
+    }
+    mutex_unlock(&sublock);
+    DEBUG("[emcute] on register: topic id %i [%i]\n", (int)tid, (int)buf[6]);
+    sock_udp_send(&sock, &buf, 7, &gateway);
+}
+
 static void on_pingreq(sock_udp_ep_t *remote)
 {
     /* @todo    respond with a PINGRESP only if the PINGREQ came from the
@@ -376,6 +411,15 @@ int emcute_sub(emcute_sub_t *sub, unsigned flags)
         return EMCUTE_OVERFLOW;
     }
 
+    /* add the filter first, so no REGISTER for it gets lost */
+    mutex_lock(&sublock);
+    int res = mqttsn_trie_add(&filters, sub->topic.name, sub);
+    mutex_unlock(&sublock);
+    if ((res < 0) && (res != -EALREADY)) {
+        return EMCUTE_OVERFLOW;
+    }
+    bool added = (res == 0);
+
     mutex_lock(&txlock);
 
     tbuf[0] = (strlen(sub->topic.name) + 5);
@@ -385,20 +429,23 @@ int emcute_sub(emcute_sub_t *sub, unsigned flags)
     waitonid = id_next++;
     memcpy(&tbuf[5], sub->topic.name, strlen(sub->topic.name));
 
-    int res = syncsend(SUBACK, (size_t)tbuf[0], false);
-    if (res > 0) {
+    res = syncsend(SUBACK, (size_t)tbuf[0], false);
+    mutex_lock(&sublock);
+    if (res >= 0) {
+        /* the topic ID is 0 for topic names with wildcards */
         DEBUG("[emcute] sub: success, topic id is %i\n", res);
         sub->topic.id = res;
-
-        /* check if subscription is already in the list, only insert if not*/
-        emcute_sub_t *s;
-        for (s = subs; s && (s != sub); s = s->next) {}
-        if (!s) {
-            sub->next = subs;
-            subs = sub;
-            res = EMCUTE_OK;
+        res = EMCUTE_OK;
+        if ((sub->topic.id != 0) &&
+            (mqttsn_tid_map_add(&tids, sub->topic.id, sub) < 0)) {
+            res = EMCUTE_OVERFLOW;
         }
     }
+    if ((res != EMCUTE_OK) && added) {
+        mqttsn_trie_del(&filters, sub->topic.name);
+        mqttsn_tid_map_del_ctx(&tids, sub);
+    }
+    mutex_unlock(&sublock);
 
     mutex_unlock(&txlock);
     return res;
@@ -423,18 +470,10 @@ int emcute_unsub(emcute_sub_t *sub)
 
     int res = syncsend(UNSUBACK, (size_t)tbuf[0], false);
     if (res == EMCUTE_OK) {
-        if (subs == sub) {
-            subs = sub->next;
-        }
-        else {
-            emcute_sub_t *s;
-            for (s = subs; s; s = s->next) {
-                if (s->next == sub) {
-                    s->next = sub->next;
-                    break;
-                }
-            }
-        }
+        mutex_lock(&sublock);
+        mqttsn_trie_del(&filters, sub->topic.name);
+        mqttsn_tid_map_del_ctx(&tids, sub);
+        mutex_unlock(&sublock);
     }
 
     mutex_unlock(&txlock);
@@ -499,6 +538,8 @@ void emcute_run(uint16_t port, const char *id)
     timer.callback = time_evt;
     timer.arg = NULL;
     mutex_init(&txlock);
+    mqttsn_tid_map_init(&tids);
+    mqttsn_trie_init(&filters);
 
     if (sock_udp_create(&sock, &local, NULL, 0) < 0) {
         LOG_ERROR("[emcute] unable to open UDP socket on port %i\n", (int)port);
@@ -537,6 +578,7 @@ void emcute_run(uint16_t port, const char *id)
                 case WILLTOPICREQ:  on_ack(type, 0, 0, 0);              break;
                 case WILLMSGREQ:    on_ack(type, 0, 0, 0);              break;
                 case REGACK:        on_ack(type, 4, 6, 2);              break;
+                case REGISTER:      on_register((size_t)pkt_len, pos);  break;
                 case PUBLISH:       on_publish((size_t)pkt_len, pos);   break;
                 case PUBACK:        on_ack(type, 4, 6, 0);              break;
                 case SUBACK:        on_ack(type, 5, 7, 3);              break;
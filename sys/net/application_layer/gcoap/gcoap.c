@@ -13,7 +13,8 @@
  * @file
  * @brief       GNRC's implementation of CoAP protocol
  *
- * Runs a thread (_pid) to manage request/response messaging.
+ * Runs a thread (_pid) to manage request/response messaging, or, with the
+ * gnrc_udp_mux module, the handlers on the event queue of the multiplexer.
  *
  * @author      Ken Bannister <kb2ma@runbox.com>
  */
@@ -29,6 +30,9 @@
 #include "mutex.h"
 #include "random.h"
 #include "thread.h"
+#ifdef MODULE_GNRC_UDP_MUX
+#include "net/gnrc/udp_mux.h"
+#endif
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -47,15 +51,71 @@
 #define GCOAP_RESP_OPTIONS_BUF  (4)
 #define GCOAP_OBS_OPTIONS_BUF   (4)
 
+/* End of a chain in the observe hash buckets */
+#define GCOAP_OBS_NONE          (UINT8_MAX)
+
+#if (GCOAP_OBS_CLIENTS_MAX >= GCOAP_OBS_NONE) || \
+    (GCOAP_OBS_REGISTRATIONS_MAX >= GCOAP_OBS_NONE)
+#error "gcoap: too many observers for 8 bit observe hash chains"
+#endif
+
+#if (GCOAP_OBS_HASH_SIZE & (GCOAP_OBS_HASH_SIZE - 1)) != 0
+#error "gcoap: GCOAP_OBS_HASH_SIZE must be a power of 2"
+#endif
+
+#ifdef MODULE_GCOAP_RESP_CACHE
+/* Cache key of a request, see RFC 7252, section 5.6 */
+typedef struct {
+    uint8_t method;
+    uint8_t len;                        /* 0 if request not cacheable */
+    uint32_t path_hash;                 /* hash of the Uri-Path options */
+    uint8_t data[GCOAP_RESP_CACHE_KEY_SIZE];
+} _cache_key_t;
+
+/* Cached response, without header and token */
+typedef struct {
+    _cache_key_t key;
+    uint32_t used;                      /* for LRU replacement; 0 if unused */
+    uint32_t expires;                   /* end of freshness in s */
+    uint8_t code;
+    uint8_t max_age_len;
+    uint8_t etag_len;                   /* 0 if no ETag */
+    uint16_t max_age_pos;               /* offset of Max-Age value in pdu */
+    uint16_t etag_pos;                  /* offset of ETag value in pdu */
+    uint16_t len;
+    uint8_t pdu[GCOAP_RESP_CACHE_PDU_SIZE];
+} _cache_entry_t;
+#endif
+
 /* Internal functions */
+#ifdef MODULE_GNRC_UDP_MUX
+static void _on_udp(gnrc_udp_mux_ep_t *ep, uint8_t *data, size_t len,
+                    const sock_udp_ep_t *remote);
+static void _on_timeout_event(event_t *event);
+static void _on_response_timer(void *arg);
+static void _on_obs_event(event_t *event);
+static void _on_obs_timer(void *arg);
+#else
 static void *_event_loop(void *arg);
-static void _listen(sock_udp_t *sock);
+static void _listen(void);
+#endif
+static void _process(uint8_t *buf, size_t len, size_t size,
+                     sock_udp_ep_t *remote);
+static ssize_t _send(const void *data, size_t len,
+                     const sock_udp_ep_t *remote);
+static void _set_timeout(gcoap_request_memo_t *memo, uint32_t timeout);
+static void _clear_timeout(gcoap_request_memo_t *memo);
+static void _handle_timeout(gcoap_request_memo_t *memo);
 static ssize_t _well_known_core_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
 static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
                                                          sock_udp_ep_t *remote);
 static void _expire_request(gcoap_request_memo_t *memo);
+static void _handle_empty(coap_pkt_t *pdu, sock_udp_ep_t *remote);
+static void _send_empty_ack(coap_pkt_t *pdu, sock_udp_ep_t *remote);
 static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *pdu,
                            const sock_udp_ep_t *remote);
+static void _find_req_memo_by_id(gcoap_request_memo_t **memo_ptr,
+                                 coap_pkt_t *pdu, const sock_udp_ep_t *remote);
 static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
                                             gcoap_listener_t **listener_ptr);
 static int _find_observer(sock_udp_ep_t **observer, sock_udp_ep_t *remote);
@@ -63,6 +123,21 @@ static int _find_obs_memo(gcoap_observe_memo_t **memo, sock_udp_ep_t *remote,
                                                        coap_pkt_t *pdu);
 static void _find_obs_memo_resource(gcoap_observe_memo_t **memo,
                                    const coap_resource_t *resource);
+static gcoap_observe_memo_t *_next_obs_memo(uint8_t i,
+                                            const coap_resource_t *resource);
+static sock_udp_ep_t *_add_observer(int slot, const sock_udp_ep_t *remote);
+static void _remove_observer(sock_udp_ep_t *observer);
+static void _link_obs_memo(gcoap_observe_memo_t *memo,
+                           const coap_resource_t *resource);
+static void _unlink_obs_memo(gcoap_observe_memo_t *memo);
+static void _obs_set_pending(gcoap_observe_memo_t *memo, uint32_t now);
+static void _obs_notified(gcoap_observe_memo_t *memo, bool sent, uint32_t now);
+static void _notify_pending(void);
+#ifdef MODULE_GCOAP_RESP_CACHE
+static size_t _cache_lookup(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                            _cache_key_t *key);
+static void _cache_update(const _cache_key_t *key, uint8_t *buf, size_t len);
+#endif
 
 /* Internal variables */
 const coap_resource_t _default_resources[] = {
@@ -89,10 +164,46 @@ typedef struct {
                                            observe memos */
     gcoap_observe_memo_t observe_memos[GCOAP_OBS_REGISTRATIONS_MAX];
                                         /* Observed resource registrations */
+    uint8_t observer_heads[GCOAP_OBS_HASH_SIZE];
+                                        /* First observer in each bucket, by
+                                           hash of the endpoint */
+    uint8_t observer_next[GCOAP_OBS_CLIENTS_MAX];
+                                        /* Next observer in the bucket */
+    uint32_t observer_notified[GCOAP_OBS_CLIENTS_MAX];
+                                        /* Time of the last notification sent
+                                           to an observer, or of the last
+                                           failure to send one, in ms */
+    uint8_t observer_backoff[GCOAP_OBS_CLIENTS_MAX];
+                                        /* Number of times the interval between
+                                           notifications to an observer is
+                                           doubled */
+    xtimer_t obs_timer;                 /* Ends the interval of the first
+                                           pending notification */
+#ifdef MODULE_GNRC_UDP_MUX
+    event_t obs_event;                  /* For obs_timer, posted to the
+                                           multiplexer's event queue */
+#else
+    msg_t obs_msg;                      /* For obs_timer */
+#endif
+    uint32_t obs_due;                   /* End of that interval, in ms */
+    bool obs_timer_set;                 /* obs_timer runs */
+    uint8_t obs_memo_heads[GCOAP_OBS_HASH_SIZE];
+                                        /* First observe memo in each bucket,
+                                           by hash of the resource */
     uint8_t resend_bufs[GCOAP_RESEND_BUFS_MAX][GCOAP_PDU_BUF_SIZE];
                                         /* Buffers for PDU for request resends;
                                            if first byte of an entry is zero,
                                            the entry is available */
+    gcoap_req_ctx_t req_ctxs[GCOAP_REQ_CTX_MAX];
+                                        /* Requests with a deferred response */
+    sock_udp_ep_t *req_remote;          /* Remote of the request in handling,
+                                           for gcoap_resp_defer() */
+#ifdef MODULE_GCOAP_RESP_CACHE
+    _cache_entry_t resp_cache[GCOAP_RESP_CACHE_SIZE];
+                                        /* Cached responses */
+    uint32_t resp_cache_clock;          /* Last use of a cached response */
+    gcoap_resp_cache_stats_t resp_cache_stats;
+#endif
 } gcoap_state_t;
 
 static gcoap_state_t _coap_state = {
@@ -100,11 +211,66 @@ static gcoap_state_t _coap_state = {
 };
 
 static kernel_pid_t _pid = KERNEL_PID_UNDEF;
+#ifdef MODULE_GNRC_UDP_MUX
+static gnrc_udp_mux_ep_t _ep;
+/* requests are copied here, as the response is written over them */
+static uint8_t _req_buf[GCOAP_PDU_BUF_SIZE];
+#else
 static char _msg_stack[GCOAP_STACK_SIZE];
 static msg_t _msg_queue[GCOAP_MSG_QUEUE_SIZE];
 static sock_udp_t _sock;
+#endif
 
+#ifdef MODULE_GNRC_UDP_MUX
+/* Handles a message received on the multiplexer thread. */
+static void _on_udp(gnrc_udp_mux_ep_t *ep, uint8_t *data, size_t len,
+                    const sock_udp_ep_t *remote)
+{
+    sock_udp_ep_t rem = *remote;
+    (void)ep;
+
+    if ((len < sizeof(coap_hdr_t)) || (len > GCOAP_PDU_BUF_SIZE)) {
+        DEBUG("gcoap: dropping message of %u bytes\n", (unsigned)len);
+        return;
+    }
+    if ((data[1] != COAP_CODE_EMPTY) &&
+        ((data[1] >> 5) == COAP_CLASS_REQ)) {
+        memcpy(_req_buf, data, len);
+        _process(_req_buf, len, sizeof(_req_buf), &rem);
+    }
+    else {
+        /* responses are read where they are */
+        _process(data, len, len, &rem);
+    }
+}
 
+static void _on_timeout_event(event_t *event)
+{
+    _handle_timeout(container_of(event, gcoap_request_memo_t, timeout_event));
+}
+
+/* Posts the timeout of a request to the multiplexer thread. */
+static void _on_response_timer(void *arg)
+{
+    gcoap_request_memo_t *memo = arg;
+
+    event_post(gnrc_udp_mux_queue(), &memo->timeout_event);
+}
+
+static void _on_obs_event(event_t *event)
+{
+    (void)event;
+    _notify_pending();
+}
+
+/* Posts the end of the interval for a pending notification to the
+ * multiplexer thread. */
+static void _on_obs_timer(void *arg)
+{
+    (void)arg;
+    event_post(gnrc_udp_mux_queue(), &_coap_state.obs_event);
+}
+#else
 /* Event/Message loop for gcoap _pid thread. */
 static void *_event_loop(void *arg)
 {
@@ -130,63 +296,39 @@ static void *_event_loop(void *arg)
 
         if (res > 0) {
             switch (msg_rcvd.type) {
-            case GCOAP_MSG_TYPE_TIMEOUT: {
-                gcoap_request_memo_t *memo = (gcoap_request_memo_t *)msg_rcvd.content.ptr;
-
-                /* no retries remaining */
-                if ((memo->send_limit == GCOAP_SEND_LIMIT_NON)
-                        || (memo->send_limit == 0)) {
-                    _expire_request(memo);
-                }
-                /* reduce retries remaining, double timeout and resend */
-                else {
-                    memo->send_limit--;
-                    unsigned i        = COAP_MAX_RETRANSMIT - memo->send_limit;
-                    uint32_t timeout  = ((uint32_t)COAP_ACK_TIMEOUT << i) * US_PER_SEC;
-                    uint32_t variance = ((uint32_t)COAP_ACK_VARIANCE << i) * US_PER_SEC;
-                    timeout = random_uint32_range(timeout, timeout + variance);
-
-                    ssize_t bytes = sock_udp_send(&_sock, memo->msg.data.pdu_buf,
-                                                  memo->msg.data.pdu_len,
-                                                  &memo->remote_ep);
-                    if (bytes > 0) {
-                        xtimer_set_msg(&memo->response_timer, timeout,
-                                       &memo->timeout_msg, _pid);
-                    }
-                    else {
-                        DEBUG("gcoap: sock resend failed: %d\n", (int)bytes);
-                        _expire_request(memo);
-                    }
-                }
+            case GCOAP_MSG_TYPE_TIMEOUT:
+                _handle_timeout((gcoap_request_memo_t *)msg_rcvd.content.ptr);
+                break;
+            case GCOAP_MSG_TYPE_OBS:
+                _notify_pending();
                 break;
-            }
             default:
                 break;
             }
         }
 
-        _listen(&_sock);
+        _listen();
     }
 
     return 0;
 }
 
 /* Listen for an incoming CoAP message. */
-static void _listen(sock_udp_t *sock)
+static void _listen(void)
 {
-    coap_pkt_t pdu;
     uint8_t buf[GCOAP_PDU_BUF_SIZE];
     sock_udp_ep_t remote;
-    gcoap_request_memo_t *memo = NULL;
     uint8_t open_reqs = gcoap_op_state();
 
     /* We expect a -EINTR response here when unlimited waiting (SOCK_NO_TIMEOUT)
      * is interrupted when sending a message in gcoap_req_send2(). While a
-     * request is outstanding, sock_udp_recv() is called here with limited
-     * waiting so the request's timeout can be handled in a timely manner in
+     * request is outstanding or an Observe notification is pending,
+     * sock_udp_recv() is called here with limited waiting so the request's
+     * timeout or the notification can be handled in a timely manner in
      * _event_loop(). */
-    ssize_t res = sock_udp_recv(sock, buf, sizeof(buf),
-                                open_reqs > 0 ? GCOAP_RECV_TIMEOUT : SOCK_NO_TIMEOUT,
+    bool wait = (open_reqs > 0) || _coap_state.obs_timer_set;
+    ssize_t res = sock_udp_recv(&_sock, buf, sizeof(buf),
+                                wait ? GCOAP_RECV_TIMEOUT : SOCK_NO_TIMEOUT,
                                 &remote);
     if (res <= 0) {
 #if ENABLE_DEBUG
@@ -196,8 +338,84 @@ static void _listen(sock_udp_t *sock)
 #endif
         return;
     }
+    _process(buf, res, sizeof(buf), &remote);
+}
+#endif
 
-    res = coap_parse(&pdu, buf, res);
+/* Resends a confirmable request or expires the request on its timeout. */
+static void _handle_timeout(gcoap_request_memo_t *memo)
+{
+    /* no retries remaining */
+    if ((memo->send_limit == GCOAP_SEND_LIMIT_NON)
+            || (memo->send_limit == 0)) {
+        _expire_request(memo);
+    }
+    /* reduce retries remaining, double timeout and resend */
+    else {
+        memo->send_limit--;
+        unsigned i        = COAP_MAX_RETRANSMIT - memo->send_limit;
+        uint32_t timeout  = ((uint32_t)COAP_ACK_TIMEOUT << i) * US_PER_SEC;
+        uint32_t variance = ((uint32_t)COAP_ACK_VARIANCE << i) * US_PER_SEC;
+        timeout = random_uint32_range(timeout, timeout + variance);
+
+        ssize_t bytes = _send(memo->msg.data.pdu_buf, memo->msg.data.pdu_len,
+                              &memo->remote_ep);
+        if (bytes > 0) {
+            _set_timeout(memo, timeout);
+        }
+        else {
+            DEBUG("gcoap: sock resend failed: %d\n", (int)bytes);
+            _expire_request(memo);
+        }
+    }
+}
+
+/* Sends a message from the gcoap port. */
+static ssize_t _send(const void *data, size_t len, const sock_udp_ep_t *remote)
+{
+#ifdef MODULE_GNRC_UDP_MUX
+    return gnrc_udp_mux_send(&_ep, data, len, remote);
+#else
+    return sock_udp_send(&_sock, data, len, remote);
+#endif
+}
+
+/* Starts the timer for the response to a request. */
+static void _set_timeout(gcoap_request_memo_t *memo, uint32_t timeout)
+{
+#ifdef MODULE_GNRC_UDP_MUX
+    memo->timeout_event.handler = _on_timeout_event;
+    memo->response_timer.callback = _on_response_timer;
+    memo->response_timer.arg = memo;
+    xtimer_set(&memo->response_timer, timeout);
+#else
+    memo->timeout_msg.type        = GCOAP_MSG_TYPE_TIMEOUT;
+    memo->timeout_msg.content.ptr = (char *)memo;
+    xtimer_set_msg(&memo->response_timer, timeout, &memo->timeout_msg, _pid);
+#endif
+}
+
+/* Stops the timer for the response to a request. */
+static void _clear_timeout(gcoap_request_memo_t *memo)
+{
+    xtimer_remove(&memo->response_timer);
+#ifdef MODULE_GNRC_UDP_MUX
+    /* the timer may have fired already */
+    event_cancel(gnrc_udp_mux_queue(), &memo->timeout_event);
+#endif
+}
+
+/*
+ * Handles an incoming CoAP message of len bytes in buf. A response to a
+ * request is written to buf, which must have size bytes.
+ */
+static void _process(uint8_t *buf, size_t len, size_t size,
+                     sock_udp_ep_t *remote)
+{
+    coap_pkt_t pdu;
+    gcoap_request_memo_t *memo = NULL;
+
+    ssize_t res = coap_parse(&pdu, buf, len);
     if (res < 0) {
         DEBUG("gcoap: parse failure: %d\n", (int)res);
         /* If a response, can't clear memo, but it will timeout later. */
@@ -205,7 +423,7 @@ static void _listen(sock_udp_t *sock)
     }
 
     if (pdu.hdr->code == COAP_CODE_EMPTY) {
-        DEBUG("gcoap: empty messages not handled yet\n");
+        _handle_empty(&pdu, remote);
         return;
     }
 
@@ -215,9 +433,18 @@ static void _listen(sock_udp_t *sock)
     case COAP_CLASS_REQ:
         if (coap_get_type(&pdu) == COAP_TYPE_NON
                 || coap_get_type(&pdu) == COAP_TYPE_CON) {
-            size_t pdu_len = _handle_req(&pdu, buf, sizeof(buf), &remote);
+#ifdef MODULE_GCOAP_RESP_CACHE
+            _cache_key_t key;
+            size_t pdu_len = _cache_lookup(&pdu, buf, size, &key);
+            if (pdu_len == 0) {
+                pdu_len = _handle_req(&pdu, buf, size, remote);
+                _cache_update(&key, buf, pdu_len);
+            }
+#else
+            size_t pdu_len = _handle_req(&pdu, buf, size, remote);
+#endif
             if (pdu_len > 0) {
-                ssize_t bytes = sock_udp_send(sock, buf, pdu_len, &remote);
+                ssize_t bytes = _send(buf, pdu_len, remote);
                 if (bytes <= 0) {
                     DEBUG("gcoap: send response failed: %d\n", (int)bytes);
                 }
@@ -232,15 +459,21 @@ static void _listen(sock_udp_t *sock)
     case COAP_CLASS_SUCCESS:
     case COAP_CLASS_CLIENT_FAILURE:
     case COAP_CLASS_SERVER_FAILURE:
-        _find_req_memo(&memo, &pdu, &remote);
+        if (coap_get_type(&pdu) == COAP_TYPE_CON) {
+            /* separate response; acknowledged even without memo, because it
+             * may be resent after our ACK was lost */
+            _send_empty_ack(&pdu, remote);
+        }
+        _find_req_memo(&memo, &pdu, remote);
         if (memo) {
             switch (coap_get_type(&pdu)) {
             case COAP_TYPE_NON:
             case COAP_TYPE_ACK:
-                xtimer_remove(&memo->response_timer);
+            case COAP_TYPE_CON:
+                _clear_timeout(memo);
                 memo->state = GCOAP_MEMO_RESP;
                 if (memo->resp_handler) {
-                    memo->resp_handler(memo->state, &pdu, &remote);
+                    memo->resp_handler(memo->state, &pdu, remote);
                 }
 
                 if (memo->send_limit >= 0) {        /* if confirmable */
@@ -248,9 +481,6 @@ static void _listen(sock_udp_t *sock)
                 }
                 memo->state = GCOAP_MEMO_UNUSED;
                 break;
-            case COAP_TYPE_CON:
-                DEBUG("gcoap: separate CON response not handled yet\n");
-                break;
             default:
                 DEBUG("gcoap: illegal response type: %u\n", coap_get_type(&pdu));
                 break;
@@ -287,40 +517,42 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         case GCOAP_RESOURCE_NO_PATH:
             return gcoap_response(pdu, buf, len, COAP_CODE_PATH_NOT_FOUND);
         case GCOAP_RESOURCE_FOUND:
-            /* find observe registration for resource */
-            _find_obs_memo_resource(&resource_memo, resource);
             break;
     }
 
     if (coap_get_observe(pdu) == COAP_OBS_REGISTER) {
+        mutex_lock(&_coap_state.lock);
         /* lookup remote+token */
         int empty_slot = _find_obs_memo(&memo, remote, pdu);
+        int obs_slot = _find_observer(&observer, remote);
+        /* find registration of this observer for resource */
+        if (observer != NULL) {
+            _find_obs_memo_resource(&resource_memo, resource);
+            while ((resource_memo != NULL)
+                    && (resource_memo->observer != observer)) {
+                resource_memo = _next_obs_memo(resource_memo->next, resource);
+            }
+        }
         /* validate re-registration request */
         if (resource_memo != NULL) {
-            if (memo != NULL) {
-                if (memo != resource_memo) {
-                    /* reject token already used for a different resource */
-                    memo = NULL;
-                    coap_clear_observe(pdu);
-                    DEBUG("gcoap: can't change resource for token\n");
-                }
-                /* otherwise OK to re-register resource with the same token */
+            if ((memo != NULL) && (memo != resource_memo)) {
+                /* reject token already used for a different resource */
+                memo = NULL;
+                coap_clear_observe(pdu);
+                DEBUG("gcoap: can't change resource for token\n");
             }
-            else if (sock_udp_ep_equal(remote, resource_memo->observer)) {
-                /* accept new token for resource */
+            else {
+                /* re-register resource with the same or a new token */
                 memo = resource_memo;
             }
         }
         /* initialize new registration request */
         if ((memo == NULL) && coap_has_observe(pdu)) {
-            /* verify resource not already registerered (for another endpoint) */
-            if ((empty_slot >= 0) && (resource_memo == NULL)) {
-                int obs_slot = _find_observer(&observer, remote);
+            if (empty_slot >= 0) {
                 /* cache new observer */
                 if (observer == NULL) {
                     if (obs_slot >= 0) {
-                        observer = &_coap_state.observers[obs_slot];
-                        memcpy(observer, remote, sizeof(sock_udp_ep_t));
+                        observer = _add_observer(obs_slot, remote);
                     } else {
                         DEBUG("gcoap: can't register observer\n");
                     }
@@ -328,6 +560,7 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
                 if (observer != NULL) {
                     memo = &_coap_state.observe_memos[empty_slot];
                     memo->observer = observer;
+                    memo->resource = NULL;
                 }
             }
             if (memo == NULL) {
@@ -337,30 +570,42 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         }
         /* finish registration */
         if (memo != NULL) {
-            /* resource may be assigned here if it is not already registered */
-            memo->resource = resource;
+            /* token may move here from a resource to another one */
+            if (memo->resource != resource) {
+                if (memo->resource != NULL) {
+                    _unlink_obs_memo(memo);
+                }
+                _link_obs_memo(memo, resource);
+            }
             memo->token_len = coap_get_token_len(pdu);
             if (memo->token_len) {
                 memcpy(&memo->token[0], pdu->token, memo->token_len);
             }
+            /* the response carries the current state of the resource */
+            memo->state = GCOAP_OBS_MEMO_IDLE;
             DEBUG("gcoap: Registered observer for: %s\n", memo->resource->path);
         }
+        mutex_unlock(&_coap_state.lock);
 
     } else if (coap_get_observe(pdu) == COAP_OBS_DEREGISTER) {
+        mutex_lock(&_coap_state.lock);
         _find_obs_memo(&memo, remote, pdu);
         /* clear memo, and clear observer if no other memos */
         if (memo != NULL) {
             DEBUG("gcoap: Deregistering observer for: %s\n", memo->resource->path);
+            _unlink_obs_memo(memo);
             memo->observer = NULL;
+            memo->state    = GCOAP_OBS_MEMO_UNUSED;
             memo           = NULL;
             _find_obs_memo(&memo, remote, NULL);
             if (memo == NULL) {
                 _find_observer(&observer, remote);
                 if (observer != NULL) {
-                    observer->family = AF_UNSPEC;
+                    _remove_observer(observer);
                 }
             }
         }
+        mutex_unlock(&_coap_state.lock);
         coap_clear_observe(pdu);
 
     } else if (coap_has_observe(pdu)) {
@@ -369,7 +614,9 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         return -1;
     }
 
+    _coap_state.req_remote = remote;
     ssize_t pdu_len = resource->handler(pdu, buf, len, resource->context);
+    _coap_state.req_remote = NULL;
     if (pdu_len < 0) {
         pdu_len = gcoap_response(pdu, buf, len,
                                  COAP_CODE_INTERNAL_SERVER_ERROR);
@@ -392,15 +639,21 @@ static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
 {
     int ret = GCOAP_RESOURCE_NO_PATH;
     unsigned method_flag = coap_method2flag(coap_get_code_detail(pdu));
+    size_t path_len = 1;
 
-    /* Find path for CoAP msg among listener resources and execute callback. */
-    gcoap_listener_t *listener = _coap_state.listeners;
-
-    uint8_t uri[NANOCOAP_URI_MAX];
-    if (coap_get_uri_path(pdu, uri) <= 0) {
+    /* like coap_get_uri_path(), reject a path that does not fit into
+     * NANOCOAP_URI_MAX */
+    for (const coap_optpos_t *opt = coap_opt_find(pdu, COAP_OPT_URI_PATH);
+         opt != NULL; opt = coap_opt_next(pdu, opt)) {
+        path_len += opt->len + 1;
+    }
+    if (path_len > NANOCOAP_URI_MAX) {
         return GCOAP_RESOURCE_NO_PATH;
     }
 
+    /* Find path for CoAP msg among listener resources and execute callback. */
+    gcoap_listener_t *listener = _coap_state.listeners;
+
     while (listener) {
         const coap_resource_t *resource = listener->resources;
         for (size_t i = 0; i < listener->resources_len; i++) {
@@ -408,7 +661,7 @@ static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
                 resource++;
             }
 
-            int res = strcmp((char *)&uri[0], resource->path);
+            int res = coap_match_path(pdu, resource);
             if (res > 0) {
                 continue;
             }
@@ -473,6 +726,91 @@ static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *src_pdu,
     }
 }
 
+/*
+ * Finds the memo for an outstanding confirmable message within the
+ * _coap_state.open_reqs array. Matches on remote endpoint and message ID.
+ *
+ * memo_ptr[out] -- Registered request memo, or NULL if not found
+ * src_pdu[in] -- PDU for message ID to match
+ * remote[in] -- Remote endpoint to match
+ */
+static void _find_req_memo_by_id(gcoap_request_memo_t **memo_ptr,
+                                 coap_pkt_t *src_pdu,
+                                 const sock_udp_ep_t *remote)
+{
+    *memo_ptr = NULL;
+    coap_pkt_t memo_pdu;
+
+    for (int i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
+        gcoap_request_memo_t *memo = &_coap_state.open_reqs[i];
+
+        if ((memo->state == GCOAP_MEMO_UNUSED) ||
+                (memo->send_limit == GCOAP_SEND_LIMIT_NON)) {
+            continue;
+        }
+        memo_pdu.hdr = (coap_hdr_t *)memo->msg.data.pdu_buf;
+        if ((coap_get_id(&memo_pdu) == coap_get_id(src_pdu))
+                && sock_udp_ep_equal(&memo->remote_ep, remote)) {
+            *memo_ptr = memo;
+            break;
+        }
+    }
+}
+
+/*
+ * Handles an empty ACK or RST for a confirmable message sent by gcoap.
+ */
+static void _handle_empty(coap_pkt_t *pdu, sock_udp_ep_t *remote)
+{
+    gcoap_request_memo_t *memo = NULL;
+    unsigned type = coap_get_type(pdu);
+
+    if ((type != COAP_TYPE_ACK) && (type != COAP_TYPE_RST)) {
+        DEBUG("gcoap: illegal empty message type: %u\n", type);
+        return;
+    }
+    _find_req_memo_by_id(&memo, pdu, remote);
+    if (memo == NULL) {
+        DEBUG("gcoap: msg not found for ID: %u\n", coap_get_id(pdu));
+        return;
+    }
+    _clear_timeout(memo);
+
+    if ((type == COAP_TYPE_ACK) && (memo->resp_handler != NULL)) {
+        /* The request was accepted, but the response is separate. Stop
+         * resending and wait for the response like for a non-confirmable
+         * request. */
+        uint8_t hdr[GCOAP_HEADER_MAXLEN];
+
+        memcpy(hdr, memo->msg.data.pdu_buf, GCOAP_HEADER_MAXLEN);
+        *memo->msg.data.pdu_buf = 0;        /* clear resend buffer */
+        memcpy(&memo->msg.hdr_buf[0], hdr, GCOAP_HEADER_MAXLEN);
+        memo->send_limit = GCOAP_SEND_LIMIT_NON;
+        _set_timeout(memo, GCOAP_NON_TIMEOUT);
+        return;
+    }
+    if ((type == COAP_TYPE_RST) && (memo->resp_handler != NULL)) {
+        memo->state = GCOAP_MEMO_ERR;
+        memo->resp_handler(memo->state, pdu, remote);
+    }
+    /* message without response handler, e.g. a separate response, is done */
+    *memo->msg.data.pdu_buf = 0;            /* clear resend buffer */
+    memo->state = GCOAP_MEMO_UNUSED;
+}
+
+/* Acknowledges a confirmable message with an empty ACK. */
+static void _send_empty_ack(coap_pkt_t *pdu, sock_udp_ep_t *remote)
+{
+    coap_hdr_t ack;
+
+    coap_build_hdr(&ack, COAP_TYPE_ACK, NULL, 0, COAP_CODE_EMPTY,
+                   coap_get_id(pdu));
+    ssize_t bytes = _send(&ack, sizeof(ack), remote);
+    if (bytes <= 0) {
+        DEBUG("gcoap: send ACK failed: %d\n", (int)bytes);
+    }
+}
+
 /* Calls handler callback on receipt of a timeout message. */
 static void _expire_request(gcoap_request_memo_t *memo)
 {
@@ -516,6 +854,37 @@ static ssize_t _well_known_core_handler(coap_pkt_t* pdu, uint8_t *buf, size_t le
     return gcoap_finish(pdu, (size_t)plen, COAP_FORMAT_LINK);
 }
 
+/*
+ * Hash bucket of an observer endpoint.
+ */
+static unsigned _observer_hash(const sock_udp_ep_t *remote)
+{
+    const uint8_t *addr = (const uint8_t *)&remote->addr;
+    unsigned addr_len = sizeof(remote->addr.ipv6);
+    unsigned hash = remote->port;
+
+#ifdef SOCK_HAS_IPV4
+    if (remote->family == AF_INET) {
+        addr_len = sizeof(remote->addr.ipv4);
+    }
+#endif
+    /* the interface identifier differs the most between clients */
+    for (unsigned i = 0; i < addr_len; i++) {
+        hash = (hash * 31) + addr[i];
+    }
+    return hash & (GCOAP_OBS_HASH_SIZE - 1);
+}
+
+/*
+ * Hash bucket of the observe memos for a resource.
+ */
+static unsigned _obs_memo_hash(const coap_resource_t *resource)
+{
+    /* resources are mostly elements of an array */
+    return ((uintptr_t)resource / sizeof(coap_resource_t))
+           & (GCOAP_OBS_HASH_SIZE - 1);
+}
+
 /*
  * Find registered observer for a remote address and port.
  *
@@ -527,19 +896,104 @@ static ssize_t _well_known_core_handler(coap_pkt_t* pdu, uint8_t *buf, size_t le
  */
 static int _find_observer(sock_udp_ep_t **observer, sock_udp_ep_t *remote)
 {
-    int empty_slot = -1;
-    *observer      = NULL;
-    for (unsigned i = 0; i < GCOAP_OBS_CLIENTS_MAX; i++) {
+    uint8_t i = _coap_state.observer_heads[_observer_hash(remote)];
 
-        if (_coap_state.observers[i].family == AF_UNSPEC) {
-            empty_slot = i;
-        }
-        else if (sock_udp_ep_equal(&_coap_state.observers[i], remote)) {
+    *observer = NULL;
+    while (i != GCOAP_OBS_NONE) {
+        if (sock_udp_ep_equal(&_coap_state.observers[i], remote)) {
             *observer = &_coap_state.observers[i];
-            break;
+            return -1;
         }
+        i = _coap_state.observer_next[i];
     }
-    return empty_slot;
+    for (unsigned j = 0; j < GCOAP_OBS_CLIENTS_MAX; j++) {
+        if (_coap_state.observers[j].family == AF_UNSPEC) {
+            return j;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Register an observer in an empty slot.
+ *
+ * return the registered observer
+ */
+static sock_udp_ep_t *_add_observer(int slot, const sock_udp_ep_t *remote)
+{
+    sock_udp_ep_t *observer = &_coap_state.observers[slot];
+    unsigned hash = _observer_hash(remote);
+
+    memcpy(observer, remote, sizeof(sock_udp_ep_t));
+    _coap_state.observer_next[slot] = _coap_state.observer_heads[hash];
+    _coap_state.observer_heads[hash] = slot;
+    /* the first notification is never delayed */
+    _coap_state.observer_notified[slot] = (uint32_t)(xtimer_now_usec64() / US_PER_MS)
+                                          - GCOAP_OBS_NOTIFY_INTERVAL_MS;
+    _coap_state.observer_backoff[slot] = 0;
+    return observer;
+}
+
+/*
+ * Remove an observer without memos.
+ */
+static void _remove_observer(sock_udp_ep_t *observer)
+{
+    uint8_t slot = observer - &_coap_state.observers[0];
+    uint8_t *i = &_coap_state.observer_heads[_observer_hash(observer)];
+
+    while (*i != slot) {
+        i = &_coap_state.observer_next[*i];
+    }
+    *i = _coap_state.observer_next[slot];
+    observer->family = AF_UNSPEC;
+}
+
+/*
+ * Add an observe memo to the bucket of a resource.
+ */
+static void _link_obs_memo(gcoap_observe_memo_t *memo,
+                           const coap_resource_t *resource)
+{
+    unsigned hash = _obs_memo_hash(resource);
+
+    memo->resource = resource;
+    memo->next = _coap_state.obs_memo_heads[hash];
+    _coap_state.obs_memo_heads[hash] = memo - &_coap_state.observe_memos[0];
+}
+
+/*
+ * Remove an observe memo from the bucket of its resource.
+ */
+static void _unlink_obs_memo(gcoap_observe_memo_t *memo)
+{
+    uint8_t slot = memo - &_coap_state.observe_memos[0];
+    uint8_t *i = &_coap_state.obs_memo_heads[_obs_memo_hash(memo->resource)];
+
+    while (*i != slot) {
+        i = &_coap_state.observe_memos[*i].next;
+    }
+    *i = memo->next;
+}
+
+/*
+ * Find the next observe memo for a resource in a bucket.
+ *
+ * i[in] -- Index of the memo to start with
+ * resource[in] -- Resource to match
+ *
+ * return the memo, or NULL if not found
+ */
+static gcoap_observe_memo_t *_next_obs_memo(uint8_t i,
+                                            const coap_resource_t *resource)
+{
+    while (i != GCOAP_OBS_NONE) {
+        if (_coap_state.observe_memos[i].resource == resource) {
+            return &_coap_state.observe_memos[i];
+        }
+        i = _coap_state.observe_memos[i].next;
+    }
+    return NULL;
 }
 
 /*
@@ -596,16 +1050,398 @@ static int _find_obs_memo(gcoap_observe_memo_t **memo, sock_udp_ep_t *remote,
 static void _find_obs_memo_resource(gcoap_observe_memo_t **memo,
                                    const coap_resource_t *resource)
 {
-    *memo = NULL;
-    for (int i = 0; i < GCOAP_OBS_REGISTRATIONS_MAX; i++) {
-        if (_coap_state.observe_memos[i].observer != NULL
-                && _coap_state.observe_memos[i].resource == resource) {
-            *memo = &_coap_state.observe_memos[i];
-            break;
+    *memo = _next_obs_memo(_coap_state.obs_memo_heads[_obs_memo_hash(resource)],
+                           resource);
+}
+
+/*
+ * Time in ms after the last notification to the observer of a memo, when
+ * the next one may be sent.
+ */
+static uint32_t _obs_due(const gcoap_observe_memo_t *memo)
+{
+    unsigned slot = memo->observer - &_coap_state.observers[0];
+
+    return _coap_state.observer_notified[slot]
+           + ((uint32_t)GCOAP_OBS_NOTIFY_INTERVAL_MS
+              << _coap_state.observer_backoff[slot]);
+}
+
+/*
+ * Marks the notification for an observe memo pending, and starts the timer
+ * if the interval of the observer ends before the one it runs for. Expects
+ * the lock to be held.
+ *
+ * now[in] -- Current time in ms, before the end of the interval
+ */
+static void _obs_set_pending(gcoap_observe_memo_t *memo, uint32_t now)
+{
+    uint32_t due = _obs_due(memo);
+
+    memo->state = GCOAP_OBS_MEMO_PENDING;
+    if (_coap_state.obs_timer_set
+            && ((int32_t)(due - _coap_state.obs_due) >= 0)) {
+        return;
+    }
+    _coap_state.obs_due       = due;
+    _coap_state.obs_timer_set = true;
+#ifdef MODULE_GNRC_UDP_MUX
+    _coap_state.obs_event.handler = _on_obs_event;
+    _coap_state.obs_timer.callback = _on_obs_timer;
+    xtimer_set(&_coap_state.obs_timer, (due - now) * US_PER_MS);
+#else
+    _coap_state.obs_msg.type = GCOAP_MSG_TYPE_OBS;
+    xtimer_set_msg(&_coap_state.obs_timer, (due - now) * US_PER_MS,
+                   &_coap_state.obs_msg, _pid);
+    /* The gcoap thread may wait without timeout in _listen(), so it would not
+     * see the timer message. Interrupt listening as in gcoap_req_send2(), so
+     * the thread waits with limited timeout from now on. */
+    if (thread_getpid() != _pid) {
+        msg_t mbox_msg;
+        mbox_msg.type          = GCOAP_MSG_TYPE_INTR;
+        mbox_msg.content.value = 0;
+        if (!mbox_try_put(&_sock.reg.mbox, &mbox_msg)) {
+            DEBUG("gcoap: can't wake up mbox for pending notification\n");
         }
     }
+#endif
 }
 
+/*
+ * Records a notification sent to the observer of a memo. If it could not be
+ * sent, the notification stays pending, and the interval for the observer
+ * doubles. Expects the lock to be held.
+ */
+static void _obs_notified(gcoap_observe_memo_t *memo, bool sent, uint32_t now)
+{
+    unsigned slot = memo->observer - &_coap_state.observers[0];
+    uint8_t *backoff = &_coap_state.observer_backoff[slot];
+
+    _coap_state.observer_notified[slot] = now;
+    if (sent) {
+        memo->state = GCOAP_OBS_MEMO_IDLE;
+        if (*backoff > 0) {
+            (*backoff)--;
+        }
+    }
+    else {
+        if (*backoff < GCOAP_OBS_NOTIFY_BACKOFF_MAX) {
+            (*backoff)++;
+        }
+        DEBUG("gcoap: notification failed, backoff %u for observer %u\n",
+              *backoff, slot);
+        _obs_set_pending(memo, now);
+    }
+}
+
+/*
+ * Sends the pending notifications, for which the interval of the observer
+ * has ended, with the current state of the resource, and starts the timer
+ * for the remaining ones.
+ */
+static void _notify_pending(void)
+{
+#ifdef MODULE_GNRC_UDP_MUX
+    /* runs on the multiplexer thread like the handling of requests */
+    uint8_t *buf = _req_buf;
+#else
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+#endif
+
+    while (1) {
+        gcoap_observe_memo_t *memo = NULL;
+        uint32_t now = (uint32_t)(xtimer_now_usec64() / US_PER_MS);
+
+        mutex_lock(&_coap_state.lock);
+        _coap_state.obs_timer_set = false;
+        for (unsigned i = 0; i < GCOAP_OBS_REGISTRATIONS_MAX; i++) {
+            gcoap_observe_memo_t *pending = &_coap_state.observe_memos[i];
+
+            if ((pending->observer == NULL)
+                    || (pending->state != GCOAP_OBS_MEMO_PENDING)) {
+                continue;
+            }
+            if ((int32_t)(now - _obs_due(pending)) >= 0) {
+                memo = pending;
+                break;
+            }
+            _obs_set_pending(pending, now);
+        }
+        if (memo == NULL) {
+            mutex_unlock(&_coap_state.lock);
+            return;
+        }
+
+        /* the resource handler encodes the notification as response to a
+         * registration, which is sent without lock. The memo stays pending
+         * until the notification has been sent. */
+        sock_udp_ep_t remote = *memo->observer;
+        const coap_resource_t *resource = memo->resource;
+        uint16_t msgid = (uint16_t)atomic_fetch_add(&_coap_state.next_message_id, 1);
+        ssize_t hdrlen = coap_build_hdr((coap_hdr_t *)buf, COAP_TYPE_NON,
+                                        &memo->token[0], memo->token_len,
+                                        COAP_METHOD_GET, msgid);
+        mutex_unlock(&_coap_state.lock);
+
+        coap_pkt_t pdu;
+        bool sent = false;
+
+        coap_pkt_init(&pdu, buf, GCOAP_PDU_BUF_SIZE, hdrlen);
+        coap_opt_add_uint(&pdu, COAP_OPT_OBSERVE, COAP_OBS_REGISTER);
+        ssize_t len = coap_opt_finish(&pdu, COAP_OPT_FINISH_NONE);
+        if (coap_parse(&pdu, buf, len) == 0) {
+            _coap_state.req_remote = &remote;
+            len = resource->handler(&pdu, buf, GCOAP_PDU_BUF_SIZE,
+                                    resource->context);
+            _coap_state.req_remote = NULL;
+            if (len > 0) {
+                sent = (_send(buf, len, &remote) > 0);
+            }
+            else {
+                DEBUG("gcoap: no pending notification for %s\n",
+                      resource->path);
+            }
+        }
+
+        mutex_lock(&_coap_state.lock);
+        /* the observer may have deregistered meanwhile */
+        if ((memo->observer != NULL) && (memo->resource == resource)
+                && sock_udp_ep_equal(memo->observer, &remote)) {
+            /* otherwise retried after the interval with backoff */
+            _obs_notified(memo, sent, now);
+        }
+        mutex_unlock(&_coap_state.lock);
+    }
+}
+
+#ifdef MODULE_GCOAP_RESP_CACHE
+static uint32_t _cache_hash(uint32_t hash, const uint8_t *data, size_t len)
+{
+    /* FNV-1a */
+    while (len--) {
+        hash = (hash ^ *data++) * 16777619U;
+    }
+    return hash;
+}
+
+static uint32_t _cache_now(void)
+{
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC);
+}
+
+/*
+ * Builds the cache key of a request.
+ *
+ * The key is the method and all options except for ETag and options marked
+ * NoCacheKey, each as option number, length and value. The hash of the path
+ * is computed, even if the key is too long.
+ */
+static void _cache_key(coap_pkt_t *pdu, _cache_key_t *key)
+{
+    bool fits = true;
+
+    key->method = coap_get_code_raw(pdu);
+    key->len = 0;
+    key->path_hash = 2166136261U;
+    for (unsigned i = 0; i < pdu->options_len; i++) {
+        const coap_optpos_t *opt = &pdu->options[i];
+        unsigned num = opt->opt_num;
+        uint8_t *value = coap_opt_value(pdu, opt);
+
+        if ((num == COAP_OPT_ETAG) || ((num & 0x1e) == 0x1c)) {
+            continue;
+        }
+        if (num == COAP_OPT_URI_PATH) {
+            key->path_hash = _cache_hash(key->path_hash,
+                                         (const uint8_t *)"/", 1);
+            key->path_hash = _cache_hash(key->path_hash, value, opt->len);
+        }
+        if (!fits || ((key->len + 3U + opt->len) >= sizeof(key->data))) {
+            fits = false;
+            continue;
+        }
+        key->data[key->len++] = num >> 8;
+        key->data[key->len++] = num & 0xff;
+        key->data[key->len++] = opt->len;
+        memcpy(&key->data[key->len], value, opt->len);
+        key->len += opt->len;
+    }
+    if (!fits || (key->method != COAP_METHOD_GET) || coap_has_observe(pdu)
+            || (pdu->payload_len > 0)) {
+        key->len = 0;
+    }
+    else {
+        /* an empty key still differs from a request not cacheable */
+        key->data[key->len++] = 0;
+    }
+}
+
+static _cache_entry_t *_cache_find(const _cache_key_t *key)
+{
+    for (unsigned i = 0; i < GCOAP_RESP_CACHE_SIZE; i++) {
+        _cache_entry_t *entry = &_coap_state.resp_cache[i];
+
+        if (entry->used && (entry->key.len == key->len)
+                && (memcmp(entry->key.data, key->data, key->len) == 0)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Answers a request from the response cache.
+ *
+ * key[out] -- Cache key of the request, for _cache_update()
+ *
+ * return length of the response in buf, or 0 if not answered
+ */
+static size_t _cache_lookup(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                            _cache_key_t *key)
+{
+    uint8_t token[GCOAP_TOKENLEN_MAX];
+    unsigned token_len = coap_get_token_len(pdu);
+    unsigned type = (coap_get_type(pdu) == COAP_TYPE_CON) ? COAP_TYPE_ACK
+                                                          : COAP_TYPE_NON;
+    uint32_t now = _cache_now();
+    bool valid = false;
+    size_t pdu_len;
+
+    _cache_key(pdu, key);
+    if ((key->len == 0) || (token_len > GCOAP_TOKENLEN_MAX)) {
+        return 0;
+    }
+
+    mutex_lock(&_coap_state.lock);
+    _cache_entry_t *entry = _cache_find(key);
+    if ((entry == NULL) || ((int32_t)(entry->expires - now) <= 0)) {
+        _coap_state.resp_cache_stats.misses++;
+        mutex_unlock(&_coap_state.lock);
+        return 0;
+    }
+    /* a matching ETag validates the response of the client */
+    if (entry->etag_len > 0) {
+        for (const coap_optpos_t *etag = coap_opt_find(pdu, COAP_OPT_ETAG);
+             etag != NULL; etag = coap_opt_next(pdu, etag)) {
+            if ((etag->len == entry->etag_len) &&
+                (memcmp(coap_opt_value(pdu, etag), &entry->pdu[entry->etag_pos],
+                        etag->len) == 0)) {
+                valid = true;
+                break;
+            }
+        }
+    }
+
+    /* the remaining freshness fits into the length of the original Max-Age */
+    uint32_t max_age = entry->expires - now;
+    for (unsigned i = entry->max_age_len; i > 0; i--) {
+        entry->pdu[entry->max_age_pos + i - 1] = max_age & 0xff;
+        max_age >>= 8;
+    }
+
+    memcpy(token, pdu->token, token_len);
+    pdu_len = coap_build_hdr((coap_hdr_t *)buf, type, token, token_len,
+                             valid ? COAP_CODE_VALID : entry->code,
+                             coap_get_id(pdu));
+    if (valid) {
+        pdu_len += coap_put_option(&buf[pdu_len], 0, COAP_OPT_ETAG,
+                                   &entry->pdu[entry->etag_pos],
+                                   entry->etag_len);
+        pdu_len += coap_put_option(&buf[pdu_len], COAP_OPT_ETAG,
+                                   COAP_OPT_MAX_AGE,
+                                   &entry->pdu[entry->max_age_pos],
+                                   entry->max_age_len);
+        _coap_state.resp_cache_stats.validated++;
+    }
+    else {
+        assert((pdu_len + entry->len) <= len);
+        memcpy(&buf[pdu_len], entry->pdu, entry->len);
+        pdu_len += entry->len;
+    }
+    entry->used = ++_coap_state.resp_cache_clock;
+    _coap_state.resp_cache_stats.hits++;
+    mutex_unlock(&_coap_state.lock);
+    (void)len;      /* only used in assert */
+
+    DEBUG("gcoap: response from cache\n");
+    return pdu_len;
+}
+
+/*
+ * Stores the response to a cacheable request, or removes the responses for
+ * the path of a successful unsafe request.
+ */
+static void _cache_update(const _cache_key_t *key, uint8_t *buf, size_t len)
+{
+    coap_pkt_t pdu;
+    uint32_t max_age;
+    uint32_t now = _cache_now();
+
+    if ((len == 0) || (len > GCOAP_PDU_BUF_SIZE)
+            || (coap_parse(&pdu, buf, len) < 0)) {
+        return;
+    }
+    if (key->method != COAP_METHOD_GET) {
+        if (coap_get_code_class(&pdu) == COAP_CLASS_SUCCESS) {
+            mutex_lock(&_coap_state.lock);
+            for (unsigned i = 0; i < GCOAP_RESP_CACHE_SIZE; i++) {
+                if (_coap_state.resp_cache[i].key.path_hash == key->path_hash) {
+                    _coap_state.resp_cache[i].used = 0;
+                }
+            }
+            mutex_unlock(&_coap_state.lock);
+        }
+        return;
+    }
+
+    size_t hdr_len = coap_get_total_hdr_len(&pdu);
+    if ((key->len == 0) || (coap_get_code_raw(&pdu) != COAP_CODE_CONTENT)
+            || (coap_get_option_uint(&pdu, COAP_OPT_MAX_AGE, &max_age) != 0)
+            || (max_age == 0) || ((len - hdr_len) > GCOAP_RESP_CACHE_PDU_SIZE)) {
+        return;
+    }
+
+    mutex_lock(&_coap_state.lock);
+    /* replace the same request, else an unused or stale response, else the
+     * least recently used one */
+    _cache_entry_t *entry = _cache_find(key);
+    if (entry == NULL) {
+        entry = &_coap_state.resp_cache[0];
+        for (unsigned i = 0; i < GCOAP_RESP_CACHE_SIZE; i++) {
+            _cache_entry_t *tmp = &_coap_state.resp_cache[i];
+
+            if ((tmp->used == 0) || ((int32_t)(tmp->expires - now) <= 0)) {
+                entry = tmp;
+                break;
+            }
+            if (tmp->used < entry->used) {
+                entry = tmp;
+            }
+        }
+        if (entry->used && ((int32_t)(entry->expires - now) > 0)) {
+            _coap_state.resp_cache_stats.evictions++;
+        }
+    }
+
+    const coap_optpos_t *opt = coap_opt_find(&pdu, COAP_OPT_MAX_AGE);
+    entry->max_age_pos = opt->value - hdr_len;
+    entry->max_age_len = opt->len;
+    entry->etag_len = 0;
+    opt = coap_opt_find(&pdu, COAP_OPT_ETAG);
+    if (opt != NULL) {
+        entry->etag_pos = opt->value - hdr_len;
+        entry->etag_len = opt->len;
+    }
+    memcpy(&entry->key, key, sizeof(entry->key));
+    entry->code = coap_get_code_raw(&pdu);
+    entry->expires = now + max_age;
+    entry->len = len - hdr_len;
+    memcpy(entry->pdu, &buf[hdr_len], entry->len);
+    entry->used = ++_coap_state.resp_cache_clock;
+    mutex_unlock(&_coap_state.lock);
+}
+#endif
+
 /*
  * gcoap interface functions
  */
@@ -615,17 +1451,33 @@ kernel_pid_t gcoap_init(void)
     if (_pid != KERNEL_PID_UNDEF) {
         return -EEXIST;
     }
+#ifdef MODULE_GNRC_UDP_MUX
+    _pid = gnrc_udp_mux_init();
+#else
     _pid = thread_create(_msg_stack, sizeof(_msg_stack), THREAD_PRIORITY_MAIN - 1,
                             THREAD_CREATE_STACKTEST, _event_loop, NULL, "coap");
+#endif
 
     mutex_init(&_coap_state.lock);
     /* Blank lists so we know if an entry is available. */
     memset(&_coap_state.open_reqs[0], 0, sizeof(_coap_state.open_reqs));
     memset(&_coap_state.observers[0], 0, sizeof(_coap_state.observers));
     memset(&_coap_state.observe_memos[0], 0, sizeof(_coap_state.observe_memos));
+    memset(&_coap_state.observer_heads[0], GCOAP_OBS_NONE,
+           sizeof(_coap_state.observer_heads));
+    memset(&_coap_state.obs_memo_heads[0], GCOAP_OBS_NONE,
+           sizeof(_coap_state.obs_memo_heads));
     memset(&_coap_state.resend_bufs[0], 0, sizeof(_coap_state.resend_bufs));
+    memset(&_coap_state.req_ctxs[0], 0, sizeof(_coap_state.req_ctxs));
     /* randomize initial value */
     atomic_init(&_coap_state.next_message_id, (unsigned)random_uint32());
+#ifdef MODULE_GNRC_UDP_MUX
+    int res = gnrc_udp_mux_add(&_ep, GCOAP_PORT, gnrc_udp_mux_queue(), _on_udp,
+                               NULL);
+    if (res < 0) {
+        DEBUG("gcoap: cannot register port: %d\n", res);
+    }
+#endif
 
     return _pid;
 }
@@ -805,10 +1657,15 @@ size_t gcoap_req_send2(const uint8_t *buf, size_t len,
     }
 
     /* Memos complete; send msg and start timer */
-    ssize_t res = sock_udp_send(&_sock, buf, len, remote);
+    ssize_t res = _send(buf, len, remote);
 
     /* timeout may be zero for non-confirmable */
     if ((memo != NULL) && (res > 0) && (timeout > 0)) {
+#ifdef MODULE_GNRC_UDP_MUX
+        /* the timeout is posted to the multiplexer thread, which does not
+         * block in a receive */
+        _set_timeout(memo, timeout);
+#else
         /* We assume gcoap_req_send2() is called on some thread other than
          * gcoap's. First, put a message in the mbox for the sock udp object,
          * which will interrupt listening on the gcoap thread. (When there are
@@ -822,14 +1679,13 @@ size_t gcoap_req_send2(const uint8_t *buf, size_t len,
         mbox_msg.content.value = 0;
         if (mbox_try_put(&_sock.reg.mbox, &mbox_msg)) {
             /* start response wait timer on the gcoap thread */
-            memo->timeout_msg.type        = GCOAP_MSG_TYPE_TIMEOUT;
-            memo->timeout_msg.content.ptr = (char *)memo;
-            xtimer_set_msg(&memo->response_timer, timeout, &memo->timeout_msg, _pid);
+            _set_timeout(memo, timeout);
         }
         else {
             res = 0;
             DEBUG("gcoap: can't wake up mbox; no timeout for msg\n");
         }
+#endif
     }
     if (res <= 0) {
         if (memo != NULL) {
@@ -866,6 +1722,91 @@ int gcoap_resp_init(coap_pkt_t *pdu, uint8_t *buf, size_t len, unsigned code)
     return 0;
 }
 
+ssize_t gcoap_resp_defer(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                         gcoap_req_ctx_t **ctx)
+{
+    gcoap_req_ctx_t *req_ctx = NULL;
+
+    assert(_coap_state.req_remote != NULL);
+    assert(len >= sizeof(coap_hdr_t));
+    (void)len;
+
+    mutex_lock(&_coap_state.lock);
+    for (int i = 0; i < GCOAP_REQ_CTX_MAX; i++) {
+        if (!_coap_state.req_ctxs[i].in_use) {
+            req_ctx = &_coap_state.req_ctxs[i];
+            req_ctx->in_use = true;
+            break;
+        }
+    }
+    mutex_unlock(&_coap_state.lock);
+    if (req_ctx == NULL) {
+        DEBUG("gcoap: no request context to defer response\n");
+        return -ENOMEM;
+    }
+
+    /* read the request before the ACK overwrites it in buf */
+    memcpy(&req_ctx->remote, _coap_state.req_remote, sizeof(sock_udp_ep_t));
+    req_ctx->token_len = coap_get_token_len(pdu);
+    memcpy(&req_ctx->token[0], pdu->token, req_ctx->token_len);
+    req_ctx->type = coap_get_type(pdu);
+    *ctx = req_ctx;
+
+    if (req_ctx->type == COAP_TYPE_CON) {
+        return coap_build_hdr((coap_hdr_t *)buf, COAP_TYPE_ACK, NULL, 0,
+                              COAP_CODE_EMPTY, coap_get_id(pdu));
+    }
+    return 0;
+}
+
+const sock_udp_ep_t *gcoap_req_remote(void)
+{
+    assert(_coap_state.req_remote != NULL);
+    return _coap_state.req_remote;
+}
+
+int gcoap_resp_init_deferred(const gcoap_req_ctx_t *ctx, coap_pkt_t *pdu,
+                             uint8_t *buf, size_t len, unsigned code)
+{
+    pdu->hdr       = (coap_hdr_t *)buf;
+    uint16_t msgid = (uint16_t)atomic_fetch_add(&_coap_state.next_message_id, 1);
+    /* same type as the request, i.e. confirmable for a confirmable request */
+    ssize_t hdrlen = coap_build_hdr(pdu->hdr, ctx->type,
+                                    (uint8_t *)&ctx->token[0], ctx->token_len,
+                                    code, msgid);
+
+    if (hdrlen > 0) {
+        coap_pkt_init(pdu, buf, len - GCOAP_RESP_OPTIONS_BUF, hdrlen);
+        return 0;
+    }
+    else {
+        /* reason for negative hdrlen is not defined, so we also are vague */
+        return -1;
+    }
+}
+
+size_t gcoap_resp_send_deferred(gcoap_req_ctx_t *ctx, const uint8_t *buf,
+                                size_t len)
+{
+    size_t res = 0;
+
+    if (ctx->type == COAP_TYPE_CON) {
+        /* resent like a confirmable request, until acknowledged */
+        res = gcoap_req_send2(buf, len, &ctx->remote, NULL);
+    }
+    if (res == 0) {
+        /* no memo or resend buffer for a confirmable response, so at least
+         * try once */
+        ssize_t bytes = _send(buf, len, &ctx->remote);
+        res = (size_t)((bytes > 0) ? bytes : 0);
+    }
+
+    mutex_lock(&_coap_state.lock);
+    ctx->in_use = false;
+    mutex_unlock(&_coap_state.lock);
+    return res;
+}
+
 int gcoap_obs_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
                                                   const coap_resource_t *resource)
 {
@@ -905,7 +1846,7 @@ size_t gcoap_obs_send(const uint8_t *buf, size_t len,
     _find_obs_memo_resource(&memo, resource);
 
     if (memo) {
-        ssize_t bytes = sock_udp_send(&_sock, buf, len, memo->observer);
+        ssize_t bytes = _send(buf, len, memo->observer);
         return (size_t)((bytes > 0) ? bytes : 0);
     }
     else {
@@ -913,6 +1854,110 @@ size_t gcoap_obs_send(const uint8_t *buf, size_t len,
     }
 }
 
+int gcoap_obs_init_all(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                       const coap_resource_t *resource)
+{
+    /* placeholder, replaced by the token of each observer */
+    uint8_t token[GCOAP_TOKENLEN_MAX] = { 0 };
+    gcoap_observe_memo_t *memo = NULL;
+
+    _find_obs_memo_resource(&memo, resource);
+    if (memo == NULL) {
+        return GCOAP_OBS_INIT_UNUSED;
+    }
+
+    pdu->hdr       = (coap_hdr_t *)buf;
+    ssize_t hdrlen = coap_build_hdr(pdu->hdr, COAP_TYPE_NON, token,
+                                    sizeof(token), COAP_CODE_CONTENT, 0);
+
+    if (hdrlen > 0) {
+        coap_pkt_init(pdu, buf, len - GCOAP_OBS_OPTIONS_BUF, hdrlen);
+
+        uint32_t now       = xtimer_now_usec();
+        pdu->observe_value = (now >> GCOAP_OBS_TICK_EXPONENT) & 0xFFFFFF;
+        coap_opt_add_uint(pdu, COAP_OPT_OBSERVE, pdu->observe_value);
+
+        return GCOAP_OBS_INIT_OK;
+    }
+    else {
+        return GCOAP_OBS_INIT_ERR;
+    }
+}
+
+unsigned gcoap_obs_send_all(uint8_t *buf, size_t len,
+                            const coap_resource_t *resource)
+{
+    uint8_t token[GCOAP_TOKENLEN_MAX];
+    uint8_t due[GCOAP_OBS_REGISTRATIONS_MAX];
+    unsigned due_num = 0;
+    unsigned sent = 0;
+    uint8_t code = ((coap_hdr_t *)buf)->code;
+#if GCOAP_OBS_NOTIFY_INTERVAL_MS
+    uint32_t now = (uint32_t)(xtimer_now_usec64() / US_PER_MS);
+#endif
+    gcoap_observe_memo_t *memo = NULL;
+
+    /* the Observe option after the placeholder token stays in place, only
+     * header and token are rewritten in front of it for each observer */
+    assert((buf[0] & 0x0f) == GCOAP_TOKENLEN_MAX);
+
+    /* select the observers to notify now; the notifications are sent without
+     * lock, so the calling thread does not hold up the gcoap thread */
+    mutex_lock(&_coap_state.lock);
+    for (_find_obs_memo_resource(&memo, resource); memo != NULL;
+         memo = _next_obs_memo(memo->next, resource)) {
+#if GCOAP_OBS_NOTIFY_INTERVAL_MS
+        if ((int32_t)(now - _obs_due(memo)) < 0) {
+            /* sent with the state of the resource at the end of the
+             * interval */
+            DEBUG("gcoap: notification too early for an observer of %s\n",
+                  resource->path);
+            _obs_set_pending(memo, now);
+            continue;
+        }
+#endif
+        due[due_num++] = memo - &_coap_state.observe_memos[0];
+    }
+    mutex_unlock(&_coap_state.lock);
+
+    for (unsigned i = 0; i < due_num; i++) {
+        sock_udp_ep_t remote;
+        unsigned start;
+
+        memo = &_coap_state.observe_memos[due[i]];
+        mutex_lock(&_coap_state.lock);
+        /* the observer may have deregistered meanwhile */
+        if ((memo->observer == NULL) || (memo->resource != resource)) {
+            mutex_unlock(&_coap_state.lock);
+            continue;
+        }
+        remote = *memo->observer;
+        start  = GCOAP_TOKENLEN_MAX - memo->token_len;
+        uint16_t msgid = (uint16_t)atomic_fetch_add(&_coap_state.next_message_id, 1);
+        coap_build_hdr((coap_hdr_t *)&buf[start], COAP_TYPE_NON,
+                       &memo->token[0], memo->token_len, code, msgid);
+        mutex_unlock(&_coap_state.lock);
+
+        bool notified = (_send(&buf[start], len - start, &remote) > 0);
+        if (notified) {
+            sent++;
+        }
+#if GCOAP_OBS_NOTIFY_INTERVAL_MS
+        mutex_lock(&_coap_state.lock);
+        if ((memo->observer != NULL) && (memo->resource == resource)
+                && sock_udp_ep_equal(memo->observer, &remote)) {
+            _obs_notified(memo, notified, now);
+        }
+        mutex_unlock(&_coap_state.lock);
+#endif
+    }
+    /* restore the placeholder, so the buffer can be sent again */
+    memset(token, 0, sizeof(token));
+    coap_build_hdr((coap_hdr_t *)buf, COAP_TYPE_NON, token, sizeof(token),
+                   code, 0);
+    return sent;
+}
+
 uint8_t gcoap_op_state(void)
 {
     uint8_t count = 0;
@@ -924,6 +1969,34 @@ uint8_t gcoap_op_state(void)
     return count;
 }
 
+#ifdef MODULE_GCOAP_RESP_CACHE
+void gcoap_resp_cache_get_stats(gcoap_resp_cache_stats_t *stats)
+{
+    mutex_lock(&_coap_state.lock);
+    memcpy(stats, &_coap_state.resp_cache_stats, sizeof(*stats));
+    mutex_unlock(&_coap_state.lock);
+}
+
+void gcoap_resp_cache_invalidate(const char *path)
+{
+    uint32_t path_hash = 2166136261U;
+
+    /* same as the hash of the Uri-Path options; "/" has none */
+    if ((path != NULL) && (strcmp(path, "/") != 0)) {
+        path_hash = _cache_hash(path_hash, (const uint8_t *)path,
+                                strlen(path));
+    }
+    mutex_lock(&_coap_state.lock);
+    for (unsigned i = 0; i < GCOAP_RESP_CACHE_SIZE; i++) {
+        if ((path == NULL)
+                || (_coap_state.resp_cache[i].key.path_hash == path_hash)) {
+            _coap_state.resp_cache[i].used = 0;
+        }
+    }
+    mutex_unlock(&_coap_state.lock);
+}
+#endif
+
 int gcoap_get_resource_list(void *buf, size_t maxlen, uint8_t cf)
 {
     (void)cf; /* only used in the assert below. */
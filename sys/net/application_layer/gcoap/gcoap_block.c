@@ -0,0 +1,546 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gcoap
+ * @{
+ *
+ * @file
+ * @brief       Block-wise transfers (RFC 7959) for gcoap
+ *
+ * The server side reads or writes only the block of a request. The client
+ * side keeps up to a window of block requests in flight, each in a slot
+ * that is matched to its response or timeout by the token.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "assert.h"
+#include "mutex.h"
+#include "net/gcoap.h"
+#ifdef MODULE_VFS
+#include "vfs.h"
+#endif
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/* Largest block size exponent, as SZX */
+#define BLOCK_SZX_MAX       (NANOCOAP_BLOCK_SIZE_EXP_MAX - 4)
+
+/* Reserved in a PDU for a block option and the payload marker */
+#define BLOCK_OPT_BUF       (5)
+
+/* Block number while the last block of a transfer is unknown */
+#define BLOCK_NONE          (UINT32_MAX)
+
+/* Slot states of a client transfer */
+#define SLOT_UNUSED         (0)
+#define SLOT_WAIT           (1)     /* request sent */
+#define SLOT_RESEND         (2)     /* request to be sent again */
+
+typedef struct {
+    uint8_t token[GCOAP_TOKENLEN];
+    uint8_t state;
+    uint8_t retries;
+    uint16_t len;                   /* payload length of an upload */
+    uint32_t blknum;
+} _slot_t;
+
+static void _resp_handler(unsigned req_state, coap_pkt_t *pdu,
+                          sock_udp_ep_t *remote);
+
+/* Only one client transfer at a time, because a response handler has no
+ * context */
+static mutex_t _xfer_lock = MUTEX_INIT;
+
+static struct {
+    const gcoap_block_xfer_t *xfer;
+    mutex_t lock;                   /* protects the state, locked by the
+                                       caller and the gcoap thread */
+    mutex_t wakeup;                 /* unlocked on each response or timeout */
+    _slot_t slots[GCOAP_REQ_WAITING_MAX];
+    unsigned szx;
+    bool agreed;                    /* szx agreed with the server */
+    uint32_t start;                 /* first block */
+    uint32_t next;                  /* next block to request */
+    uint32_t last;                  /* last block, BLOCK_NONE if unknown */
+    uint32_t limit;                 /* first block past the end, reported by
+                                       the server for a download */
+    size_t bytes;
+    int error;
+} _state = {
+    .lock = MUTEX_INIT,
+    .wakeup = MUTEX_INIT_LOCKED,
+};
+
+/* Largest SZX up to @p szx for a block that fits into @p avail bytes */
+static unsigned _fit_szx(unsigned szx, size_t avail)
+{
+    while ((szx > 0) && (coap_szx2size(szx) > avail)) {
+        szx--;
+    }
+    return szx;
+}
+
+static inline uint32_t _blkopt(uint32_t blknum, bool more, unsigned szx)
+{
+    return (blknum << 4) | (more ? 0x8 : 0) | szx;
+}
+
+ssize_t gcoap_block2_resp(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                          unsigned format, gcoap_block_read_t read, void *arg)
+{
+    uint32_t blknum;
+    unsigned szx;
+    uint8_t probe;
+
+    if ((coap_get_blockopt(pdu, COAP_OPT_BLOCK2, &blknum, &szx) < 0) ||
+        (szx > BLOCK_SZX_MAX)) {
+        /* first block, or smaller blocks than requested; the client follows
+         * the block size of the response */
+        size_t offset = blknum << (szx + 4);
+        szx = BLOCK_SZX_MAX;
+        blknum = offset >> (szx + 4);
+    }
+
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    if (format != COAP_FORMAT_NONE) {
+        coap_opt_add_uint(pdu, COAP_OPT_CONTENT_FORMAT, format);
+    }
+
+    /* a block must fit into the buffer, the block number is scaled to
+     * keep the offset */
+    unsigned fit = _fit_szx(szx, pdu->payload_len - BLOCK_OPT_BUF);
+    blknum <<= (szx - fit);
+    szx = fit;
+
+    size_t size = coap_szx2size(szx);
+    size_t offset = blknum * size;
+
+    /* read one byte past the block to learn if there are more */
+    ssize_t res = read(arg, offset + size, &probe, 1);
+    if (res < 0) {
+        return gcoap_response(pdu, buf, len, COAP_CODE_INTERNAL_SERVER_ERROR);
+    }
+    coap_opt_add_uint(pdu, COAP_OPT_BLOCK2, _blkopt(blknum, res > 0, szx));
+    coap_opt_finish(pdu, COAP_OPT_FINISH_PAYLOAD);
+
+    res = read(arg, offset, pdu->payload, size);
+    if (res < 0) {
+        return gcoap_response(pdu, buf, len, COAP_CODE_INTERNAL_SERVER_ERROR);
+    }
+    if ((res == 0) && (offset > 0)) {
+        /* block out of range, see RFC 7959, section 2.4 */
+        return gcoap_response(pdu, buf, len, COAP_CODE_BAD_OPTION);
+    }
+    if (res == 0) {
+        /* empty representation, no payload marker */
+        pdu->payload--;
+    }
+    pdu->payload_len = res;
+
+    return (pdu->payload - buf) + res;
+}
+
+ssize_t gcoap_block1_resp(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                          unsigned code, gcoap_block_write_t write, void *arg)
+{
+    uint32_t blknum;
+    unsigned szx;
+    int more = coap_get_blockopt(pdu, COAP_OPT_BLOCK1, &blknum, &szx);
+
+    if (szx == COAP_BLOCKWISE_SZX_MAX) {
+        /* reserved, see RFC 7959, section 2.2 */
+        return gcoap_response(pdu, buf, len, COAP_CODE_BAD_OPTION);
+    }
+
+    size_t offset = blknum << (szx + 4);
+    if (write(arg, offset, pdu->payload, pdu->payload_len, more > 0) < 0) {
+        return gcoap_response(pdu, buf, len,
+                              COAP_CODE_REQUEST_ENTITY_INCOMPLETE);
+    }
+
+    gcoap_resp_init(pdu, buf, len, (more > 0) ? COAP_CODE_CONTINUE : code);
+    if (more >= 0) {
+        if ((blknum == 0) && (szx > BLOCK_SZX_MAX)) {
+            /* the first block is accepted as a whole, the client continues
+             * with smaller blocks, see RFC 7959, section 2.3 */
+            szx = BLOCK_SZX_MAX;
+        }
+        coap_opt_add_uint(pdu, COAP_OPT_BLOCK1, _blkopt(blknum, more, szx));
+    }
+    return coap_opt_finish(pdu, COAP_OPT_FINISH_NONE);
+}
+
+/* Must be called with _state.lock held */
+static _slot_t *_slot_by_token(const uint8_t *token)
+{
+    for (unsigned i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
+        _slot_t *slot = &_state.slots[i];
+        if ((slot->state == SLOT_WAIT) &&
+            (memcmp(slot->token, token, GCOAP_TOKENLEN) == 0)) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+static unsigned _slots_in(uint8_t state)
+{
+    unsigned numof = 0;
+
+    for (unsigned i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
+        if (_state.slots[i].state == state) {
+            numof++;
+        }
+    }
+    return numof;
+}
+
+static bool _is_done(void)
+{
+    return (_state.last != BLOCK_NONE) && (_state.next > _state.last) &&
+           (_slots_in(SLOT_UNUSED) == GCOAP_REQ_WAITING_MAX);
+}
+
+static void _handle_download(_slot_t *slot, coap_pkt_t *pdu)
+{
+    const gcoap_block_xfer_t *xfer = _state.xfer;
+    uint32_t blknum;
+    unsigned szx;
+    int more;
+
+    if (coap_get_code_class(pdu) != COAP_CLASS_SUCCESS) {
+        if ((coap_get_code_raw(pdu) == COAP_CODE_BAD_OPTION) &&
+            (slot->blknum > _state.start)) {
+            /* requested past the end before the last block was known */
+            if (slot->blknum < _state.limit) {
+                _state.limit = slot->blknum;
+            }
+            return;
+        }
+        _state.error = -EIO;
+        return;
+    }
+
+    more = coap_get_blockopt(pdu, COAP_OPT_BLOCK2, &blknum, &szx);
+    if (more < 0) {
+        /* the server sent the whole representation */
+        more = 0;
+        szx = _state.szx;
+    }
+    size_t offset = blknum << (szx + 4);
+
+    if (!_state.agreed) {
+        /* the server may answer with smaller blocks */
+        if (offset != (_state.start << (_state.szx + 4))) {
+            _state.error = -EIO;
+            return;
+        }
+        _state.szx = szx;
+        _state.start = blknum;
+        _state.next = blknum + 1;
+        _state.agreed = true;
+    }
+    else if (offset != (slot->blknum << (_state.szx + 4))) {
+        _state.error = -EIO;
+        return;
+    }
+    blknum = offset >> (_state.szx + 4);
+
+    if (!more && (blknum < _state.last)) {
+        _state.last = blknum;
+    }
+    if ((pdu->payload_len == 0) && (blknum > _state.start)) {
+        /* block past the end */
+        return;
+    }
+    int res = xfer->write(xfer->arg, offset, pdu->payload, pdu->payload_len,
+                          more);
+    if (res < 0) {
+        _state.error = res;
+        return;
+    }
+    _state.bytes += pdu->payload_len;
+}
+
+static void _handle_upload(_slot_t *slot, coap_pkt_t *pdu)
+{
+    uint32_t blknum;
+    unsigned szx;
+
+    if (coap_get_code_class(pdu) != COAP_CLASS_SUCCESS) {
+        _state.error = -EIO;
+        return;
+    }
+    _state.bytes += slot->len;
+
+    if (!_state.agreed) {
+        if ((coap_get_blockopt(pdu, COAP_OPT_BLOCK1, &blknum, &szx) >= 0) &&
+            (szx < _state.szx)) {
+            /* the server accepted the first block, but wants smaller blocks
+             * from now on, see RFC 7959, section 2.3 */
+            _state.next = (slot->blknum + 1) << (_state.szx - szx);
+            _state.szx = szx;
+            if (_state.last != BLOCK_NONE) {
+                _state.last = _state.next - 1;
+            }
+        }
+        _state.agreed = true;
+    }
+}
+
+static void _resp_handler(unsigned req_state, coap_pkt_t *pdu,
+                          sock_udp_ep_t *remote)
+{
+    (void)remote;
+    _slot_t *slot;
+
+    mutex_lock(&_state.lock);
+    if ((_state.xfer == NULL) ||
+        ((slot = _slot_by_token(coap_hdr_data_ptr(pdu->hdr))) == NULL)) {
+        /* a response of an earlier transfer */
+        mutex_unlock(&_state.lock);
+        return;
+    }
+
+    if (req_state != GCOAP_MEMO_RESP) {
+        if (++slot->retries > GCOAP_BLOCK_RETRIES) {
+            _state.error = -ETIMEDOUT;
+        }
+        slot->state = SLOT_RESEND;
+    }
+    else {
+        if (_state.xfer->method == COAP_METHOD_GET) {
+            _handle_download(slot, pdu);
+        }
+        else {
+            _handle_upload(slot, pdu);
+        }
+        slot->state = SLOT_UNUSED;
+    }
+    mutex_unlock(&_state.lock);
+    mutex_unlock(&_state.wakeup);
+}
+
+/* Builds the request for a slot, must be called with _state.lock held */
+static ssize_t _build(_slot_t *slot, coap_pkt_t *pdu, uint8_t *buf,
+                      size_t len)
+{
+    const gcoap_block_xfer_t *xfer = _state.xfer;
+    size_t size = coap_szx2size(_state.szx);
+
+    gcoap_req_init(pdu, buf, len, xfer->method, xfer->path);
+    memcpy(slot->token, pdu->token, GCOAP_TOKENLEN);
+
+    if (xfer->method == COAP_METHOD_GET) {
+        coap_opt_add_uint(pdu, COAP_OPT_BLOCK2,
+                          _blkopt(slot->blknum, false, _state.szx));
+        return coap_opt_finish(pdu, COAP_OPT_FINISH_NONE);
+    }
+
+    /* read one byte past the block to learn if there are more */
+    uint8_t probe;
+    size_t offset = slot->blknum * size;
+    ssize_t more = xfer->read(xfer->arg, offset + size, &probe, 1);
+    if (more < 0) {
+        return more;
+    }
+    if (xfer->format != COAP_FORMAT_NONE) {
+        coap_opt_add_uint(pdu, COAP_OPT_CONTENT_FORMAT, xfer->format);
+    }
+    coap_opt_add_uint(pdu, COAP_OPT_BLOCK1,
+                      _blkopt(slot->blknum, more > 0, _state.szx));
+    coap_opt_finish(pdu, COAP_OPT_FINISH_PAYLOAD);
+
+    ssize_t res = xfer->read(xfer->arg, offset, pdu->payload, size);
+    if (res < 0) {
+        return res;
+    }
+    if (!more) {
+        _state.last = slot->blknum;
+    }
+    slot->len = res;
+    if (res == 0) {
+        /* empty representation, no payload marker */
+        pdu->payload--;
+    }
+    return (pdu->payload - buf) + res;
+}
+
+/* Sends the request for a slot, takes _state.lock */
+static int _send(_slot_t *slot)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+
+    mutex_lock(&_state.lock);
+    ssize_t len = _build(slot, &pdu, buf, sizeof(buf));
+    if (len < 0) {
+        mutex_unlock(&_state.lock);
+        return len;
+    }
+    /* the response may come before gcoap_req_send2() returns */
+    slot->state = SLOT_WAIT;
+    mutex_unlock(&_state.lock);
+
+    if (gcoap_req_send2(buf, len, &_state.xfer->remote, _resp_handler) == 0) {
+        mutex_lock(&_state.lock);
+        slot->state = SLOT_RESEND;
+        mutex_unlock(&_state.lock);
+        return -ENOMEM;
+    }
+    return 0;
+}
+
+/* Initial block size, so that a block fits into a PDU */
+static unsigned _initial_szx(const gcoap_block_xfer_t *xfer)
+{
+    if (xfer->method == COAP_METHOD_GET) {
+        /* leaves room for the header and a few options of a response */
+        return _fit_szx(BLOCK_SZX_MAX, GCOAP_PDU_BUF_SIZE -
+                        GCOAP_HEADER_MAXLEN - 4 * BLOCK_OPT_BUF);
+    }
+
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+
+    gcoap_req_init(&pdu, buf, sizeof(buf), xfer->method, xfer->path);
+    if (xfer->format != COAP_FORMAT_NONE) {
+        coap_opt_add_uint(&pdu, COAP_OPT_CONTENT_FORMAT, xfer->format);
+    }
+    return _fit_szx(BLOCK_SZX_MAX, pdu.payload_len - BLOCK_OPT_BUF);
+}
+
+ssize_t gcoap_block_xfer(const gcoap_block_xfer_t *xfer)
+{
+    unsigned window = xfer->window;
+    ssize_t res = 0;
+
+    if ((xfer->path == NULL) || (window == 0) ||
+        ((xfer->method == COAP_METHOD_GET) ? (xfer->write == NULL)
+                                           : (xfer->read == NULL))) {
+        return -EINVAL;
+    }
+    if (window > GCOAP_REQ_WAITING_MAX) {
+        window = GCOAP_REQ_WAITING_MAX;
+    }
+#if !GCOAP_TOKENLEN
+    /* responses are told apart by the token only */
+    window = 1;
+#endif
+
+    mutex_lock(&_xfer_lock);
+    mutex_lock(&_state.lock);
+    memset(_state.slots, 0, sizeof(_state.slots));
+    _state.szx = _initial_szx(xfer);
+    _state.agreed = false;
+    _state.start = xfer->offset >> (_state.szx + 4);
+    _state.next = _state.start;
+    _state.last = BLOCK_NONE;
+    _state.limit = BLOCK_NONE;
+    _state.bytes = 0;
+    _state.error = 0;
+    _state.xfer = xfer;
+    /* discard a wakeup left over from an earlier transfer */
+    mutex_trylock(&_state.wakeup);
+
+    while (!_is_done() && (_state.error == 0)) {
+        /* until the block size is agreed, only the first block is sent */
+        unsigned allowed = _state.agreed ? window : 1;
+        unsigned in_flight = _slots_in(SLOT_WAIT);
+        uint32_t end = (_state.last < _state.limit) ? _state.last
+                                                    : _state.limit - 1;
+        _slot_t *slot = NULL;
+
+        for (unsigned i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
+            if (_state.slots[i].state == SLOT_RESEND) {
+                slot = &_state.slots[i];
+                break;
+            }
+        }
+        if ((slot == NULL) && (in_flight < allowed) && (_state.next <= end)) {
+            for (unsigned i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
+                if (_state.slots[i].state == SLOT_UNUSED) {
+                    slot = &_state.slots[i];
+                    slot->blknum = _state.next++;
+                    slot->retries = 0;
+                    slot->state = SLOT_RESEND;
+                    break;
+                }
+            }
+        }
+        if (slot != NULL) {
+            mutex_unlock(&_state.lock);
+            res = _send(slot);
+            mutex_lock(&_state.lock);
+            if ((res == -ENOMEM) && (in_flight > 0)) {
+                /* no memo available yet, try again after a response */
+                res = 0;
+            }
+            else if (res < 0) {
+                _state.error = res;
+            }
+            else {
+                continue;
+            }
+        }
+        if (in_flight == 0) {
+            if (slot == NULL) {
+                /* the server reported the end without a last block */
+                _state.error = -EIO;
+            }
+            continue;
+        }
+        mutex_unlock(&_state.lock);
+        mutex_lock(&_state.wakeup);
+        mutex_lock(&_state.lock);
+    }
+
+    res = (_state.error < 0) ? _state.error : (ssize_t)_state.bytes;
+    _state.xfer = NULL;
+    mutex_unlock(&_state.lock);
+    mutex_unlock(&_xfer_lock);
+    DEBUG("gcoap: block transfer finished: %d\n", (int)res);
+    return res;
+}
+
+#ifdef MODULE_VFS
+ssize_t gcoap_block_vfs_read(void *arg, size_t offset, uint8_t *buf,
+                             size_t len)
+{
+    int fd = *(int *)arg;
+    off_t res = vfs_lseek(fd, offset, SEEK_SET);
+
+    if (res < 0) {
+        return res;
+    }
+    return vfs_read(fd, buf, len);
+}
+
+int gcoap_block_vfs_write(void *arg, size_t offset, const uint8_t *data,
+                          size_t len, bool more)
+{
+    (void)more;
+    int fd = *(int *)arg;
+    off_t res = vfs_lseek(fd, offset, SEEK_SET);
+
+    if (res < 0) {
+        return res;
+    }
+    res = vfs_write(fd, data, len);
+    if (res < 0) {
+        return res;
+    }
+    return ((size_t)res == len) ? 0 : -ENOSPC;
+}
+#endif
@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_mqttsn_topics
+ * @{
+ *
+ * @file
+ * @brief       MQTT-SN topic ID map and topic filter trie implementation
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "net/mqttsn_topics.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+/* index of the root node of a trie, it is never the child of a node, so 0
+ * marks a missing child or sibling */
+#define ROOT            (0U)
+
+static inline unsigned _home(uint16_t id)
+{
+    /* multiplying by an odd constant spreads consecutive topic IDs, as
+     * gateways assign them, over the map */
+    return (uint16_t)(id * 40503U) % MQTTSN_TID_MAP_SIZE;
+}
+
+static inline unsigned _next(unsigned i)
+{
+    return (i + 1) % MQTTSN_TID_MAP_SIZE;
+}
+
+void mqttsn_tid_map_init(mqttsn_tid_map_t *map)
+{
+    memset(map, 0, sizeof(*map));
+}
+
+int mqttsn_tid_map_add(mqttsn_tid_map_t *map, uint16_t id, void *ctx)
+{
+    assert(id != 0);
+    unsigned i = _home(id);
+
+    for (unsigned n = 0; n < MQTTSN_TID_MAP_SIZE; n++) {
+        mqttsn_tid_slot_t *slot = &map->slots[i];
+
+        if ((slot->id == 0) || (slot->id == id)) {
+            slot->id = id;
+            slot->ctx = ctx;
+            return 0;
+        }
+        i = _next(i);
+    }
+    return -ENOMEM;
+}
+
+void *mqttsn_tid_map_get(const mqttsn_tid_map_t *map, uint16_t id)
+{
+    unsigned i = _home(id);
+
+    if (id == 0) {
+        return NULL;
+    }
+    for (unsigned n = 0; n < MQTTSN_TID_MAP_SIZE; n++) {
+        const mqttsn_tid_slot_t *slot = &map->slots[i];
+
+        if (slot->id == id) {
+            return slot->ctx;
+        }
+        if (slot->id == 0) {
+            break;
+        }
+        i = _next(i);
+    }
+    return NULL;
+}
+
+/* frees slot i and moves the following entries of its probe sequence back,
+ * so lookups need no tombstones */
+static void _del_at(mqttsn_tid_map_t *map, unsigned i)
+{
+    unsigned j = i;
+
+    map->slots[i].id = 0;
+    while (1) {
+        j = _next(j);
+        if (map->slots[j].id == 0) {
+            break;
+        }
+        unsigned k = _home(map->slots[j].id);
+        /* the entry stays if its home slot lies cyclically in (i, j] */
+        if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j))) {
+            continue;
+        }
+        map->slots[i] = map->slots[j];
+        map->slots[j].id = 0;
+        i = j;
+    }
+    map->slots[i].ctx = NULL;
+}
+
+void mqttsn_tid_map_del_ctx(mqttsn_tid_map_t *map, const void *ctx)
+{
+    for (unsigned i = 0; i < MQTTSN_TID_MAP_SIZE; i++) {
+        /* an entry of the same context may move into slot i */
+        while ((map->slots[i].id != 0) && (map->slots[i].ctx == ctx)) {
+            _del_at(map, i);
+        }
+    }
+}
+
+/* length of the level at pos, levels end at the next '/' or at end */
+static inline size_t _level_len(const char *pos, const char *end)
+{
+    const char *sep = memchr(pos, '/', end - pos);
+
+    return (sep) ? (size_t)(sep - pos) : (size_t)(end - pos);
+}
+
+/* start of the level following the level of len at pos, NULL if there is
+ * none */
+static inline const char *_level_next(const char *pos, size_t len,
+                                      const char *end)
+{
+    return ((pos + len) == end) ? NULL : (pos + len + 1);
+}
+
+static inline bool _level_is(const mqttsn_trie_node_t *node,
+                             const char *level, size_t len)
+{
+    return (node->len == len) && (memcmp(node->level, level, len) == 0);
+}
+
+static unsigned _find_child(const mqttsn_trie_t *trie, unsigned parent,
+                            const char *level, size_t len)
+{
+    for (unsigned i = trie->nodes[parent].child; i != ROOT;
+         i = trie->nodes[i].sibling) {
+        if (_level_is(&trie->nodes[i], level, len)) {
+            return i;
+        }
+    }
+    return ROOT;
+}
+
+void mqttsn_trie_init(mqttsn_trie_t *trie)
+{
+    memset(trie, 0, sizeof(*trie));
+    trie->nodes[ROOT].level = "";
+}
+
+int mqttsn_trie_add(mqttsn_trie_t *trie, const char *filter, void *ctx)
+{
+    assert(filter && ctx);
+    const char *end = filter + strlen(filter);
+    const char *pos = filter;
+    unsigned node = ROOT, missing = 0, free_nodes = 0;
+
+    /* count the nodes to create first, so a failed add changes nothing */
+    while (pos) {
+        size_t len = _level_len(pos, end);
+
+        if (missing == 0) {
+            node = _find_child(trie, node, pos, len);
+        }
+        if (node == ROOT) {
+            missing++;
+        }
+        pos = _level_next(pos, len, end);
+    }
+    if ((missing == 0) && trie->nodes[node].ctx) {
+        return (trie->nodes[node].ctx == ctx) ? -EALREADY : -EEXIST;
+    }
+    for (unsigned i = 1; i < MQTTSN_TRIE_SIZE; i++) {
+        if (trie->nodes[i].level == NULL) {
+            free_nodes++;
+        }
+    }
+    if (free_nodes < missing) {
+        DEBUG("mqttsn_topics: no space for %u levels of %s\n", missing, filter);
+        return -ENOMEM;
+    }
+
+    node = ROOT;
+    pos = filter;
+    unsigned free_node = 1;
+    const char *last = filter;
+    while (pos) {
+        size_t len = _level_len(pos, end);
+        unsigned child = _find_child(trie, node, pos, len);
+
+        last = pos;
+
+        if (child == ROOT) {
+            while (trie->nodes[free_node].level != NULL) {
+                free_node++;
+            }
+            child = free_node;
+            trie->nodes[child].level = pos;
+            trie->nodes[child].len = len;
+            trie->nodes[child].ctx = NULL;
+            trie->nodes[child].child = ROOT;
+            trie->nodes[child].sibling = trie->nodes[node].child;
+            trie->nodes[node].child = child;
+        }
+        node = child;
+        pos = _level_next(pos, len, end);
+    }
+    /* a node with a context refers to its own filter, so it stays valid
+     * while the node is needed */
+    trie->nodes[node].level = last;
+    trie->nodes[node].ctx = ctx;
+    return 0;
+}
+
+static void _unlink(mqttsn_trie_t *trie, unsigned parent, unsigned node)
+{
+    uint16_t *link = &trie->nodes[parent].child;
+
+    while (*link != node) {
+        link = &trie->nodes[*link].sibling;
+    }
+    *link = trie->nodes[node].sibling;
+    trie->nodes[node].level = NULL;
+}
+
+/* removes the filter below node, returns whether node is no longer needed */
+static bool _del(mqttsn_trie_t *trie, unsigned node, const char *pos,
+                 const char *filter, const char *end)
+{
+    mqttsn_trie_node_t *n = &trie->nodes[node];
+
+    if (pos == NULL) {
+        n->ctx = NULL;
+    }
+    else {
+        size_t len = _level_len(pos, end);
+        unsigned child = _find_child(trie, node, pos, len);
+
+        if (child == ROOT) {
+            return false;
+        }
+        if (_del(trie, child, _level_next(pos, len, end), filter, end)) {
+            _unlink(trie, node, child);
+        }
+    }
+    if ((node == ROOT) || (n->ctx == NULL && n->child == ROOT)) {
+        return (node != ROOT);
+    }
+    if ((n->level >= filter) && (n->level <= end)) {
+        /* the node outlives the filter it refers to: a node without a
+         * context refers to the filter of a child, where its level
+         * precedes the level of the child */
+        n->level = trie->nodes[n->child].level - 1 - n->len;
+    }
+    return false;
+}
+
+void mqttsn_trie_del(mqttsn_trie_t *trie, const char *filter)
+{
+    _del(trie, ROOT, filter, filter, filter + strlen(filter));
+}
+
+static void *_match(const mqttsn_trie_t *trie, unsigned node,
+                    const char *pos, const char *end)
+{
+    const mqttsn_trie_node_t *n = &trie->nodes[node];
+    unsigned exact = ROOT, plus = ROOT, hash = ROOT;
+    size_t len = (pos) ? _level_len(pos, end) : 0;
+
+    for (unsigned i = n->child; i != ROOT; i = trie->nodes[i].sibling) {
+        const mqttsn_trie_node_t *c = &trie->nodes[i];
+
+        if (_level_is(c, "#", 1)) {
+            hash = i;
+        }
+        else if (pos && _level_is(c, "+", 1)) {
+            plus = i;
+        }
+        else if (pos && _level_is(c, pos, len)) {
+            exact = i;
+        }
+    }
+    if (pos == NULL) {
+        /* "a/#" also matches "a" */
+        if (n->ctx) {
+            return n->ctx;
+        }
+        return (hash != ROOT) ? trie->nodes[hash].ctx : NULL;
+    }
+    /* names starting with '$' are not matched by wildcards on the first
+     * level */
+    if ((node == ROOT) && (len > 0) && (*pos == '$')) {
+        plus = ROOT;
+        hash = ROOT;
+    }
+
+    const char *next = _level_next(pos, len, end);
+    void *ctx = NULL;
+
+    if (exact != ROOT) {
+        ctx = _match(trie, exact, next, end);
+    }
+    if ((ctx == NULL) && (plus != ROOT)) {
+        ctx = _match(trie, plus, next, end);
+    }
+    if ((ctx == NULL) && (hash != ROOT)) {
+        ctx = trie->nodes[hash].ctx;
+    }
+    return ctx;
+}
+
+void *mqttsn_trie_match(const mqttsn_trie_t *trie, const char *name,
+                        size_t len)
+{
+    return _match(trie, ROOT, name, name + len);
+}
@@ -40,7 +40,6 @@
 /** @} */
 
 static int _decode_value(unsigned val, uint8_t **pkt_pos_ptr, uint8_t *pkt_end);
-int coap_get_option_uint(coap_pkt_t *pkt, unsigned opt_num, uint32_t *target);
 static uint32_t _decode_uint(uint8_t *pkt_pos, unsigned nbytes);
 static size_t _encode_uint(uint32_t *val);
 
@@ -105,13 +104,18 @@ int coap_parse(coap_pkt_t *pkt, uint8_t *buf, size_t len)
             option_nr += option_delta;
             DEBUG("option count=%u nr=%u len=%i\n", option_count, option_nr, option_len);
 
-            if (option_delta) {
-                optpos->opt_num = option_nr;
-                optpos->offset = (uintptr_t)option_start - (uintptr_t)hdr;
-                DEBUG("optpos option_nr=%u %u\n", (unsigned)option_nr, (unsigned)optpos->offset);
-                optpos++;
-                option_count++;
+            if (option_count == NANOCOAP_NOPTS_MAX) {
+                DEBUG("nanocoap: too many options\n");
+                return -ENOMEM;
             }
+            /* every instance, so an option is never decoded again */
+            optpos->opt_num = option_nr;
+            optpos->offset = (uintptr_t)option_start - (uintptr_t)hdr;
+            optpos->value = (uintptr_t)pkt_pos - (uintptr_t)hdr;
+            optpos->len = option_len;
+            DEBUG("optpos option_nr=%u %u\n", (unsigned)option_nr, (unsigned)optpos->offset);
+            optpos++;
+            option_count++;
 
             pkt_pos += option_len;
 
@@ -141,20 +145,46 @@ int coap_parse(coap_pkt_t *pkt, uint8_t *buf, size_t len)
     return 0;
 }
 
-uint8_t *coap_find_option(const coap_pkt_t *pkt, unsigned opt_num)
+const coap_optpos_t *coap_opt_find(const coap_pkt_t *pkt, unsigned opt_num)
 {
-    const coap_optpos_t *optpos = pkt->options;
-    unsigned opt_count = pkt->options_len;
+    unsigned low = 0;
+    unsigned high = pkt->options_len;
 
-    while (opt_count--) {
-        if (optpos->opt_num == opt_num) {
-            return (uint8_t*)pkt->hdr + optpos->offset;
+    /* first option with a number not below opt_num */
+    while (low < high) {
+        unsigned mid = (low + high) / 2;
+        if (pkt->options[mid].opt_num < opt_num) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
         }
-        optpos++;
+    }
+    if ((low < pkt->options_len) && (pkt->options[low].opt_num == opt_num)) {
+        return &pkt->options[low];
     }
     return NULL;
 }
 
+ssize_t coap_opt_get_opaque(const coap_pkt_t *pkt, unsigned opt_num,
+                            uint8_t **value)
+{
+    const coap_optpos_t *opt = coap_opt_find(pkt, opt_num);
+
+    if (!opt) {
+        return -ENOENT;
+    }
+    *value = coap_opt_value(pkt, opt);
+    return opt->len;
+}
+
+uint8_t *coap_find_option(const coap_pkt_t *pkt, unsigned opt_num)
+{
+    const coap_optpos_t *opt = coap_opt_find(pkt, opt_num);
+
+    return opt ? (uint8_t *)pkt->hdr + opt->offset : NULL;
+}
+
 static uint8_t *_parse_option(const coap_pkt_t *pkt,
                               uint8_t *pkt_pos, uint16_t *delta, int *opt_len)
 {
@@ -176,23 +206,14 @@ int coap_get_option_uint(coap_pkt_t *pkt, unsigned opt_num, uint32_t *target)
 {
     assert(target);
 
-    uint8_t *opt_pos = coap_find_option(pkt, opt_num);
-    if (opt_pos) {
-        uint16_t delta;
-        int option_len = 0;
-        uint8_t *pkt_pos = _parse_option(pkt, opt_pos, &delta, &option_len);
-        if (option_len >= 0) {
-            if (option_len > 4) {
-                DEBUG("nanocoap: uint option with len > 4 (unsupported).\n");
-                return -ENOSPC;
-            }
-            *target = _decode_uint(pkt_pos, option_len);
-            return 0;
-        }
-        else {
-            DEBUG("nanocoap: discarding packet with invalid option length.\n");
-            return -EBADMSG;
+    const coap_optpos_t *opt = coap_opt_find(pkt, opt_num);
+    if (opt) {
+        if (opt->len > 4) {
+            DEBUG("nanocoap: uint option with len > 4 (unsupported).\n");
+            return -ENOSPC;
         }
+        *target = _decode_uint(coap_opt_value(pkt, opt), opt->len);
+        return 0;
     }
     return -1;
 }
@@ -216,21 +237,10 @@ uint8_t *coap_iterate_option(const coap_pkt_t *pkt, uint8_t **optpos,
 
 unsigned coap_get_content_type(coap_pkt_t *pkt)
 {
-    uint8_t *opt_pos = coap_find_option(pkt, COAP_OPT_CONTENT_FORMAT);
+    const coap_optpos_t *opt = coap_opt_find(pkt, COAP_OPT_CONTENT_FORMAT);
     unsigned content_type = COAP_FORMAT_NONE;
-    if (opt_pos) {
-        uint16_t delta;
-        int option_len = 0;
-        uint8_t *pkt_pos = _parse_option(pkt, opt_pos, &delta, &option_len);
-
-        if (option_len == 0) {
-            content_type = 0;
-        } else if (option_len == 1) {
-            content_type = *pkt_pos;
-        } else if (option_len == 2) {
-            memcpy(&content_type, pkt_pos, 2);
-            content_type = ntohs(content_type);
-        }
+    if (opt && (opt->len <= 2)) {
+        content_type = _decode_uint(coap_opt_value(pkt, opt), opt->len);
     }
 
     return content_type;
@@ -270,22 +280,60 @@ ssize_t coap_opt_get_string(const coap_pkt_t *pkt, uint16_t optnum,
     return (int)(max_len - left);
 }
 
+static int _cmp_string(const coap_pkt_t *pkt, uint16_t optnum,
+                       const char *string, char separator, bool prefix)
+{
+    const coap_optpos_t *opt = coap_opt_find(pkt, optnum);
+    const uint8_t *pos = (const uint8_t *)string;
+
+    /* without the option, the string is a single separator */
+    do {
+        if (*pos != (uint8_t)separator) {
+            return (int)(uint8_t)separator - *pos;
+        }
+        pos++;
+        if (opt) {
+            const uint8_t *value = coap_opt_value(pkt, opt);
+            for (unsigned i = 0; i < opt->len; i++, pos++) {
+                if (*pos != value[i]) {
+                    return (int)value[i] - *pos;
+                }
+            }
+            opt = coap_opt_next(pkt, opt);
+            /* more parts follow all of the string */
+            if (prefix && opt && (*pos == '\0')) {
+                return 0;
+            }
+        }
+    } while (opt);
+
+    return -(int)*pos;
+}
+
+int coap_opt_cmp_string(const coap_pkt_t *pkt, uint16_t optnum,
+                        const char *string, char separator)
+{
+    return _cmp_string(pkt, optnum, string, separator, false);
+}
+
+int coap_opt_cmp_prefix(const coap_pkt_t *pkt, uint16_t optnum,
+                        const char *string, char separator)
+{
+    return _cmp_string(pkt, optnum, string, separator, true);
+}
+
 int coap_get_blockopt(coap_pkt_t *pkt, uint16_t option, uint32_t *blknum, unsigned *szx)
 {
-    uint8_t *optpos = coap_find_option(pkt, option);
-    if (!optpos) {
+    const coap_optpos_t *opt = coap_opt_find(pkt, option);
+    if (!opt) {
         *blknum = 0;
         *szx = 0;
         return -1;
     }
 
-    int option_len;
-    uint16_t delta;
-
-    uint8_t *data_start = _parse_option(pkt, optpos, &delta, &option_len);
-    uint32_t blkopt = _decode_uint(data_start, option_len);
+    uint32_t blkopt = _decode_uint(coap_opt_value(pkt, opt), opt->len);
 
-    DEBUG("nanocoap: blkopt len: %i\n", option_len);
+    DEBUG("nanocoap: blkopt len: %u\n", opt->len);
     DEBUG("nanocoap: blkopt: 0x%08x\n", (unsigned)blkopt);
     *blknum = blkopt >> COAP_BLOCKWISE_NUM_OFF;
     *szx = blkopt & COAP_BLOCKWISE_SZX_MASK;
@@ -306,19 +354,13 @@ ssize_t coap_handle_req(coap_pkt_t *pkt, uint8_t *resp_buf, unsigned resp_buf_le
 
     unsigned method_flag = coap_method2flag(coap_get_code_detail(pkt));
 
-    uint8_t uri[NANOCOAP_URI_MAX];
-    if (coap_get_uri_path(pkt, uri) <= 0) {
-        return -EBADMSG;
-    }
-    DEBUG("nanocoap: URI path: \"%s\"\n", uri);
-
     for (unsigned i = 0; i < coap_resources_numof; i++) {
         const coap_resource_t *resource = &coap_resources[i];
         if (!(resource->methods & method_flag)) {
             continue;
         }
 
-        int res = strcmp((char *)uri, resource->path);
+        int res = coap_match_path(pkt, resource);
         if (res > 0) {
             continue;
         }
@@ -689,6 +731,9 @@ static ssize_t _add_opt_pkt(coap_pkt_t *pkt, uint16_t optnum, uint8_t *val,
 
     pkt->options[pkt->options_len].opt_num = optnum;
     pkt->options[pkt->options_len].offset = pkt->payload - (uint8_t *)pkt->hdr;
+    pkt->options[pkt->options_len].value =
+        pkt->options[pkt->options_len].offset + optlen - val_len;
+    pkt->options[pkt->options_len].len = val_len;
     pkt->options_len++;
     pkt->payload += optlen;
     pkt->payload_len -= optlen;
@@ -18,6 +18,7 @@
  * @}
  */
 
+#include <errno.h>
 #include <string.h>
 #include "net/sntp.h"
 #include "net/ntp_packet.h"
@@ -25,15 +26,112 @@
 #include "xtimer.h"
 #include "mutex.h"
 #include "byteorder.h"
+#ifdef MODULE_GNRC_UDP_MUX
+#include "net/gnrc/udp_mux.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
-static sock_udp_t _sntp_sock;
 static int64_t _sntp_offset = 0;
 static mutex_t _sntp_mutex = MUTEX_INIT;
 static ntp_packet_t _sntp_packet;
 
+static void _set_offset(const ntp_packet_t *packet)
+{
+    mutex_lock(&_sntp_mutex);
+    _sntp_offset = (((int64_t)byteorder_ntohl(packet->transmit.seconds)) * US_PER_SEC) +
+                   ((((int64_t)byteorder_ntohl(packet->transmit.fraction)) * 232)
+                   / 1000000) - xtimer_now_usec64();
+    mutex_unlock(&_sntp_mutex);
+}
+
+#ifdef MODULE_GNRC_UDP_MUX
+static gnrc_udp_mux_ep_t _sntp_ep;
+static const sock_udp_ep_t *_sntp_server;
+/* unlocked by the first response from _sntp_server */
+static mutex_t _sntp_done = MUTEX_INIT;
+/* unlocked when _sntp_ep was removed on the multiplexer thread */
+static mutex_t _sntp_removed = MUTEX_INIT;
+
+static void _on_remove(event_t *event)
+{
+    (void)event;
+    gnrc_udp_mux_remove(&_sntp_ep);
+    mutex_unlock(&_sntp_removed);
+}
+
+static event_t _sntp_remove = { .handler = _on_remove };
+
+static void _on_udp(gnrc_udp_mux_ep_t *ep, uint8_t *data, size_t len,
+                    const sock_udp_ep_t *remote)
+{
+    ntp_packet_t packet;
+    (void)ep;
+
+    if ((len < sizeof(packet)) || (remote->port != _sntp_server->port) ||
+        (memcmp(&remote->addr, &_sntp_server->addr,
+                sizeof(remote->addr)) != 0)) {
+        DEBUG("Dropping unexpected message\n");
+        return;
+    }
+    /* the payload in the packet buffer may not be aligned */
+    memcpy(&packet, data, sizeof(packet));
+    _set_offset(&packet);
+    mutex_unlock(&_sntp_done);
+}
+
+/* the handler might still run on the multiplexer thread, so the endpoint
+ * is removed by the same thread after it */
+static void _remove(void)
+{
+    mutex_trylock(&_sntp_removed);
+    event_post(gnrc_udp_mux_queue(), &_sntp_remove);
+    mutex_lock(&_sntp_removed);
+}
+
+int sntp_sync(sock_udp_ep_t *server, uint32_t timeout)
+{
+    int result;
+
+    gnrc_udp_mux_init();
+    _sntp_server = server;
+    mutex_trylock(&_sntp_done);
+    if ((result = gnrc_udp_mux_add(&_sntp_ep, 0, gnrc_udp_mux_queue(),
+                                   _on_udp, NULL)) < 0) {
+        DEBUG("Error registering UDP endpoint\n");
+        return result;
+    }
+    memset(&_sntp_packet, 0, sizeof(_sntp_packet));
+    ntp_packet_set_vn(&_sntp_packet);
+    ntp_packet_set_mode(&_sntp_packet, NTP_MODE_CLIENT);
+
+    if ((result = (int)gnrc_udp_mux_send(&_sntp_ep, &_sntp_packet,
+                                         sizeof(_sntp_packet), server)) < 0) {
+        DEBUG("Error sending message\n");
+        _remove();
+        return result;
+    }
+    result = 0;
+    if (timeout == SOCK_NO_TIMEOUT) {
+        mutex_lock(&_sntp_done);
+    }
+    else if (xtimer_mutex_lock_timeout(&_sntp_done, timeout) < 0) {
+        result = -ETIMEDOUT;
+    }
+    _remove();
+    /* the response might have come in before the endpoint was removed */
+    if ((result < 0) && mutex_trylock(&_sntp_done)) {
+        result = 0;
+    }
+    if (result < 0) {
+        DEBUG("Error receiving message\n");
+    }
+    return result;
+}
+#else
+static sock_udp_t _sntp_sock;
+
 int sntp_sync(sock_udp_ep_t *server, uint32_t timeout)
 {
     int result;
@@ -67,13 +165,10 @@ int sntp_sync(sock_udp_ep_t *server, uint32_t timeout)
         return result;
     }
     sock_udp_close(&_sntp_sock);
-    mutex_lock(&_sntp_mutex);
-    _sntp_offset = (((int64_t)byteorder_ntohl(_sntp_packet.transmit.seconds)) * US_PER_SEC) +
-                   ((((int64_t)byteorder_ntohl(_sntp_packet.transmit.fraction)) * 232)
-                   / 1000000) - xtimer_now_usec64();
-    mutex_unlock(&_sntp_mutex);
+    _set_offset(&_sntp_packet);
     return 0;
 }
+#endif
 
 int64_t sntp_get_offset(void)
 {
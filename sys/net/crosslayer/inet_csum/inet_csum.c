@@ -13,13 +13,113 @@
  */
 
 #include <inttypes.h>
+#include <limits.h>
 #include <stdio.h>
+#include <string.h>
+
+#include "byteorder.h"
 #include "od.h"
 #include "net/inet_csum.h"
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
+/* aligned loads from the byte buffer without violating strict aliasing */
+typedef uint16_t __attribute__((__may_alias__)) _u16_alias_t;
+typedef uint32_t __attribute__((__may_alias__)) _u32_alias_t;
+
+/* Sums up buf as 16-bit words in host byte order. As the 1's complement sum
+ * is independent of the byte order (RFC 1071, section 2 (B)), it only needs
+ * to be converted to network byte order once at the end.
+ * buf must be 2-byte aligned */
+#if (UINT_MAX >= UINT32_MAX)
+static uint16_t _sum_aligned(const uint8_t *buf, size_t len)
+{
+    /* sum up 32-bit words and fold the carries back in only once at the
+     * end */
+    uint64_t sum = 0;
+    const _u32_alias_t *words;
+
+    if (((uintptr_t)buf & 0x2) && (len >= 2)) {
+        sum += *((const _u16_alias_t *)buf);
+        buf += 2;
+        len -= 2;
+    }
+    words = (const _u32_alias_t *)buf;
+    for (; len >= 16; len -= 16, words += 4) {
+        sum += (uint64_t)words[0] + words[1] + words[2] + words[3];
+    }
+    for (; len >= 4; len -= 4, words++) {
+        sum += *words;
+    }
+    buf = (const uint8_t *)words;
+    if (len >= 2) {
+        sum += *((const _u16_alias_t *)buf);
+        buf += 2;
+        len -= 2;
+    }
+    if (len) {
+        /* pad with 0 in memory order */
+        uint16_t last = 0;
+
+        memcpy(&last, buf, 1);
+        sum += last;
+    }
+    sum = (sum & 0xffffffff) + (sum >> 32);
+    sum = (sum & 0xffffffff) + (sum >> 32);
+    sum = (sum & 0xffff) + (sum >> 16);
+    sum = (sum & 0xffff) + (sum >> 16);
+    return (uint16_t)sum;
+}
+#else   /* UINT_MAX < UINT32_MAX */
+static uint16_t _sum_aligned(const uint8_t *buf, size_t len)
+{
+    /* on 8- and 16-bit platforms 16-bit words are the natural unit */
+    uint32_t sum = 0;
+    const _u16_alias_t *words = (const _u16_alias_t *)buf;
+
+    for (; len >= 8; len -= 8, words += 4) {
+        sum += (uint32_t)words[0] + words[1] + words[2] + words[3];
+    }
+    for (; len >= 2; len -= 2, words++) {
+        sum += *words;
+    }
+    if (len) {
+        /* pad with 0 in memory order */
+        uint16_t last = 0;
+
+        memcpy(&last, words, 1);
+        sum += last;
+    }
+    sum = (sum & 0xffff) + (sum >> 16);
+    sum = (sum & 0xffff) + (sum >> 16);
+    return (uint16_t)sum;
+}
+#endif  /* UINT_MAX < UINT32_MAX */
+
+/* 1's complement sum of buf as 16-bit words in network byte order with buf[0]
+ * as the most significant byte of the first word */
+static uint16_t _sum(const uint8_t *buf, size_t len)
+{
+    network_uint16_t sum;
+
+    if (len == 0) {
+        return 0;
+    }
+    if ((uintptr_t)buf & 0x1) {
+        /* Summing up from the next aligned byte pairs every byte with its
+         * neighbour in the wrong half of the word, which is the same as
+         * summing up the byte-swapped words. Swap back and add the first
+         * byte as top half of the first word. */
+        uint32_t tmp = (uint32_t)byteorder_swaps(_sum(buf + 1, len - 1)) +
+                       (uint16_t)(*buf << 8);
+
+        return (uint16_t)((tmp & 0xffff) + (tmp >> 16));
+    }
+    sum.u16 = _sum_aligned(buf, len);
+    return byteorder_ntohs(sum);
+}
+
 uint16_t inet_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len, size_t accum_len)
 {
     uint32_t csum = sum;
@@ -41,16 +141,10 @@ uint16_t inet_csum_slice(uint16_t sum, const uint8_t *buf, uint16_t len, size_t
         csum += *buf;         /* add first byte as bottom half of 16-byte word */
         buf++;
         len--;
-        accum_len++;
-    }
-
-    for (unsigned i = 0; i < (len >> 1); buf += 2, i++) {
-        csum += (uint16_t)(*buf << 8) + *(buf + 1); /* group bytes by 16-byte words */
-                                                    /* and add them */
     }
 
-    if ((accum_len + len) & 1)          /* if accumulated length is odd */
-        csum += (uint16_t)(*buf << 8);  /* add last byte as top half of 16-byte word */
+    /* an odd last byte is added as top half of 16-byte word */
+    csum += _sum(buf, len);
 
     while (csum >> 16) {
         uint16_t carry = csum >> 16;
@@ -1486,7 +1486,7 @@ static void gomach_listen_init(gnrc_netif_t *netif)
 
     /* Set listen period timeout. */
     uint32_t listen_period = random_uint32_range(0, GNRC_GOMACH_CP_RANDOM_END_US) +
-                             GNRC_GOMACH_CP_DURATION_US;
+                             netif->mac.prot.gomach.cp_duration_us;
     gnrc_gomach_set_timeout(netif, GNRC_GOMACH_TIMEOUT_CP_END, listen_period);
     gnrc_gomach_set_timeout(netif, GNRC_GOMACH_TIMEOUT_CP_MAX, GNRC_GOMACH_CP_DURATION_MAX_US);
 
@@ -1520,6 +1520,7 @@ static void _cp_listen_get_pkt(gnrc_netif_t *netif)
     /* If the device has replied a preamble-ACK, it must waits for the data.
      * Here, we extend the CP. */
     if (gnrc_gomach_get_got_preamble(netif)) {
+        netif->mac.prot.gomach.cp_rx_count++;
         gnrc_gomach_set_got_preamble(netif, false);
         gnrc_gomach_set_cp_end(netif, false);
         gnrc_gomach_clear_timeout(netif, GNRC_GOMACH_TIMEOUT_CP_END);
@@ -1527,6 +1528,7 @@ static void _cp_listen_get_pkt(gnrc_netif_t *netif)
     }
     else if ((!gnrc_gomach_get_unintd_preamble(netif)) &&
              (!gnrc_gomach_get_quit_cycle(netif))) {
+        netif->mac.prot.gomach.cp_rx_count++;
         gnrc_gomach_set_got_preamble(netif, false);
         gnrc_gomach_set_cp_end(netif, false);
         gnrc_gomach_clear_timeout(netif, GNRC_GOMACH_TIMEOUT_CP_END);
@@ -1586,6 +1588,9 @@ static void gomach_listen_cp_end(gnrc_netif_t *netif)
     gnrc_priority_pktqueue_flush(&netif->mac.rx.queue);
     gnrc_mac_dispatch(&netif->mac.rx);
 
+    /* Adapt slot allocation and next CP duration to the traffic of this cycle. */
+    gnrc_gomach_traffic_update(netif);
+
     /* If we need to quit communications in this cycle, go to sleep. */
     if (gnrc_gomach_get_quit_cycle(netif)) {
         netif->mac.rx.listen_state = GNRC_GOMACH_LISTEN_SLEEP_INIT;
@@ -2158,6 +2163,8 @@ static void _gomach_init(gnrc_netif_t *netif)
     /* Initialize GoMacH's other key parameters. */
     netif->mac.tx.no_ack_counter = 0;
     gnrc_gomach_set_enter_new_cycle(netif, false);
+    netif->mac.prot.gomach.cp_duration_us = GNRC_GOMACH_CP_DURATION_US;
+    netif->mac.prot.gomach.cp_rx_count = 0;
     netif->mac.rx.vtdma_manag.sub_channel_seq = 26;
     netif->mac.prot.gomach.subchannel_occu_flags = 0;
     gnrc_gomach_set_pkt_received(netif, false);
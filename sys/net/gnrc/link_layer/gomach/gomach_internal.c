@@ -438,12 +438,124 @@ static bool _assemble_beacon(gnrc_netif_t *netif, uint8_t total_tdma_slot_num,
     return true;
 }
 
+static uint8_t _alloc_slots(gnrc_netif_t *netif, uint8_t max_slot_num,
+                            gnrc_gomach_l2_id_t *id_list, uint8_t *slots_list,
+                            uint8_t *total_slot_num)
+{
+    gnrc_gomach_slosch_unit_t *senders[GNRC_GOMACH_MAX_ALLOC_SENDER_NUM];
+    uint8_t senders_num = 0;
+    uint8_t total = 0;
+    uint8_t j = 0;
+    bool granted = true;
+
+    /* Collect the senders with pending packets, the ones with the heaviest
+     * traffic first. If there are more senders than can be scheduled, the
+     * lightest ones have to wait for the next cycle. */
+    for (uint8_t i = 0; i < GNRC_GOMACH_SLOSCH_UNIT_COUNT; i++) {
+        gnrc_gomach_slosch_unit_t *unit = &netif->mac.rx.slosch_list[i];
+        uint8_t pos;
+
+        if (unit->queue_indicator == 0) {
+            continue;
+        }
+        if (senders_num < GNRC_GOMACH_MAX_ALLOC_SENDER_NUM) {
+            pos = senders_num++;
+        }
+        else if (senders[senders_num - 1]->history < unit->history) {
+            pos = senders_num - 1;
+        }
+        else {
+            continue;
+        }
+        while ((pos > 0) && (senders[pos - 1]->history < unit->history)) {
+            senders[pos] = senders[pos - 1];
+            pos--;
+        }
+        senders[pos] = unit;
+    }
+
+    /* Hand out the slots one by one in turns, so that a single sender with a
+     * long queue does not starve the others when the cycle is too short for
+     * all requested slots. */
+    memset(slots_list, 0, senders_num);
+    while (granted && (total < max_slot_num)) {
+        granted = false;
+        for (uint8_t i = 0; (i < senders_num) && (total < max_slot_num); i++) {
+            if (slots_list[i] < senders[i]->queue_indicator) {
+                slots_list[i]++;
+                total++;
+                granted = true;
+            }
+        }
+    }
+
+    /* A sender that announced less than it usually has queued is likely in
+     * the middle of a burst: reserve one more slot for packets that arrive
+     * before its slots period, instead of letting them wait a whole cycle. */
+    for (uint8_t i = 0; (i < senders_num) && (total < max_slot_num); i++) {
+        if ((slots_list[i] == senders[i]->queue_indicator) &&
+            (senders[i]->history >
+             (senders[i]->queue_indicator * GNRC_GOMACH_SLOSCH_HISTORY_WEIGHT))) {
+            slots_list[i]++;
+            total++;
+        }
+    }
+
+    /* Record the devices that got slots to the ID list. */
+    for (uint8_t i = 0; i < senders_num; i++) {
+        if (slots_list[i] > 0) {
+            memcpy(id_list[j].addr, senders[i]->node_addr.addr,
+                   senders[i]->node_addr.len);
+            slots_list[j] = slots_list[i];
+            j++;
+        }
+    }
+
+    *total_slot_num = total;
+    return j;
+}
+
+void gnrc_gomach_traffic_update(gnrc_netif_t *netif)
+{
+    assert(netif != NULL);
+
+    gnrc_gomach_t *gomach = &netif->mac.prot.gomach;
+
+    for (uint8_t i = 0; i < GNRC_GOMACH_SLOSCH_UNIT_COUNT; i++) {
+        gnrc_gomach_slosch_unit_t *unit = &netif->mac.rx.slosch_list[i];
+        unsigned history;
+
+        if (unit->node_addr.len == 0) {
+            continue;
+        }
+        /* round the decay up, so an idle sender's history reaches zero */
+        history = unit->history -
+                  ((unit->history + GNRC_GOMACH_SLOSCH_HISTORY_WEIGHT - 1) /
+                   GNRC_GOMACH_SLOSCH_HISTORY_WEIGHT) +
+                  unit->queue_indicator;
+        unit->history = (history > UINT8_MAX) ? UINT8_MAX : history;
+    }
+
+    /* Widen the CP quickly when traffic shows up and narrow it slowly. */
+    if (gomach->cp_rx_count > 0) {
+        gomach->cp_duration_us *= 2;
+        if (gomach->cp_duration_us > GNRC_GOMACH_CP_DURATION_ADAPT_MAX_US) {
+            gomach->cp_duration_us = GNRC_GOMACH_CP_DURATION_ADAPT_MAX_US;
+        }
+    }
+    else if (gomach->cp_duration_us > GNRC_GOMACH_CP_DURATION_US) {
+        gomach->cp_duration_us -= GNRC_GOMACH_CP_DURATION_US / 2;
+        if (gomach->cp_duration_us < GNRC_GOMACH_CP_DURATION_US) {
+            gomach->cp_duration_us = GNRC_GOMACH_CP_DURATION_US;
+        }
+    }
+    gomach->cp_rx_count = 0;
+}
+
 int gnrc_gomach_send_beacon(gnrc_netif_t *netif)
 {
     assert(netif != NULL);
 
-    uint8_t i;
-    uint8_t j = 0;
     uint8_t total_tdma_node_num = 0;
     uint8_t total_tdma_slot_num = 0;
     gnrc_pktsnip_t *pkt = NULL;
@@ -463,40 +575,16 @@ int gnrc_gomach_send_beacon(gnrc_netif_t *netif)
     uint8_t slots_list[GNRC_GOMACH_SLOSCH_UNIT_COUNT];
 
     /* Check the maximum number of slots that can be allocated to senders. */
-    uint16_t max_slot_num = (GNRC_GOMACH_SUPERFRAME_DURATION_US - gnrc_gomach_phase_now(netif)) /
+    uint32_t max_slot_num = (GNRC_GOMACH_SUPERFRAME_DURATION_US - gnrc_gomach_phase_now(netif)) /
                             GNRC_GOMACH_VTDMA_SLOT_SIZE_US;
 
-    for (i = 0; i < GNRC_GOMACH_SLOSCH_UNIT_COUNT; i++) {
-        if (netif->mac.rx.slosch_list[i].queue_indicator > 0) {
-            /* Record the device's (that will be allocated slots) address to the ID list. */
-            memcpy(id_list[j].addr,
-                   netif->mac.rx.slosch_list[i].node_addr.addr,
-                   netif->mac.rx.slosch_list[i].node_addr.len);
-
-            /* Record the number of allocated slots to the slots list. */
-            slots_list[j] = netif->mac.rx.slosch_list[i].queue_indicator;
-
-            total_tdma_node_num++;
-            total_tdma_slot_num += slots_list[j];
-
-            /* If there is no room for allocating more slots, stop. */
-            if (total_tdma_slot_num >= max_slot_num) {
-                uint8_t redueced_slots_num;
-                redueced_slots_num = total_tdma_slot_num - max_slot_num;
-                slots_list[j] -= redueced_slots_num;
-                total_tdma_slot_num -= redueced_slots_num;
-                break;
-            }
-
-            j++;
-
-            /* If reach the maximum sender ID number limit, stop. */
-            if (total_tdma_node_num >= GNRC_GOMACH_MAX_ALLOC_SENDER_NUM) {
-                break;
-            }
-        }
+    if (max_slot_num > UINT8_MAX) {
+        max_slot_num = UINT8_MAX;
     }
 
+    total_tdma_node_num = _alloc_slots(netif, max_slot_num, id_list, slots_list,
+                                       &total_tdma_slot_num);
+
     gomach_beaocn_hdr.schedulelist_size = total_tdma_node_num;
 
     if (total_tdma_node_num > 0) {
@@ -622,6 +710,7 @@ void gnrc_gomach_indicator_update(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt,
 
             /* Update the sender's queue-length indicator. */
             netif->mac.rx.slosch_list[i].queue_indicator = gomach_data_hdr->queue_indicator;
+            netif->mac.rx.slosch_list[i].history = 0;
             return;
         }
     }
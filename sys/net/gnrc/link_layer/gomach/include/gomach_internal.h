@@ -790,6 +790,15 @@ int gnrc_gomach_dispatch_defer(gnrc_pktsnip_t * buffer[], gnrc_pktsnip_t * pkt);
 void gnrc_gomach_indicator_update(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt,
                                   gnrc_gomach_packet_info_t *pa_info);
 
+/**
+ * @brief Update the traffic history of the senders and adapt the duration of
+ *        the CP (wake-up) period of GoMacH at the end of the CP.
+ *
+ * @param[in,out] netif    the network interface.
+ *
+ */
+void gnrc_gomach_traffic_update(gnrc_netif_t *netif);
+
 /**
  * @brief Process packets received during the CP (wake-up) period of GoMacH.
  *
@@ -80,6 +80,16 @@ extern "C" {
  */
 #define GNRC_LWMAC_QUIT_RX              (0x0040U)
 
+/**
+ * @brief   Flag to track if the device is receiving a packet train.
+ *
+ * Set by the receiver when it gets a data packet with pending-bit and
+ * @ref GNRC_LWMAC_ENABLE_PACKET_TRAIN is enabled. The receiver then keeps
+ * waiting for the next data packet of the train without a new WR/WA handshake,
+ * and a timeout while waiting for it ends the reception successfully.
+ */
+#define GNRC_LWMAC_RX_TRAIN             (0x0080U)
+
 /**
  * @brief Type to pass information about parsing.
  */
@@ -217,6 +227,36 @@ static inline bool gnrc_lwmac_get_quit_rx(gnrc_netif_t *netif)
     return (netif->mac.mac_info & GNRC_LWMAC_QUIT_RX);
 }
 
+/**
+ * @brief set the @ref GNRC_LWMAC_RX_TRAIN flag of the device
+ *
+ * @param[in] netif        ptr to the network interface
+ * @param[in] rx_train     value for LWMAC @ref GNRC_LWMAC_RX_TRAIN flag
+ *
+ */
+static inline void gnrc_lwmac_set_rx_train(gnrc_netif_t *netif, bool rx_train)
+{
+    if (rx_train) {
+        netif->mac.mac_info |= GNRC_LWMAC_RX_TRAIN;
+    }
+    else {
+        netif->mac.mac_info &= ~GNRC_LWMAC_RX_TRAIN;
+    }
+}
+
+/**
+ * @brief get the @ref GNRC_LWMAC_RX_TRAIN flag of the device
+ *
+ * @param[in] netif        ptr to the network interface
+ *
+ * @return                 true if a packet train is being received
+ * @return                 false if no packet train is being received
+ */
+static inline bool gnrc_lwmac_get_rx_train(gnrc_netif_t *netif)
+{
+    return (netif->mac.mac_info & GNRC_LWMAC_RX_TRAIN);
+}
+
 /**
  * @brief set the @ref GNRC_LWMAC_DUTYCYCLE_ACTIVE flag of LWMAC
  *
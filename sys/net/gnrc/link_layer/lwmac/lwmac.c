@@ -881,6 +881,22 @@ static void _lwmac_msg_handler(gnrc_netif_t *netif, msg_t *msg)
             break;
         }
 
+#if (GNRC_LWMAC_ENABLE_DUTYCYLE_RECORD == 1)
+        case GNRC_MAC_TYPE_GET_DUTYCYCLE: {
+            /* Output LWMAC's radio-on time and duty-cycle so far */
+            uint32_t now = rtt_get_counter();
+            uint64_t awake = netif->mac.prot.lwmac.awake_duration_sum_ticks;
+            uint64_t total = now - netif->mac.prot.lwmac.system_start_time_ticks;
+
+            if (netif->mac.prot.lwmac.lwmac_info & GNRC_LWMAC_RADIO_IS_ON) {
+                awake += now - netif->mac.prot.lwmac.last_radio_on_time_ticks;
+            }
+            printf("[LWMAC]: radio-on time: %lu ms, achieved duty-cycle: %lu %% \n",
+                   (unsigned long)((awake * MS_PER_SEC) / RTT_FREQUENCY),
+                   (unsigned long)((total > 0) ? ((awake * 100) / total) : 0));
+            break;
+        }
+#endif
         default: {
 #if ENABLE_DEBUG
             DEBUG("[LWMAC]: unknown message type 0x%04x"
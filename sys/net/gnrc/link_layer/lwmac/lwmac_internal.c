@@ -51,6 +51,7 @@ int _gnrc_lwmac_transmit(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
     }
     if (pkt->type != GNRC_NETTYPE_NETIF) {
         DEBUG("_send_ieee802154: first header is not generic netif header\n");
+        gnrc_pktbuf_release(pkt);
         return -EBADMSG;
     }
     netif_hdr = pkt->data;
@@ -77,6 +78,7 @@ int _gnrc_lwmac_transmit(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
                                         dst, dst_len, dev_pan,
                                         dev_pan, flags, state->seq++)) == 0) {
         DEBUG("_send_ieee802154: Error preperaring frame\n");
+        gnrc_pktbuf_release(pkt);
         return -EINVAL;
     }
 
@@ -183,9 +183,6 @@ static bool _send_wa(gnrc_netif_t *netif)
     /* Send WA */
     if (_gnrc_lwmac_transmit(netif, pkt) < 0) {
         LOG_ERROR("ERROR: [LWMAC-rx] Send WA failed.");
-        if (pkt != NULL) {
-            gnrc_pktbuf_release(pkt);
-        }
         gnrc_lwmac_set_quit_rx(netif, true);
         return false;
     }
@@ -258,8 +255,21 @@ static uint8_t _packet_process_in_wait_for_data(gnrc_netif_t *netif)
         }
 
         switch (info.header->type) {
-            case GNRC_LWMAC_FRAMETYPE_DATA:
             case GNRC_LWMAC_FRAMETYPE_DATA_PENDING: {
+#if (GNRC_LWMAC_ENABLE_PACKET_TRAIN == 1)
+                /* Packet train: the sender announced another data packet
+                 * which it sends without a new WR, so keep waiting for it */
+                _gnrc_lwmac_dispatch_defer(netif->mac.rx.dispatch_buffer, pkt);
+                gnrc_mac_dispatch(&netif->mac.rx);
+                LOG_DEBUG("[LWMAC-rx] Found DATA of packet train\n");
+                gnrc_lwmac_set_rx_train(netif, true);
+                gnrc_lwmac_clear_timeout(netif, GNRC_LWMAC_TIMEOUT_DATA);
+                gnrc_lwmac_set_timeout(netif, GNRC_LWMAC_TIMEOUT_DATA, GNRC_LWMAC_DATA_DELAY_US);
+                continue;
+#endif
+            }
+            /* Intentionally falls through */
+            case GNRC_LWMAC_FRAMETYPE_DATA: {
                 /* Receiver gets the data packet */
                 _gnrc_lwmac_dispatch_defer(netif->mac.rx.dispatch_buffer, pkt);
                 gnrc_mac_dispatch(&netif->mac.rx);
@@ -292,6 +302,7 @@ void gnrc_lwmac_rx_start(gnrc_netif_t *netif)
     netif->dev->driver->set(netif->dev, NETOPT_CSMA, &csma_disable,
                             sizeof(csma_disable));
 
+    gnrc_lwmac_set_rx_train(netif, false);
     netif->mac.rx.state = GNRC_LWMAC_RX_STATE_INIT;
 }
 
@@ -302,6 +313,7 @@ void gnrc_lwmac_rx_stop(gnrc_netif_t *netif)
     }
 
     gnrc_lwmac_clear_timeout(netif, GNRC_LWMAC_TIMEOUT_DATA);
+    gnrc_lwmac_set_rx_train(netif, false);
     netif->mac.rx.state = GNRC_LWMAC_RX_STATE_STOPPED;
     netif->mac.rx.l2_addr.len = 0;
 }
@@ -318,6 +330,7 @@ static bool _lwmac_rx_update(gnrc_netif_t *netif)
     switch (netif->mac.rx.state) {
         case GNRC_LWMAC_RX_STATE_INIT: {
             gnrc_lwmac_clear_timeout(netif, GNRC_LWMAC_TIMEOUT_DATA);
+            gnrc_lwmac_set_rx_train(netif, false);
             netif->mac.rx.state = GNRC_LWMAC_RX_STATE_WAIT_FOR_WR;
             reschedule = true;
             break;
@@ -397,7 +410,15 @@ static bool _lwmac_rx_update(gnrc_netif_t *netif)
              * machine (see above).
              */
             if (gnrc_lwmac_timeout_is_expired(netif, GNRC_LWMAC_TIMEOUT_DATA)) {
-                if (!gnrc_netif_get_rx_started(netif)) {
+                if (gnrc_lwmac_get_rx_train(netif) &&
+                    !gnrc_netif_get_rx_started(netif)) {
+                    /* The sender of the packet train gave up or lost the
+                     * ACK, the data received so far is fine */
+                    LOG_DEBUG("[LWMAC-rx] Packet train ended\n");
+                    netif->mac.rx.state = GNRC_LWMAC_RX_STATE_SUCCESSFUL;
+                    reschedule = true;
+                }
+                else if (!gnrc_netif_get_rx_started(netif)) {
                     LOG_INFO("[LWMAC-rx] DATA timed out\n");
                     netif->mac.rx.rx_bad_exten_count++;
                     netif->mac.rx.state = GNRC_LWMAC_RX_STATE_FAILED;
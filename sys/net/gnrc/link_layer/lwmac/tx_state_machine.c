@@ -217,9 +217,6 @@ static uint8_t _send_wr(gnrc_netif_t *netif)
     int res = _gnrc_lwmac_transmit(netif, pkt);
     if (res < 0) {
         LOG_ERROR("ERROR: [LWMAC-tx] Send WR failed.");
-        if (pkt != NULL) {
-            gnrc_pktbuf_release(pkt);
-        }
         tx_info |= GNRC_LWMAC_TX_FAIL;
         return tx_info;
     }
@@ -370,6 +367,29 @@ static uint8_t _packet_process_in_wait_for_wa(gnrc_netif_t *netif)
     return tx_info;
 }
 
+/* Removes the LWMAC header from the data packet and puts it back into the
+ * queue, so it is sent again in a following cycle */
+static void _requeue_data(gnrc_netif_t *netif)
+{
+    gnrc_pktsnip_t *pkt = netif->mac.tx.packet;
+    /* save pointer to payload */
+    gnrc_pktsnip_t *pkt_payload = pkt->next->next;
+
+    /* remove LWMAC header */
+    pkt->next->next = NULL;
+    gnrc_pktbuf_release(pkt->next);
+
+    /* make append netif header after payload again */
+    pkt->next = pkt_payload;
+
+    if (!gnrc_mac_queue_tx_packet(&netif->mac.tx, 0, pkt)) {
+        gnrc_pktbuf_release(pkt);
+        LOG_WARNING("WARNING: [LWMAC-tx] TX queue full, drop packet\n");
+    }
+    /* drop pointer so it wont be free'd */
+    netif->mac.tx.packet = NULL;
+}
+
 /* return false if send data failed, otherwise return true */
 static bool _send_data(gnrc_netif_t *netif)
 {
@@ -429,37 +449,49 @@ static bool _send_data(gnrc_netif_t *netif)
     /* if found ongoing transmission, quit this cycle for collision avoidance.
      * Data packet will be re-queued and try to send in the next cycle. */
     if (_gnrc_lwmac_get_netdev_state(netif) == NETOPT_STATE_RX) {
-        /* save pointer to netif header */
-        gnrc_pktsnip_t *netif_snip = pkt->next->next;
-
-        /* remove LWMAC header */
-        pkt->next->next = NULL;
-        gnrc_pktbuf_release(pkt->next);
+        _requeue_data(netif);
+        return false;
+    }
 
-        /* make append netif header after payload again */
-        pkt->next = netif_snip;
+#if (GNRC_LWMAC_ENABLE_PACKET_TRAIN == 1)
+    /* A packet of a train is sent without WR (see GNRC_LWMAC_TX_STATE_INIT),
+     * so the receiver may have stopped waiting for it already. Keep it to
+     * send it again with a WR stream if it is not acknowledged. */
+    bool train = (netif->mac.tx.wr_sent == 0);
 
-        if (!gnrc_mac_queue_tx_packet(&netif->mac.tx, 0, netif->mac.tx.packet)) {
-            gnrc_pktbuf_release(netif->mac.tx.packet);
-            LOG_WARNING("WARNING: [LWMAC-tx] TX queue full, drop packet\n");
-        }
-        /* drop pointer so it wont be free'd */
-        netif->mac.tx.packet = NULL;
-        return false;
+    if (train) {
+        gnrc_pktbuf_hold(pkt, 1);
     }
+#endif
 
     /* Send data */
     int res = _gnrc_lwmac_transmit(netif, pkt);
     if (res < 0) {
         LOG_ERROR("ERROR: [LWMAC-tx] Send data failed.");
-        gnrc_pktbuf_release(pkt);
-        /* clear packet point to avoid TX retry */
+#if (GNRC_LWMAC_ENABLE_PACKET_TRAIN == 1)
+        if (train) {
+            /* the reference of _gnrc_lwmac_transmit() was released, ours
+             * is left */
+            _requeue_data(netif);
+            return false;
+        }
+#endif
+        /* packet was released by _gnrc_lwmac_transmit(), so clear packet
+         * point to avoid TX retry */
         netif->mac.tx.packet = NULL;
         return false;
     }
 
+#if (GNRC_LWMAC_ENABLE_PACKET_TRAIN == 1)
+    /* Packet has been released by netdev, so drop pointer unless it is kept
+     * for the packet train */
+    if (!train) {
+        netif->mac.tx.packet = NULL;
+    }
+#else
     /* Packet has been released by netdev, so drop pointer */
     netif->mac.tx.packet = NULL;
+#endif
 
     DEBUG("[LWMAC-tx]: spent %lu WR in TX\n",
           (unsigned long)netif->mac.tx.wr_sent);
@@ -570,6 +602,21 @@ static bool _lwmac_tx_update(gnrc_netif_t *netif)
                 reschedule = true;
                 break;
             }
+#if (GNRC_LWMAC_ENABLE_PACKET_TRAIN == 1)
+            /* In a packet train, the receiver is still waiting for the data
+             * announced by the pending-bit of the previous packet, so send it
+             * right away without a new WR/WA handshake. */
+            else if (gnrc_lwmac_get_tx_continue(netif) &&
+                     (netif->mac.tx.tx_burst_count > 0)) {
+                LOG_DEBUG("[LWMAC-tx] Continue packet train\n");
+                /* Set a timeout in case of no Tx-isr */
+                gnrc_lwmac_set_timeout(netif, GNRC_LWMAC_TIMEOUT_NO_RESPONSE, GNRC_LWMAC_PREAMBLE_DURATION_US);
+
+                netif->mac.tx.state = GNRC_LWMAC_TX_STATE_SEND_DATA;
+                reschedule = true;
+                break;
+            }
+#endif
             else {
                 /* Use CSMA for the first WR */
                 netif->mac.mac_info |= GNRC_NETIF_MAC_INFO_CSMA_ENABLED;
@@ -758,6 +805,11 @@ static bool _lwmac_tx_update(gnrc_netif_t *netif)
         case GNRC_LWMAC_TX_STATE_WAIT_FEEDBACK: {
             /* In case of no Tx-isr error, goto TX failure. */
             if (gnrc_lwmac_timeout_is_expired(netif, GNRC_LWMAC_TIMEOUT_NO_RESPONSE)) {
+#if (GNRC_LWMAC_ENABLE_PACKET_TRAIN == 1)
+                if (netif->mac.tx.packet != NULL) {
+                    _requeue_data(netif);
+                }
+#endif
                 netif->mac.tx.state = GNRC_LWMAC_TX_STATE_FAILED;
                 reschedule = true;
                 break;
@@ -767,7 +819,26 @@ static bool _lwmac_tx_update(gnrc_netif_t *netif)
             if (gnrc_netif_get_tx_feedback(netif) == TX_FEEDBACK_UNDEF) {
                 break;
             }
-            else if (gnrc_netif_get_tx_feedback(netif) == TX_FEEDBACK_SUCCESS) {
+#if (GNRC_LWMAC_ENABLE_PACKET_TRAIN == 1)
+            /* A packet of a train is kept until its feedback arrives */
+            if (netif->mac.tx.packet != NULL) {
+                if (gnrc_netif_get_tx_feedback(netif) == TX_FEEDBACK_SUCCESS) {
+                    gnrc_pktbuf_release(netif->mac.tx.packet);
+                    netif->mac.tx.packet = NULL;
+                }
+                else {
+                    /* The receiver missed it, so end the train and send the
+                     * packet again with a WR stream, as for a burst whose WR
+                     * got no WA. */
+                    LOG_DEBUG("[LWMAC-tx] Packet train fail\n");
+                    _requeue_data(netif);
+                    netif->mac.tx.state = GNRC_LWMAC_TX_STATE_FAILED;
+                    reschedule = true;
+                    break;
+                }
+            }
+#endif
+            if (gnrc_netif_get_tx_feedback(netif) == TX_FEEDBACK_SUCCESS) {
                 netif->mac.tx.state = GNRC_LWMAC_TX_STATE_SUCCESSFUL;
                 reschedule = true;
                 break;
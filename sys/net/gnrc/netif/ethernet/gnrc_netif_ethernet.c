@@ -23,6 +23,9 @@
 #ifdef MODULE_GNRC_IPV6
 #include "net/ipv6/hdr.h"
 #endif
+#ifdef MODULE_GNRC_PCAPNG
+#include "net/gnrc/pcapng.h"
+#endif
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -150,6 +153,9 @@ static int _send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
     else {
         dev->stats.tx_unicast_count++;
     }
+#endif
+#ifdef MODULE_GNRC_PCAPNG
+    gnrc_pcapng_capture(netif->pid, GNRC_PCAPNG_LINKTYPE_ETHERNET, &iolist);
 #endif
     res = dev->driver->send(dev, &iolist);
 
@@ -183,6 +189,10 @@ static gnrc_pktsnip_t *_recv(gnrc_netif_t *netif)
             DEBUG("gnrc_netif_ethernet: read error.\n");
             goto safe_out;
         }
+#ifdef MODULE_GNRC_PCAPNG
+        gnrc_pcapng_capture_buf(netif->pid, GNRC_PCAPNG_LINKTYPE_ETHERNET,
+                                pkt->data, nread);
+#endif
 
         if (nread < bytes_expected) {
             /* we've got less than the expected packet size,
@@ -22,10 +22,12 @@
 #include "net/ipv6.h"
 #include "net/gnrc.h"
 #ifdef MODULE_GNRC_IPV6_NIB
+#include "net/gnrc/ipv6/flowcache.h"
 #include "net/gnrc/ipv6/nib.h"
 #include "net/gnrc/ipv6.h"
 #endif /* MODULE_GNRC_IPV6_NIB */
-#ifdef MODULE_NETSTATS_IPV6
+#if defined(MODULE_NETSTATS_IPV6) || defined(MODULE_GNRC_NETIF_TXQ) || \
+    defined(MODULE_NETSTATS_NEIGHBOR)
 #include "net/netstats.h"
 #endif
 #include "fmt.h"
@@ -126,6 +128,20 @@ int gnrc_netif_get_from_netdev(gnrc_netif_t *netif, gnrc_netapi_opt_t *opt)
                     *((netstats_t **)opt->data) = &netif->ipv6.stats;
                     res = sizeof(&netif->ipv6.stats);
                     break;
+#endif
+#ifdef MODULE_GNRC_NETIF_TXQ
+                case NETSTATS_TXQ:
+                    assert(opt->data_len == sizeof(netstats_txq_t *));
+                    *((netstats_txq_t **)opt->data) = &netif->txq.stats;
+                    res = sizeof(&netif->txq.stats);
+                    break;
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+                case NETSTATS_NEIGHBOR:
+                    assert(opt->data_len == sizeof(netstats_nb_t *));
+                    *((netstats_nb_t **)opt->data) = netif->nb_stats;
+                    res = sizeof(netstats_nb_t *);
+                    break;
 #endif
                 default:
                     /* take from device */
@@ -564,6 +580,31 @@ static ipv6_addr_t *_src_addr_selection(gnrc_netif_t *netif,
                                         const ipv6_addr_t *dst,
                                         uint8_t *candidate_set);
 
+#if GNRC_NETIF_IPV6_SRC_CACHE_SIZE > 0
+static inline void _src_cache_invalidate(gnrc_netif_t *netif)
+{
+    memset(netif->ipv6.src_cache, 0, sizeof(netif->ipv6.src_cache));
+}
+
+static gnrc_netif_ipv6_src_cache_t *_src_cache_get(gnrc_netif_t *netif,
+                                                   const ipv6_addr_t *dst)
+{
+    /* mix the last octets of prefix and interface identifier */
+    unsigned slot = (dst->u8[15] ^ dst->u8[7]) % GNRC_NETIF_IPV6_SRC_CACHE_SIZE;
+
+    if (memcmp(netif->ipv6.src_cache_addrs_flags, netif->ipv6.addrs_flags,
+               sizeof(netif->ipv6.addrs_flags)) != 0) {
+        DEBUG("gnrc_netif: address state changed, flush source cache\n");
+        _src_cache_invalidate(netif);
+        memcpy(netif->ipv6.src_cache_addrs_flags, netif->ipv6.addrs_flags,
+               sizeof(netif->ipv6.addrs_flags));
+    }
+    return &netif->ipv6.src_cache[slot];
+}
+#else
+#define _src_cache_invalidate(netif)    (void)netif
+#endif
+
 int gnrc_netif_ipv6_addr_add_internal(gnrc_netif_t *netif,
                                       const ipv6_addr_t *addr,
                                       unsigned pfx_len, uint8_t flags)
@@ -611,6 +652,9 @@ int gnrc_netif_ipv6_addr_add_internal(gnrc_netif_t *netif,
 #endif /* GNRC_IPV6_NIB_CONF_ARSM */
     netif->ipv6.addrs_flags[idx] = flags;
     memcpy(&netif->ipv6.addrs[idx], addr, sizeof(netif->ipv6.addrs[idx]));
+    _src_cache_invalidate(netif);
+    /* packets to this address must not be forwarded anymore */
+    gnrc_ipv6_flowcache_invalidate();
 #ifdef MODULE_GNRC_IPV6_NIB
     if (_get_state(netif, idx) == GNRC_NETIF_IPV6_ADDRS_FLAGS_STATE_VALID) {
         void *state = NULL;
@@ -657,6 +701,7 @@ void gnrc_netif_ipv6_addr_remove_internal(gnrc_netif_t *netif,
         if (ipv6_addr_equal(&netif->ipv6.addrs[i], addr)) {
             netif->ipv6.addrs_flags[i] = 0;
             ipv6_addr_set_unspecified(&netif->ipv6.addrs[i]);
+            _src_cache_invalidate(netif);
         }
         else {
             ipv6_addr_t tmp;
@@ -711,8 +756,19 @@ ipv6_addr_t *gnrc_netif_ipv6_addr_best_src(gnrc_netif_t *netif,
     assert((netif != NULL) && (dst != NULL));
     DEBUG("gnrc_netif: get best source address for %s\n",
           ipv6_addr_to_str(addr_str, dst, sizeof(addr_str)));
-    memset(candidate_set, 0, sizeof(candidate_set));
     gnrc_netif_acquire(netif);
+#if GNRC_NETIF_IPV6_SRC_CACHE_SIZE > 0
+    gnrc_netif_ipv6_src_cache_t *entry = _src_cache_get(netif, dst);
+
+    if (entry->valid && (entry->ll_only == ll_only) &&
+        ipv6_addr_equal(&entry->dst, dst)) {
+        DEBUG("gnrc_netif: source address found in cache\n");
+        best_src = (entry->idx < 0) ? NULL : &netif->ipv6.addrs[entry->idx];
+        gnrc_netif_release(netif);
+        return best_src;
+    }
+#endif
+    memset(candidate_set, 0, sizeof(candidate_set));
     int first_candidate = _create_candidate_set(netif, dst, ll_only,
                                                 candidate_set);
     if (first_candidate >= 0) {
@@ -721,6 +777,12 @@ ipv6_addr_t *gnrc_netif_ipv6_addr_best_src(gnrc_netif_t *netif,
             best_src = &(netif->ipv6.addrs[first_candidate]);
         }
     }
+#if GNRC_NETIF_IPV6_SRC_CACHE_SIZE > 0
+    entry->dst = *dst;
+    entry->idx = (best_src == NULL) ? -1 : (best_src - netif->ipv6.addrs);
+    entry->ll_only = ll_only;
+    entry->valid = true;
+#endif
     gnrc_netif_release(netif);
     return best_src;
 }
@@ -1233,6 +1295,15 @@ static void _init_from_device(gnrc_netif_t *netif)
 #endif
             break;
     }
+    {
+        netopt_enable_t csum_offload;
+
+        if ((dev->driver->get(dev, NETOPT_CSUM_OFFLOAD, &csum_offload,
+                              sizeof(csum_offload)) > 0) &&
+            (csum_offload == NETOPT_ENABLE)) {
+            netif->flags |= GNRC_NETIF_FLAGS_CSUM_OFFLOAD;
+        }
+    }
     _update_l2addr_from_dev(netif);
 }
 
@@ -1244,7 +1315,7 @@ static void _configure_netdev(netdev_t *dev)
     if (res < 0) {
         DEBUG("gnrc_netif: enable NETOPT_RX_END_IRQ failed: %d\n", res);
     }
-#ifdef MODULE_NETSTATS_L2
+#if defined(MODULE_NETSTATS_L2) || defined(MODULE_NETSTATS_NEIGHBOR)
     res = dev->driver->set(dev, NETOPT_TX_END_IRQ, &enable, sizeof(enable));
     if (res < 0) {
         DEBUG("gnrc_netif: enable NETOPT_TX_END_IRQ failed: %d\n", res);
@@ -1252,6 +1323,22 @@ static void _configure_netdev(netdev_t *dev)
 #endif
 }
 
+static void _recv_msg(gnrc_netif_t *netif, msg_t *msg)
+{
+#ifdef MODULE_GNRC_NETIF_TXQ
+    /* send queued packets while no other message is pending */
+    while (gnrc_netif_txq_ready(netif)) {
+        if (msg_try_receive(msg) > 0) {
+            return;
+        }
+        gnrc_netif_txq_send(netif);
+    }
+#else
+    (void)netif;
+#endif
+    msg_receive(msg);
+}
+
 static void *_gnrc_netif_thread(void *args)
 {
     gnrc_netapi_opt_t *opt;
@@ -1286,6 +1373,13 @@ static void *_gnrc_netif_thread(void *args)
     _configure_netdev(dev);
     _init_from_device(netif);
     netif->cur_hl = GNRC_NETIF_DEFAULT_HL;
+#ifdef MODULE_GNRC_NETIF_TXQ
+    gnrc_netif_txq_init(netif);
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+    netstats_nb_init(netif->nb_stats);
+    netif->nb_tx_addr_len = 0;
+#endif
 #ifdef MODULE_GNRC_IPV6_NIB
     gnrc_ipv6_nib_init_iface(netif);
 #endif
@@ -1297,7 +1391,7 @@ static void *_gnrc_netif_thread(void *args)
 
     while (1) {
         DEBUG("gnrc_netif: waiting for incoming messages\n");
-        msg_receive(&msg);
+        _recv_msg(netif, &msg);
         /* dispatch netdev, MAC and gnrc_netapi messages */
         switch (msg.type) {
             case NETDEV_MSG_TYPE_EVENT:
@@ -1306,12 +1400,22 @@ static void *_gnrc_netif_thread(void *args)
                 break;
             case GNRC_NETAPI_MSG_TYPE_SND:
                 DEBUG("gnrc_netif: GNRC_NETDEV_MSG_TYPE_SND received\n");
+#ifdef MODULE_GNRC_NETIF_TXQ
+                gnrc_netif_txq_push(netif, msg.content.ptr);
+#else
                 res = netif->ops->send(netif, msg.content.ptr);
                 if (res < 0) {
                     DEBUG("gnrc_netif: error sending packet %p (code: %u)\n",
                           msg.content.ptr, res);
                 }
+#endif
                 break;
+#ifdef MODULE_GNRC_NETIF_TXQ
+            case GNRC_NETIF_TXQ_MSG_TYPE_RETRY:
+                DEBUG("gnrc_netif: GNRC_NETIF_TXQ_MSG_TYPE_RETRY received\n");
+                gnrc_netif_txq_retry(netif);
+                break;
+#endif
             case GNRC_NETAPI_MSG_TYPE_SET:
                 opt = msg.content.ptr;
 #ifdef MODULE_NETOPT
@@ -1369,6 +1473,29 @@ static void _pass_on_packet(gnrc_pktsnip_t *pkt)
     }
 }
 
+#ifdef MODULE_NETSTATS_NEIGHBOR
+static void _update_nb_stats_tx(gnrc_netif_t *netif,
+                                netstats_nb_result_t result)
+{
+    netdev_t *dev = netif->dev;
+    uint8_t retries = 0;
+
+    if (netif->nb_tx_addr_len == 0) {
+        /* no unicast frame in transmission */
+        return;
+    }
+    if ((result == NETSTATS_NB_SUCCESS) &&
+        (dev->driver->get(dev, NETOPT_TX_RETRIES_NEEDED, &retries,
+                          sizeof(retries)) < 0)) {
+        /* device does not report retransmissions */
+        retries = 0;
+    }
+    netstats_nb_update_tx(netif->nb_stats, netif->nb_tx_addr,
+                          netif->nb_tx_addr_len, result, retries + 1);
+    netif->nb_tx_addr_len = 0;
+}
+#endif
+
 static void _event_cb(netdev_t *dev, netdev_event_t event)
 {
     gnrc_netif_t *netif = (gnrc_netif_t *) dev->context;
@@ -1392,16 +1519,36 @@ static void _event_cb(netdev_t *dev, netdev_event_t event)
                     }
                 }
                 break;
-#ifdef MODULE_NETSTATS_L2
+#ifdef MODULE_NETSTATS_NEIGHBOR
+            case NETDEV_EVENT_TX_NOACK:
+                _update_nb_stats_tx(netif, NETSTATS_NB_NOACK);
+                break;
+            case NETDEV_EVENT_TX_COMPLETE_DATA_PENDING:
+                _update_nb_stats_tx(netif, NETSTATS_NB_SUCCESS);
+                break;
+#endif
+#if defined(MODULE_NETSTATS_L2) || defined(MODULE_NETSTATS_NEIGHBOR)
             case NETDEV_EVENT_TX_MEDIUM_BUSY:
+#ifdef MODULE_NETSTATS_L2
                 /* we are the only ones supposed to touch this variable,
                  * so no acquire necessary */
                 dev->stats.tx_failed++;
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+                /* the frame was not sent, so it tells nothing about the
+                 * link */
+                netif->nb_tx_addr_len = 0;
+#endif
                 break;
             case NETDEV_EVENT_TX_COMPLETE:
+#ifdef MODULE_NETSTATS_L2
                 /* we are the only ones supposed to touch this variable,
                  * so no acquire necessary */
                 dev->stats.tx_success++;
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+                _update_nb_stats_tx(netif, NETSTATS_NB_SUCCESS);
+#endif
                 break;
 #endif
             default:
@@ -50,6 +50,20 @@ uint8_t gnrc_netif_hdr_get_flag(gnrc_pktsnip_t* pkt)
     return 0U;
 }
 
+bool gnrc_netif_hdr_csum_offloaded(gnrc_pktsnip_t *pkt)
+{
+    assert(pkt != NULL);
+
+    pkt = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_NETIF);
+    if (pkt && pkt->data) {
+        gnrc_netif_t *netif = gnrc_netif_hdr_get_netif(pkt->data);
+
+        return (netif != NULL) &&
+               (netif->flags & GNRC_NETIF_FLAGS_CSUM_OFFLOAD);
+    }
+    return false;
+}
+
 int gnrc_netif_hdr_get_dstaddr(gnrc_pktsnip_t* pkt, uint8_t** pointer_to_addr)
 {
     assert(pkt != NULL);
@@ -13,6 +13,8 @@
  * @author  Martine Lenders <m.lenders@fu-berlin.de>
  */
 
+#include <string.h>
+
 #include "net/gnrc.h"
 #include "net/gnrc/netif/ieee802154.h"
 #include "net/netdev/ieee802154.h"
@@ -20,6 +22,9 @@
 #ifdef MODULE_GNRC_IPV6
 #include "net/ipv6/hdr.h"
 #endif
+#ifdef MODULE_GNRC_PCAPNG
+#include "net/gnrc/pcapng.h"
+#endif
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -95,6 +100,11 @@ static gnrc_pktsnip_t *_recv(gnrc_netif_t *netif)
             gnrc_pktbuf_release(pkt);
             return NULL;
         }
+#ifdef MODULE_GNRC_PCAPNG
+        gnrc_pcapng_capture_buf(netif->pid,
+                                GNRC_PCAPNG_LINKTYPE_IEEE802_15_4_NOFCS,
+                                pkt->data, nread);
+#endif
         if (netif->flags & GNRC_NETIF_FLAGS_RAWMODE) {
             /* Raw mode, skip packet processing, but provide rx_info via
              * GNRC_NETTYPE_NETIF */
@@ -154,6 +164,12 @@ static gnrc_pktsnip_t *_recv(gnrc_netif_t *netif)
             hdr->lqi = rx_info.lqi;
             hdr->rssi = rx_info.rssi;
             hdr->if_pid = thread_getpid();
+#ifdef MODULE_NETSTATS_NEIGHBOR
+            netstats_nb_update_rx(netif->nb_stats,
+                                  gnrc_netif_hdr_get_src_addr(hdr),
+                                  hdr->src_l2addr_len, rx_info.rssi,
+                                  rx_info.lqi);
+#endif
             dev->driver->get(dev, NETOPT_PROTO, &pkt->type, sizeof(pkt->type));
 #if ENABLE_DEBUG
             DEBUG("_recv_ieee802154: received packet from %s of length %u\n",
@@ -247,6 +263,21 @@ static int _send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
         netif->dev->stats.tx_unicast_count++;
     }
 #endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+    /* remember the destination for the TX events of the device */
+    if (netif_hdr->flags &
+            (GNRC_NETIF_HDR_FLAGS_BROADCAST | GNRC_NETIF_HDR_FLAGS_MULTICAST)) {
+        netif->nb_tx_addr_len = 0;
+    }
+    else {
+        memcpy(netif->nb_tx_addr, dst, dst_len);
+        netif->nb_tx_addr_len = dst_len;
+    }
+#endif
+#ifdef MODULE_GNRC_PCAPNG
+    gnrc_pcapng_capture(netif->pid, GNRC_PCAPNG_LINKTYPE_IEEE802_15_4_NOFCS,
+                        &iolist);
+#endif
 #ifdef MODULE_GNRC_MAC
     if (netif->mac.mac_info & GNRC_NETIF_MAC_INFO_CSMA_ENABLED) {
         res = csma_sender_csma_ca_send(dev, &iolist, &netif->mac.csma_conf);
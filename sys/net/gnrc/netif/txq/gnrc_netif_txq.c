@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "net/gnrc.h"
+#include "net/gnrc/netif/internal.h"
+#ifdef MODULE_GNRC_IPV6
+#include "net/protnum.h"
+#endif
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+/* DSCP values (RFC 4594, RFC 8622) */
+#define _DSCP_CS1       (0x08)  /* low-priority data */
+#define _DSCP_LE        (0x01)  /* lower effort */
+#define _DSCP_CS6       (0x30)  /* network control */
+
+#ifdef MODULE_GNRC_IPV6
+uint8_t gnrc_netif_txq_hdr_flags(const ipv6_hdr_t *hdr)
+{
+    uint8_t dscp = ipv6_hdr_get_tc(hdr) >> 2;
+
+    /* neighbor discovery and routing protocol messages must not wait
+     * behind data */
+    if ((hdr->nh == PROTNUM_ICMPV6) || (dscp >= _DSCP_CS6)) {
+        return GNRC_NETIF_HDR_FLAGS_PRIO_HIGH;
+    }
+    if ((dscp == _DSCP_CS1) || (dscp == _DSCP_LE)) {
+        return GNRC_NETIF_HDR_FLAGS_PRIO_LOW;
+    }
+    return 0U;
+}
+#endif
+
+static uint32_t _prio(gnrc_pktsnip_t *pkt)
+{
+    uint8_t flags = 0U;
+
+    /* the IPv6 header might already be compressed (e.g. by 6LoWPAN), so the
+     * class set by the network layer takes precedence */
+    if (pkt->type == GNRC_NETTYPE_NETIF) {
+        flags = ((gnrc_netif_hdr_t *)pkt->data)->flags;
+    }
+#ifdef MODULE_GNRC_IPV6
+    if (!(flags & (GNRC_NETIF_HDR_FLAGS_PRIO_HIGH |
+                   GNRC_NETIF_HDR_FLAGS_PRIO_LOW))) {
+        gnrc_pktsnip_t *ipv6 = gnrc_pktsnip_search_type(pkt,
+                                                        GNRC_NETTYPE_IPV6);
+
+        if (ipv6 != NULL) {
+            flags = gnrc_netif_txq_hdr_flags(ipv6->data);
+        }
+    }
+#endif
+    if (flags & GNRC_NETIF_HDR_FLAGS_PRIO_HIGH) {
+        return GNRC_NETIF_TXQ_PRIO_HIGH;
+    }
+    if (flags & GNRC_NETIF_HDR_FLAGS_PRIO_LOW) {
+        return GNRC_NETIF_TXQ_PRIO_LOW;
+    }
+    return GNRC_NETIF_TXQ_PRIO_NORMAL;
+}
+
+static gnrc_netif_txq_node_t *_alloc_node(gnrc_netif_txq_t *txq, uint32_t prio)
+{
+    gnrc_netif_txq_node_t *tail;
+
+    for (unsigned i = 0; i < GNRC_NETIF_TXQ_SIZE; i++) {
+        if (txq->nodes[i].node.pkt == NULL) {
+            return &txq->nodes[i];
+        }
+    }
+    /* queue is full: make room by dropping the last packet if it has a lower
+     * priority. The head is never dropped as it might be in transmission. */
+    tail = (gnrc_netif_txq_node_t *)txq->queue.first;
+    while (tail->node.next != NULL) {
+        tail = (gnrc_netif_txq_node_t *)tail->node.next;
+    }
+    if ((tail == (gnrc_netif_txq_node_t *)txq->queue.first) ||
+        (tail->node.priority <= prio)) {
+        return NULL;
+    }
+    DEBUG("gnrc_netif_txq: dropping %p in favor of higher priority packet\n",
+          (void *)tail->node.pkt);
+    priority_queue_remove(&txq->queue, (priority_queue_node_t *)&tail->node);
+    gnrc_pktbuf_release_error(tail->node.pkt, ENOBUFS);
+    txq->stats.overflows++;
+    txq->stats.depth--;
+    return tail;
+}
+
+void gnrc_netif_txq_init(gnrc_netif_t *netif)
+{
+    gnrc_netif_txq_t *txq = &netif->txq;
+
+    memset(txq, 0, sizeof(*txq));
+    gnrc_priority_pktqueue_init(&txq->queue);
+    txq->retry_msg.type = GNRC_NETIF_TXQ_MSG_TYPE_RETRY;
+    txq->retry_msg.content.ptr = netif;
+}
+
+void gnrc_netif_txq_push(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
+{
+    gnrc_netif_txq_t *txq = &netif->txq;
+    uint32_t prio = _prio(pkt);
+    gnrc_netif_txq_node_t *node = _alloc_node(txq, prio);
+
+    if (node == NULL) {
+        DEBUG("gnrc_netif_txq: queue full, dropping %p\n", (void *)pkt);
+        txq->stats.overflows++;
+        /* let the sender know so it can back off */
+        gnrc_pktbuf_release_error(pkt, ENOBUFS);
+        return;
+    }
+    gnrc_priority_pktqueue_node_init(&node->node, prio, pkt);
+    node->time = xtimer_now_usec();
+    gnrc_priority_pktqueue_push(&txq->queue, &node->node);
+    txq->stats.enqueued++;
+    if (++txq->stats.depth > txq->stats.depth_max) {
+        txq->stats.depth_max = txq->stats.depth;
+    }
+}
+
+static void _remove_head(gnrc_netif_txq_t *txq)
+{
+    gnrc_netif_txq_node_t *head;
+    uint32_t latency;
+
+    head = (gnrc_netif_txq_node_t *)priority_queue_remove_head(&txq->queue);
+    latency = xtimer_now_usec() - head->time;
+    txq->stats.latency_avg -= txq->stats.latency_avg / 8;
+    txq->stats.latency_avg += latency / 8;
+    if (latency > txq->stats.latency_max) {
+        txq->stats.latency_max = latency;
+    }
+    txq->stats.depth--;
+    txq->retries = 0;
+    /* mark node as free */
+    priority_queue_node_init((priority_queue_node_t *)&head->node);
+}
+
+void gnrc_netif_txq_send(gnrc_netif_t *netif)
+{
+    gnrc_netif_txq_t *txq = &netif->txq;
+    /* Ethernet devices are fast compared to the rate packets are generated,
+     * so sending several packets at once saves going through the message
+     * queue for each packet */
+    unsigned burst = (netif->device_type == NETDEV_TYPE_ETHERNET) ?
+                     GNRC_NETIF_TXQ_BURST : 1;
+
+    while (burst-- && gnrc_netif_txq_ready(netif)) {
+        gnrc_pktsnip_t *pkt = gnrc_priority_pktqueue_head(&txq->queue);
+        gnrc_pktsnip_t *next = pkt->next;
+        int res;
+
+        /* keep packet in case the device is busy */
+        gnrc_pktbuf_hold(pkt, 1);
+        res = netif->ops->send(netif, pkt);
+        /* some interfaces (e.g. gnrc_netif_raw) remove the netif header from
+         * the packet before they release it. Our references to the header and
+         * to the rest of the packet are left, so link them again. */
+        pkt->next = next;
+        if ((res == -EBUSY) && (txq->retries < GNRC_NETIF_TXQ_RETRIES)) {
+            DEBUG("gnrc_netif_txq: device busy, retrying %p\n", (void *)pkt);
+            txq->retries++;
+            txq->stats.retries++;
+            txq->wait = true;
+            xtimer_set_msg(&txq->retry_timer, GNRC_NETIF_TXQ_RETRY_DELAY,
+                           &txq->retry_msg, netif->pid);
+            return;
+        }
+        if (res < 0) {
+            DEBUG("gnrc_netif_txq: error sending packet %p (code: %i)\n",
+                  (void *)pkt, res);
+        }
+        _remove_head(txq);
+        gnrc_pktbuf_release(pkt);
+    }
+}
+
+/** @} */
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "net/protnum.h"
+
+#include "net/gnrc/ipv6/flowcache.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#if (GNRC_IPV6_FLOWCACHE_SIZE & (GNRC_IPV6_FLOWCACHE_SIZE - 1))
+#error "GNRC_IPV6_FLOWCACHE_SIZE must be a power of 2"
+#endif
+
+static gnrc_ipv6_flowcache_entry_t _cache[GNRC_IPV6_FLOWCACHE_SIZE];
+/* entries of an older generation are invalid; starts at 1 so zeroed entries
+ * are never valid */
+static volatile uint32_t _gen = 1;
+
+static inline unsigned _slot(const gnrc_ipv6_flowcache_key_t *key)
+{
+    uint32_t h = key->src.u32[3].u32 ^ key->dst.u32[3].u32 ^
+                 key->dst.u32[2].u32 ^ ((uint32_t)key->sport << 16) ^
+                 key->dport ^ key->nh;
+
+    h ^= h >> 16;
+    h ^= h >> 8;
+    return h & (GNRC_IPV6_FLOWCACHE_SIZE - 1);
+}
+
+static inline bool _key_equal(const gnrc_ipv6_flowcache_key_t *a,
+                              const gnrc_ipv6_flowcache_key_t *b)
+{
+    return (a->nh == b->nh) && (a->sport == b->sport) &&
+           (a->dport == b->dport) && ipv6_addr_equal(&a->dst, &b->dst) &&
+           ipv6_addr_equal(&a->src, &b->src);
+}
+
+void gnrc_ipv6_flowcache_key(gnrc_ipv6_flowcache_key_t *key,
+                             const ipv6_hdr_t *hdr, const void *payload,
+                             size_t payload_len)
+{
+    const uint8_t *ports = payload;
+
+    key->src = hdr->src;
+    key->dst = hdr->dst;
+    key->nh = hdr->nh;
+    key->sport = 0;
+    key->dport = 0;
+    key->gen = _gen;
+    /* the ports are the first 4 bytes of both the UDP and the TCP header.
+     * They are kept in network byte order. */
+    if (((hdr->nh == PROTNUM_UDP) || (hdr->nh == PROTNUM_TCP)) &&
+        (payload_len >= 4)) {
+        memcpy(&key->sport, &ports[0], sizeof(key->sport));
+        memcpy(&key->dport, &ports[2], sizeof(key->dport));
+    }
+}
+
+const gnrc_ipv6_flowcache_entry_t *gnrc_ipv6_flowcache_get(const gnrc_ipv6_flowcache_key_t *key)
+{
+    const gnrc_ipv6_flowcache_entry_t *entry = &_cache[_slot(key)];
+
+    if ((entry->key.gen == _gen) && _key_equal(&entry->key, key)) {
+        return entry;
+    }
+    return NULL;
+}
+
+void gnrc_ipv6_flowcache_add(const gnrc_ipv6_flowcache_key_t *key,
+                             kernel_pid_t iface,
+                             const gnrc_netif_hdr_t *netif_hdr, size_t len)
+{
+    gnrc_ipv6_flowcache_entry_t *entry = &_cache[_slot(key)];
+
+    assert(len >= sizeof(gnrc_netif_hdr_t));
+    if ((key->gen != _gen) || (len > sizeof(entry->netif_hdr))) {
+        /* cache was invalidated while the route was determined */
+        return;
+    }
+    DEBUG("ipv6 flowcache: add flow to slot %u\n", _slot(key));
+    entry->key = *key;
+    entry->iface = iface;
+    entry->netif_hdr_len = len;
+    memcpy(entry->netif_hdr, netif_hdr, len);
+}
+
+void gnrc_ipv6_flowcache_invalidate(void)
+{
+    _gen++;
+}
+
+/** @} */
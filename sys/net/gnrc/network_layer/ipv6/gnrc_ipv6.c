@@ -31,6 +31,12 @@
 #include "net/gnrc/netif/internal.h"
 #include "net/gnrc/ipv6/whitelist.h"
 #include "net/gnrc/ipv6/blacklist.h"
+#ifdef MODULE_GNRC_RPL_SRH
+#include "net/gnrc/rpl/srh.h"
+#endif
+#ifdef MODULE_GNRC_IPV6_FLOWCACHE
+#include "net/gnrc/ipv6/flowcache.h"
+#endif
 
 #include "net/gnrc/ipv6.h"
 
@@ -61,6 +67,11 @@ fib_table_t gnrc_ipv6_fib_table;
 
 static char addr_str[IPV6_ADDR_MAX_STR_LEN];
 
+#ifdef MODULE_GNRC_IPV6_FLOWCACHE
+/* flow of the packet currently forwarded, NULL if not forwarding */
+static gnrc_ipv6_flowcache_key_t *_fwd_flow = NULL;
+#endif
+
 kernel_pid_t gnrc_ipv6_pid = KERNEL_PID_UNDEF;
 
 /* handles GNRC_NETAPI_MSG_TYPE_RCV commands */
@@ -275,6 +286,14 @@ static gnrc_pktsnip_t *_create_netif_hdr(uint8_t *dst_l2addr,
     /* previous netif header might have been allocated by some higher layer
      * to provide some flags (provided to us via netif_flags). */
     hdr->flags = flags;
+#ifdef MODULE_GNRC_NETIF_TXQ
+    /* the IPv6 header might be compressed before the packet is queued */
+    gnrc_pktsnip_t *ipv6 = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_IPV6);
+
+    if (ipv6 != NULL) {
+        hdr->flags |= gnrc_netif_txq_hdr_flags(ipv6->data);
+    }
+#endif
 
     /* add netif_hdr to front of the pkt list */
     LL_PREPEND(pkt, netif_hdr);
@@ -360,6 +379,12 @@ static int _fill_ipv6_hdr(gnrc_netif_t *netif, gnrc_pktsnip_t *ipv6)
         prev->next = payload;
         prev = payload;
     } while (_is_ipv6_hdr(payload) && (payload->next != NULL));
+    if ((netif != NULL) && (netif->flags & GNRC_NETIF_FLAGS_CSUM_OFFLOAD) &&
+        /* looped back packets never pass the device */
+        (gnrc_netif_ipv6_addr_idx(netif, &hdr->dst) < 0)) {
+        DEBUG("ipv6: checksum calculation offloaded to device.\n");
+        return 0;
+    }
     DEBUG("ipv6: calculate checksum for upper header.\n");
     if ((res = gnrc_netreg_calc_csum(payload, ipv6)) < 0) {
         if (res != -ENOENT) {   /* if there is no checksum we are okay */
@@ -383,6 +408,53 @@ static bool _safe_fill_ipv6_hdr(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt,
     return true;
 }
 
+#ifdef MODULE_GNRC_RPL_SRH
+/* inserts a RPL source routing header if a source route to the destination is
+ * known (i.e. we are the root of a non-storing DODAG). Only called for
+ * locally originated packets, since extension headers must not be inserted
+ * into forwarded packets (RFC 8200, section 4). Returns false if pkt was
+ * released. */
+static bool _insert_srh(gnrc_pktsnip_t *pkt, bool *prep_hdr,
+                        gnrc_netif_t *netif)
+{
+    ipv6_hdr_t *ipv6_hdr = pkt->data;
+    gnrc_pktsnip_t *srh_snip;
+    ipv6_addr_t first_hop;
+    int res;
+
+    if (((pkt->next != NULL) && (pkt->next->type == GNRC_NETTYPE_IPV6_EXT)) ||
+        ((res = gnrc_rpl_srh_build(&ipv6_hdr->dst, &first_hop, NULL, 0)) <= 0)) {
+        /* extension headers already present or no source route needed */
+        return true;
+    }
+    /* upper layer checksum is calculated over the final destination */
+    if (!_safe_fill_ipv6_hdr(netif, pkt, *prep_hdr)) {
+        return false;
+    }
+    *prep_hdr = false;
+    srh_snip = gnrc_pktbuf_add(pkt->next, NULL, res, GNRC_NETTYPE_IPV6_EXT);
+    if ((srh_snip == NULL) ||
+        (gnrc_rpl_srh_build(&ipv6_hdr->dst, &first_hop, srh_snip->data,
+                            srh_snip->size) != res)) {
+        DEBUG("ipv6: unable to add source routing header, dropping packet\n");
+        if (srh_snip != NULL) {
+            srh_snip->next = NULL;
+            gnrc_pktbuf_release(srh_snip);
+        }
+        gnrc_pktbuf_release(pkt);
+        return false;
+    }
+    pkt->next = srh_snip;
+    ((gnrc_rpl_srh_t *)srh_snip->data)->nh = ipv6_hdr->nh;
+    ipv6_hdr->nh = PROTNUM_IPV6_EXT_RH;
+    ipv6_hdr->len = byteorder_htons(byteorder_ntohs(ipv6_hdr->len) + res);
+    ipv6_hdr->dst = first_hop;
+    DEBUG("ipv6: added source routing header, first hop %s\n",
+          ipv6_addr_to_str(addr_str, &first_hop, sizeof(addr_str)));
+    return true;
+}
+#endif
+
 /* functions for sending */
 static void _send_unicast(gnrc_pktsnip_t *pkt, bool prep_hdr,
                           gnrc_netif_t *netif, ipv6_hdr_t *ipv6_hdr,
@@ -406,6 +478,15 @@ static void _send_unicast(gnrc_pktsnip_t *pkt, bool prep_hdr,
                                      netif_hdr_flags)) == NULL) {
             return;
         }
+#ifdef MODULE_GNRC_IPV6_FLOWCACHE
+        /* only cache the flow if the destination was not changed (e.g. by a
+         * source routing header) */
+        if ((_fwd_flow != NULL) &&
+            ipv6_addr_equal(&_fwd_flow->dst, &ipv6_hdr->dst)) {
+            gnrc_ipv6_flowcache_add(_fwd_flow, netif->pid, pkt->data,
+                                    pkt->size);
+        }
+#endif
         DEBUG("ipv6: send unicast over interface %" PRIkernel_pid "\n",
               netif->pid);
         /* and send to interface */
@@ -590,6 +671,13 @@ static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr)
             _send_to_self(pkt, prep_hdr, tmp_netif);
         }
         else {
+#ifdef MODULE_GNRC_RPL_SRH
+            /* forwarded packets would need to be encapsulated (RFC 6554,
+             * section 2), so they are routed by the forwarding table */
+            if (prep_hdr && !_insert_srh(pkt, &prep_hdr, netif)) {
+                return;
+            }
+#endif
             _send_unicast(pkt, prep_hdr, netif, ipv6_hdr, netif_hdr_flags);
         }
     }
@@ -611,6 +699,49 @@ static inline bool _pkt_not_for_me(gnrc_netif_t **netif, ipv6_hdr_t *hdr)
     }
 }
 
+#ifdef MODULE_GNRC_IPV6_FLOWCACHE
+/* sends a received packet of a known flow directly to the outgoing interface.
+ * Returns false if the packet needs to take the regular path */
+static bool _fast_forward(gnrc_pktsnip_t *pkt, ipv6_hdr_t *hdr,
+                          const gnrc_ipv6_flowcache_key_t *flow)
+{
+    const gnrc_ipv6_flowcache_entry_t *entry = gnrc_ipv6_flowcache_get(flow);
+    gnrc_pktsnip_t *netif_hdr;
+    gnrc_netif_t *netif;
+
+    /* let the regular path generate the ICMPv6 error for the hop limit */
+    if ((entry == NULL) || (hdr->hl <= 1) ||
+        ((netif = gnrc_netif_get_by_pid(entry->iface)) == NULL)) {
+        return false;
+    }
+    DEBUG("ipv6: fast-forward packet over interface %" PRIkernel_pid "\n",
+          netif->pid);
+    /* pkt and its IPv6 header were made writable in _receive() */
+    hdr->hl--;
+    netif_hdr = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_NETIF);
+    if (netif_hdr != NULL) {
+        gnrc_pktbuf_remove_snip(pkt, netif_hdr);
+    }
+    if ((pkt = gnrc_pktbuf_reverse_snips(pkt)) == NULL) {
+        DEBUG("ipv6: unable to reverse pkt from receive order to send "
+              "order; dropping it\n");
+        return true;
+    }
+    netif_hdr = gnrc_pktbuf_add(pkt, entry->netif_hdr, entry->netif_hdr_len,
+                                GNRC_NETTYPE_NETIF);
+    if (netif_hdr == NULL) {
+        DEBUG("ipv6: error on interface header allocation, dropping packet\n");
+        gnrc_pktbuf_release(pkt);
+        return true;
+    }
+#ifdef MODULE_NETSTATS_IPV6
+    netif->ipv6.stats.tx_unicast_count++;
+#endif
+    _send_to_iface(netif, netif_hdr);
+    return true;
+}
+#endif
+
 static void _receive(gnrc_pktsnip_t *pkt)
 {
     gnrc_netif_t *netif = NULL;
@@ -717,6 +848,20 @@ static void _receive(gnrc_pktsnip_t *pkt)
           ipv6_addr_to_str(addr_str, &(hdr->dst), sizeof(addr_str)),
           first_nh, byteorder_ntohs(hdr->len));
 
+#ifdef MODULE_GNRC_IPV6_FLOWCACHE
+    gnrc_ipv6_flowcache_key_t flow, *fwd_flow = NULL;
+
+    /* hop-by-hop options need to be processed by every router */
+    if ((netif_hdr != NULL) && (first_nh != PROTNUM_IPV6_EXT_HOPOPT) &&
+        !ipv6_addr_is_multicast(&hdr->dst)) {
+        gnrc_ipv6_flowcache_key(&flow, hdr, pkt->data, pkt->size);
+        if (_fast_forward(pkt, hdr, &flow)) {
+            return;
+        }
+        fwd_flow = &flow;
+    }
+#endif
+
     if ((pkt = gnrc_ipv6_ext_process_hopopt(pkt, &first_nh)) != NULL) {
         ipv6 = pkt->next->next;
     }
@@ -770,7 +915,14 @@ static void _receive(gnrc_pktsnip_t *pkt)
             }
             pkt = gnrc_pktbuf_reverse_snips(pkt);
             if (pkt != NULL) {
+#ifdef MODULE_GNRC_IPV6_FLOWCACHE
+                /* cache the route of this flow when sending */
+                _fwd_flow = fwd_flow;
                 _send(pkt, false);
+                _fwd_flow = NULL;
+#else
+                _send(pkt, false);
+#endif
             }
             else {
                 DEBUG("ipv6: unable to reverse pkt from receive order to send "
@@ -15,6 +15,7 @@
 
 #include "xtimer.h"
 #include "net/gnrc/ndp.h"
+#include "net/gnrc/ipv6/flowcache.h"
 #include "net/gnrc/ipv6/nib.h"
 #include "net/gnrc/netif/internal.h"
 #ifdef MODULE_GNRC_SIXLOWPAN_ND
@@ -169,6 +170,7 @@ void _handle_sl2ao(gnrc_netif_t *netif, const ipv6_hdr_t *ipv6,
         if (!_rtr_sol_on_6lr(netif, icmpv6)) {
             nce->l2addr_len = l2addr_len;
             memcpy(nce->l2addr, sl2ao + 1, l2addr_len);
+            gnrc_ipv6_flowcache_invalidate();
         }
 #endif  /* GNRC_IPV6_NIB_CONF_ARSM */
     }
@@ -403,6 +405,7 @@ void _handle_adv_l2(gnrc_netif_t *netif, _nib_onl_entry_t *nce,
         else {
             nce->l2addr_len = 0;
         }
+        gnrc_ipv6_flowcache_invalidate();
         if (_sflag_set((ndp_nbr_adv_t *)icmpv6)) {
             _set_reachable(netif, nce);
         }
@@ -482,6 +485,11 @@ void _set_nud_state(gnrc_netif_t *netif, _nib_onl_entry_t *nce,
 {
     nce->info &= ~GNRC_IPV6_NIB_NC_INFO_NUD_STATE_MASK;
     nce->info |= state;
+    /* let the next packet of a flow to this neighbor go through the regular
+     * path so neighbor unreachability detection can kick in */
+    if (state != GNRC_IPV6_NIB_NC_INFO_NUD_STATE_REACHABLE) {
+        gnrc_ipv6_flowcache_invalidate();
+    }
 
 #if GNRC_IPV6_NIB_CONF_ROUTER
     gnrc_netif_acquire(netif);
@@ -19,10 +19,14 @@
 
 #include "net/gnrc/icmpv6/error.h"
 #include "net/gnrc/ipv6.h"
+#include "net/gnrc/ipv6/flowcache.h"
 #include "net/gnrc/ipv6/nib/conf.h"
 #include "net/gnrc/ipv6/nib/nc.h"
 #include "net/gnrc/ipv6/nib.h"
 #include "net/gnrc/netif/internal.h"
+#ifdef MODULE_NETSTATS_NEIGHBOR
+#include "net/netstats/neighbor.h"
+#endif
 #include "random.h"
 
 #include "_nib-internal.h"
@@ -273,6 +277,7 @@ void _nib_nc_remove(_nib_onl_entry_t *node)
     }
 #endif  /* GNRC_IPV6_NIB_CONF_QUEUE_PKT */
     _nib_onl_clear(node);
+    gnrc_ipv6_flowcache_invalidate();
 }
 
 #if GNRC_IPV6_NIB_CONF_6LN || !GNRC_IPV6_NIB_CONF_ARSM
@@ -352,6 +357,7 @@ _nib_dr_entry_t *_nib_drl_add(const ipv6_addr_t *router_addr, unsigned iface)
         }
         _override_node(router_addr, iface, def_router->next_hop);
         def_router->next_hop->mode |= _DRL;
+        gnrc_ipv6_flowcache_invalidate();
     }
     return def_router;
 }
@@ -366,6 +372,7 @@ void _nib_drl_remove(_nib_dr_entry_t *nib_dr)
     if (nib_dr == _prime_def_router) {
         _prime_def_router = NULL;
     }
+    gnrc_ipv6_flowcache_invalidate();
 }
 
 _nib_dr_entry_t *_nib_drl_iter(const _nib_dr_entry_t *last)
@@ -495,6 +502,7 @@ _nib_offl_entry_t *_nib_offl_alloc(const ipv6_addr_t *next_hop, unsigned iface,
         dst->next_hop->mode |= _DST;
         ipv6_addr_init_prefix(&dst->pfx, pfx, pfx_len);
         dst->pfx_len = pfx_len;
+        gnrc_ipv6_flowcache_invalidate();
     }
     return dst;
 }
@@ -527,6 +535,7 @@ void _nib_offl_clear(_nib_offl_entry_t *dst)
             _nib_onl_clear(dst->next_hop);
         }
         memset(dst, 0, sizeof(_nib_offl_entry_t));
+        gnrc_ipv6_flowcache_invalidate();
     }
 }
 
@@ -808,6 +817,25 @@ static void _override_node(const ipv6_addr_t *addr, unsigned iface,
     _nib_onl_set_if(node, iface);
 }
 
+#if defined(MODULE_NETSTATS_NEIGHBOR) && GNRC_IPV6_NIB_CONF_ARSM
+/* a neighbor is reachable in terms of NUD even if most frames to it need
+ * several retransmissions, so also check the link statistics */
+static bool _node_lossy(_nib_onl_entry_t *node)
+{
+    gnrc_netif_t *netif = gnrc_netif_get_by_pid(_nib_onl_get_if(node));
+    netstats_nb_t *stats;
+
+    if ((netif == NULL) || (node->l2addr_len == 0)) {
+        return false;
+    }
+    stats = netstats_nb_get(netif->nb_stats, node->l2addr, node->l2addr_len);
+    return (stats != NULL) && netstats_nb_isfresh(stats) &&
+           (stats->etx > GNRC_IPV6_NIB_CONF_MAX_DR_ETX);
+}
+#else
+#define _node_lossy(node)   (false)
+#endif
+
 static inline bool _node_unreachable(_nib_onl_entry_t *node)
 {
     switch (node->info & GNRC_IPV6_NIB_NC_INFO_NUD_STATE_MASK) {
@@ -816,7 +844,7 @@ static inline bool _node_unreachable(_nib_onl_entry_t *node)
         case GNRC_IPV6_NIB_NC_INFO_NUD_STATE_INCOMPLETE:
             return true;
         default:
-            return false;
+            return _node_lossy(node);
     }
 }
 
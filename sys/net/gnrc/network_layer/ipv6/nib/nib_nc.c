@@ -20,6 +20,7 @@
 #include "net/gnrc/ipv6.h"
 #include "net/gnrc/netif.h"
 
+#include "net/gnrc/ipv6/flowcache.h"
 #include "net/gnrc/ipv6/nib/nc.h"
 
 #include "_nib-internal.h"
@@ -43,6 +44,7 @@ int gnrc_ipv6_nib_nc_set(const ipv6_addr_t *ipv6, unsigned iface,
         memcpy(node->l2addr, l2addr, l2addr_len);
     }
     node->l2addr_len = l2addr_len;
+    gnrc_ipv6_flowcache_invalidate();
 #else
     (void)l2addr;
     (void)l2addr_len;
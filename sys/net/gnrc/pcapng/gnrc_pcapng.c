@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_pcapng
+ * @{
+ *
+ * @file
+ * @brief       Capture of network packets as pcapng
+ *
+ * Packets are serialized to pcapng blocks by the capturing thread and put into
+ * a @ref tsrb. The producers are serialized by a mutex, so the pcapng thread
+ * as the only consumer reads the ring buffer without locking.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "msg.h"
+#include "mutex.h"
+#include "thread.h"
+#include "tsrb.h"
+#include "xtimer.h"
+#include "net/gnrc.h"
+#include "net/gnrc/pcapng.h"
+
+#ifdef MODULE_NATIVE_PCAPNG
+#include "native_pcapng.h"
+#endif
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#if (GNRC_PCAPNG_BUFSIZE & (GNRC_PCAPNG_BUFSIZE - 1))
+#error "GNRC_PCAPNG_BUFSIZE must be a power of 2"
+#endif
+
+#define _MSG_TYPE_FLUSH         (0x0a01)    /**< flush without reply */
+#define _MSG_TYPE_FLUSH_SYNC    (0x0a02)    /**< flush and reply */
+#define _MSG_TYPE_SET_OUTPUT    (0x0a03)
+
+/**
+ * @name    pcapng block types
+ * @{
+ */
+#define _BLOCK_SHB              (0x0a0d0d0aU)   /**< section header */
+#define _BLOCK_IDB              (0x00000001U)   /**< interface description */
+#define _BLOCK_EPB              (0x00000006U)   /**< enhanced packet */
+/** @} */
+
+#define _BYTE_ORDER_MAGIC       (0x1a2b3c4dU)
+#define _SHB_LEN                (28U)
+#define _IDB_LEN                (20U)
+#define _EPB_LEN                (32U)   /**< without the packet data */
+#define _DRAIN_CHUNK_SIZE       (64U)
+
+/**
+ * @brief   A pcapng interface, i.e. a network interface with a link type
+ */
+typedef struct {
+    kernel_pid_t pid;
+    uint16_t linktype;
+} _iface_t;
+
+kernel_pid_t gnrc_pcapng_pid = KERNEL_PID_UNDEF;
+
+static char _stack[GNRC_PCAPNG_STACKSIZE];
+static char _buf[GNRC_PCAPNG_BUFSIZE];
+static tsrb_t _rb = TSRB_INIT(_buf);
+static mutex_t _lock = MUTEX_INIT;      /**< serializes the producers */
+static _iface_t _ifaces[GNRC_PCAPNG_IF_NUMOF];
+static unsigned _ifaces_numof;
+static gnrc_pcapng_write_t _output;
+static gnrc_pcapng_stats_t _stats;
+static bool _shb_written;
+static volatile bool _flush_pending;
+
+static inline void _add_u16(uint16_t val)
+{
+    tsrb_add(&_rb, (char *)&val, sizeof(val));
+}
+
+static inline void _add_u32(uint32_t val)
+{
+    tsrb_add(&_rb, (char *)&val, sizeof(val));
+}
+
+static inline size_t _pad(size_t len)
+{
+    return (len + 3U) & ~((size_t)3U);
+}
+
+static int _get_iface(kernel_pid_t pid, uint16_t linktype)
+{
+    for (unsigned i = 0; i < _ifaces_numof; i++) {
+        if ((_ifaces[i].pid == pid) && (_ifaces[i].linktype == linktype)) {
+            return i;
+        }
+    }
+    if ((_ifaces_numof >= GNRC_PCAPNG_IF_NUMOF)) {
+        return -ENOSPC;
+    }
+    if (tsrb_free(&_rb) < _IDB_LEN) {
+        return -ENOBUFS;
+    }
+    /* the interface is only known, if its description is in the capture */
+    _add_u32(_BLOCK_IDB);
+    _add_u32(_IDB_LEN);
+    _add_u16(linktype);
+    _add_u16(0);                /* reserved */
+    _add_u32(GNRC_PCAPNG_SNAPLEN);
+    _add_u32(_IDB_LEN);
+    _ifaces[_ifaces_numof].pid = pid;
+    _ifaces[_ifaces_numof].linktype = linktype;
+    DEBUG("gnrc_pcapng: interface %u for PID %d with link type %u\n",
+          _ifaces_numof, (int)pid, (unsigned)linktype);
+    return _ifaces_numof++;
+}
+
+int gnrc_pcapng_capture(kernel_pid_t if_pid, uint16_t linktype,
+                        const iolist_t *iolist)
+{
+    uint64_t now = xtimer_now_usec64();
+    size_t len = iolist_size(iolist);
+    size_t caplen = (len > GNRC_PCAPNG_SNAPLEN) ? GNRC_PCAPNG_SNAPLEN : len;
+    size_t total = _EPB_LEN + _pad(caplen);
+    int res;
+
+    mutex_lock(&_lock);
+    if (_output == NULL) {
+        res = -ENOBUFS;
+        goto out;
+    }
+    if ((res = _get_iface(if_pid, linktype)) < 0) {
+        goto out;
+    }
+    if (tsrb_free(&_rb) < total) {
+        res = -ENOBUFS;
+        goto out;
+    }
+    _add_u32(_BLOCK_EPB);
+    _add_u32(total);
+    _add_u32(res);
+    _add_u32((uint32_t)(now >> 32));
+    _add_u32((uint32_t)now);
+    _add_u32(caplen);
+    _add_u32(len);
+    for (size_t left = caplen; left > 0; iolist = iolist->iol_next) {
+        size_t part = (iolist->iol_len < left) ? iolist->iol_len : left;
+
+        tsrb_add(&_rb, iolist->iol_base, part);
+        left -= part;
+    }
+    for (size_t i = caplen; i < _pad(caplen); i++) {
+        tsrb_add_one(&_rb, 0);
+    }
+    _add_u32(total);
+    _stats.captured++;
+    res = 0;
+    /* don't wait for the flush interval, if a burst would fill the buffer */
+    if (!_flush_pending && (tsrb_avail(&_rb) > (GNRC_PCAPNG_BUFSIZE / 2)) &&
+        (gnrc_pcapng_pid != KERNEL_PID_UNDEF)) {
+        msg_t msg = { .type = _MSG_TYPE_FLUSH };
+
+        _flush_pending = (msg_try_send(&msg, gnrc_pcapng_pid) == 1);
+    }
+out:
+    if (res == -ENOBUFS) {
+        _stats.dropped++;
+    }
+    mutex_unlock(&_lock);
+    return res;
+}
+
+void gnrc_pcapng_get_stats(gnrc_pcapng_stats_t *stats)
+{
+    mutex_lock(&_lock);
+    *stats = _stats;
+    mutex_unlock(&_lock);
+}
+
+static void _write_shb(void)
+{
+    struct {
+        uint32_t type;
+        uint32_t len;
+        uint32_t magic;
+        uint16_t major;
+        uint16_t minor;
+        uint32_t section_len[2];
+        uint32_t trailer_len;
+    } shb = {
+        _BLOCK_SHB, _SHB_LEN, _BYTE_ORDER_MAGIC,
+        1U, 0U,
+        { UINT32_MAX, UINT32_MAX },     /* section length unknown */
+        _SHB_LEN,
+    };
+
+    _output(&shb, sizeof(shb));
+    _shb_written = true;
+}
+
+static void _drain(void)
+{
+    char chunk[_DRAIN_CHUNK_SIZE];
+    int len;
+
+    _flush_pending = false;
+    if (_output == NULL) {
+        return;
+    }
+    if (!_shb_written) {
+        _write_shb();
+    }
+    while ((len = tsrb_get(&_rb, chunk, sizeof(chunk))) > 0) {
+        if (_output(chunk, len) < 0) {
+            DEBUG("gnrc_pcapng: unable to write %d bytes\n", len);
+        }
+    }
+}
+
+static void _set_output(gnrc_pcapng_write_t write)
+{
+    mutex_lock(&_lock);
+    tsrb_init(&_rb, _buf, sizeof(_buf));
+    _ifaces_numof = 0;
+    _shb_written = false;
+    _output = write;
+    mutex_unlock(&_lock);
+}
+
+static uint16_t _linktype(gnrc_nettype_t type)
+{
+    switch (type) {
+#ifdef MODULE_GNRC_IPV6
+        case GNRC_NETTYPE_IPV6:
+            return GNRC_PCAPNG_LINKTYPE_IPV6;
+#endif
+        default:
+            (void)type;
+            return GNRC_PCAPNG_LINKTYPE_USER0;
+    }
+}
+
+static void _capture_pkt(gnrc_pktsnip_t *pkt, bool rcv)
+{
+    gnrc_pktsnip_t *netif = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_NETIF);
+    kernel_pid_t if_pid = KERNEL_PID_UNDEF;
+    iolist_t iolist[GNRC_NETTYPE_NUMOF];
+    iolist_t *head = NULL;
+    uint16_t linktype = GNRC_PCAPNG_LINKTYPE_USER0;
+
+    if (netif != NULL) {
+        if_pid = ((gnrc_netif_hdr_t *)netif->data)->if_pid;
+    }
+    /* received packets start with the payload, so the snips are reversed to
+     * get the header first */
+    for (unsigned i = 0; (pkt != NULL) && (i < GNRC_NETTYPE_NUMOF);
+         pkt = pkt->next) {
+        if (pkt->type == GNRC_NETTYPE_NETIF) {
+            continue;
+        }
+        iolist[i].iol_base = pkt->data;
+        iolist[i].iol_len = pkt->size;
+        if (rcv) {
+            iolist[i].iol_next = head;
+            head = &iolist[i];
+            linktype = _linktype(pkt->type);
+        }
+        else {
+            iolist[i].iol_next = NULL;
+            if (i > 0) {
+                iolist[i - 1].iol_next = &iolist[i];
+            }
+            else {
+                head = &iolist[i];
+                linktype = _linktype(pkt->type);
+            }
+        }
+        i++;
+    }
+    if (head != NULL) {
+        gnrc_pcapng_capture(if_pid, linktype, head);
+    }
+}
+
+static void *_eventloop(void *arg)
+{
+    (void)arg;
+    msg_t msg, reply;
+    msg_t msg_queue[GNRC_PCAPNG_MSG_QUEUE_SIZE];
+
+    msg_init_queue(msg_queue, GNRC_PCAPNG_MSG_QUEUE_SIZE);
+#ifdef MODULE_NATIVE_PCAPNG
+    if (native_pcapng_open() == 0) {
+        _set_output(native_pcapng_write);
+    }
+#endif
+
+    while (1) {
+        if (xtimer_msg_receive_timeout(&msg,
+                                       GNRC_PCAPNG_FLUSH_INTERVAL_US) < 0) {
+            _drain();
+            continue;
+        }
+        switch (msg.type) {
+            case GNRC_NETAPI_MSG_TYPE_RCV:
+            case GNRC_NETAPI_MSG_TYPE_SND:
+                _capture_pkt(msg.content.ptr,
+                             (msg.type == GNRC_NETAPI_MSG_TYPE_RCV));
+                gnrc_pktbuf_release(msg.content.ptr);
+                break;
+            case GNRC_NETAPI_MSG_TYPE_GET:
+            case GNRC_NETAPI_MSG_TYPE_SET:
+                reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
+                reply.content.value = (uint32_t)(-ENOTSUP);
+                msg_reply(&msg, &reply);
+                break;
+            case _MSG_TYPE_SET_OUTPUT:
+                _set_output(*((gnrc_pcapng_write_t *)msg.content.ptr));
+                msg_reply(&msg, &msg);
+                break;
+            case _MSG_TYPE_FLUSH:
+                _drain();
+                break;
+            case _MSG_TYPE_FLUSH_SYNC:
+                _drain();
+                msg_reply(&msg, &msg);
+                break;
+            default:
+                DEBUG("gnrc_pcapng: unexpected message type 0x%04x\n",
+                      msg.type);
+                break;
+        }
+    }
+
+    /* never reached */
+    return NULL;
+}
+
+static void _send_receive(uint16_t type, void *ptr)
+{
+    msg_t msg = { .type = type, .content = { .ptr = ptr } };
+
+    if (gnrc_pcapng_pid == KERNEL_PID_UNDEF) {
+        /* without thread the caller is the only consumer */
+        if (type == _MSG_TYPE_SET_OUTPUT) {
+            _set_output(*((gnrc_pcapng_write_t *)ptr));
+        }
+        else {
+            _drain();
+        }
+        return;
+    }
+    msg_send_receive(&msg, &msg, gnrc_pcapng_pid);
+}
+
+void gnrc_pcapng_set_output(gnrc_pcapng_write_t write)
+{
+    _send_receive(_MSG_TYPE_SET_OUTPUT, &write);
+}
+
+void gnrc_pcapng_flush(void)
+{
+    _send_receive(_MSG_TYPE_FLUSH_SYNC, NULL);
+}
+
+kernel_pid_t gnrc_pcapng_init(void)
+{
+    if (gnrc_pcapng_pid == KERNEL_PID_UNDEF) {
+        gnrc_pcapng_pid = thread_create(_stack, sizeof(_stack),
+                                        GNRC_PCAPNG_PRIO,
+                                        THREAD_CREATE_STACKTEST,
+                                        _eventloop, NULL, "pcapng");
+    }
+    return gnrc_pcapng_pid;
+}
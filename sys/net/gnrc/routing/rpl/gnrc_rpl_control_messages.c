@@ -37,6 +37,10 @@
 #include "gnrc_rpl_internal/validation.h"
 #endif
 
+#ifdef MODULE_GNRC_RPL_SRH
+#include "net/gnrc/rpl/srh.h"
+#endif
+
 #ifdef MODULE_GNRC_RPL_P2P
 #include "net/gnrc/rpl/p2p_structs.h"
 #include "net/gnrc/rpl/p2p_dodag.h"
@@ -393,6 +397,27 @@ static inline uint32_t _sec_to_ms(uint32_t sec)
     }
 }
 
+#ifdef MODULE_GNRC_RPL_SRH
+static void _update_srh_table(ipv6_addr_t *target, ipv6_addr_t *parent,
+                              uint8_t lifetime)
+{
+    if (lifetime == 0) {
+        DEBUG("RPL: remove %s from source route table\n",
+              ipv6_addr_to_str(addr_str, target, sizeof(addr_str)));
+        gnrc_rpl_srh_table_del(target);
+        return;
+    }
+    /* a parent address of the root itself means the target is our child */
+    if (gnrc_netif_get_by_ipv6_addr(parent) != NULL) {
+        parent = NULL;
+    }
+    if (gnrc_rpl_srh_table_add(target, parent) < 0) {
+        DEBUG("RPL: source route table full, unable to add %s\n",
+              ipv6_addr_to_str(addr_str, target, sizeof(addr_str)));
+    }
+}
+#endif
+
 /** @todo allow target prefixes in target options to be of variable length */
 bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt, uint16_t len,
                     ipv6_addr_t *src, uint32_t *included_opts)
@@ -537,6 +562,18 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                     break;
                 }
 
+#ifdef MODULE_GNRC_RPL_SRH
+                ipv6_addr_t *transit_parent = NULL;
+
+                /* the root of a non-storing DODAG learns the parent of each
+                 * target to build source routes */
+                if ((inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) &&
+                    (dodag->node_status == GNRC_RPL_ROOT_NODE) &&
+                    (transit->length >= (GNRC_RPL_OPT_TRANSIT_INFO_LEN + sizeof(ipv6_addr_t)))) {
+                    transit_parent = (ipv6_addr_t *)(transit + 1);
+                }
+#endif
+
                 do {
                     DEBUG("RPL: updating FT entry %s/%d\n",
                           ipv6_addr_to_str(addr_str, &(first_target->target), sizeof(addr_str)),
@@ -548,6 +585,12 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                                          first_target->prefix_length, src,
                                          dodag->iface,
                                          transit->path_lifetime * dodag->lifetime_unit);
+#ifdef MODULE_GNRC_RPL_SRH
+                    if (transit_parent != NULL) {
+                        _update_srh_table(&first_target->target, transit_parent,
+                                          transit->path_lifetime);
+                    }
+#endif
 
                     first_target = (gnrc_rpl_opt_target_t *) (((uint8_t *) (first_target)) +
                                    sizeof(gnrc_rpl_opt_t) + first_target->length);
@@ -833,12 +876,17 @@ gnrc_pktsnip_t *_dao_target_build(gnrc_pktsnip_t *pkt, ipv6_addr_t *addr, uint8_
     return opt_snip;
 }
 
-gnrc_pktsnip_t *_dao_transit_build(gnrc_pktsnip_t *pkt, uint8_t lifetime, bool external)
+gnrc_pktsnip_t *_dao_transit_build(gnrc_pktsnip_t *pkt, uint8_t lifetime, bool external,
+                                   ipv6_addr_t *parent)
 {
     gnrc_rpl_opt_transit_t *transit;
     gnrc_pktsnip_t *opt_snip;
-    if ((opt_snip = gnrc_pktbuf_add(pkt, NULL, sizeof(gnrc_rpl_opt_transit_t),
-                               GNRC_NETTYPE_UNDEF)) == NULL) {
+    size_t size = sizeof(gnrc_rpl_opt_transit_t);
+
+    if (parent != NULL) {
+        size += sizeof(ipv6_addr_t);
+    }
+    if ((opt_snip = gnrc_pktbuf_add(pkt, NULL, size, GNRC_NETTYPE_UNDEF)) == NULL) {
         DEBUG("RPL: Send DAO - no space left in packet buffer\n");
         gnrc_pktbuf_release(pkt);
         return NULL;
@@ -851,6 +899,11 @@ gnrc_pktsnip_t *_dao_transit_build(gnrc_pktsnip_t *pkt, uint8_t lifetime, bool e
     transit->path_control = 0;
     transit->path_sequence = 0;
     transit->path_lifetime = lifetime;
+    if (parent != NULL) {
+        /* the parent address is only included in non-storing mode */
+        transit->length += sizeof(ipv6_addr_t);
+        memcpy(transit + 1, parent, sizeof(ipv6_addr_t));
+    }
     return opt_snip;
 }
 
@@ -875,13 +928,23 @@ void gnrc_rpl_send_DAO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination, uint
     }
 #endif
 
+    bool non_storing = (inst->mop == GNRC_RPL_MOP_NON_STORING_MODE);
+
+    if (non_storing && (destination != NULL)) {
+        /* the root learns the new parent from the next DAO, so there is no
+         * No-Path DAO to the old parent in non-storing mode */
+        return;
+    }
+
     if (destination == NULL) {
         if (dodag->parents == NULL) {
             DEBUG("RPL: dodag has no preferred parent\n");
             return;
         }
 
-        destination = &(dodag->parents->addr);
+        /* in non-storing mode DAOs are sent to the root directly,
+         * see RFC 6550, section 9.7 */
+        destination = (non_storing) ? &dodag->dodag_id : &(dodag->parents->addr);
     }
 
     gnrc_pktsnip_t *pkt = NULL, *tmp = NULL;
@@ -899,14 +962,30 @@ void gnrc_rpl_send_DAO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination, uint
     idx = gnrc_netif_ipv6_addr_match(netif, &dodag->dodag_id);
     me = &netif->ipv6.addrs[idx];
 
+    if (non_storing) {
+        /* each node announces only itself with its preferred parent; the
+         * parent is addressed by its address with the prefix of the DODAG,
+         * since the root builds the source routes from these addresses */
+        ipv6_addr_t parent;
+
+        ipv6_addr_init_prefix(&parent, &dodag->dodag_id, 64);
+        ipv6_addr_init_iid(&parent, &dodag->parents->addr.u8[8], 64);
+        DEBUG("RPL: Send DAO - building transit option with parent %s\n",
+              ipv6_addr_to_str(addr_str, &parent, sizeof(addr_str)));
+        if ((pkt = _dao_transit_build(pkt, lifetime, false, &parent)) == NULL) {
+            DEBUG("RPL: Send DAO - no space left in packet buffer\n");
+            return;
+        }
+    }
+
     /* add external and RPL FT entries */
     /* TODO: nib: dropped support for external transit options for now */
     void *ft_state = NULL;
     gnrc_ipv6_nib_ft_t fte;
-    while(gnrc_ipv6_nib_ft_iter(NULL, dodag->iface, &ft_state, &fte)) {
+    while(!non_storing && gnrc_ipv6_nib_ft_iter(NULL, dodag->iface, &ft_state, &fte)) {
         DEBUG("RPL: Send DAO - building transit option\n");
 
-        if ((pkt = _dao_transit_build(pkt, lifetime, false)) == NULL) {
+        if ((pkt = _dao_transit_build(pkt, lifetime, false, NULL)) == NULL) {
             DEBUG("RPL: Send DAO - no space left in packet buffer\n");
             return;
         }
@@ -38,7 +38,8 @@
 
 static char addr_str[IPV6_ADDR_MAX_STR_LEN];
 
-static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag);
+static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag,
+                                                          gnrc_rpl_parent_t *changed);
 
 static void _rpl_trickle_send_dio(void *args)
 {
@@ -210,6 +211,7 @@ bool gnrc_rpl_parent_add_by_addr(gnrc_rpl_dodag_t *dodag, ipv6_addr_t *addr,
         (*parent)->state = GNRC_RPL_PARENT_ACTIVE;
         (*parent)->addr = *addr;
         (*parent)->rank = GNRC_RPL_INFINITE_RANK;
+        (*parent)->link_metric = 0;
         evtimer_del((evtimer_t *)(&gnrc_rpl_evtimer), (evtimer_event_t *)(&(*parent)->timeout_event));
         ((evtimer_event_t *)(&(*parent)->timeout_event))->next = NULL;
         (*parent)->timeout_event.msg.type = GNRC_RPL_MSG_TYPE_PARENT_TIMEOUT;
@@ -268,8 +270,11 @@ void gnrc_rpl_local_repair(gnrc_rpl_dodag_t *dodag)
 
 void gnrc_rpl_parent_update(gnrc_rpl_dodag_t *dodag, gnrc_rpl_parent_t *parent)
 {
+    gnrc_rpl_parent_t *changed = NULL;
+
     /* update Parent lifetime */
     if ((parent != NULL) && (parent->state != GNRC_RPL_PARENT_UNUSED)) {
+        changed = parent;
         parent->state = GNRC_RPL_PARENT_ACTIVE;
         evtimer_del((evtimer_t *)(&gnrc_rpl_evtimer), (evtimer_event_t *)&parent->timeout_event);
         ((evtimer_event_t *)&(parent->timeout_event))->offset = dodag->default_lifetime * dodag->lifetime_unit * MS_PER_SEC;
@@ -288,23 +293,63 @@ void gnrc_rpl_parent_update(gnrc_rpl_dodag_t *dodag, gnrc_rpl_parent_t *parent)
 #endif
     }
 
-    if (_gnrc_rpl_find_preferred_parent(dodag) == NULL) {
+    if (_gnrc_rpl_find_preferred_parent(dodag, changed) == NULL) {
         gnrc_rpl_local_repair(dodag);
     }
 }
 
 /**
- * @brief   Find the parent with the lowest rank and update the DODAG's preferred parent
+ * @brief   Insert a parent at its position in an ordered list of parents
+ *
+ * The parent set of a DODAG is headed by the preferred parent, the other
+ * parents follow ordered by gnrc_rpl_of_t::parent_cmp. So when only one
+ * parent changed it suffices to insert it again with a single pass over the
+ * list instead of re-sorting the whole set.
+ *
+ * @param[in,out] list      The list of parents, ordered by @p parent_cmp
+ * @param[in] parent        The parent to insert
+ * @param[in] parent_cmp    The parent comparison of the objective function
+ */
+static void _parent_insert(gnrc_rpl_parent_t **list, gnrc_rpl_parent_t *parent,
+                           int (*parent_cmp)(gnrc_rpl_parent_t *, gnrc_rpl_parent_t *))
+{
+    gnrc_rpl_parent_t *prev = NULL, *elt;
+
+    for (elt = *list; elt != NULL; elt = elt->next) {
+        if (parent_cmp(parent, elt) < 0) {
+            break;
+        }
+        prev = elt;
+    }
+
+    if (prev == NULL) {
+        LL_PREPEND(*list, parent);
+    }
+    else {
+        parent->next = prev->next;
+        prev->next = parent;
+    }
+}
+
+/**
+ * @brief   Find the most preferred parent and update the DODAG's preferred parent
+ *
+ * Only the parent that changed is re-evaluated by the objective function, all
+ * other parents keep their position within the ordered parent set.
  *
  * @param[in] dodag     Pointer to the DODAG
+ * @param[in] changed   The parent whose rank or link changed, may be NULL
  *
  * @return  Pointer to the preferred parent, on success.
  * @return  NULL, otherwise.
  */
-static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag)
+static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag,
+                                                          gnrc_rpl_parent_t *changed)
 {
+    gnrc_rpl_of_t *of = dodag->instance->of;
     gnrc_rpl_parent_t *old_best = dodag->parents;
     gnrc_rpl_parent_t *new_best = old_best;
+    gnrc_rpl_parent_t *others;
     uint16_t old_rank = dodag->my_rank;
     gnrc_rpl_parent_t *elt, *tmp;
 
@@ -312,8 +357,30 @@ static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *doda
         return NULL;
     }
 
-    LL_SORT(dodag->parents, dodag->instance->of->parent_cmp);
-    new_best = dodag->parents;
+    /* the preferred parent is not necessarily better than the parents
+     * following it, so keep it apart while the others are ordered */
+    others = old_best->next;
+    old_best->next = NULL;
+    if (changed != NULL) {
+        if (of->update_link_metric != NULL) {
+            of->update_link_metric(changed);
+        }
+        if (changed != old_best) {
+            LL_DELETE(others, changed);
+            _parent_insert(&others, changed, of->parent_cmp);
+        }
+    }
+
+    /* the current preferred parent wins ties to prevent needless flapping,
+     * and the OF decides if switching is worth it (e.g. MRHOF's hysteresis) */
+    if ((others != NULL) && (of->parent_cmp(others, old_best) < 0) &&
+        (of->which_parent(old_best, others) != old_best)) {
+        new_best = others;
+        others = others->next;
+        _parent_insert(&others, old_best, of->parent_cmp);
+    }
+    new_best->next = others;
+    dodag->parents = new_best;
 
     if (new_best->rank == GNRC_RPL_INFINITE_RANK) {
         return NULL;
@@ -339,7 +406,7 @@ static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *doda
 
     }
 
-    dodag->my_rank = dodag->instance->of->calc_rank(dodag->parents, 0);
+    dodag->my_rank = of->calc_rank(dodag->parents, 0);
     if (dodag->my_rank != old_rank) {
         trickle_reset_timer(&dodag->trickle);
     }
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_rpl
+ * @{
+ * @file
+ * @brief       Minimum Rank with Hysteresis Objective Function (MRHOF)
+ *
+ * Implementation of MRHOF using the ETX metric. The ETX of a link is taken
+ * from the statistics of the parent in the neighbor table of the DODAG's
+ * interface (if the `netstats_neighbor` module is used and the entry is
+ * fresh), otherwise from the link-layer statistics of the whole interface (if
+ * the `netstats_l2` module is used). It is cached in
+ * gnrc_rpl_parent_t::link_metric, so rank calculation and parent comparison
+ * never have to query the link layer.
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "mrhof.h"
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/structs.h"
+#if defined(MODULE_NETSTATS_L2) || defined(MODULE_NETSTATS_NEIGHBOR)
+#include "net/gnrc/netif.h"
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+#include "net/gnrc/ipv6/nib/nc.h"
+#include "net/gnrc/netif/internal.h"
+#include "net/netstats/neighbor.h"
+#endif
+
+static uint16_t calc_rank(gnrc_rpl_parent_t *, uint16_t);
+static gnrc_rpl_parent_t *which_parent(gnrc_rpl_parent_t *, gnrc_rpl_parent_t *);
+static int parent_cmp(gnrc_rpl_parent_t *, gnrc_rpl_parent_t *);
+static gnrc_rpl_dodag_t *which_dodag(gnrc_rpl_dodag_t *, gnrc_rpl_dodag_t *);
+static void reset(gnrc_rpl_dodag_t *);
+static void update_link_metric(gnrc_rpl_parent_t *);
+
+static gnrc_rpl_of_t gnrc_rpl_mrhof = {
+    GNRC_RPL_MRHOF_OCP,
+    calc_rank,
+    which_parent,
+    parent_cmp,
+    which_dodag,
+    reset,
+    NULL,
+    NULL,
+    NULL,
+    update_link_metric
+};
+
+gnrc_rpl_of_t *gnrc_rpl_get_of_mrhof(void)
+{
+    return &gnrc_rpl_mrhof;
+}
+
+void reset(gnrc_rpl_dodag_t *dodag)
+{
+    /* Nothing to do in MRHOF, link metrics are kept per parent */
+    (void) dodag;
+}
+
+static uint16_t _link_metric(gnrc_rpl_parent_t *parent)
+{
+    return (parent->link_metric == 0) ? GNRC_RPL_MRHOF_DEFAULT_ETX : parent->link_metric;
+}
+
+static uint32_t _path_cost(gnrc_rpl_parent_t *parent)
+{
+    uint16_t link_metric = _link_metric(parent);
+
+    if ((parent->rank == GNRC_RPL_INFINITE_RANK) ||
+        (link_metric > GNRC_RPL_MRHOF_MAX_LINK_METRIC)) {
+        return GNRC_RPL_INFINITE_RANK;
+    }
+
+    uint32_t cost = (uint32_t)parent->rank + link_metric;
+
+    return (cost > GNRC_RPL_MRHOF_MAX_PATH_COST) ? GNRC_RPL_INFINITE_RANK : cost;
+}
+
+uint16_t calc_rank(gnrc_rpl_parent_t *parent, uint16_t base_rank)
+{
+    uint16_t add;
+
+    if (base_rank == 0) {
+        if (parent == NULL) {
+            return GNRC_RPL_INFINITE_RANK;
+        }
+
+        base_rank = parent->rank;
+    }
+
+    if (parent != NULL) {
+        if (_path_cost(parent) == GNRC_RPL_INFINITE_RANK) {
+            return GNRC_RPL_INFINITE_RANK;
+        }
+        add = parent->dodag->instance->min_hop_rank_inc;
+        if (_link_metric(parent) > add) {
+            add = _link_metric(parent);
+        }
+    }
+    else {
+        add = GNRC_RPL_DEFAULT_MIN_HOP_RANK_INCREASE;
+    }
+
+    if ((base_rank + add) < base_rank) {
+        return GNRC_RPL_INFINITE_RANK;
+    }
+
+    return base_rank + add;
+}
+
+/* p1 is kept unless p2 is better by more than the switch threshold */
+gnrc_rpl_parent_t *which_parent(gnrc_rpl_parent_t *p1, gnrc_rpl_parent_t *p2)
+{
+    uint32_t cost1 = _path_cost(p1);
+    uint32_t cost2 = _path_cost(p2);
+
+    if ((cost2 + GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD) < cost1) {
+        return p2;
+    }
+    return p1;
+}
+
+int parent_cmp(gnrc_rpl_parent_t *parent1, gnrc_rpl_parent_t *parent2)
+{
+    uint32_t cost1 = _path_cost(parent1);
+    uint32_t cost2 = _path_cost(parent2);
+
+    if (cost1 < cost2) {
+        return -1;
+    }
+    else if (cost1 > cost2) {
+        return 1;
+    }
+    return 0;
+}
+
+/* Not used yet */
+gnrc_rpl_dodag_t *which_dodag(gnrc_rpl_dodag_t *d1, gnrc_rpl_dodag_t *d2)
+{
+    (void) d2;
+    return d1;
+}
+
+#ifdef MODULE_NETSTATS_NEIGHBOR
+/* returns the ETX of the link to parent or 0 if it is not known well enough */
+static uint32_t _neighbor_etx(gnrc_netif_t *netif, gnrc_rpl_parent_t *parent)
+{
+    uint8_t l2addr[GNRC_IPV6_NIB_L2ADDR_MAX_LEN];
+    int l2addr_len = -ENOENT;
+    gnrc_ipv6_nib_nc_t nce;
+    void *state = NULL;
+    netstats_nb_t *stats;
+
+    while (gnrc_ipv6_nib_nc_iter(netif->pid, &state, &nce)) {
+        if (ipv6_addr_equal(&nce.ipv6, &parent->addr) &&
+            (nce.l2addr_len > 0)) {
+            memcpy(l2addr, nce.l2addr, nce.l2addr_len);
+            l2addr_len = nce.l2addr_len;
+            break;
+        }
+    }
+    if (l2addr_len < 0) {
+        /* parents are usually addressed by their link-local address */
+        l2addr_len = gnrc_netif_ipv6_iid_to_addr(netif,
+                                                 (eui64_t *)&parent->addr.u64[1],
+                                                 l2addr);
+    }
+    if (l2addr_len <= 0) {
+        return 0;
+    }
+    stats = netstats_nb_get(netif->nb_stats, l2addr, l2addr_len);
+    if ((stats == NULL) || !netstats_nb_isfresh(stats)) {
+        return 0;
+    }
+    return ((uint32_t)stats->etx * GNRC_RPL_MRHOF_ETX_DIVISOR) /
+           NETSTATS_NB_ETX_DIVISOR;
+}
+#endif
+
+void update_link_metric(gnrc_rpl_parent_t *parent)
+{
+    uint32_t etx = GNRC_RPL_MRHOF_DEFAULT_ETX;
+
+#if defined(MODULE_NETSTATS_L2) || defined(MODULE_NETSTATS_NEIGHBOR)
+    gnrc_netif_t *netif = gnrc_netif_get_by_pid(parent->dodag->iface);
+#endif
+
+#ifdef MODULE_NETSTATS_NEIGHBOR
+    if (netif != NULL) {
+        uint32_t nb_etx = _neighbor_etx(netif, parent);
+
+        if (nb_etx > 0) {
+            /* already a moving average of the link to this parent */
+            parent->link_metric = (nb_etx > UINT16_MAX) ? UINT16_MAX : nb_etx;
+            return;
+        }
+    }
+#endif
+
+#ifdef MODULE_NETSTATS_L2
+    if ((netif != NULL) && (netif->dev->stats.tx_success > 0)) {
+        netstats_t *stats = &netif->dev->stats;
+
+        /* transmissions per successful transmission on this interface */
+        etx = GNRC_RPL_MRHOF_ETX_DIVISOR +
+              (uint32_t)(((uint64_t)stats->tx_failed * GNRC_RPL_MRHOF_ETX_DIVISOR) /
+                         stats->tx_success);
+        if (etx > UINT16_MAX) {
+            etx = UINT16_MAX;
+        }
+    }
+#endif
+
+    if (parent->link_metric == 0) {
+        parent->link_metric = (uint16_t)etx;
+    }
+    else {
+        parent->link_metric = (uint16_t)(((uint32_t)parent->link_metric *
+                                          GNRC_RPL_MRHOF_ETX_ALPHA +
+                                          etx * (8 - GNRC_RPL_MRHOF_ETX_ALPHA)) / 8);
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_rpl
+ * @{
+ * @file
+ * @brief       Minimum Rank with Hysteresis Objective Function (MRHOF)
+ *
+ * Header-file, which defines all functions for the implementation of MRHOF
+ * using the ETX metric.
+ *
+ * @see <a href="https://tools.ietf.org/html/rfc6719">
+ *          RFC6719, The Minimum Rank with Hysteresis Objective Function
+ *      </a>
+ */
+
+#ifndef MRHOF_H
+#define MRHOF_H
+
+#include "net/gnrc/rpl/structs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Objective Code Point of MRHOF
+ */
+#define GNRC_RPL_MRHOF_OCP                  (0x1)
+
+/**
+ * @brief   Fixed point divisor of the ETX metric (an ETX of 1.0 equals 128)
+ *
+ * @see <a href="https://tools.ietf.org/html/rfc6551#section-4.3.2">
+ *          RFC6551, section 4.3.2, Link ETX
+ *      </a>
+ */
+#define GNRC_RPL_MRHOF_ETX_DIVISOR          (128)
+
+/**
+ * @brief   Link ETX assumed when no link-layer statistics are available
+ */
+#ifndef GNRC_RPL_MRHOF_DEFAULT_ETX
+#define GNRC_RPL_MRHOF_DEFAULT_ETX          (2 * GNRC_RPL_MRHOF_ETX_DIVISOR)
+#endif
+
+/**
+ * @brief   Links with a higher ETX are not considered for parent selection
+ */
+#ifndef GNRC_RPL_MRHOF_MAX_LINK_METRIC
+#define GNRC_RPL_MRHOF_MAX_LINK_METRIC      (512)
+#endif
+
+/**
+ * @brief   Paths with a higher cost are not considered for parent selection
+ */
+#ifndef GNRC_RPL_MRHOF_MAX_PATH_COST
+#define GNRC_RPL_MRHOF_MAX_PATH_COST        (32768U)
+#endif
+
+/**
+ * @brief   Path cost difference needed to switch the preferred parent
+ */
+#ifndef GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD
+#define GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD  (192)
+#endif
+
+/**
+ * @brief   Weight (out of 8) of the previous link metric when smoothing
+ *          new ETX samples
+ */
+#ifndef GNRC_RPL_MRHOF_ETX_ALPHA
+#define GNRC_RPL_MRHOF_ETX_ALPHA            (7)
+#endif
+
+/**
+ * @brief   Return the address to the MRHOF objective function
+ *
+ * @return  Address of the MRHOF objective function
+ */
+gnrc_rpl_of_t *gnrc_rpl_get_of_mrhof(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MRHOF_H */
+/**
+ * @}
+ */
@@ -38,6 +38,7 @@ static gnrc_rpl_of_t gnrc_rpl_of0 = {
     reset,
     NULL,
     NULL,
+    NULL,
     NULL
 };
 
@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief   Source route table of a non-storing mode DODAG root
+ *
+ * The table stores one entry per node with the index of its parent, i.e. the
+ * DODAG is kept as a parent-pointer tree. Nodes are found by address via a
+ * chained hash table, so building the source route to a node only walks the
+ * path from the node up to the root.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "net/ipv6/ext/rh.h"
+#include "net/gnrc/rpl/srh.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#if (GNRC_RPL_SRH_TABLE_BUCKETS & (GNRC_RPL_SRH_TABLE_BUCKETS - 1))
+#error "GNRC_RPL_SRH_TABLE_BUCKETS must be a power of 2"
+#endif
+
+#define _IDX_NONE           (UINT16_MAX)        /**< end of list/unknown parent */
+#define _IDX_ROOT           (UINT16_MAX - 1)    /**< parent is the root */
+
+/* maximum number of prefix octets that can be elided */
+#define _COMPR_MAX          (15U)
+
+typedef struct {
+    ipv6_addr_t addr;       /**< address of the node */
+    uint16_t parent;        /**< index of the parent */
+    uint16_t next;          /**< next entry in hash bucket or free list */
+} _node_t;
+
+#if GNRC_RPL_SRH_CACHE_SIZE
+typedef struct {
+    uint32_t gen;           /**< table generation the entry was built for */
+    uint16_t idx;           /**< index of the destination */
+    uint16_t first_hop;     /**< index of the first hop */
+    uint8_t len;            /**< length of hdr */
+    uint8_t hdr[GNRC_RPL_SRH_CACHE_HDR_LEN];    /**< built header */
+} _cache_entry_t;
+
+static _cache_entry_t _cache[GNRC_RPL_SRH_CACHE_SIZE];
+#endif
+
+static _node_t _nodes[GNRC_RPL_SRH_TABLE_SIZE];
+static uint16_t _buckets[GNRC_RPL_SRH_TABLE_BUCKETS];
+static uint16_t _free;
+/* incremented on every change of the tree, invalidates the cache */
+static uint32_t _gen;
+static bool _initialized;
+static mutex_t _mutex = MUTEX_INIT;
+
+static void _init(void)
+{
+    for (unsigned i = 0; i < GNRC_RPL_SRH_TABLE_BUCKETS; i++) {
+        _buckets[i] = _IDX_NONE;
+    }
+    for (unsigned i = 0; i < GNRC_RPL_SRH_TABLE_SIZE; i++) {
+        _nodes[i].next = (i + 1 < GNRC_RPL_SRH_TABLE_SIZE) ? (i + 1) : _IDX_NONE;
+    }
+    _free = 0;
+    _gen++;
+    _initialized = true;
+}
+
+static inline unsigned _hash(const ipv6_addr_t *addr)
+{
+    /* the IIDs of the nodes in a DODAG are what tells them apart */
+    uint32_t h = addr->u32[2].u32 ^ addr->u32[3].u32;
+
+    h ^= h >> 16;
+    h ^= h >> 8;
+    return h & (GNRC_RPL_SRH_TABLE_BUCKETS - 1);
+}
+
+static uint16_t _find(const ipv6_addr_t *addr)
+{
+    uint16_t idx = _buckets[_hash(addr)];
+
+    while ((idx != _IDX_NONE) && !ipv6_addr_equal(&_nodes[idx].addr, addr)) {
+        idx = _nodes[idx].next;
+    }
+    return idx;
+}
+
+static uint16_t _find_or_add(const ipv6_addr_t *addr)
+{
+    uint16_t idx = _find(addr);
+
+    if ((idx == _IDX_NONE) && (_free != _IDX_NONE)) {
+        unsigned bucket = _hash(addr);
+
+        idx = _free;
+        _free = _nodes[idx].next;
+        _nodes[idx].addr = *addr;
+        _nodes[idx].parent = _IDX_NONE;
+        _nodes[idx].next = _buckets[bucket];
+        _buckets[bucket] = idx;
+    }
+    return idx;
+}
+
+int gnrc_rpl_srh_table_add(const ipv6_addr_t *addr, const ipv6_addr_t *parent)
+{
+    uint16_t idx, parent_idx = _IDX_ROOT;
+    int res = 0;
+
+    assert(addr != NULL);
+    mutex_lock(&_mutex);
+    if (!_initialized) {
+        _init();
+    }
+    if ((parent != NULL) && ((parent_idx = _find_or_add(parent)) == _IDX_NONE)) {
+        res = -ENOMEM;
+    }
+    else if ((idx = _find_or_add(addr)) == _IDX_NONE) {
+        res = -ENOMEM;
+    }
+    else if (_nodes[idx].parent != parent_idx) {
+        _nodes[idx].parent = parent_idx;
+        _gen++;
+    }
+    mutex_unlock(&_mutex);
+    return res;
+}
+
+int gnrc_rpl_srh_table_del(const ipv6_addr_t *addr)
+{
+    uint16_t *ptr, idx;
+    int res = -ENOENT;
+
+    mutex_lock(&_mutex);
+    if (!_initialized) {
+        mutex_unlock(&_mutex);
+        return res;
+    }
+    ptr = &_buckets[_hash(addr)];
+    while ((idx = *ptr) != _IDX_NONE) {
+        if (ipv6_addr_equal(&_nodes[idx].addr, addr)) {
+            /* unlink from bucket and put on the free list */
+            *ptr = _nodes[idx].next;
+            _nodes[idx].next = _free;
+            _free = idx;
+            /* detach children, they need to announce a new parent */
+            for (unsigned i = 0; i < GNRC_RPL_SRH_TABLE_SIZE; i++) {
+                if (_nodes[i].parent == idx) {
+                    _nodes[i].parent = _IDX_NONE;
+                }
+            }
+            _nodes[idx].parent = _IDX_NONE;
+            _gen++;
+            res = 0;
+            break;
+        }
+        ptr = &_nodes[idx].next;
+    }
+    mutex_unlock(&_mutex);
+    return res;
+}
+
+void gnrc_rpl_srh_table_flush(void)
+{
+    mutex_lock(&_mutex);
+    _init();
+    mutex_unlock(&_mutex);
+}
+
+static unsigned _common_prefix(const ipv6_addr_t *a, const ipv6_addr_t *b)
+{
+    unsigned i = 0;
+
+    while ((i < _COMPR_MAX) && (a->u8[i] == b->u8[i])) {
+        i++;
+    }
+    return i;
+}
+
+static int _build(uint16_t idx, uint16_t *first_hop, gnrc_rpl_srh_t *srh,
+                  size_t srh_len)
+{
+    uint16_t hops[GNRC_RPL_SRH_MAX_HOPS];
+    unsigned num = 0, compri = _COMPR_MAX, compre, size, pad;
+    const ipv6_addr_t *hop_addr;
+    uint8_t *vec;
+
+    /* walk up to the root, hops[0] is the destination */
+    while (idx != _IDX_ROOT) {
+        if (idx == _IDX_NONE) {
+            return -ENOENT;
+        }
+        if (num == GNRC_RPL_SRH_MAX_HOPS) {
+            return -ELOOP;
+        }
+        hops[num++] = idx;
+        idx = _nodes[idx].parent;
+    }
+    *first_hop = hops[num - 1];
+    if (num == 1) {
+        /* direct child of the root */
+        return 0;
+    }
+    hop_addr = &_nodes[*first_hop].addr;
+    /* intermediate addresses: hops[num - 2] ... hops[1] */
+    for (unsigned i = 1; i < (num - 1); i++) {
+        unsigned prefix = _common_prefix(hop_addr, &_nodes[hops[i]].addr);
+
+        if (prefix < compri) {
+            compri = prefix;
+        }
+    }
+    /* the last hop restores the prefix of the destination from its own
+     * address (RFC 6554, section 3) */
+    compre = _common_prefix(&_nodes[hops[1]].addr, &_nodes[hops[0]].addr);
+    if (num == 2) {
+        /* only the destination in the address vector */
+        compri = compre;
+    }
+    size = ((num - 2) * (sizeof(ipv6_addr_t) - compri)) +
+           (sizeof(ipv6_addr_t) - compre);
+    pad = (8 - (size & 0x7)) & 0x7;
+    if (srh == NULL) {
+        return sizeof(gnrc_rpl_srh_t) + size + pad;
+    }
+    if ((sizeof(gnrc_rpl_srh_t) + size + pad) > srh_len) {
+        return -ENOBUFS;
+    }
+
+    srh->len = (size + pad) / 8;
+    srh->type = IPV6_EXT_RH_TYPE_RPL_SRH;
+    srh->seg_left = num - 1;
+    srh->compr = (compri << 4) | compre;
+    srh->pad_resv = pad << 4;
+    srh->resv = 0;
+    vec = (uint8_t *)(srh + 1);
+    for (unsigned i = num - 1; i > 1; i--) {
+        memcpy(vec, &_nodes[hops[i - 1]].addr.u8[compri],
+               sizeof(ipv6_addr_t) - compri);
+        vec += sizeof(ipv6_addr_t) - compri;
+    }
+    memcpy(vec, &_nodes[hops[0]].addr.u8[compre], sizeof(ipv6_addr_t) - compre);
+    memset(vec + sizeof(ipv6_addr_t) - compre, 0, pad);
+    return sizeof(gnrc_rpl_srh_t) + size + pad;
+}
+
+int gnrc_rpl_srh_build(const ipv6_addr_t *dst, ipv6_addr_t *first_hop,
+                       gnrc_rpl_srh_t *srh, size_t srh_len)
+{
+    uint16_t idx, first_hop_idx;
+    int res;
+
+    assert((dst != NULL) && (first_hop != NULL));
+    mutex_lock(&_mutex);
+    if (!_initialized || ((idx = _find(dst)) == _IDX_NONE)) {
+        mutex_unlock(&_mutex);
+        return -ENOENT;
+    }
+#if GNRC_RPL_SRH_CACHE_SIZE
+    _cache_entry_t *entry = &_cache[idx % GNRC_RPL_SRH_CACHE_SIZE];
+
+    if ((entry->gen == _gen) && (entry->idx == idx)) {
+        DEBUG("RPL SRH: route cache hit\n");
+        res = entry->len;
+        *first_hop = _nodes[entry->first_hop].addr;
+        if (srh != NULL) {
+            if (entry->len > srh_len) {
+                res = -ENOBUFS;
+            }
+            else {
+                memcpy(srh, entry->hdr, entry->len);
+            }
+        }
+        mutex_unlock(&_mutex);
+        return res;
+    }
+#endif
+    res = _build(idx, &first_hop_idx, srh, srh_len);
+    if (res >= 0) {
+        *first_hop = _nodes[first_hop_idx].addr;
+#if GNRC_RPL_SRH_CACHE_SIZE
+        if ((srh != NULL) && (res <= (int)sizeof(entry->hdr))) {
+            entry->gen = _gen;
+            entry->idx = idx;
+            entry->first_hop = first_hop_idx;
+            entry->len = res;
+            memcpy(entry->hdr, srh, res);
+        }
+#endif
+    }
+    mutex_unlock(&_mutex);
+    return res;
+}
+
+/** @} */
@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "irq.h"
+#include "kernel_defines.h"
+#include "msg.h"
+#include "mutex.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/udp.h"
+#include "net/gnrc/udp_mux.h"
+#include "net/protnum.h"
+#include "net/udp.h"
+#include "thread_flags.h"
+
+#include "gnrc_sock_internal.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+static char _stack[GNRC_UDP_MUX_STACK_SIZE];
+static msg_t _msg_queue[GNRC_UDP_MUX_MSG_QUEUE_SIZE];
+static kernel_pid_t _pid = KERNEL_PID_UNDEF;
+static event_queue_t _queue;
+
+/* registered endpoints, looked up by the multiplexer thread */
+static gnrc_udp_mux_ep_t *_eps;
+static mutex_t _lock = MUTEX_INIT;
+static uint16_t _dyn_port_next;
+
+static gnrc_udp_mux_ep_t *_find(uint16_t port)
+{
+    for (gnrc_udp_mux_ep_t *ep = _eps; ep; ep = ep->next) {
+        if (gnrc_udp_mux_port(ep) == port) {
+            return ep;
+        }
+    }
+    return NULL;
+}
+
+static gnrc_pktsnip_t *_pop(gnrc_udp_mux_ep_t *ep)
+{
+    gnrc_pktsnip_t *pkt = NULL;
+    unsigned state = irq_disable();
+    int n = cib_get(&ep->cib);
+
+    if (n >= 0) {
+        pkt = ep->pkts[n];
+    }
+    irq_restore(state);
+    return pkt;
+}
+
+static void _receive(gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *udp = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_UDP);
+    gnrc_udp_mux_ep_t *ep;
+
+    if (udp == NULL) {
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    mutex_lock(&_lock);
+    ep = _find(byteorder_ntohs(((udp_hdr_t *)udp->data)->dst_port));
+    if (ep != NULL) {
+        unsigned state = irq_disable();
+        int n = cib_put(&ep->cib);
+
+        if (n >= 0) {
+            ep->pkts[n] = pkt;
+            pkt = NULL;
+        }
+        else {
+            ep->dropped++;
+        }
+        irq_restore(state);
+        if (pkt == NULL) {
+            event_post(ep->queue, &ep->event);
+        }
+    }
+    mutex_unlock(&_lock);
+    if (pkt != NULL) {
+        DEBUG("udp_mux: dropped packet\n");
+        gnrc_pktbuf_release(pkt);
+    }
+}
+
+/* runs on the event queue of the endpoint */
+static void _on_event(event_t *event)
+{
+    gnrc_udp_mux_ep_t *ep = container_of(event, gnrc_udp_mux_ep_t, event);
+    gnrc_pktsnip_t *pkt;
+
+    while ((pkt = _pop(ep)) != NULL) {
+        gnrc_pktsnip_t *udp = gnrc_pktsnip_search_type(pkt,
+                                                       GNRC_NETTYPE_UDP);
+        gnrc_pktsnip_t *netif = gnrc_pktsnip_search_type(pkt,
+                                                         GNRC_NETTYPE_NETIF);
+        ipv6_hdr_t *ipv6_hdr = gnrc_ipv6_get_header(pkt);
+        gnrc_pktsnip_t *tmp;
+        sock_udp_ep_t remote;
+
+        assert((udp != NULL) && (ipv6_hdr != NULL));
+        memcpy(&remote.addr, &ipv6_hdr->src, sizeof(ipv6_addr_t));
+        remote.family = AF_INET6;
+        remote.port = byteorder_ntohs(((udp_hdr_t *)udp->data)->src_port);
+        if (netif == NULL) {
+            remote.netif = SOCK_ADDR_ANY_NETIF;
+        }
+        else {
+            gnrc_netif_hdr_t *netif_hdr = netif->data;
+            remote.netif = (uint16_t)netif_hdr->if_pid;
+        }
+        /* the handler may write to the payload */
+        tmp = gnrc_pktbuf_start_write(pkt);
+        if (tmp == NULL) {
+            DEBUG("udp_mux: no space to write to packet\n");
+            gnrc_pktbuf_release(pkt);
+            continue;
+        }
+        pkt = tmp;
+        ep->handler(ep, pkt->data, pkt->size, &remote);
+        gnrc_pktbuf_release(pkt);
+    }
+}
+
+static void *_thread(void *arg)
+{
+    (void)arg;
+    msg_init_queue(_msg_queue, GNRC_UDP_MUX_MSG_QUEUE_SIZE);
+
+    while (1) {
+        thread_flags_t flags = thread_flags_wait_any(THREAD_FLAG_EVENT |
+                                                     THREAD_FLAG_MSG_WAITING);
+        msg_t msg;
+        event_t *event;
+
+        if (flags & THREAD_FLAG_MSG_WAITING) {
+            while (msg_try_receive(&msg) == 1) {
+                switch (msg.type) {
+                    case GNRC_NETAPI_MSG_TYPE_RCV:
+                        _receive(msg.content.ptr);
+                        break;
+                    case GNRC_NETAPI_MSG_TYPE_SND:
+                        gnrc_pktbuf_release(msg.content.ptr);
+                        break;
+                    default:
+                        DEBUG("udp_mux: unexpected message type 0x%04x\n",
+                              msg.type);
+                        break;
+                }
+            }
+        }
+        if (flags & THREAD_FLAG_EVENT) {
+            while ((event = event_get(&_queue)) != NULL) {
+                event->handler(event);
+            }
+        }
+    }
+    return NULL;
+}
+
+kernel_pid_t gnrc_udp_mux_init(void)
+{
+    if (_pid == KERNEL_PID_UNDEF) {
+        /* the queue must have its waiter before the thread runs */
+        _pid = thread_create(_stack, sizeof(_stack), GNRC_UDP_MUX_PRIO,
+                             THREAD_CREATE_STACKTEST |
+                             THREAD_CREATE_WOUT_YIELD, _thread, NULL,
+                             "udp_mux");
+        assert(_pid > KERNEL_PID_UNDEF);
+        _queue.waiter = (thread_t *)thread_get(_pid);
+    }
+    return _pid;
+}
+
+event_queue_t *gnrc_udp_mux_queue(void)
+{
+    assert(_pid != KERNEL_PID_UNDEF);
+    return &_queue;
+}
+
+/* as gnrc_sock_udp, complies to RFC 6056 section 3.3.3 */
+static uint16_t _dyn_port(void)
+{
+    for (unsigned count = 0; count < GNRC_SOCK_DYN_PORTRANGE_NUM; count++) {
+        uint16_t port = GNRC_SOCK_DYN_PORTRANGE_MIN +
+                        (_dyn_port_next * GNRC_SOCK_DYN_PORTRANGE_OFF) %
+                        GNRC_SOCK_DYN_PORTRANGE_NUM;
+
+        _dyn_port_next++;
+        if (gnrc_netreg_num(GNRC_NETTYPE_UDP, port) == 0) {
+            return port;
+        }
+    }
+    return GNRC_SOCK_DYN_PORTRANGE_ERR;
+}
+
+int gnrc_udp_mux_add(gnrc_udp_mux_ep_t *ep, uint16_t port,
+                     event_queue_t *queue, gnrc_udp_mux_handler_t handler,
+                     void *arg)
+{
+    assert((ep != NULL) && (queue != NULL) && (handler != NULL));
+    assert(_pid != KERNEL_PID_UNDEF);
+
+    mutex_lock(&_lock);
+    if (port == 0) {
+        port = _dyn_port();
+    }
+    if ((port == GNRC_SOCK_DYN_PORTRANGE_ERR) ||
+        (gnrc_netreg_num(GNRC_NETTYPE_UDP, port) > 0)) {
+        mutex_unlock(&_lock);
+        return -EADDRINUSE;
+    }
+    memset(ep, 0, sizeof(*ep));
+    ep->event.handler = _on_event;
+    ep->queue = queue;
+    ep->handler = handler;
+    ep->arg = arg;
+    cib_init(&ep->cib, GNRC_UDP_MUX_EP_QUEUE_SIZE);
+    gnrc_netreg_entry_init_pid(&ep->reg, port, _pid);
+    ep->next = _eps;
+    _eps = ep;
+    gnrc_netreg_register(GNRC_NETTYPE_UDP, &ep->reg);
+    mutex_unlock(&_lock);
+    return 0;
+}
+
+void gnrc_udp_mux_remove(gnrc_udp_mux_ep_t *ep)
+{
+    gnrc_pktsnip_t *pkt;
+
+    mutex_lock(&_lock);
+    gnrc_netreg_unregister(GNRC_NETTYPE_UDP, &ep->reg);
+    for (gnrc_udp_mux_ep_t **prev = &_eps; *prev; prev = &(*prev)->next) {
+        if (*prev == ep) {
+            *prev = ep->next;
+            break;
+        }
+    }
+    mutex_unlock(&_lock);
+    event_cancel(ep->queue, &ep->event);
+    while ((pkt = _pop(ep)) != NULL) {
+        gnrc_pktbuf_release(pkt);
+    }
+}
+
+ssize_t gnrc_udp_mux_send(const gnrc_udp_mux_ep_t *ep, const void *data,
+                          size_t len, const sock_udp_ep_t *remote)
+{
+    gnrc_pktsnip_t *payload, *pkt;
+    sock_ip_ep_t local, rem;
+    ssize_t res;
+
+    assert((ep != NULL) && (remote != NULL));
+    assert((data != NULL) || (len == 0));
+    if ((remote->port == 0) || gnrc_ep_addr_any((const sock_ip_ep_t *)remote)) {
+        return -EINVAL;
+    }
+    if (gnrc_af_not_supported(remote->family)) {
+        return -EAFNOSUPPORT;
+    }
+    memset(&local, 0, sizeof(local));
+    local.family = remote->family;
+    gnrc_ep_set(&rem, (const sock_ip_ep_t *)remote, sizeof(rem));
+    payload = gnrc_pktbuf_add(NULL, (void *)data, len, GNRC_NETTYPE_UNDEF);
+    if (payload == NULL) {
+        return -ENOMEM;
+    }
+    pkt = gnrc_udp_hdr_build(payload, gnrc_udp_mux_port(ep), remote->port);
+    if (pkt == NULL) {
+        gnrc_pktbuf_release(payload);
+        return -ENOMEM;
+    }
+    res = gnrc_sock_send(pkt, &local, &rem, PROTNUM_UDP);
+    if (res > 0) {
+        res -= sizeof(udp_hdr_t);
+    }
+    return res;
+}
+
+/** @} */
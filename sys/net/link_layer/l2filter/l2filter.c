@@ -21,18 +21,66 @@
 #include <string.h>
 
 #include "assert.h"
+#include "hashes.h"
 #include "net/l2filter.h"
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
-static inline bool match(const l2filter_t *filter,
+/* The list is an open addressing hash table using Robin Hood hashing: an
+ * entry is stored at the first free slot after its home slot, but takes over
+ * the slot of any entry closer to its own home slot on the way. This keeps
+ * the probe sequences short and lets lookups of addresses not in the list
+ * stop at the first entry closer to its home than the address would be. */
+
+static inline uint16_t hash(const void *addr, size_t addr_len)
+{
+    uint32_t h = one_at_a_time_hash(addr, addr_len);
+
+    return (uint16_t)(h ^ (h >> 16));
+}
+
+static inline unsigned home(uint16_t h)
+{
+    return h % L2FILTER_LISTSIZE;
+}
+
+static inline unsigned next(unsigned i)
+{
+    return (i + 1 < L2FILTER_LISTSIZE) ? (i + 1) : 0;
+}
+
+/* number of slots entry at i is away from its home slot */
+static inline unsigned dist(const l2filter_t *list, unsigned i)
+{
+    return (i + L2FILTER_LISTSIZE - home(list[i].hash)) % L2FILTER_LISTSIZE;
+}
+
+static inline bool match(const l2filter_t *filter, uint16_t h,
                          const void *addr, size_t addr_len)
 {
-    return ((filter->addr_len == addr_len) &&
+    /* the stored hash rejects almost all other entries without memcmp */
+    return ((filter->hash == h) && (filter->addr_len == addr_len) &&
             (memcmp(filter->addr, addr, addr_len) == 0));
 }
 
+static int find(const l2filter_t *list, uint16_t h,
+                const void *addr, size_t addr_len)
+{
+    unsigned i = home(h);
+
+    for (unsigned d = 0; d < L2FILTER_LISTSIZE; d++, i = next(i)) {
+        if ((list[i].addr_len == 0) || (dist(list, i) < d)) {
+            /* the address would have been stored here */
+            break;
+        }
+        if (match(&list[i], h, addr, addr_len)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 void l2filter_init(l2filter_t *list)
 {
     assert(list);
@@ -46,62 +94,87 @@ int l2filter_add(l2filter_t *list, const void *addr, size_t addr_len)
 {
     assert(list && addr && (addr_len <= L2FILTER_ADDR_MAXLEN));
 
-    int res = -ENOMEM;
+    l2filter_t entry;
+    uint16_t h = hash(addr, addr_len);
+    unsigned i = home(h), empty = i;
+    unsigned d;
 
-    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
-        if (list[i].addr_len == 0) {
-            list[i].addr_len = addr_len;
-            memcpy(list[i].addr, addr, addr_len);
-            res = 0;
+    if (find(list, h, addr, addr_len) >= 0) {
+        return 0;
+    }
+    /* entries are only moved up to the next free slot */
+    for (d = 0; d < L2FILTER_LISTSIZE; d++, empty = next(empty)) {
+        if (list[empty].addr_len == 0) {
             break;
         }
     }
+    if (d == L2FILTER_LISTSIZE) {
+        return -ENOMEM;
+    }
 
-    return res;
+    memcpy(entry.addr, addr, addr_len);
+    entry.addr_len = addr_len;
+    entry.hash = h;
+    for (d = 0; i != empty; d++, i = next(i)) {
+        unsigned cur = dist(list, i);
+
+        if (cur < d) {
+            /* take over the slot and continue with the displaced entry */
+            l2filter_t tmp = list[i];
+
+            list[i] = entry;
+            entry = tmp;
+            d = cur;
+        }
+    }
+    list[empty] = entry;
+
+    return 0;
 }
 
 int l2filter_rm(l2filter_t *list, const void *addr, size_t addr_len)
 {
     assert(list && addr && (addr_len <= L2FILTER_ADDR_MAXLEN));
 
-    int res = -ENOENT;
+    int pos = find(list, hash(addr, addr_len), addr, addr_len);
+    unsigned i;
 
-    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
-        if (match(&list[i], addr, addr_len)) {
-            list[i].addr_len = 0;
-            res = 0;
-            break;
-        }
+    if (pos < 0) {
+        return -ENOENT;
     }
+    /* shift the following entries back towards their home slot, so no
+     * probe sequence is interrupted by the removed entry */
+    i = pos;
+    for (unsigned j = next(i); (list[j].addr_len != 0) && (dist(list, j) > 0);
+         i = j, j = next(j)) {
+        list[i] = list[j];
+    }
+    list[i].addr_len = 0;
 
-    return res;
+    return 0;
 }
 
 bool l2filter_pass(const l2filter_t *list, const void *addr, size_t addr_len)
 {
     assert(list && addr && (addr_len <= L2FILTER_ADDR_MAXLEN));
 
+    bool found = (find(list, hash(addr, addr_len), addr, addr_len) >= 0);
+
 #ifdef MODULE_L2FILTER_WHITELIST
-    bool res = false;
-    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
-        if (match(&list[i], addr, addr_len)) {
-            DEBUG("[l2filter] whitelist: address match -> packet passes\n");
-            res = true;
-            break;
-        }
+    if (found) {
+        DEBUG("[l2filter] whitelist: address match -> packet passes\n");
+    }
+    else {
+        DEBUG("[l2filter] whitelist: no match -> packet dropped\n");
     }
-    DEBUG("[l2filter] whitelist: no match -> packet dropped\n");
+    return found;
 #else
-    bool res = true;
-    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
-        if (match(&list[i], addr, addr_len)) {
-            DEBUG("[l2filter] blacklist: address match -> packet dropped\n");
-            res = false;
-            break;
-        }
+    if (found) {
+        DEBUG("[l2filter] blacklist: address match -> packet dropped\n");
     }
-    DEBUG("[l2fitler] blacklist: no match -> packet passes\n");
+    else {
+        DEBUG("[l2fitler] blacklist: no match -> packet passes\n");
+    }
+    return !found;
 #endif
-
-    return res;
 }
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <string.h>
+
+#include "net/netstats/neighbor.h"
+#include "timex.h"
+#include "xtimer.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+static uint32_t _now_sec(void)
+{
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC);
+}
+
+static int32_t _ewma(int32_t old, int32_t sample, int32_t alpha)
+{
+    return ((old * alpha) + (sample * (100 - alpha))) / 100;
+}
+
+void netstats_nb_init(netstats_nb_t *table)
+{
+    memset(table, 0, NETSTATS_NB_SIZE * sizeof(netstats_nb_t));
+}
+
+netstats_nb_t *netstats_nb_get(netstats_nb_t *table, const uint8_t *l2_addr,
+                               uint8_t len)
+{
+    for (unsigned i = 0; i < NETSTATS_NB_SIZE; i++) {
+        if ((table[i].l2_addr_len == len) &&
+            (memcmp(table[i].l2_addr, l2_addr, len) == 0)) {
+            return &table[i];
+        }
+    }
+    return NULL;
+}
+
+static netstats_nb_t *_get_or_add(netstats_nb_t *table,
+                                  const uint8_t *l2_addr, uint8_t len)
+{
+    netstats_nb_t *entry, *oldest = NULL;
+    uint32_t now;
+
+    if ((len == 0) || (len > NETSTATS_NB_L2ADDR_MAXLEN)) {
+        return NULL;
+    }
+    if ((entry = netstats_nb_get(table, l2_addr, len)) != NULL) {
+        return entry;
+    }
+    now = _now_sec();
+    for (unsigned i = 0; i < NETSTATS_NB_SIZE; i++) {
+        if (table[i].l2_addr_len == 0) {
+            oldest = &table[i];
+            break;
+        }
+        if ((oldest == NULL) ||
+            ((now - table[i].last_updated) > (now - oldest->last_updated))) {
+            oldest = &table[i];
+        }
+    }
+    DEBUG("netstats_nb: new neighbor in slot %u\n",
+          (unsigned)(oldest - table));
+    memset(oldest, 0, sizeof(*oldest));
+    memcpy(oldest->l2_addr, l2_addr, len);
+    oldest->l2_addr_len = len;
+    return oldest;
+}
+
+netstats_nb_t *netstats_nb_update_rx(netstats_nb_t *table,
+                                     const uint8_t *l2_addr, uint8_t len,
+                                     int16_t rssi, uint8_t lqi)
+{
+    netstats_nb_t *entry = _get_or_add(table, l2_addr, len);
+
+    if (entry == NULL) {
+        return NULL;
+    }
+    if (entry->rx_count == 0) {
+        entry->rssi = rssi;
+        entry->lqi = lqi;
+    }
+    else {
+        entry->rssi = _ewma(entry->rssi, rssi, NETSTATS_NB_RX_ALPHA);
+        entry->lqi = _ewma(entry->lqi, lqi, NETSTATS_NB_RX_ALPHA);
+    }
+    if (entry->rx_count < UINT16_MAX) {
+        entry->rx_count++;
+    }
+    entry->last_updated = _now_sec();
+    return entry;
+}
+
+netstats_nb_t *netstats_nb_update_tx(netstats_nb_t *table,
+                                     const uint8_t *l2_addr, uint8_t len,
+                                     netstats_nb_result_t result,
+                                     uint8_t transmissions)
+{
+    netstats_nb_t *entry = _get_or_add(table, l2_addr, len);
+    uint32_t sample;
+
+    if (entry == NULL) {
+        return NULL;
+    }
+    if (result == NETSTATS_NB_SUCCESS) {
+        sample = ((transmissions > 0) ? transmissions : 1) *
+                 NETSTATS_NB_ETX_DIVISOR;
+    }
+    else {
+        sample = NETSTATS_NB_ETX_NOACK_PENALTY * NETSTATS_NB_ETX_DIVISOR;
+        if (entry->tx_failed < UINT16_MAX) {
+            entry->tx_failed++;
+        }
+    }
+    /* the first samples would take long to correct a wrong initial value,
+     * so the estimation converges faster until the entry is fresh */
+    if (entry->freshness == 0) {
+        entry->etx = sample;
+    }
+    else if (entry->freshness < NETSTATS_NB_FRESHNESS_TARGET) {
+        entry->etx = (entry->etx + sample) / 2;
+    }
+    else {
+        entry->etx = _ewma(entry->etx, sample, NETSTATS_NB_ETX_ALPHA);
+    }
+    if (entry->freshness < UINT8_MAX) {
+        entry->freshness++;
+    }
+    if (entry->tx_count < UINT16_MAX) {
+        entry->tx_count++;
+    }
+    entry->last_updated = _now_sec();
+    return entry;
+}
+
+bool netstats_nb_isfresh(const netstats_nb_t *entry)
+{
+    return (entry->l2_addr_len > 0) &&
+           (entry->freshness >= NETSTATS_NB_FRESHNESS_TARGET) &&
+           ((_now_sec() - entry->last_updated) < NETSTATS_NB_FRESHNESS_EXPIRATION);
+}
+
+/** @} */
@@ -27,9 +27,12 @@
 #include "net/gnrc/netif/hdr.h"
 #include "net/lora.h"
 
-#ifdef MODULE_NETSTATS
+#if defined(MODULE_NETSTATS) || defined(MODULE_GNRC_NETIF_TXQ)
 #include "net/netstats.h"
 #endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+#include "net/netstats/neighbor.h"
+#endif
 #ifdef MODULE_L2FILTER
 #include "net/l2filter.h"
 #endif
@@ -141,6 +144,81 @@ static int _netif_stats(kernel_pid_t iface, unsigned module, bool reset)
 }
 #endif /* MODULE_NETSTATS */
 
+#ifdef MODULE_GNRC_NETIF_TXQ
+static int _netif_txq_stats(kernel_pid_t iface, bool reset)
+{
+    netstats_txq_t *stats;
+    int res = gnrc_netapi_get(iface, NETOPT_STATS, NETSTATS_TXQ, &stats,
+                              sizeof(&stats));
+
+    if (res < 0) {
+        return res;
+    }
+    if (reset) {
+        /* keep the current depth, it is still valid */
+        uint16_t depth = stats->depth;
+
+        memset(stats, 0, sizeof(netstats_txq_t));
+        stats->depth = depth;
+        puts("Reset statistics for module TX queue!");
+    }
+    else {
+        printf("          Statistics for TX queue\n"
+               "            queued %u  overflows %u  retries %u\n"
+               "            depth %u (max: %u)  latency avg %uus max %uus\n",
+               (unsigned) stats->enqueued,
+               (unsigned) stats->overflows,
+               (unsigned) stats->retries,
+               (unsigned) stats->depth,
+               (unsigned) stats->depth_max,
+               (unsigned) stats->latency_avg,
+               (unsigned) stats->latency_max);
+    }
+    return 0;
+}
+#endif /* MODULE_GNRC_NETIF_TXQ */
+
+#ifdef MODULE_NETSTATS_NEIGHBOR
+static int _netif_nb_stats(kernel_pid_t iface, bool reset)
+{
+    netstats_nb_t *stats;
+    int res = gnrc_netapi_get(iface, NETOPT_STATS, NETSTATS_NEIGHBOR, &stats,
+                              sizeof(&stats));
+
+    if (res < 0) {
+        puts("           Protocol or device doesn't provide statistics.");
+        return res;
+    }
+    if (reset) {
+        netstats_nb_init(stats);
+        puts("Reset statistics for module Neighbors!");
+        return 0;
+    }
+    puts("          Statistics for Neighbors\n"
+         "            L2 address               ETX  RSSI  LQI  TX (failed)"
+         "     RX  fresh");
+    for (unsigned i = 0; i < NETSTATS_NB_SIZE; i++) {
+        char l2addr_str[3 * NETSTATS_NB_L2ADDR_MAXLEN];
+
+        if (stats[i].l2_addr_len == 0) {
+            continue;
+        }
+        gnrc_netif_addr_to_str(stats[i].l2_addr, stats[i].l2_addr_len,
+                               l2addr_str);
+        printf("            %-23s %2u.%02u %5d %4u %5u (%5u) %5u  %s\n",
+               l2addr_str,
+               (unsigned)(stats[i].etx / NETSTATS_NB_ETX_DIVISOR),
+               (unsigned)(((stats[i].etx % NETSTATS_NB_ETX_DIVISOR) * 100) /
+                          NETSTATS_NB_ETX_DIVISOR),
+               (int)stats[i].rssi, (unsigned)stats[i].lqi,
+               (unsigned)stats[i].tx_count, (unsigned)stats[i].tx_failed,
+               (unsigned)stats[i].rx_count,
+               netstats_nb_isfresh(&stats[i]) ? "yes" : "no");
+    }
+    return 0;
+}
+#endif /* MODULE_NETSTATS_NEIGHBOR */
+
 static void _set_usage(char *cmd_name)
 {
     printf("usage: %s <if_id> set <key> <value>\n", cmd_name);
@@ -201,7 +279,7 @@ static void _del_usage(char *cmd_name)
 #ifdef MODULE_NETSTATS
 static void _stats_usage(char *cmd_name)
 {
-    printf("usage: %s <if_id> stats [l2|ipv6] [reset]\n", cmd_name);
+    printf("usage: %s <if_id> stats [l2|ipv6|txq|nb] [reset]\n", cmd_name);
     puts("       reset can be only used if the module is specified.");
 }
 #endif
@@ -596,6 +674,9 @@ static void _netif_list(kernel_pid_t iface)
 #endif
 #ifdef MODULE_NETSTATS_IPV6
     _netif_stats(iface, NETSTATS_IPV6, false);
+#endif
+#ifdef MODULE_GNRC_NETIF_TXQ
+    _netif_txq_stats(iface, false);
 #endif
     puts("");
 }
@@ -1336,6 +1417,16 @@ int _gnrc_netif_config(int argc, char **argv)
                 else if (strcmp(argv[3], "ipv6") == 0) {
                     module = NETSTATS_IPV6;
                 }
+#ifdef MODULE_GNRC_NETIF_TXQ
+                else if (strcmp(argv[3], "txq") == 0) {
+                    module = NETSTATS_TXQ;
+                }
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+                else if (strcmp(argv[3], "nb") == 0) {
+                    module = NETSTATS_NEIGHBOR;
+                }
+#endif
                 else {
                     printf("Module %s doesn't exist or does not provide statistics.\n", argv[3]);
 
@@ -1352,6 +1443,16 @@ int _gnrc_netif_config(int argc, char **argv)
                 if (module & NETSTATS_IPV6) {
                     _netif_stats((kernel_pid_t) iface, NETSTATS_IPV6, reset);
                 }
+#ifdef MODULE_GNRC_NETIF_TXQ
+                if (module & NETSTATS_TXQ) {
+                    _netif_txq_stats((kernel_pid_t) iface, reset);
+                }
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+                if (module & NETSTATS_NEIGHBOR) {
+                    _netif_nb_stats((kernel_pid_t) iface, reset);
+                }
+#endif
 
                 return 1;
             }
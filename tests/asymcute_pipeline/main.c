@@ -0,0 +1,347 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Throughput test for pipelined publishing with Asymcute
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "msg.h"
+#include "net/asymcute.h"
+#include "net/ipv6/addr.h"
+#include "random.h"
+#include "shell.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define GW_PORT             (MQTTSN_DEFAULT_PORT)
+#define GW_PRIO             (THREAD_PRIORITY_MAIN - 1)
+#define GW_QUEUE_SIZE       (32U)
+#define REQ_NUMOF           (16U)
+#define TOPIC_NUMOF         (4U)
+#define PAYLOAD_LEN         (32U)
+#define MAIN_QUEUE_SIZE     (32U)
+#define MSG_TYPE_EVT        (0x4d01)
+
+/* a response of the gateway stand-in, sent after LATENCY_MS */
+typedef struct {
+    uint32_t due;
+    sock_udp_ep_t remote;
+    uint8_t data[8];
+    uint8_t len;
+} _delayed_t;
+
+static char _gw_stack[THREAD_STACKSIZE_DEFAULT];
+static char _listener_stack[ASYMCUTE_LISTENER_STACKSIZE];
+static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
+static kernel_pid_t _main_pid;
+
+static asymcute_con_t _con;
+static asymcute_req_t _reqs[REQ_NUMOF];
+static asymcute_topic_t _topics[TOPIC_NUMOF];
+
+/* counted by the gateway stand-in */
+static struct {
+    unsigned publish;
+    unsigned dup;
+} _gw;
+
+static bool _lost(void)
+{
+#if LOSS_PCT
+    return (random_uint32_range(0, 100) < LOSS_PCT);
+#else
+    return false;
+#endif
+}
+
+/* a minimal gateway: accepts every client, assigns topic IDs in order and
+ * acknowledges every QoS 1 message */
+static void *_gw_thread(void *arg)
+{
+    (void)arg;
+    static _delayed_t queue[GW_QUEUE_SIZE];
+    static uint8_t buf[ASYMCUTE_BUFSIZE];
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+    sock_udp_t sock;
+    unsigned head = 0, numof = 0;
+    uint16_t next_topic = 1;
+
+    local.port = GW_PORT;
+    if (sock_udp_create(&sock, &local, NULL, 0) < 0) {
+        puts("error: unable to create gateway socket");
+        return NULL;
+    }
+
+    while (1) {
+        uint32_t timeout = SOCK_NO_TIMEOUT;
+        sock_udp_ep_t remote;
+        uint8_t resp[8];
+        size_t resp_len = 0;
+
+        /* send the responses that are due, they are in order */
+        while (numof > 0) {
+            int32_t left = (int32_t)(queue[head].due - xtimer_now_usec());
+
+            if (left > 0) {
+                timeout = left;
+                break;
+            }
+            sock_udp_send(&sock, queue[head].data, queue[head].len,
+                          &queue[head].remote);
+            head = (head + 1) % GW_QUEUE_SIZE;
+            numof--;
+        }
+
+        ssize_t len = sock_udp_recv(&sock, buf, sizeof(buf), timeout, &remote);
+        if ((len < 2) || (buf[0] == 0x01) || (buf[0] > len)) {
+            continue;
+        }
+        switch (buf[1]) {
+            case MQTTSN_CONNECT:
+                _gw.publish = 0;
+                _gw.dup = 0;
+                resp[0] = 3;
+                resp[1] = MQTTSN_CONNACK;
+                resp[2] = MQTTSN_ACCEPTED;
+                resp_len = 3;
+                break;
+            case MQTTSN_REGISTER:
+                if (len < 6) {
+                    continue;
+                }
+                resp[0] = 7;
+                resp[1] = MQTTSN_REGACK;
+                byteorder_htobebufs(&resp[2], next_topic++);
+                memcpy(&resp[4], &buf[4], 2);
+                resp[6] = MQTTSN_ACCEPTED;
+                resp_len = 7;
+                break;
+            case MQTTSN_PUBLISH:
+                if ((len < 7) || _lost()) {
+                    continue;
+                }
+                _gw.publish++;
+                if (buf[2] & MQTTSN_DUP) {
+                    _gw.dup++;
+                }
+                if (!(buf[2] & MQTTSN_QOS_1) || _lost()) {
+                    continue;
+                }
+                resp[0] = 7;
+                resp[1] = MQTTSN_PUBACK;
+                memcpy(&resp[2], &buf[3], 4);
+                resp[6] = MQTTSN_ACCEPTED;
+                resp_len = 7;
+                break;
+            case MQTTSN_PINGREQ:
+                resp[0] = 2;
+                resp[1] = MQTTSN_PINGRESP;
+                resp_len = 2;
+                break;
+            case MQTTSN_DISCONNECT:
+                resp[0] = 2;
+                resp[1] = MQTTSN_DISCONNECT;
+                resp_len = 2;
+                break;
+            default:
+                continue;
+        }
+        if (numof == GW_QUEUE_SIZE) {
+            /* as a congested gateway would */
+            continue;
+        }
+        _delayed_t *d = &queue[(head + numof++) % GW_QUEUE_SIZE];
+        d->due = xtimer_now_usec() + (LATENCY_MS * US_PER_MS);
+        d->remote = remote;
+        memcpy(d->data, resp, resp_len);
+        d->len = resp_len;
+    }
+    return NULL;
+}
+
+static void _on_evt(asymcute_req_t *req, unsigned evt_type)
+{
+    (void)req;
+    msg_t msg = { .type = MSG_TYPE_EVT, .content.value = evt_type };
+
+    msg_try_send(&msg, _main_pid);
+}
+
+/* waits for the next event of a request */
+static unsigned _wait(void)
+{
+    msg_t msg;
+
+    do {
+        msg_receive(&msg);
+    } while (msg.type != MSG_TYPE_EVT);
+    return msg.content.value;
+}
+
+static asymcute_req_t *_free_req(void)
+{
+    for (unsigned i = 0; i < REQ_NUMOF; i++) {
+        if (!asymcute_req_in_use(&_reqs[i])) {
+            return &_reqs[i];
+        }
+    }
+    return NULL;
+}
+
+static int _connect(sock_udp_ep_t *gw)
+{
+    if (asymcute_connect(&_con, &_reqs[0], gw, "bench", true, NULL) !=
+        ASYMCUTE_OK) {
+        puts("error: unable to connect");
+        return -1;
+    }
+    if (_wait() != ASYMCUTE_CONNECTED) {
+        puts("error: gateway did not accept the connection");
+        return -1;
+    }
+    return 0;
+}
+
+static int _register(void)
+{
+    unsigned registered = 0;
+
+    for (unsigned i = 0; i < TOPIC_NUMOF; i++) {
+        char name[sizeof("bench/0")];
+
+        sprintf(name, "bench/%u", i);
+        asymcute_topic_reset(&_topics[i]);
+        asymcute_topic_init(&_topics[i], name, 0);
+    }
+    if (asymcute_register_batch(&_con, _reqs, _topics, TOPIC_NUMOF) !=
+        ASYMCUTE_OK) {
+        puts("error: unable to register topics");
+        return -1;
+    }
+    for (unsigned i = 0; i < TOPIC_NUMOF; i++) {
+        if (_wait() == ASYMCUTE_REGISTERED) {
+            registered++;
+        }
+    }
+    return (registered == TOPIC_NUMOF) ? 0 : -1;
+}
+
+static int _cmd_pub(int argc, char **argv)
+{
+    sock_udp_ep_t gw = { .family = AF_INET6, .port = GW_PORT };
+    unsigned count, sent = 0, done = 0, published = 0, timeouts = 0;
+    uint8_t payload[PAYLOAD_LEN];
+    uint32_t start, reg_duration, duration;
+
+    if (argc < 2) {
+        printf("usage: %s <count> [<gateway addr> <port>]\n", argv[0]);
+        return 1;
+    }
+    count = atoi(argv[1]);
+    if (ipv6_addr_from_str((ipv6_addr_t *)&gw.addr.ipv6,
+                           (argc > 2) ? argv[2] : "::1") == NULL) {
+        puts("error: invalid address");
+        return 1;
+    }
+    if (argc > 3) {
+        gw.port = atoi(argv[3]);
+    }
+    memset(payload, 'x', sizeof(payload));
+
+    if (_connect(&gw) < 0) {
+        return 1;
+    }
+    start = xtimer_now_usec();
+    if (_register() < 0) {
+        puts("error: registration failed");
+        return 1;
+    }
+    reg_duration = xtimer_now_usec() - start;
+
+    start = xtimer_now_usec();
+    while (done < count) {
+        asymcute_req_t *req;
+
+        /* asymcute queues what exceeds the window */
+        while ((sent < count) && (req = _free_req())) {
+            if (asymcute_publish(&_con, req, &_topics[sent % TOPIC_NUMOF],
+                                 payload, sizeof(payload),
+                                 MQTTSN_QOS_1) != ASYMCUTE_OK) {
+                break;
+            }
+            sent++;
+        }
+        if (sent == done) {
+            puts("error: unable to publish");
+            return 1;
+        }
+        switch (_wait()) {
+            case ASYMCUTE_PUBLISHED:
+                published++;
+                done++;
+                break;
+            case ASYMCUTE_TIMEOUT:
+            case ASYMCUTE_REJECTED:
+                timeouts++;
+                done++;
+                break;
+            default:
+                /* the connection is gone */
+                done = count;
+                break;
+        }
+    }
+    duration = xtimer_now_usec() - start;
+
+    if (asymcute_disconnect(&_con, &_reqs[0]) == ASYMCUTE_OK) {
+        _wait();
+    }
+    printf("{ \"count\" : %u, \"window\" : %u, \"latency_ms\" : %u, "
+           "\"loss_pct\" : %u, \"register_ms\" : %lu, \"published\" : %u, "
+           "\"timeouts\" : %u, \"gw_publish\" : %u, \"gw_dup\" : %u, "
+           "\"duration_ms\" : %lu, \"msg_per_s\" : %lu }\n",
+           count, ASYMCUTE_PUBLISH_WINDOW, LATENCY_MS, LOSS_PCT,
+           (unsigned long)(reg_duration / US_PER_MS), published, timeouts,
+           _gw.publish, _gw.dup, (unsigned long)(duration / US_PER_MS),
+           (unsigned long)(((uint64_t)published * US_PER_SEC) /
+                           (duration ? duration : 1)));
+    return 0;
+}
+
+static const shell_command_t _commands[] = {
+    { "pub", "publish QoS 1 messages to a gateway", _cmd_pub },
+    { NULL, NULL, NULL }
+};
+
+int main(void)
+{
+    msg_init_queue(_main_msg_queue, MAIN_QUEUE_SIZE);
+    _main_pid = thread_getpid();
+    thread_create(_gw_stack, sizeof(_gw_stack), GW_PRIO,
+                  THREAD_CREATE_STACKTEST, _gw_thread, NULL, "gateway");
+    asymcute_listener_run(&_con, _listener_stack, sizeof(_listener_stack),
+                          ASYMCUTE_LISTENER_PRIO, _on_evt);
+    puts("Asymcute pipelined publishing test");
+
+    char line_buf[SHELL_DEFAULT_BUFSIZE];
+    shell_run(_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
+
+    return 0;
+}
@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark of registrations and lookups of the CoRE Resource
+ *              Directory server with simulated endpoints
+ *
+ * @}
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/cord/common.h"
+#include "net/cord/ep.h"
+#include "net/cord/rd.h"
+#include "net/gcoap.h"
+#include "net/ipv6/addr.h"
+#include "xtimer.h"
+
+/* lookups of each kind */
+#define QUERIES             (100U)
+/* distinct resource types of the lights of the endpoints */
+#define LIGHTS              (16U)
+#define NAME_LEN            (16U)
+#define LINKS_LEN           (192U)
+
+static int _ids[ENDPOINTS];
+static char _out[16384];
+
+static void _name(char *name, unsigned i)
+{
+    snprintf(name, NAME_LEN, "sim-%u", i);
+}
+
+/* the links of a sensor node with a light */
+static size_t _links(char *links, unsigned i)
+{
+    return snprintf(links, LINKS_LEN,
+                    "</s/temp>;rt=\"temperature\";if=\"sensor\";obs,"
+                    "</s/hum>;rt=\"humidity\";if=\"sensor\","
+                    "</a/light>;rt=\"light-%02u\";if=\"actuator\","
+                    "</dev/bat>;rt=\"battery\";ct=0", i % LIGHTS);
+}
+
+/* returns the number of entries of a result, or UINT_MAX if it did not fit */
+static unsigned _entries(ssize_t len)
+{
+    unsigned entries = (len > 0) ? 1 : 0;
+
+    if (len >= (ssize_t)sizeof(_out)) {
+        return UINT_MAX;
+    }
+    for (ssize_t i = 0; i < len; i++) {
+        entries += (_out[i] == ',');
+    }
+    return entries;
+}
+
+static bool _print(const char *op, unsigned n, unsigned entries,
+                   unsigned exp_entries, uint32_t start)
+{
+    uint32_t us = xtimer_now_usec() - start;
+
+    printf("{ \"op\" : \"%s\", \"n\" : %u, \"entries\" : %u, \"us\" : %lu }\n",
+           op, n, entries, (unsigned long)us);
+    if (entries != exp_entries) {
+        printf("error: expected %u entries\n", exp_entries);
+        return false;
+    }
+    return true;
+}
+
+static bool _register(void)
+{
+    sock_udp_ep_t base = { .family = AF_INET6, .port = COAP_PORT };
+    uint32_t start = xtimer_now_usec();
+
+    base.addr.ipv6[0] = 0x20;
+    base.addr.ipv6[1] = 0x01;
+    base.addr.ipv6[2] = 0x0d;
+    base.addr.ipv6[3] = 0xb8;
+    for (unsigned i = 0; i < ENDPOINTS; i++) {
+        char name[NAME_LEN], links[LINKS_LEN];
+
+        _name(name, i);
+        base.addr.ipv6[14] = i >> 8;
+        base.addr.ipv6[15] = i & 0xff;
+        _ids[i] = cord_rd_register(name, NULL, 0, &base, links,
+                                   _links(links, i));
+        if (_ids[i] < 0) {
+            printf("error: unable to register %s: %d\n", name, _ids[i]);
+            return false;
+        }
+    }
+    return _print("register", ENDPOINTS, ENDPOINTS, ENDPOINTS, start);
+}
+
+/* looks up single endpoints by name from the hash table, and by location,
+ * which scans all registrations */
+static bool _lookup_ep(void)
+{
+    cord_rd_filter_t filter;
+    unsigned entries = 0;
+    uint32_t start = xtimer_now_usec();
+    bool ok;
+
+    memset(&filter, 0, sizeof(filter));
+    for (unsigned q = 0; q < QUERIES; q++) {
+        char name[NAME_LEN];
+
+        _name(name, (q * ENDPOINTS) / QUERIES);
+        filter.ep = name;
+        entries += _entries(cord_rd_lookup_ep(&filter, 0, _out,
+                                              sizeof(_out)));
+    }
+    ok = _print("lookup_ep_name", QUERIES, entries, QUERIES, start);
+
+    memset(&filter, 0, sizeof(filter));
+    entries = 0;
+    start = xtimer_now_usec();
+    for (unsigned q = 0; q < QUERIES; q++) {
+        char loc[NAME_LEN];
+
+        snprintf(loc, sizeof(loc), "/rd/%d", _ids[(q * ENDPOINTS) / QUERIES]);
+        filter.href = loc;
+        entries += _entries(cord_rd_lookup_ep(&filter, 0, _out,
+                                              sizeof(_out)));
+    }
+    return _print("lookup_ep_scan", QUERIES, entries, QUERIES, start) && ok;
+}
+
+/* looks up the lights of a type from the inverted index, and with a prefix
+ * filter, which scans all links */
+static bool _lookup_res(void)
+{
+    cord_rd_filter_t filter;
+    unsigned entries = 0, exp_entries = 0;
+    uint32_t start = xtimer_now_usec();
+    bool ok;
+
+    for (unsigned q = 0; q < QUERIES; q++) {
+        exp_entries += (ENDPOINTS / LIGHTS) +
+                       (((q % LIGHTS) < (ENDPOINTS % LIGHTS)) ? 1 : 0);
+    }
+
+    memset(&filter, 0, sizeof(filter));
+    for (unsigned q = 0; q < QUERIES; q++) {
+        char rt[NAME_LEN];
+
+        snprintf(rt, sizeof(rt), "light-%02u", q % LIGHTS);
+        filter.rt = rt;
+        entries += _entries(cord_rd_lookup_res(&filter, 0, _out,
+                                               sizeof(_out)));
+    }
+    ok = _print("lookup_res_index", QUERIES, entries, exp_entries, start);
+
+    entries = 0;
+    start = xtimer_now_usec();
+    for (unsigned q = 0; q < QUERIES; q++) {
+        char rt[NAME_LEN];
+
+        snprintf(rt, sizeof(rt), "light-%02u*", q % LIGHTS);
+        filter.rt = rt;
+        entries += _entries(cord_rd_lookup_res(&filter, 0, _out,
+                                               sizeof(_out)));
+    }
+    return _print("lookup_res_scan", QUERIES, entries, exp_entries, start) &&
+           ok;
+}
+
+static bool _update_remove(void)
+{
+    unsigned done = 0;
+    uint32_t start = xtimer_now_usec();
+    bool ok;
+
+    for (unsigned i = 0; i < ENDPOINTS; i++) {
+        done += (cord_rd_update(_ids[i], 0, NULL, 0) == 0);
+    }
+    ok = _print("update", ENDPOINTS, done, ENDPOINTS, start);
+
+    done = 0;
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < ENDPOINTS; i++) {
+        done += (cord_rd_remove(_ids[i]) == 0);
+    }
+    return _print("remove", ENDPOINTS, done, ENDPOINTS, start) && ok;
+}
+
+/* registers this node with its own RD over CoAP */
+static bool _cord_ep(void)
+{
+    sock_udp_ep_t rd = { .family = AF_INET6, .port = COAP_PORT };
+    cord_rd_filter_t filter;
+    ssize_t len;
+    int res;
+
+    memcpy(rd.addr.ipv6, &ipv6_addr_loopback, sizeof(ipv6_addr_t));
+    memset(&filter, 0, sizeof(filter));
+    filter.ep = cord_common_get_ep();
+
+    res = cord_ep_register(&rd, NULL);
+    if (res != CORD_EP_OK) {
+        printf("error: cord_ep_register: %d\n", res);
+        return false;
+    }
+    len = cord_rd_lookup_ep(&filter, 0, _out, sizeof(_out) - 1);
+    _out[len] = '\0';
+    if ((_entries(len) != 1) ||
+        (strstr(_out, "base=\"coap://[::1]:") == NULL)) {
+        puts("error: registration of cord_ep not found");
+        return false;
+    }
+    res = cord_ep_update();
+    if (res != CORD_EP_OK) {
+        printf("error: cord_ep_update: %d\n", res);
+        return false;
+    }
+    cord_ep_remove();
+    if (cord_rd_lookup_ep(&filter, 0, _out, sizeof(_out)) != 0) {
+        puts("error: registration of cord_ep not removed");
+        return false;
+    }
+    puts("cord_ep: registered, updated and removed");
+    return true;
+}
+
+int main(void)
+{
+    bool ok;
+
+    puts("CoRE RD server benchmark");
+    ok = _register();
+    ok = ok && _lookup_ep();
+    ok = ok && _lookup_res();
+    ok = ok && _update_remove();
+    ok = ok && _cord_ep();
+    puts(ok ? "[SUCCESS]" : "[FAILURE]");
+    return 0;
+}
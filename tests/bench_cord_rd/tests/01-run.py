@@ -0,0 +1,25 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+OPS = ("register", "lookup_ep_name", "lookup_ep_scan", "lookup_res_index",
+       "lookup_res_scan", "update", "remove")
+
+
+def testfunc(child):
+    for op in OPS:
+        child.expect(r"{ \"op\" : \"%s\", \"n\" : \d+, \"entries\" : \d+, "
+                     r"\"us\" : \d+ }" % op)
+    child.expect_exact("[SUCCESS]")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc, timeout=120))
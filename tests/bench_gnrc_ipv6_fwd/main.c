@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark of the IPv6 forwarding rate with and without flow
+ *              cache
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/flowcache.h"
+#include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/ipv6/hdr.h"
+#include "net/protnum.h"
+#include "net/udp.h"
+#include "xtimer.h"
+
+#define PAYLOAD_LEN         (32U)
+#define PKT_LEN             (sizeof(ipv6_hdr_t) + sizeof(udp_hdr_t) + \
+                             PAYLOAD_LEN)
+#define PREFIX_LEN          (64U)
+/* more flows than fit into the flow cache */
+#define MANY_FLOWS          (GNRC_IPV6_FLOWCACHE_SIZE * 4)
+
+static const ipv6_addr_t _route = {
+    .u8 = { 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x02 }
+};
+static const ipv6_addr_t _next_hop = { .u8 = { 0xfe, 0x80, [15] = 0x02 } };
+static const uint8_t _next_hop_l2addr[] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 };
+static uint8_t _buf[PKT_LEN];
+
+static void _build_pkt(unsigned flow)
+{
+    ipv6_hdr_t *hdr = (ipv6_hdr_t *)_buf;
+    udp_hdr_t *udp = (udp_hdr_t *)(hdr + 1);
+
+    memset(_buf, 0, sizeof(_buf));
+    ipv6_hdr_set_version(hdr);
+    hdr->len = byteorder_htons(sizeof(udp_hdr_t) + PAYLOAD_LEN);
+    hdr->nh = PROTNUM_UDP;
+    hdr->hl = 64;
+    hdr->src.u8[0] = 0x20;
+    hdr->src.u8[1] = 0x01;
+    hdr->src.u8[2] = 0x0d;
+    hdr->src.u8[3] = 0xb8;
+    hdr->src.u8[5] = 0x01;
+    hdr->src.u8[15] = (uint8_t)flow;
+    hdr->dst = _route;
+    hdr->dst.u8[15] = 0x01;
+    udp->src_port = byteorder_htons(1000 + flow);
+    udp->dst_port = byteorder_htons(1000);
+    udp->length = hdr->len;
+}
+
+static uint32_t _run(gnrc_netif_t *in, unsigned flows, bool fast)
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < PACKETS_NUMOF; i++) {
+        gnrc_pktsnip_t *netif_hdr, *pkt;
+
+        if (!fast) {
+            gnrc_ipv6_flowcache_invalidate();
+        }
+        _build_pkt(i % flows);
+        netif_hdr = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+        if (netif_hdr == NULL) {
+            return 0;
+        }
+        ((gnrc_netif_hdr_t *)netif_hdr->data)->if_pid = in->pid;
+        pkt = gnrc_pktbuf_add(netif_hdr, _buf, sizeof(_buf),
+                              GNRC_NETTYPE_IPV6);
+        if (pkt == NULL) {
+            gnrc_pktbuf_release(netif_hdr);
+            return 0;
+        }
+        /* IPv6 and the interface run with higher priority, so the packet is
+         * forwarded and sent before this call returns */
+        if (gnrc_netapi_dispatch_receive(GNRC_NETTYPE_IPV6,
+                                         GNRC_NETREG_DEMUX_CTX_ALL, pkt) == 0) {
+            gnrc_pktbuf_release(pkt);
+            return 0;
+        }
+    }
+    return (uint32_t)(((uint64_t)PACKETS_NUMOF * US_PER_SEC) /
+                      (xtimer_now_usec() - start));
+}
+
+static int _bench(gnrc_netif_t *in, unsigned flows)
+{
+    static const char *paths[] = { "slow", "fast" };
+
+    for (unsigned i = 0; i < 2; i++) {
+        uint32_t pps = _run(in, flows, (i == 1));
+
+        if (pps == 0) {
+            return 1;
+        }
+        printf("{ \"path\" : \"%s\", \"flows\" : %u, \"packets\" : %u, "
+               "\"pps\" : %lu }\n", paths[i], flows, (unsigned)PACKETS_NUMOF,
+               (unsigned long)pps);
+    }
+    return 0;
+}
+
+int main(void)
+{
+    gnrc_netif_t *in = gnrc_netif_iter(NULL);
+    gnrc_netif_t *out = (in != NULL) ? gnrc_netif_iter(in) : NULL;
+
+    puts("IPv6 forwarding benchmark");
+    if (out == NULL) {
+        puts("Two network interfaces are required");
+        puts("[FAILURE]");
+        return 1;
+    }
+    if ((gnrc_ipv6_nib_nc_set(&_next_hop, out->pid, _next_hop_l2addr,
+                              sizeof(_next_hop_l2addr)) < 0) ||
+        (gnrc_ipv6_nib_ft_add(&_route, PREFIX_LEN, &_next_hop, out->pid,
+                              0) < 0)) {
+        puts("Unable to add route");
+        puts("[FAILURE]");
+        return 1;
+    }
+    if (_bench(in, 1) || _bench(in, MANY_FLOWS)) {
+        puts("Unable to inject packet");
+        puts("[FAILURE]");
+        return 1;
+    }
+    puts("[SUCCESS]");
+    return 0;
+}
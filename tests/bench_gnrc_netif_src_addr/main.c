@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark of the IPv6 source address selection
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/internal.h"
+#include "xtimer.h"
+
+#define ITERATIONS          (10000U)
+#define DST_NUMOF           (16U)
+#define GLOBAL_NUMOF        (3U)
+#define PREFIX_LEN          (64U)
+
+static void _dst_addr(ipv6_addr_t *addr, unsigned i)
+{
+    ipv6_addr_set_unspecified(addr);
+    addr->u8[0] = 0x20;
+    addr->u8[1] = 0x01;
+    addr->u8[2] = 0x0d;
+    addr->u8[3] = 0xb8;
+    addr->u8[5] = 0x01;
+    addr->u8[15] = (uint8_t)(i + 0x10);
+}
+
+static uint32_t _run(gnrc_netif_t *netif, unsigned dst_numof)
+{
+    ipv6_addr_t dsts[DST_NUMOF];
+    uint32_t start;
+
+    for (unsigned i = 0; i < dst_numof; i++) {
+        _dst_addr(&dsts[i], i);
+    }
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < ITERATIONS; i++) {
+        if (gnrc_netif_ipv6_addr_best_src(netif, &dsts[i % dst_numof],
+                                          false) == NULL) {
+            return UINT32_MAX;
+        }
+    }
+    return (uint32_t)(((uint64_t)(xtimer_now_usec() - start) * NS_PER_US) /
+                      ITERATIONS);
+}
+
+int main(void)
+{
+    gnrc_netif_t *netif = gnrc_netif_iter(NULL);
+    uint32_t same, rotating;
+
+    puts("IPv6 source address selection benchmark");
+    if (netif == NULL) {
+        puts("No network interface found");
+        puts("[FAILURE]");
+        return 1;
+    }
+    /* global addresses in different subnets, so the selection needs to go
+     * down to the longest matching prefix */
+    for (unsigned i = 0; i < GLOBAL_NUMOF; i++) {
+        ipv6_addr_t addr;
+
+        _dst_addr(&addr, i);
+        addr.u8[5] = (uint8_t)i;
+        addr.u8[15] = 0x01;
+        if (gnrc_netif_ipv6_addr_add_internal(netif, &addr, PREFIX_LEN,
+                                              GNRC_NETIF_IPV6_ADDRS_FLAGS_STATE_VALID) < 0) {
+            puts("Unable to add address");
+            puts("[FAILURE]");
+            return 1;
+        }
+    }
+    same = _run(netif, 1);
+    rotating = _run(netif, DST_NUMOF);
+    if ((same == UINT32_MAX) || (rotating == UINT32_MAX)) {
+        puts("No source address selected");
+        puts("[FAILURE]");
+        return 1;
+    }
+    printf("{ \"cache_size\" : %u, \"same_dst_ns\" : %lu, "
+           "\"rotating_dst_ns\" : %lu }\n",
+           (unsigned)GNRC_NETIF_IPV6_SRC_CACHE_SIZE, (unsigned long)same,
+           (unsigned long)rotating);
+    puts("[SUCCESS]");
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark of the RPL parent set update per DIO
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "net/gnrc/netif.h"
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/dodag.h"
+#include "net/gnrc/rpl/of_manager.h"
+#include "random.h"
+#include "utlist.h"
+#include "xtimer.h"
+
+#define ITERATIONS          (1000U)
+#define INSTANCE_ID         (42U)
+#define MRHOF_OCP           (0x1)
+/* keep all parents within the same DAGRank as the root so none is pruned */
+#define RANK_MIN            (GNRC_RPL_DEFAULT_MIN_HOP_RANK_INCREASE)
+#define RANK_MAX            ((2 * GNRC_RPL_DEFAULT_MIN_HOP_RANK_INCREASE) - 1)
+
+static gnrc_rpl_parent_t *parents[GNRC_RPL_PARENTS_NUMOF];
+
+static uint32_t _run(gnrc_rpl_dodag_t *dodag, bool full_sort)
+{
+    uint32_t total = 0;
+
+    for (unsigned i = 0; i < ITERATIONS; i++) {
+        gnrc_rpl_parent_t *parent = parents[random_uint32_range(0, GNRC_RPL_PARENTS_NUMOF)];
+        uint32_t start;
+
+        parent->rank = (uint16_t)random_uint32_range(RANK_MIN, RANK_MAX + 1);
+        start = xtimer_now_usec();
+        if (full_sort) {
+            /* previous behavior: re-evaluate every parent on every DIO */
+            LL_SORT(dodag->parents, dodag->instance->of->parent_cmp);
+        }
+        gnrc_rpl_parent_update(dodag, parent);
+        total += xtimer_now_usec() - start;
+    }
+    return total / ITERATIONS;
+}
+
+static int _bench(const char *name, uint16_t ocp, kernel_pid_t iface)
+{
+    gnrc_rpl_instance_t *inst;
+    gnrc_rpl_dodag_t *dodag;
+    ipv6_addr_t dodag_id = { .u8 = { 0x20, 0x01, 0x0d, 0xb8, [15] = 0x01 } };
+    uint32_t incremental, full_sort;
+
+    if (!gnrc_rpl_instance_add(INSTANCE_ID, &inst)) {
+        puts("Unable to create RPL instance");
+        return 1;
+    }
+    inst->of = gnrc_rpl_get_of_for_ocp(ocp);
+    inst->mop = GNRC_RPL_MOP_NO_DOWNWARD_ROUTES;
+    gnrc_rpl_dodag_init(inst, &dodag_id, iface);
+    dodag = &inst->dodag;
+    dodag->node_status = GNRC_RPL_NORMAL_NODE;
+    trickle_start(thread_getpid(), &dodag->trickle, GNRC_RPL_MSG_TYPE_TRICKLE_MSG,
+                  (1 << dodag->dio_min), dodag->dio_interval_doubl,
+                  dodag->dio_redun);
+
+    for (unsigned i = 0; i < GNRC_RPL_PARENTS_NUMOF; i++) {
+        ipv6_addr_t addr = { .u8 = { 0xfe, 0x80, [14] = 0xaa, [15] = i } };
+
+        gnrc_rpl_parent_add_by_addr(dodag, &addr, &parents[i]);
+        parents[i]->rank = (uint16_t)random_uint32_range(RANK_MIN, RANK_MAX + 1);
+        gnrc_rpl_parent_update(dodag, parents[i]);
+    }
+
+    incremental = _run(dodag, false);
+    full_sort = _run(dodag, true);
+    printf("{ \"of\" : \"%s\", \"parents\" : %u, \"incremental_us\" : %lu, "
+           "\"full_sort_us\" : %lu }\n", name, (unsigned)GNRC_RPL_PARENTS_NUMOF,
+           (unsigned long)incremental, (unsigned long)full_sort);
+    gnrc_rpl_instance_remove(inst);
+    return 0;
+}
+
+int main(void)
+{
+    gnrc_netif_t *netif = gnrc_netif_iter(NULL);
+
+    puts("RPL parent set benchmark");
+    if (netif == NULL) {
+        puts("No network interface found");
+        return 1;
+    }
+    gnrc_rpl_init(netif->pid);
+
+    if (_bench("OF0", GNRC_RPL_DEFAULT_OCP, netif->pid) ||
+        _bench("MRHOF", MRHOF_OCP, netif->pid)) {
+        puts("[FAILURE]");
+        return 1;
+    }
+    puts("[SUCCESS]");
+    return 0;
+}
@@ -0,0 +1,21 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    for of in ("OF0", "MRHOF"):
+        child.expect(r"{ \"of\" : \"%s\", \"parents\" : \d+, "
+                     r"\"incremental_us\" : \d+, \"full_sort_us\" : \d+ }" % of)
+    child.expect_exact("[SUCCESS]")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
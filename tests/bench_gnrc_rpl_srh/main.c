@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark of the source routing header generation of a
+ *              non-storing mode RPL root
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "net/gnrc/rpl/srh.h"
+#include "random.h"
+#include "xtimer.h"
+
+#define ITERATIONS          (1000U)
+
+static uint8_t srh_buf[GNRC_RPL_SRH_MAX_LEN];
+static uint16_t depth[NODES_NUMOF];
+
+static void _node_addr(ipv6_addr_t *addr, unsigned i)
+{
+    ipv6_addr_set_unspecified(addr);
+    addr->u8[0] = 0x20;
+    addr->u8[1] = 0x01;
+    addr->u8[2] = 0x0d;
+    addr->u8[3] = 0xb8;
+    addr->u8[11] = 0xff;
+    addr->u8[12] = 0xfe;
+    addr->u8[14] = (uint8_t)(i >> 8);
+    addr->u8[15] = (uint8_t)i;
+}
+
+static uint32_t _fill(void)
+{
+    uint32_t total = 0;
+
+    for (unsigned i = 0; i < NODES_NUMOF; i++) {
+        ipv6_addr_t addr, parent;
+        uint32_t start;
+        int res;
+
+        _node_addr(&addr, i);
+        start = xtimer_now_usec();
+        if (i == 0) {
+            depth[i] = 1;
+            res = gnrc_rpl_srh_table_add(&addr, NULL);
+        }
+        else {
+            unsigned p = random_uint32_range(0, i);
+
+            depth[i] = depth[p] + 1;
+            _node_addr(&parent, p);
+            res = gnrc_rpl_srh_table_add(&addr, &parent);
+        }
+        total += xtimer_now_usec() - start;
+        if (res < 0) {
+            return UINT32_MAX;
+        }
+    }
+    return total / NODES_NUMOF;
+}
+
+static uint32_t _build(bool same_dst)
+{
+    uint32_t total = 0;
+    ipv6_addr_t dst, first_hop;
+
+    _node_addr(&dst, random_uint32_range(0, NODES_NUMOF));
+    for (unsigned i = 0; i < ITERATIONS; i++) {
+        uint32_t start;
+        int res;
+
+        if (!same_dst) {
+            _node_addr(&dst, random_uint32_range(0, NODES_NUMOF));
+        }
+        start = xtimer_now_usec();
+        res = gnrc_rpl_srh_build(&dst, &first_hop, (gnrc_rpl_srh_t *)srh_buf,
+                                 sizeof(srh_buf));
+        total += xtimer_now_usec() - start;
+        if (res < 0) {
+            return UINT32_MAX;
+        }
+    }
+    return total / ITERATIONS;
+}
+
+int main(void)
+{
+    uint32_t add, build, build_cached, depth_sum = 0;
+    unsigned depth_max = 0;
+
+    puts("RPL source routing header benchmark");
+    gnrc_rpl_srh_table_flush();
+    if ((add = _fill()) == UINT32_MAX) {
+        puts("Unable to fill source route table");
+        puts("[FAILURE]");
+        return 1;
+    }
+    for (unsigned i = 0; i < NODES_NUMOF; i++) {
+        depth_sum += depth[i];
+        if (depth[i] > depth_max) {
+            depth_max = depth[i];
+        }
+    }
+    build = _build(false);
+    build_cached = _build(true);
+    if ((build == UINT32_MAX) || (build_cached == UINT32_MAX)) {
+        puts("Unable to build source routing header");
+        puts("[FAILURE]");
+        return 1;
+    }
+    printf("{ \"nodes\" : %u, \"avg_depth\" : %lu, \"max_depth\" : %u, "
+           "\"add_us\" : %lu, \"build_us\" : %lu, \"build_cached_us\" : %lu }\n",
+           (unsigned)NODES_NUMOF, (unsigned long)(depth_sum / NODES_NUMOF),
+           depth_max, (unsigned long)add, (unsigned long)build,
+           (unsigned long)build_cached);
+    puts("[SUCCESS]");
+    return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark of the Internet checksum calculation
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "net/inet_csum.h"
+#include "xtimer.h"
+
+#define MAX_LEN     (1280U)
+
+static const uint16_t _lens[] = { 8, 48, 128, 512, MAX_LEN };
+/* one byte more for the unaligned runs */
+static uint32_t _buf[(MAX_LEN / sizeof(uint32_t)) + 1];
+
+/* the plain byte-pair implementation for comparison */
+static uint16_t _ref_csum(uint16_t sum, const uint8_t *buf, uint16_t len)
+{
+    uint32_t csum = sum;
+
+    for (unsigned i = 0; i < (len >> 1U); buf += 2, i++) {
+        csum += (uint16_t)(*buf << 8) + *(buf + 1);
+    }
+    if (len & 1) {
+        csum += (uint16_t)(*buf << 8);
+    }
+    while (csum >> 16) {
+        csum = (csum & 0xffff) + (csum >> 16);
+    }
+    return csum;
+}
+
+static uint32_t _run(uint16_t (*csum)(uint16_t, const uint8_t *, uint16_t),
+                     const uint8_t *buf, uint16_t len, uint16_t *res)
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < ITERATIONS; i++) {
+        *res = csum(0, buf, len);
+    }
+    return xtimer_now_usec() - start;
+}
+
+int main(void)
+{
+    uint8_t *bytes = (uint8_t *)_buf;
+
+    puts("Internet checksum benchmark");
+    for (unsigned i = 0; i < sizeof(_buf); i++) {
+        bytes[i] = (uint8_t)(i * 13);
+    }
+    for (unsigned i = 0; i < sizeof(_lens) / sizeof(_lens[0]); i++) {
+        for (unsigned offset = 0; offset < 2; offset++) {
+            uint16_t ref_res = 0, res = 0;
+            uint32_t ref_us = _run(_ref_csum, &bytes[offset], _lens[i],
+                                   &ref_res);
+            uint32_t us = _run(inet_csum, &bytes[offset], _lens[i], &res);
+
+            if (res != ref_res) {
+                printf("Checksum mismatch for %u bytes: 0x%04x != 0x%04x\n",
+                       (unsigned)_lens[i], (unsigned)res, (unsigned)ref_res);
+                puts("[FAILURE]");
+                return 1;
+            }
+            printf("{ \"len\" : %u, \"offset\" : %u, \"ref_us\" : %lu, "
+                   "\"inet_csum_us\" : %lu }\n", (unsigned)_lens[i], offset,
+                   (unsigned long)ref_us, (unsigned long)us);
+        }
+    }
+    puts("[SUCCESS]");
+    return 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark of the link layer address filter
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "net/l2filter.h"
+#include "random.h"
+#include "xtimer.h"
+
+#define ADDR_LEN        (8U)
+#define MAX_ENTRIES     (1024U)
+
+static const unsigned _sizes[] = { 8, 128, MAX_ENTRIES };
+
+static l2filter_t _filter[L2FILTER_LISTSIZE];
+static uint8_t _addrs[MAX_ENTRIES][ADDR_LEN];
+static uint8_t _others[MAX_ENTRIES][ADDR_LEN];
+
+/* the linear scan over the entries for comparison */
+static bool _ref_pass(unsigned numof, const uint8_t *addr)
+{
+    for (unsigned i = 0; i < numof; i++) {
+        if (memcmp(_addrs[i], addr, ADDR_LEN) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t _run_ref(unsigned numof, uint8_t (*addrs)[ADDR_LEN],
+                         bool exp)
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < ITERATIONS; i++) {
+        if (_ref_pass(numof, addrs[i % numof]) != exp) {
+            return UINT32_MAX;
+        }
+    }
+    return xtimer_now_usec() - start;
+}
+
+static uint32_t _run(unsigned numof, uint8_t (*addrs)[ADDR_LEN], bool exp)
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < ITERATIONS; i++) {
+        if (l2filter_pass(_filter, addrs[i % numof], ADDR_LEN) != exp) {
+            return UINT32_MAX;
+        }
+    }
+    return xtimer_now_usec() - start;
+}
+
+int main(void)
+{
+    puts("L2 filter benchmark");
+    random_init(0);
+    for (unsigned i = 0; i < MAX_ENTRIES; i++) {
+        random_bytes(_addrs[i], ADDR_LEN);
+        random_bytes(_others[i], ADDR_LEN);
+        /* make sure the other addresses are not in the list */
+        _addrs[i][0] &= ~0x1;
+        _others[i][0] |= 0x1;
+    }
+    for (unsigned s = 0; s < sizeof(_sizes) / sizeof(_sizes[0]); s++) {
+        unsigned numof = _sizes[s];
+        uint32_t ref_hit_us, ref_miss_us, hit_us, miss_us;
+
+        l2filter_init(_filter);
+        for (unsigned i = 0; i < numof; i++) {
+            if (l2filter_add(_filter, _addrs[i], ADDR_LEN) < 0) {
+                printf("Unable to add entry %u\n", i);
+                puts("[FAILURE]");
+                return 1;
+            }
+        }
+        ref_hit_us = _run_ref(numof, _addrs, false);
+        ref_miss_us = _run_ref(numof, _others, true);
+        hit_us = _run(numof, _addrs, false);
+        miss_us = _run(numof, _others, true);
+        if ((ref_hit_us == UINT32_MAX) || (ref_miss_us == UINT32_MAX) ||
+            (hit_us == UINT32_MAX) || (miss_us == UINT32_MAX)) {
+            printf("Wrong filter result with %u entries\n", numof);
+            puts("[FAILURE]");
+            return 1;
+        }
+        printf("{ \"entries\" : %u, \"ref_hit_us\" : %lu, \"ref_miss_us\" : %lu, "
+               "\"hit_us\" : %lu, \"miss_us\" : %lu }\n", numof,
+               (unsigned long)ref_hit_us, (unsigned long)ref_miss_us,
+               (unsigned long)hit_us, (unsigned long)miss_us);
+    }
+    puts("[SUCCESS]");
+    return 0;
+}
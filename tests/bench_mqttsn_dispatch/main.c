@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark of dispatching MQTT-SN messages to subscriptions
+ *
+ * @}
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/mqttsn_topics.h"
+#include "xtimer.h"
+
+#define SUBS_MAX            (256U)
+#define NAME_LEN            (sizeof("s/00/00"))
+/* topic IDs of the names registered for wildcard subscriptions */
+#define REG_ID_BASE         (1000U)
+
+/* a subscription as the MQTT-SN clients kept them before: in a list that
+ * is walked for every message, by topic ID for a PUBLISH and by filter for
+ * a REGISTER */
+typedef struct sub {
+    struct sub *next;
+    const char *filter;
+    uint16_t id;
+} _sub_t;
+
+static const unsigned _numof[] = { 16, 64, 256 };
+
+static _sub_t _subs[SUBS_MAX];
+static char _filters[SUBS_MAX][NAME_LEN];
+/* the names the gateway registers, one per subscription */
+static char _names[SUBS_MAX][NAME_LEN];
+static uint16_t _ids[SUBS_MAX];
+static _sub_t *_list;
+
+static mqttsn_tid_map_t _map;
+static mqttsn_trie_t _trie;
+
+/* every eighth subscription has a wildcard */
+static inline bool _is_wildcard(unsigned i)
+{
+    return ((i % 8) == 7);
+}
+
+static void _setup(unsigned numof)
+{
+    _list = NULL;
+    mqttsn_tid_map_init(&_map);
+    mqttsn_trie_init(&_trie);
+
+    for (unsigned i = 0; i < numof; i++) {
+        _sub_t *sub = &_subs[i];
+
+        if (_is_wildcard(i)) {
+            sprintf(_filters[i], "w/%02u/#", i / 8);
+            sprintf(_names[i], "w/%02u/x", i / 8);
+            _ids[i] = REG_ID_BASE + i;
+        }
+        else {
+            sprintf(_filters[i], "s/%02u/%02u", i / 16, i % 16);
+            strcpy(_names[i], _filters[i]);
+            _ids[i] = i + 1;
+            mqttsn_tid_map_add(&_map, _ids[i], sub);
+        }
+        /* the reference knows the registered name of the wildcard, too */
+        sub->id = _ids[i];
+        sub->filter = _filters[i];
+        sub->next = _list;
+        _list = sub;
+        mqttsn_trie_add(&_trie, sub->filter, sub);
+    }
+    /* the gateway registered the names matching the wildcards */
+    for (unsigned i = 0; i < numof; i++) {
+        if (_is_wildcard(i)) {
+            mqttsn_tid_map_add(&_map, _ids[i], &_subs[i]);
+        }
+    }
+}
+
+/* MQTT topic matching of a single filter, level by level */
+static bool _ref_matches(const char *filter, const char *name)
+{
+    while (1) {
+        size_t flen = strcspn(filter, "/");
+        size_t nlen = strcspn(name, "/");
+
+        if ((flen == 1) && (*filter == '#')) {
+            return true;
+        }
+        if (!((flen == 1) && (*filter == '+')) &&
+            ((flen != nlen) || (memcmp(filter, name, flen) != 0))) {
+            return false;
+        }
+        filter += flen;
+        name += nlen;
+        if (*name == '\0') {
+            /* "a/#" also matches "a" */
+            return (*filter == '\0') || (strcmp(filter, "/#") == 0);
+        }
+        if (*filter == '\0') {
+            return false;
+        }
+        filter++;
+        name++;
+    }
+}
+
+static _sub_t *_ref_dispatch(uint16_t id, const char *name)
+{
+    (void)name;
+    for (_sub_t *sub = _list; sub; sub = sub->next) {
+        if (sub->id == id) {
+            return sub;
+        }
+    }
+    return NULL;
+}
+
+static _sub_t *_ref_register(uint16_t id, const char *name)
+{
+    (void)id;
+    for (_sub_t *sub = _list; sub; sub = sub->next) {
+        if (_ref_matches(sub->filter, name)) {
+            return sub;
+        }
+    }
+    return NULL;
+}
+
+static _sub_t *_map_dispatch(uint16_t id, const char *name)
+{
+    (void)name;
+    return mqttsn_tid_map_get(&_map, id);
+}
+
+static _sub_t *_trie_register(uint16_t id, const char *name)
+{
+    (void)id;
+    return mqttsn_trie_match(&_trie, name, strlen(name));
+}
+
+/* looks up every subscription ITERATIONS times, returns the time taken or
+ * UINT32_MAX if a lookup found the wrong subscription */
+static uint32_t _run(unsigned numof, _sub_t *(*lookup)(uint16_t, const char *))
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned n = 0; n < ITERATIONS; n++) {
+        for (unsigned i = 0; i < numof; i++) {
+            if (lookup(_ids[i], _names[i]) != &_subs[i]) {
+                return UINT32_MAX;
+            }
+        }
+    }
+    return xtimer_now_usec() - start;
+}
+
+int main(void)
+{
+    puts("MQTT-SN dispatch benchmark");
+    for (unsigned r = 0; r < sizeof(_numof) / sizeof(_numof[0]); r++) {
+        unsigned numof = _numof[r];
+        uint32_t res[4];
+
+        _setup(numof);
+        res[0] = _run(numof, _ref_dispatch);
+        res[1] = _run(numof, _map_dispatch);
+        res[2] = _run(numof, _ref_register);
+        res[3] = _run(numof, _trie_register);
+        for (unsigned i = 0; i < 4; i++) {
+            if (res[i] == UINT32_MAX) {
+                printf("Wrong subscription for %u subscriptions\n", numof);
+                puts("[FAILURE]");
+                return 1;
+            }
+        }
+        printf("{ \"subs\" : %u, \"ref_pub_us\" : %lu, \"map_pub_us\" : %lu, "
+               "\"ref_reg_us\" : %lu, \"trie_reg_us\" : %lu }\n", numof,
+               (unsigned long)res[0], (unsigned long)res[1],
+               (unsigned long)res[2], (unsigned long)res[3]);
+    }
+    puts("[SUCCESS]");
+    return 0;
+}
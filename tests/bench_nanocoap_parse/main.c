@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark of parsing CoAP requests and looking up options
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "net/nanocoap.h"
+#include "xtimer.h"
+
+#define BUF_SIZE        (128U)
+#define PAYLOAD_LEN     (32U)
+
+typedef struct {
+    const char *name;
+    uint8_t buf[BUF_SIZE];
+    size_t len;
+} _shape_t;
+
+/* what a request handler looks at */
+typedef struct {
+    int resource;
+    unsigned ct;
+    uint32_t accept;
+    uint32_t block1;
+    uint32_t block2;
+    int etag_len;
+} _result_t;
+
+static ssize_t _handler(coap_pkt_t *pkt, uint8_t *buf, size_t len, void *ctx)
+{
+    (void)ctx;
+    return coap_reply_simple(pkt, COAP_CODE_204, buf, len, 0, NULL, 0);
+}
+
+/* sorted by path, as nanocoap expects */
+const coap_resource_t coap_resources[] = {
+    { "/actuators/led", COAP_PUT, _handler, NULL },
+    { "/config", COAP_GET | COAP_PUT, _handler, NULL },
+    { "/sensors/humidity", COAP_GET, _handler, NULL },
+    { "/sensors/temp", COAP_GET, _handler, NULL },
+    { "/sensors/temp/avg", COAP_GET, _handler, NULL },
+    { "/time", COAP_GET, _handler, NULL },
+    { "/upload", COAP_PUT, _handler, NULL },
+    { "/version", COAP_GET, _handler, NULL },
+};
+
+const unsigned coap_resources_numof = sizeof(coap_resources) /
+                                      sizeof(coap_resources[0]);
+
+static _shape_t _shapes[] = {
+    { .name = "get" },
+    { .name = "query" },
+    { .name = "put" },
+    { .name = "observe" },
+};
+
+static void _build(void)
+{
+    coap_pkt_t pkt;
+    _shape_t *shape;
+    size_t len;
+
+    /* GET /time */
+    shape = &_shapes[0];
+    len = coap_build_hdr((coap_hdr_t *)shape->buf, COAP_TYPE_NON, NULL, 0,
+                         COAP_METHOD_GET, 1);
+    coap_pkt_init(&pkt, shape->buf, BUF_SIZE, len);
+    coap_opt_add_string(&pkt, COAP_OPT_URI_PATH, "/time", '/');
+    shape->len = coap_opt_finish(&pkt, COAP_OPT_FINISH_NONE);
+
+    /* GET /sensors/temp/avg?unit=C&window=60 with Accept */
+    shape = &_shapes[1];
+    len = coap_build_hdr((coap_hdr_t *)shape->buf, COAP_TYPE_NON, NULL, 0,
+                         COAP_METHOD_GET, 2);
+    coap_pkt_init(&pkt, shape->buf, BUF_SIZE, len);
+    coap_opt_add_string(&pkt, COAP_OPT_URI_PATH, "/sensors/temp/avg", '/');
+    coap_opt_add_string(&pkt, COAP_OPT_URI_QUERY, "unit=C&window=60", '&');
+    coap_opt_add_uint(&pkt, COAP_OPT_ACCEPT, COAP_FORMAT_JSON);
+    shape->len = coap_opt_finish(&pkt, COAP_OPT_FINISH_NONE);
+
+    /* PUT /upload with Content-Format, Block1 and a payload */
+    shape = &_shapes[2];
+    len = coap_build_hdr((coap_hdr_t *)shape->buf, COAP_TYPE_CON, NULL, 0,
+                         COAP_METHOD_PUT, 3);
+    coap_pkt_init(&pkt, shape->buf, BUF_SIZE, len);
+    coap_opt_add_string(&pkt, COAP_OPT_URI_PATH, "/upload", '/');
+    coap_opt_add_uint(&pkt, COAP_OPT_CONTENT_FORMAT, COAP_FORMAT_OCTET);
+    coap_opt_add_uint(&pkt, COAP_OPT_BLOCK1, (5 << 4) | 0x8 | 1);
+    len = coap_opt_finish(&pkt, COAP_OPT_FINISH_PAYLOAD);
+    memset(pkt.payload, 0x55, PAYLOAD_LEN);
+    shape->len = len + PAYLOAD_LEN;
+
+    /* GET /sensors/temp with Observe, ETag and Block2 */
+    shape = &_shapes[3];
+    len = coap_build_hdr((coap_hdr_t *)shape->buf, COAP_TYPE_CON, NULL, 0,
+                         COAP_METHOD_GET, 4);
+    coap_pkt_init(&pkt, shape->buf, BUF_SIZE, len);
+    coap_opt_add_uint(&pkt, COAP_OPT_ETAG, 0x1234);
+    coap_opt_add_uint(&pkt, COAP_OPT_OBSERVE, 0);
+    coap_opt_add_string(&pkt, COAP_OPT_URI_PATH, "/sensors/temp", '/');
+    coap_opt_add_uint(&pkt, COAP_OPT_BLOCK2, 2);
+    shape->len = coap_opt_finish(&pkt, COAP_OPT_FINISH_NONE);
+}
+
+static uint32_t _decode_uint(const uint8_t *pos, unsigned len)
+{
+    uint32_t res = 0;
+
+    while (len--) {
+        res = (res << 8) | *pos++;
+    }
+    return res;
+}
+
+/* lookup as nanocoap did it before the option index: a linear scan for the
+ * option, then the option header is decoded again */
+static const uint8_t *_ref_find(coap_pkt_t *pkt, unsigned opt_num,
+                                unsigned *len)
+{
+    for (unsigned i = 0; i < pkt->options_len; i++) {
+        if (pkt->options[i].opt_num == opt_num) {
+            const uint8_t *pos = (uint8_t *)pkt->hdr + pkt->options[i].offset;
+            unsigned delta = *pos >> 4;
+            unsigned opt_len = *pos++ & 0xf;
+
+            pos += (delta == 13) ? 1 : (delta == 14) ? 2 : 0;
+            if (opt_len == 13) {
+                opt_len = 13 + *pos++;
+            }
+            else if (opt_len == 14) {
+                opt_len = 269 + ((pos[0] << 8) | pos[1]);
+                pos += 2;
+            }
+            *len = opt_len;
+            return pos;
+        }
+    }
+    return NULL;
+}
+
+static uint32_t _ref_uint(coap_pkt_t *pkt, unsigned opt_num)
+{
+    unsigned len;
+    const uint8_t *value = _ref_find(pkt, opt_num, &len);
+
+    return value ? _decode_uint(value, len) : 0;
+}
+
+static int _ref_handle(_shape_t *shape, _result_t *res)
+{
+    coap_pkt_t pkt;
+    uint8_t uri[NANOCOAP_URI_MAX];
+    const uint8_t *value;
+    unsigned len;
+
+    if ((coap_parse(&pkt, shape->buf, shape->len) < 0) ||
+        (coap_get_uri_path(&pkt, uri) <= 0)) {
+        return -1;
+    }
+    res->resource = -1;
+    for (unsigned i = 0; i < coap_resources_numof; i++) {
+        int cmp = strcmp((char *)uri, coap_resources[i].path);
+        if (cmp <= 0) {
+            res->resource = (cmp == 0) ? (int)i : -1;
+            break;
+        }
+    }
+    value = _ref_find(&pkt, COAP_OPT_CONTENT_FORMAT, &len);
+    res->ct = value ? _decode_uint(value, len) : COAP_FORMAT_NONE;
+    res->accept = _ref_uint(&pkt, COAP_OPT_ACCEPT);
+    res->block1 = _ref_uint(&pkt, COAP_OPT_BLOCK1);
+    res->block2 = _ref_uint(&pkt, COAP_OPT_BLOCK2);
+    value = _ref_find(&pkt, COAP_OPT_ETAG, &len);
+    res->etag_len = value ? (int)len : -1;
+    return 0;
+}
+
+static uint32_t _index_uint(coap_pkt_t *pkt, unsigned opt_num)
+{
+    uint32_t value = 0;
+
+    coap_get_option_uint(pkt, opt_num, &value);
+    return value;
+}
+
+static int _index_handle(_shape_t *shape, _result_t *res)
+{
+    coap_pkt_t pkt;
+    uint8_t *value;
+    ssize_t len;
+
+    if (coap_parse(&pkt, shape->buf, shape->len) < 0) {
+        return -1;
+    }
+    res->resource = -1;
+    for (unsigned i = 0; i < coap_resources_numof; i++) {
+        int cmp = coap_cmp_uri_path(&pkt, coap_resources[i].path);
+        if (cmp <= 0) {
+            res->resource = (cmp == 0) ? (int)i : -1;
+            break;
+        }
+    }
+    res->ct = coap_get_content_type(&pkt);
+    res->accept = _index_uint(&pkt, COAP_OPT_ACCEPT);
+    res->block1 = _index_uint(&pkt, COAP_OPT_BLOCK1);
+    res->block2 = _index_uint(&pkt, COAP_OPT_BLOCK2);
+    len = coap_opt_get_opaque(&pkt, COAP_OPT_ETAG, &value);
+    res->etag_len = (len < 0) ? -1 : (int)len;
+    return 0;
+}
+
+static uint32_t _run(_shape_t *shape, int (*handle)(_shape_t *, _result_t *),
+                     _result_t *res)
+{
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < ITERATIONS; i++) {
+        if (handle(shape, res) < 0) {
+            return UINT32_MAX;
+        }
+    }
+    return xtimer_now_usec() - start;
+}
+
+int main(void)
+{
+    puts("nanocoap parse benchmark");
+    _build();
+    for (unsigned s = 0; s < sizeof(_shapes) / sizeof(_shapes[0]); s++) {
+        _shape_t *shape = &_shapes[s];
+        _result_t ref_res, index_res;
+        uint32_t ref_us, index_us;
+        coap_pkt_t pkt;
+
+        memset(&ref_res, 0, sizeof(ref_res));
+        memset(&index_res, 0, sizeof(index_res));
+        ref_us = _run(shape, _ref_handle, &ref_res);
+        index_us = _run(shape, _index_handle, &index_res);
+        if ((ref_us == UINT32_MAX) || (index_us == UINT32_MAX) ||
+            (ref_res.resource < 0) ||
+            (memcmp(&ref_res, &index_res, sizeof(ref_res)) != 0)) {
+            printf("Wrong result for %s\n", shape->name);
+            puts("[FAILURE]");
+            return 1;
+        }
+        coap_parse(&pkt, shape->buf, shape->len);
+        printf("{ \"shape\" : \"%s\", \"options\" : %u, \"ref_us\" : %lu, "
+               "\"index_us\" : %lu }\n", shape->name,
+               (unsigned)pkt.options_len, (unsigned long)ref_us,
+               (unsigned long)index_us);
+    }
+    puts("[SUCCESS]");
+    return 0;
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark of the frame rate and latency of the native TAP
+ *              device
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "net/gnrc.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/hdr.h"
+#include "xtimer.h"
+
+#define PAYLOAD_LEN         (64U)
+/* frames in flight during the throughput run */
+#define WINDOW              (16U)
+#define LATENCY_RUNS        (1000U)
+#define RECV_TIMEOUT        (100U * US_PER_MS)
+#define MSG_QUEUE_SIZE      (32U)
+
+static msg_t _msg_queue[MSG_QUEUE_SIZE];
+
+static int _send(gnrc_netif_t *from, gnrc_netif_t *to)
+{
+    uint32_t now = xtimer_now_usec();
+    gnrc_pktsnip_t *pkt, *netif_hdr;
+
+    pkt = gnrc_pktbuf_add(NULL, NULL, PAYLOAD_LEN, GNRC_NETTYPE_UNDEF);
+    if (pkt == NULL) {
+        return -1;
+    }
+    memset(pkt->data, 0, PAYLOAD_LEN);
+    memcpy(pkt->data, &now, sizeof(now));
+    netif_hdr = gnrc_netif_hdr_build(NULL, 0, to->l2addr, to->l2addr_len);
+    if (netif_hdr == NULL) {
+        gnrc_pktbuf_release(pkt);
+        return -1;
+    }
+    ((gnrc_netif_hdr_t *)netif_hdr->data)->if_pid = from->pid;
+    LL_PREPEND(pkt, netif_hdr);
+    if (gnrc_netapi_send(from->pid, pkt) < 1) {
+        gnrc_pktbuf_release(pkt);
+        return -1;
+    }
+    return 0;
+}
+
+/* returns the time the received frame was sent or 0 on timeout */
+static uint32_t _recv(void)
+{
+    msg_t msg;
+
+    while (xtimer_msg_receive_timeout(&msg, RECV_TIMEOUT) >= 0) {
+        if (msg.type == GNRC_NETAPI_MSG_TYPE_RCV) {
+            gnrc_pktsnip_t *pkt = msg.content.ptr;
+            uint32_t sent = 0;
+
+            if (pkt->size >= sizeof(sent)) {
+                memcpy(&sent, pkt->data, sizeof(sent));
+            }
+            gnrc_pktbuf_release(pkt);
+            if (sent != 0) {
+                return sent;
+            }
+        }
+    }
+    return 0;
+}
+
+static int _throughput(gnrc_netif_t *from, gnrc_netif_t *to,
+                       unsigned *received, uint32_t *pps)
+{
+    uint32_t start = xtimer_now_usec();
+    unsigned sent = 0;
+
+    *received = 0;
+    while (sent < PACKETS_NUMOF) {
+        unsigned burst = 0;
+
+        for (; (burst < WINDOW) && (sent < PACKETS_NUMOF); burst++, sent++) {
+            if (_send(from, to) < 0) {
+                return -1;
+            }
+        }
+        for (; burst > 0; burst--) {
+            if (_recv() == 0) {
+                /* frame lost */
+                break;
+            }
+            (*received)++;
+        }
+    }
+    *pps = (uint32_t)(((uint64_t)*received * US_PER_SEC) /
+                      (xtimer_now_usec() - start));
+    return 0;
+}
+
+static int _latency(gnrc_netif_t *from, gnrc_netif_t *to, uint32_t *avg,
+                    uint32_t *max)
+{
+    uint64_t sum = 0;
+    unsigned received = 0;
+
+    *max = 0;
+    for (unsigned i = 0; i < LATENCY_RUNS; i++) {
+        uint32_t sent, lat;
+
+        if (_send(from, to) < 0) {
+            return -1;
+        }
+        if ((sent = _recv()) == 0) {
+            continue;
+        }
+        lat = xtimer_now_usec() - sent;
+        sum += lat;
+        received++;
+        if (lat > *max) {
+            *max = lat;
+        }
+    }
+    if (received == 0) {
+        return -1;
+    }
+    *avg = (uint32_t)(sum / received);
+    return 0;
+}
+
+int main(void)
+{
+    gnrc_netreg_entry_t entry = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
+                                                          sched_active_pid);
+    gnrc_netif_t *to = gnrc_netif_iter(NULL);
+    gnrc_netif_t *from = (to != NULL) ? gnrc_netif_iter(to) : NULL;
+    uint32_t pps, lat_avg, lat_max;
+    unsigned received;
+
+    puts("native TAP benchmark");
+    msg_init_queue(_msg_queue, MSG_QUEUE_SIZE);
+    if (from == NULL) {
+        puts("Two network interfaces are required");
+        puts("[FAILURE]");
+        return 1;
+    }
+    gnrc_netreg_register(GNRC_NETTYPE_UNDEF, &entry);
+    if ((_throughput(from, to, &received, &pps) < 0) ||
+        (_latency(from, to, &lat_avg, &lat_max) < 0)) {
+        puts("Unable to exchange frames");
+        puts("[FAILURE]");
+        return 1;
+    }
+    printf("{ \"backend\" : \"%s\", \"sent\" : %u, \"received\" : %u, "
+           "\"pps\" : %lu, \"latency_avg_us\" : %lu, "
+           "\"latency_max_us\" : %lu }\n", NATIVE_IO, (unsigned)PACKETS_NUMOF,
+           received, (unsigned long)pps, (unsigned long)lat_avg,
+           (unsigned long)lat_max);
+    puts("[SUCCESS]");
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark of a UDP echo server on a sock of its own and on
+ *              the UDP endpoint multiplexer
+ *
+ * @}
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "net/gnrc/udp_mux.h"
+#include "net/ipv6/addr.h"
+#include "net/sock/udp.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define CLIENT_PORT         (20000U)
+#define SOCK_PORT           (20001U)
+#define MUX_PORT            (20002U)
+#define SOCK_PRIO           (THREAD_PRIORITY_MAIN - 1)
+#define PAYLOAD_LEN         (32U)
+#define RECV_TIMEOUT        (100U * US_PER_MS)
+
+/* the server as the protocols ran it before: a thread with a sock and a
+ * receive buffer */
+static char _sock_stack[THREAD_STACKSIZE_DEFAULT];
+static sock_udp_t _sock_server;
+
+/* the server on the multiplexer: an endpoint */
+static gnrc_udp_mux_ep_t _mux_server;
+
+static void *_sock_thread(void *arg)
+{
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+    (void)arg;
+
+    local.port = SOCK_PORT;
+    if (sock_udp_create(&_sock_server, &local, NULL, 0) < 0) {
+        puts("error: unable to create server sock");
+        return NULL;
+    }
+    while (1) {
+        uint8_t buf[PAYLOAD_LEN];
+        sock_udp_ep_t remote;
+        ssize_t len = sock_udp_recv(&_sock_server, buf, sizeof(buf),
+                                    SOCK_NO_TIMEOUT, &remote);
+
+        if (len > 0) {
+            sock_udp_send(&_sock_server, buf, len, &remote);
+        }
+    }
+    return NULL;
+}
+
+static void _on_udp(gnrc_udp_mux_ep_t *ep, uint8_t *data, size_t len,
+                    const sock_udp_ep_t *remote)
+{
+    /* answers from the packet buffer */
+    gnrc_udp_mux_send(ep, data, len, remote);
+}
+
+/* sends ROUND_TRIPS messages to port, returns the time taken or UINT32_MAX
+ * if an echo was missing or wrong */
+static uint32_t _run(sock_udp_t *client, uint16_t port)
+{
+    sock_udp_ep_t remote = SOCK_IPV6_EP_ANY;
+    uint8_t out[PAYLOAD_LEN], in[PAYLOAD_LEN];
+    uint32_t start = xtimer_now_usec();
+
+    remote.port = port;
+    memcpy(remote.addr.ipv6, &ipv6_addr_loopback, sizeof(ipv6_addr_t));
+    memset(out, 0xa5, sizeof(out));
+    for (unsigned i = 0; i < ROUND_TRIPS; i++) {
+        memcpy(out, &i, sizeof(i));
+        if (sock_udp_send(client, out, sizeof(out), &remote) < 0) {
+            return UINT32_MAX;
+        }
+        if ((sock_udp_recv(client, in, sizeof(in), RECV_TIMEOUT,
+                           NULL) != sizeof(in)) ||
+            (memcmp(in, out, sizeof(in)) != 0)) {
+            return UINT32_MAX;
+        }
+    }
+    return xtimer_now_usec() - start;
+}
+
+static bool _print(const char *server, uint32_t us, size_t ram,
+                   size_t shared_ram)
+{
+    if (us == UINT32_MAX) {
+        printf("error: missing or wrong echo from %s server\n", server);
+        return false;
+    }
+    printf("{ \"server\" : \"%s\", \"round_trips\" : %u, \"us\" : %lu, "
+           "\"ram\" : %u, \"shared_ram\" : %u }\n", server, ROUND_TRIPS,
+           (unsigned long)us, (unsigned)ram, (unsigned)shared_ram);
+    return true;
+}
+
+int main(void)
+{
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+    sock_udp_t client;
+    bool ok = true;
+
+    puts("UDP multiplexer benchmark");
+    thread_create(_sock_stack, sizeof(_sock_stack), SOCK_PRIO,
+                  THREAD_CREATE_STACKTEST, _sock_thread, NULL, "sock_echo");
+    gnrc_udp_mux_init();
+    if (gnrc_udp_mux_add(&_mux_server, MUX_PORT, gnrc_udp_mux_queue(),
+                         _on_udp, NULL) < 0) {
+        puts("error: unable to register server endpoint");
+        puts("[FAILURE]");
+        return 1;
+    }
+
+    local.port = CLIENT_PORT;
+    if (sock_udp_create(&client, &local, NULL, 0) < 0) {
+        puts("error: unable to create client sock");
+        puts("[FAILURE]");
+        return 1;
+    }
+    /* RAM per server, and what all servers on the multiplexer share */
+    ok = _print("sock", _run(&client, SOCK_PORT),
+                sizeof(_sock_stack) + sizeof(_sock_server), 0) && ok;
+    ok = _print("mux", _run(&client, MUX_PORT), sizeof(_mux_server),
+                GNRC_UDP_MUX_STACK_SIZE +
+                (GNRC_UDP_MUX_MSG_QUEUE_SIZE * sizeof(msg_t))) && ok;
+    puts(ok ? "[SUCCESS]" : "[FAILURE]");
+    return 0;
+}
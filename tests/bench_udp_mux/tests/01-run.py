@@ -0,0 +1,22 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    for server in ("sock", "mux"):
+        child.expect(r"{ \"server\" : \"%s\", \"round_trips\" : \d+, "
+                     r"\"us\" : \d+, \"ram\" : \d+, \"shared_ram\" : \d+ }"
+                     % server)
+    child.expect_exact("[SUCCESS]")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc, timeout=60))
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Latency, throughput and duty-cycle measurements shared by the
+ *              test applications of the duty-cycling MAC protocols
+ *
+ * The applications add this module with
+ * `EXTERNAL_MODULE_DIRS += $(RIOTBASE)/tests/common/mac_bench` and
+ * `USEMODULE += mac_bench`.
+ */
+#ifndef MAC_BENCH_H
+#define MAC_BENCH_H
+
+#include "shell.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Shell commands `bench`, `bench_rx` and `duty`
+ */
+extern const shell_command_t mac_bench_commands[];
+
+/**
+ * @brief   Starts the thread that answers bench requests
+ *
+ * It receives all packets of @ref GNRC_NETTYPE_UNDEF and passes the ones
+ * that are not bench frames on to @ref net_gnrc_pktdump.
+ */
+void mac_bench_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAC_BENCH_H */
+/** @} */
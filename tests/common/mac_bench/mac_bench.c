@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Latency, throughput and duty-cycle measurements shared by the
+ *              test applications of the duty-cycling MAC protocols
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "msg.h"
+#include "mutex.h"
+#include "thread.h"
+
+#include "net/gnrc/pktdump.h"
+#include "net/gnrc.h"
+#include "net/gnrc/mac/types.h"
+#include "net/gnrc/netif/hdr.h"
+#include "utlist.h"
+#include "xtimer.h"
+
+#include "mac_bench.h"
+
+/* the MACs answer GNRC_MAC_TYPE_GET_DUTYCYCLE only when they record the
+ * radio-on time */
+#ifdef MODULE_GNRC_LWMAC
+#define MAC_BENCH_DUTYCYCLE_RECORD  (GNRC_LWMAC_ENABLE_DUTYCYLE_RECORD)
+#else
+#define MAC_BENCH_DUTYCYCLE_RECORD  (GNRC_MAC_ENABLE_DUTYCYCLE_RECORD)
+#endif
+
+#define BENCH_MAGIC             (0x474dU)
+#define BENCH_TYPE_REQUEST      (0U)
+#define BENCH_TYPE_REPLY        (1U)
+#define BENCH_MAX_SIZE          (100U)
+#define BENCH_REPLY_TIMEOUT_US  (5U * US_PER_SEC)
+#define BENCH_MSG_QUEUE_SIZE    (8U)
+
+/* header of the frames exchanged by the bench command */
+typedef struct __attribute__((packed)) {
+    uint16_t magic;
+    uint8_t type;
+    uint8_t reserved;
+    uint32_t seq;
+    uint32_t time;              /* send time of the request in us */
+} bench_hdr_t;
+
+static struct {
+    mutex_t lock;
+    uint32_t replies;
+    uint64_t rtt_sum;
+    uint32_t rtt_max;
+    uint32_t last_reply;
+    uint32_t requests;
+} _stats = { .lock = MUTEX_INIT };
+
+static char _bench_stack[THREAD_STACKSIZE_MAIN];
+static msg_t _bench_msg_queue[BENCH_MSG_QUEUE_SIZE];
+
+static int _bench_send(kernel_pid_t iface, uint8_t *addr, size_t addr_len,
+                       const bench_hdr_t *hdr, size_t size)
+{
+    gnrc_pktsnip_t *pkt, *netif_hdr;
+
+    pkt = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_UNDEF);
+    if (pkt == NULL) {
+        return -1;
+    }
+    memset(pkt->data, 0, size);
+    memcpy(pkt->data, hdr, sizeof(*hdr));
+    netif_hdr = gnrc_netif_hdr_build(NULL, 0, addr, addr_len);
+    if (netif_hdr == NULL) {
+        gnrc_pktbuf_release(pkt);
+        return -1;
+    }
+    LL_PREPEND(pkt, netif_hdr);
+    if (gnrc_netapi_send(iface, pkt) < 1) {
+        gnrc_pktbuf_release(pkt);
+        return -1;
+    }
+    return 0;
+}
+
+static bool _bench_handle(gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *netif_snip;
+    gnrc_netif_hdr_t *netif_hdr;
+    bench_hdr_t hdr;
+
+    if (pkt->size < sizeof(hdr)) {
+        return false;
+    }
+    memcpy(&hdr, pkt->data, sizeof(hdr));
+    if (hdr.magic != BENCH_MAGIC) {
+        return false;
+    }
+    netif_snip = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_NETIF);
+    if (netif_snip == NULL) {
+        return false;
+    }
+    netif_hdr = netif_snip->data;
+    if (hdr.type == BENCH_TYPE_REQUEST) {
+        mutex_lock(&_stats.lock);
+        _stats.requests++;
+        mutex_unlock(&_stats.lock);
+        /* echo the request, so the sender can measure the latency without
+         * synchronized clocks */
+        hdr.type = BENCH_TYPE_REPLY;
+        _bench_send(netif_hdr->if_pid, gnrc_netif_hdr_get_src_addr(netif_hdr),
+                    netif_hdr->src_l2addr_len, &hdr, pkt->size);
+    }
+    else if (hdr.type == BENCH_TYPE_REPLY) {
+        uint32_t now = xtimer_now_usec();
+        uint32_t rtt = now - hdr.time;
+
+        mutex_lock(&_stats.lock);
+        _stats.replies++;
+        _stats.rtt_sum += rtt;
+        if (rtt > _stats.rtt_max) {
+            _stats.rtt_max = rtt;
+        }
+        _stats.last_reply = now;
+        mutex_unlock(&_stats.lock);
+    }
+    gnrc_pktbuf_release(pkt);
+    return true;
+}
+
+static void *_bench_thread(void *arg)
+{
+    (void)arg;
+    msg_init_queue(_bench_msg_queue, BENCH_MSG_QUEUE_SIZE);
+
+    while (1) {
+        msg_t msg;
+
+        msg_receive(&msg);
+        if (msg.type != GNRC_NETAPI_MSG_TYPE_RCV) {
+            continue;
+        }
+        if (!_bench_handle(msg.content.ptr)) {
+            /* everything else is dumped as before */
+            if (msg_try_send(&msg, gnrc_pktdump_pid) < 1) {
+                gnrc_pktbuf_release(msg.content.ptr);
+            }
+        }
+    }
+    return NULL;
+}
+
+static int _bench(int argc, char **argv)
+{
+    gnrc_netif_t *netif = gnrc_netif_iter(NULL);
+    uint8_t addr[GNRC_NETIF_L2ADDR_MAXLEN];
+    size_t addr_len;
+    unsigned count, interval_ms, size = sizeof(bench_hdr_t);
+    uint32_t start, replies = 0, rtt_max, duration;
+    uint64_t rtt_sum, throughput = 0;
+
+    if (argc < 4) {
+        printf("usage: %s <L2 addr> <count> <interval in ms> [<size>]\n", argv[0]);
+        return 1;
+    }
+    addr_len = gnrc_netif_addr_from_str(argv[1], addr);
+    if ((netif == NULL) || (addr_len == 0)) {
+        puts("error: invalid address given");
+        return 1;
+    }
+    count = atoi(argv[2]);
+    interval_ms = atoi(argv[3]);
+    if (argc > 4) {
+        size = atoi(argv[4]);
+        if ((size < sizeof(bench_hdr_t)) || (size > BENCH_MAX_SIZE)) {
+            printf("error: size must be between %u and %u\n",
+                   (unsigned)sizeof(bench_hdr_t), BENCH_MAX_SIZE);
+            return 1;
+        }
+    }
+
+    mutex_lock(&_stats.lock);
+    _stats.replies = 0;
+    _stats.rtt_sum = 0;
+    _stats.rtt_max = 0;
+    mutex_unlock(&_stats.lock);
+
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < count; i++) {
+        bench_hdr_t hdr = { .magic = BENCH_MAGIC, .type = BENCH_TYPE_REQUEST,
+                            .seq = i, .time = xtimer_now_usec() };
+
+        if (_bench_send(netif->pid, addr, addr_len, &hdr, size) < 0) {
+            puts("error: unable to send");
+        }
+        xtimer_usleep(interval_ms * US_PER_MS);
+    }
+    /* wait until no more replies come in */
+    do {
+        uint32_t last = replies;
+
+        xtimer_usleep(BENCH_REPLY_TIMEOUT_US);
+        mutex_lock(&_stats.lock);
+        replies = _stats.replies;
+        mutex_unlock(&_stats.lock);
+        if (replies == last) {
+            break;
+        }
+    } while (replies < count);
+
+    mutex_lock(&_stats.lock);
+    replies = _stats.replies;
+    rtt_sum = _stats.rtt_sum;
+    rtt_max = _stats.rtt_max;
+    duration = _stats.last_reply - start;
+    mutex_unlock(&_stats.lock);
+
+    if ((replies > 0) && (duration > 0)) {
+        throughput = ((uint64_t)replies * size * 8 * US_PER_SEC) / duration;
+    }
+
+    printf("{ \"sent\" : %u, \"replies\" : %lu, \"latency_avg_us\" : %lu, "
+           "\"latency_max_us\" : %lu, \"throughput_bps\" : %lu }\n", count,
+           (unsigned long)replies,
+           (unsigned long)((replies > 0) ? (rtt_sum / replies) / 2 : 0),
+           (unsigned long)(rtt_max / 2), (unsigned long)throughput);
+    return 0;
+}
+
+static int _bench_rx(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    mutex_lock(&_stats.lock);
+    printf("{ \"requests\" : %lu }\n", (unsigned long)_stats.requests);
+    _stats.requests = 0;
+    mutex_unlock(&_stats.lock);
+    return 0;
+}
+
+static int _duty(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+#if (MAC_BENCH_DUTYCYCLE_RECORD == 1)
+    gnrc_netif_t *netif = gnrc_netif_iter(NULL);
+    msg_t msg;
+
+    if (netif == NULL) {
+        puts("error: no interface");
+        return 1;
+    }
+    /* the MAC prints its radio duty-cycle */
+    msg.type = GNRC_MAC_TYPE_GET_DUTYCYCLE;
+    msg_send(&msg, netif->pid);
+#else
+    puts("MAC: radio duty-cycle unavailable.");
+#endif
+    return 0;
+}
+
+const shell_command_t mac_bench_commands[] = {
+    { "bench", "measure latency and throughput to a neighbor", _bench },
+    { "bench_rx", "print and reset the number of received bench requests",
+      _bench_rx },
+    { "duty", "print the radio duty-cycle", _duty },
+    { NULL, NULL, NULL }
+};
+
+void mac_bench_init(void)
+{
+    static gnrc_netreg_entry_t dump;
+    kernel_pid_t pid = thread_create(_bench_stack, sizeof(_bench_stack),
+                                     THREAD_PRIORITY_MAIN - 1,
+                                     THREAD_CREATE_STACKTEST, _bench_thread,
+                                     NULL, "bench");
+
+    gnrc_netreg_entry_init_pid(&dump, GNRC_NETREG_DEMUX_CTX_ALL, pid);
+    gnrc_netreg_register(GNRC_NETTYPE_UNDEF, &dump);
+}
@@ -23,10 +23,15 @@
 
 #include "common.h"
 
+#include "at86rf2xx_internal.h"
 #include "od.h"
+#include "xtimer.h"
 
 #define _MAX_ADDR_LEN    (8)
 #define MAC_VECTOR_SIZE  (2) /* mhr + payload */
+#define SPITIME_HDR_LEN  (11) /* MHR with short addresses and PAN ID
+                               * compression */
+#define SPITIME_ROUNDS   (100)
 
 static size_t _parse_addr(uint8_t *out, size_t out_len, const char *in);
 static int send(int iface, le_uint16_t dst_pan, uint8_t *dst_addr,
@@ -179,6 +184,81 @@ int txtsnd(int argc, char **argv)
     return send(iface, pan, addr, res, text);
 }
 
+int spitime(int argc, char **argv)
+{
+    static uint8_t buf[AT86RF2XX_MAX_PKT_LENGTH];
+    at86rf2xx_t *dev;
+    int iface;
+    size_t size = AT86RF2XX_MAX_PKT_LENGTH - IEEE802154_FCS_LEN;
+    uint32_t start, load_us, load_iolist_us, read_us;
+    uint8_t old_state;
+
+    if (argc < 2) {
+        printf("usage: %s <iface> [<frame size>]\n", argv[0]);
+        return 1;
+    }
+    iface = atoi(argv[1]);
+    if (((unsigned)iface) > (AT86RF2XX_NUM - 1)) {
+        printf("spitime: %d is not an interface\n", iface);
+        return 1;
+    }
+    if (argc > 2) {
+        size = atoi(argv[2]);
+        if ((size <= SPITIME_HDR_LEN) ||
+            (size > (AT86RF2XX_MAX_PKT_LENGTH - IEEE802154_FCS_LEN))) {
+            printf("spitime: frame size must be between %u and %u\n",
+                   SPITIME_HDR_LEN + 1,
+                   AT86RF2XX_MAX_PKT_LENGTH - IEEE802154_FCS_LEN);
+            return 1;
+        }
+    }
+    dev = &devs[iface];
+
+    iolist_t iol_data = {
+        .iol_base = &buf[SPITIME_HDR_LEN],
+        .iol_len = size - SPITIME_HDR_LEN
+    };
+    iolist_t iol_hdr = {
+        .iol_next = &iol_data,
+        .iol_base = buf,
+        .iol_len = SPITIME_HDR_LEN
+    };
+
+    /* no reception may overwrite the frame buffer in between */
+    old_state = at86rf2xx_set_state(dev, AT86RF2XX_STATE_TRX_OFF);
+
+    /* frame upload with one SPI transaction per part of the frame */
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < SPITIME_ROUNDS; i++) {
+        for (const iolist_t *iol = &iol_hdr; iol; iol = iol->iol_next) {
+            at86rf2xx_sram_write(dev, 1 + ((uint8_t *)iol->iol_base - buf),
+                                 iol->iol_base, iol->iol_len);
+        }
+    }
+    load_us = (xtimer_now_usec() - start) / SPITIME_ROUNDS;
+
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < SPITIME_ROUNDS; i++) {
+        dev->tx_frame_len = IEEE802154_FCS_LEN;
+        at86rf2xx_tx_load_iolist(dev, &iol_hdr, 0);
+    }
+    load_iolist_us = (xtimer_now_usec() - start) / SPITIME_ROUNDS;
+
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < SPITIME_ROUNDS; i++) {
+        at86rf2xx_sram_read(dev, 1, buf, size);
+    }
+    read_us = (xtimer_now_usec() - start) / SPITIME_ROUNDS;
+
+    at86rf2xx_set_state(dev, old_state);
+
+    printf("{ \"size\" : %u, \"load_per_part_us\" : %lu, "
+           "\"load_iolist_us\" : %lu, \"read_us\" : %lu }\n", (unsigned)size,
+           (unsigned long)load_us, (unsigned long)load_iolist_us,
+           (unsigned long)read_us);
+    return 0;
+}
+
 static inline int _dehex(char c, int default_)
 {
     if ('0' <= c && c <= '9') {
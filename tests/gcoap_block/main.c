@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Throughput test for block-wise transfers with gcoap
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "net/gcoap.h"
+#include "shell.h"
+#include "xtimer.h"
+
+#define CHUNK_SIZE          (16U)
+
+static ssize_t _file_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             void *ctx);
+static ssize_t _slicer_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                               void *ctx);
+static ssize_t _upload_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                               void *ctx);
+
+static const coap_resource_t _resources[] = {
+    { "/file", COAP_GET, _file_handler, NULL },
+    { "/slicer", COAP_GET, _slicer_handler, NULL },
+    { "/upload", COAP_PUT, _upload_handler, NULL },
+};
+
+static gcoap_listener_t _listener = {
+    &_resources[0],
+    sizeof(_resources) / sizeof(_resources[0]),
+    NULL
+};
+
+/* received by the server on /upload */
+static struct {
+    size_t bytes;
+    unsigned errors;
+} _upload;
+
+/* received by the client */
+static struct {
+    mutex_t lock;
+    size_t bytes;
+    unsigned errors;
+} _download = { .lock = MUTEX_INIT };
+
+/* content of the representations, so each side can verify it */
+static inline uint8_t _pattern(size_t offset)
+{
+    return (uint8_t)(offset ^ (offset >> 8));
+}
+
+static ssize_t _read_pattern(void *arg, size_t offset, uint8_t *buf,
+                             size_t len)
+{
+    size_t size = *(size_t *)arg;
+
+    if (offset >= size) {
+        return 0;
+    }
+    if (len > size - offset) {
+        len = size - offset;
+    }
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = _pattern(offset + i);
+    }
+    return len;
+}
+
+static unsigned _verify(size_t offset, const uint8_t *data, size_t len)
+{
+    unsigned errors = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        if (data[i] != _pattern(offset + i)) {
+            errors++;
+        }
+    }
+    return errors;
+}
+
+static ssize_t _file_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             void *ctx)
+{
+    (void)ctx;
+    static size_t size = FILE_SIZE;
+
+    return gcoap_block2_resp(pdu, buf, len, COAP_FORMAT_OCTET, _read_pattern,
+                             &size);
+}
+
+/* the same representation with the block slicer of nanocoap, which
+ * generates the whole representation for each block */
+static ssize_t _slicer_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                               void *ctx)
+{
+    (void)ctx;
+    coap_block_slicer_t slicer;
+    uint8_t chunk[CHUNK_SIZE];
+    uint8_t *payload = buf + coap_get_total_hdr_len(pdu);
+    uint8_t *bufpos = payload;
+
+    coap_block2_init(pdu, &slicer);
+    bufpos += coap_put_option_ct(bufpos, 0, COAP_FORMAT_OCTET);
+    bufpos += coap_opt_put_block2(bufpos, COAP_OPT_CONTENT_FORMAT, &slicer, 1);
+    *bufpos++ = 0xff;
+
+    for (size_t offset = 0; offset < FILE_SIZE; offset += CHUNK_SIZE) {
+        for (unsigned i = 0; i < CHUNK_SIZE; i++) {
+            chunk[i] = _pattern(offset + i);
+        }
+        bufpos += coap_blockwise_put_bytes(&slicer, bufpos, chunk, CHUNK_SIZE);
+    }
+    return coap_block2_build_reply(pdu, COAP_CODE_205, buf, len,
+                                   bufpos - payload, &slicer);
+}
+
+static int _write_upload(void *arg, size_t offset, const uint8_t *data,
+                         size_t len, bool more)
+{
+    (void)arg;
+    if (offset == 0) {
+        _upload.bytes = 0;
+        _upload.errors = 0;
+    }
+    _upload.bytes += len;
+    _upload.errors += _verify(offset, data, len);
+    if (!more) {
+        printf("{ \"upload\" : %u, \"errors\" : %u }\n",
+               (unsigned)_upload.bytes, _upload.errors);
+    }
+    return 0;
+}
+
+static ssize_t _upload_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                               void *ctx)
+{
+    (void)ctx;
+    return gcoap_block1_resp(pdu, buf, len, COAP_CODE_CHANGED, _write_upload,
+                             NULL);
+}
+
+static int _write_download(void *arg, size_t offset, const uint8_t *data,
+                           size_t len, bool more)
+{
+    (void)arg;
+    (void)more;
+    mutex_lock(&_download.lock);
+    _download.bytes += len;
+    _download.errors += _verify(offset, data, len);
+    mutex_unlock(&_download.lock);
+    return 0;
+}
+
+static void _print(const char *path, ssize_t res, unsigned errors,
+                   unsigned window, uint32_t duration)
+{
+    if (res < 0) {
+        printf("error: transfer failed: %d\n", (int)res);
+        return;
+    }
+    printf("{ \"path\" : \"%s\", \"bytes\" : %u, \"errors\" : %u, "
+           "\"window\" : %u, \"duration_ms\" : %lu, \"kib_per_s\" : %lu }\n",
+           path, (unsigned)res, errors, window,
+           (unsigned long)(duration / US_PER_MS),
+           (unsigned long)(((uint64_t)res * US_PER_SEC) /
+                           ((duration ? duration : 1) * 1024ULL)));
+}
+
+static int _parse_remote(sock_udp_ep_t *remote, const char *addr)
+{
+    remote->family = AF_INET6;
+    remote->netif = SOCK_ADDR_ANY_NETIF;
+    remote->port = GCOAP_PORT;
+    if (ipv6_addr_from_str((ipv6_addr_t *)&remote->addr.ipv6, addr) == NULL) {
+        puts("error: invalid address");
+        return -1;
+    }
+    return 0;
+}
+
+static int _get(int argc, char **argv)
+{
+    gcoap_block_xfer_t xfer = {
+        .method = COAP_METHOD_GET,
+        .format = COAP_FORMAT_NONE,
+        .write = _write_download,
+    };
+    uint32_t start, duration;
+    ssize_t res;
+
+    if (argc < 4) {
+        printf("usage: %s <addr> </file|/slicer> <window>\n", argv[0]);
+        return 1;
+    }
+    if (_parse_remote(&xfer.remote, argv[1]) < 0) {
+        return 1;
+    }
+    xfer.path = argv[2];
+    xfer.window = atoi(argv[3]);
+
+    mutex_lock(&_download.lock);
+    _download.bytes = 0;
+    _download.errors = 0;
+    mutex_unlock(&_download.lock);
+
+    start = xtimer_now_usec();
+    res = gcoap_block_xfer(&xfer);
+    duration = xtimer_now_usec() - start;
+
+    mutex_lock(&_download.lock);
+    _print(xfer.path, res, _download.errors, xfer.window, duration);
+    mutex_unlock(&_download.lock);
+    return 0;
+}
+
+static int _put(int argc, char **argv)
+{
+    size_t size;
+    gcoap_block_xfer_t xfer = {
+        .path = "/upload",
+        .method = COAP_METHOD_PUT,
+        .format = COAP_FORMAT_OCTET,
+        .read = _read_pattern,
+        .arg = &size,
+    };
+    uint32_t start, duration;
+    ssize_t res;
+
+    if (argc < 4) {
+        printf("usage: %s <addr> <size> <window>\n", argv[0]);
+        return 1;
+    }
+    if (_parse_remote(&xfer.remote, argv[1]) < 0) {
+        return 1;
+    }
+    size = atoi(argv[2]);
+    xfer.window = atoi(argv[3]);
+
+    start = xtimer_now_usec();
+    res = gcoap_block_xfer(&xfer);
+    duration = xtimer_now_usec() - start;
+
+    _print(xfer.path, res, 0, xfer.window, duration);
+    return 0;
+}
+
+static const shell_command_t _commands[] = {
+    { "get", "download a resource of a peer block-wise", _get },
+    { "put", "upload to /upload of a peer block-wise", _put },
+    { NULL, NULL, NULL }
+};
+
+int main(void)
+{
+    gcoap_register_listener(&_listener);
+    puts("gcoap block-wise transfer test");
+
+    char line_buf[SHELL_DEFAULT_BUFSIZE];
+    shell_run(_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
+
+    return 0;
+}
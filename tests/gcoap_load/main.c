@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Load test for gcoap with fast and slow resources
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "assert.h"
+#include "msg.h"
+#include "mutex.h"
+#include "net/gcoap.h"
+#include "net/sock/util.h"
+#include "shell.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define SLOW_DELAY_US       (50U * US_PER_MS)
+#define MAX_SAMPLES         (256U)
+#define MAIN_QUEUE_SIZE     (8U)
+#define WORKER_QUEUE_SIZE   (GCOAP_REQ_CTX_MAX)
+#define MSG_TYPE_DONE       (0x4c01)
+
+typedef struct {
+    uint8_t token[GCOAP_TOKENLEN];
+    uint32_t start;
+    bool slow;
+    bool used;
+} _pending_t;
+
+typedef struct {
+    uint32_t us[MAX_SAMPLES];
+    unsigned numof;
+} _samples_t;
+
+static ssize_t _fast_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             void *ctx);
+static ssize_t _slow_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             void *ctx);
+
+static const coap_resource_t _resources[] = {
+    { "/fast", COAP_GET, _fast_handler, NULL },
+    { "/slow", COAP_GET, _slow_handler, NULL },
+};
+
+static gcoap_listener_t _listener = {
+    &_resources[0],
+    sizeof(_resources) / sizeof(_resources[0]),
+    NULL
+};
+
+static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
+static kernel_pid_t _main_pid;
+static mutex_t _lock = MUTEX_INIT;
+static _pending_t _pending[GCOAP_REQ_WAITING_MAX];
+static _samples_t _fast, _slow;
+static unsigned _timeouts;
+
+#if SEPARATE_RESPONSE
+static char _worker_stack[THREAD_STACKSIZE_DEFAULT];
+static msg_t _worker_msg_queue[WORKER_QUEUE_SIZE];
+static kernel_pid_t _worker_pid;
+
+static void *_worker(void *arg)
+{
+    (void)arg;
+    msg_init_queue(_worker_msg_queue, WORKER_QUEUE_SIZE);
+
+    while (1) {
+        uint8_t buf[GCOAP_PDU_BUF_SIZE];
+        coap_pkt_t pdu;
+        msg_t msg;
+
+        msg_receive(&msg);
+        gcoap_req_ctx_t *ctx = msg.content.ptr;
+
+        /* the slow part, e.g. reading a sensor */
+        xtimer_usleep(SLOW_DELAY_US);
+        gcoap_resp_init_deferred(ctx, &pdu, buf, sizeof(buf),
+                                 COAP_CODE_CONTENT);
+        memcpy(pdu.payload, "slow", 4);
+        ssize_t len = gcoap_finish(&pdu, 4, COAP_FORMAT_TEXT);
+        gcoap_resp_send_deferred(ctx, buf, len);
+    }
+    return NULL;
+}
+#endif
+
+static ssize_t _fast_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             void *ctx)
+{
+    (void)ctx;
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    memcpy(pdu->payload, "fast", 4);
+    return gcoap_finish(pdu, 4, COAP_FORMAT_TEXT);
+}
+
+static ssize_t _slow_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             void *ctx)
+{
+    (void)ctx;
+#if SEPARATE_RESPONSE
+    gcoap_req_ctx_t *req_ctx;
+    msg_t msg;
+    ssize_t res = gcoap_resp_defer(pdu, buf, len, &req_ctx);
+
+    if (res < 0) {
+        return gcoap_response(pdu, buf, len, COAP_CODE_SERVICE_UNAVAILABLE);
+    }
+    msg.content.ptr = req_ctx;
+    if (msg_try_send(&msg, _worker_pid) < 1) {
+        /* the worker queue holds as many as there are contexts */
+        assert(false);
+    }
+    return res;
+#else
+    xtimer_usleep(SLOW_DELAY_US);
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    memcpy(pdu->payload, "slow", 4);
+    return gcoap_finish(pdu, 4, COAP_FORMAT_TEXT);
+#endif
+}
+
+static void _add_sample(_samples_t *samples, uint32_t us)
+{
+    if (samples->numof < MAX_SAMPLES) {
+        samples->us[samples->numof++] = us;
+    }
+}
+
+static void _resp_handler(unsigned req_state, coap_pkt_t *pdu,
+                          sock_udp_ep_t *remote)
+{
+    (void)remote;
+    uint8_t *token = coap_hdr_data_ptr(pdu->hdr);
+    uint32_t now = xtimer_now_usec();
+    msg_t msg = { .type = MSG_TYPE_DONE };
+
+    mutex_lock(&_lock);
+    for (unsigned i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
+        if (_pending[i].used &&
+            (memcmp(_pending[i].token, token, GCOAP_TOKENLEN) == 0)) {
+            if (req_state == GCOAP_MEMO_RESP) {
+                _add_sample(_pending[i].slow ? &_slow : &_fast,
+                            now - _pending[i].start);
+            }
+            else {
+                _timeouts++;
+            }
+            _pending[i].used = false;
+            break;
+        }
+    }
+    mutex_unlock(&_lock);
+    msg_try_send(&msg, _main_pid);
+}
+
+static int _cmp(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static uint32_t _percentile(_samples_t *samples, unsigned p)
+{
+    if (samples->numof == 0) {
+        return 0;
+    }
+    qsort(samples->us, samples->numof, sizeof(samples->us[0]), _cmp);
+    return samples->us[((samples->numof - 1) * p) / 100];
+}
+
+static int _send(const sock_udp_ep_t *remote, bool slow, bool con)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    _pending_t *pending = NULL;
+    ssize_t len = gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_GET,
+                                slow ? "/slow" : "/fast");
+
+    if (con) {
+        coap_hdr_set_type(pdu.hdr, COAP_TYPE_CON);
+    }
+    mutex_lock(&_lock);
+    for (unsigned i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
+        if (!_pending[i].used) {
+            pending = &_pending[i];
+            pending->used = true;
+            pending->slow = slow;
+            memcpy(pending->token, pdu.token, GCOAP_TOKENLEN);
+            pending->start = xtimer_now_usec();
+            break;
+        }
+    }
+    mutex_unlock(&_lock);
+    if (pending == NULL) {
+        return -1;
+    }
+    if (gcoap_req_send2(buf, len, remote, _resp_handler) == 0) {
+        mutex_lock(&_lock);
+        pending->used = false;
+        mutex_unlock(&_lock);
+        return -1;
+    }
+    return 0;
+}
+
+static int _load(int argc, char **argv)
+{
+    sock_udp_ep_t remote = { .family = AF_INET6, .port = GCOAP_PORT };
+    unsigned count, window, slow_pct, sent = 0, done = 0, failed = 0;
+    bool con = false;
+    uint32_t start, duration;
+
+    if (argc < 5) {
+        printf("usage: %s <addr> <count> <window> <slow %%> [con]\n", argv[0]);
+        return 1;
+    }
+    if (ipv6_addr_from_str((ipv6_addr_t *)&remote.addr.ipv6, argv[1]) == NULL) {
+        puts("error: invalid address");
+        return 1;
+    }
+    count = atoi(argv[2]);
+    window = atoi(argv[3]);
+    slow_pct = atoi(argv[4]);
+    con = (argc > 5) && (strcmp(argv[5], "con") == 0);
+    if ((window == 0) || (window > GCOAP_REQ_WAITING_MAX)) {
+        printf("error: window must be between 1 and %u\n",
+               GCOAP_REQ_WAITING_MAX);
+        return 1;
+    }
+
+    mutex_lock(&_lock);
+    _fast.numof = 0;
+    _slow.numof = 0;
+    _timeouts = 0;
+    mutex_unlock(&_lock);
+
+    start = xtimer_now_usec();
+    while (done < count) {
+        while ((sent < count) && ((sent - done) < window)) {
+            /* spread the slow requests evenly */
+            bool slow = ((sent * slow_pct) % 100) + slow_pct > 99;
+
+            if (_send(&remote, slow, con) < 0) {
+                failed++;
+                done++;
+            }
+            sent++;
+        }
+        if (done < count) {
+            msg_t msg;
+
+            msg_receive(&msg);
+            if (msg.type == MSG_TYPE_DONE) {
+                done++;
+            }
+        }
+    }
+    duration = xtimer_now_usec() - start;
+
+    mutex_lock(&_lock);
+    printf("{ \"requests\" : %u, \"failed\" : %u, \"timeouts\" : %u, "
+           "\"duration_ms\" : %lu, \"req_per_s\" : %lu, "
+           "\"fast_p50_us\" : %lu, \"fast_p99_us\" : %lu, "
+           "\"slow_p50_us\" : %lu, \"slow_p99_us\" : %lu }\n",
+           count, failed, _timeouts, (unsigned long)(duration / US_PER_MS),
+           (unsigned long)(((uint64_t)(count - failed - _timeouts) * US_PER_SEC)
+                           / (duration ? duration : 1)),
+           (unsigned long)_percentile(&_fast, 50),
+           (unsigned long)_percentile(&_fast, 99),
+           (unsigned long)_percentile(&_slow, 50),
+           (unsigned long)_percentile(&_slow, 99));
+    mutex_unlock(&_lock);
+    return 0;
+}
+
+static const shell_command_t _commands[] = {
+    { "load", "send GET requests to /fast and /slow of a peer", _load },
+    { NULL, NULL, NULL }
+};
+
+int main(void)
+{
+    msg_init_queue(_main_msg_queue, MAIN_QUEUE_SIZE);
+    _main_pid = thread_getpid();
+#if SEPARATE_RESPONSE
+    _worker_pid = thread_create(_worker_stack, sizeof(_worker_stack),
+                                THREAD_PRIORITY_MAIN - 1,
+                                THREAD_CREATE_STACKTEST, _worker, NULL,
+                                "worker");
+#endif
+    gcoap_register_listener(&_listener);
+    puts("gcoap load test");
+
+    char line_buf[SHELL_DEFAULT_BUFSIZE];
+    shell_run(_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
+
+    return 0;
+}
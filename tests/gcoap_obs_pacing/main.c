@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test for the pacing of gcoap Observe notifications
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "net/gcoap.h"
+#include "net/sock/udp.h"
+#include "xtimer.h"
+
+#define OBSERVERS           (2U)
+#define CLIENT_PORT         (10000U)
+#define RECV_TIMEOUT_US     (100U * US_PER_MS)
+/* a pending notification is sent at the end of the interval, at the latest
+ * when the limited wait of the gcoap thread for a request times out */
+#define PENDING_TIMEOUT_US  ((GCOAP_OBS_NOTIFY_INTERVAL_MS * US_PER_MS) + \
+                             GCOAP_RECV_TIMEOUT + RECV_TIMEOUT_US)
+#define PAYLOAD_LEN         (16U)
+
+typedef struct {
+    sock_udp_t sock;
+    uint8_t token[GCOAP_TOKENLEN];
+    uint32_t observe_value;
+    bool observed;
+} _client_t;
+
+static ssize_t _obs_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                            void *ctx);
+
+static const coap_resource_t _resources[] = {
+    { "/obs", COAP_GET, _obs_handler, NULL },
+};
+
+static gcoap_listener_t _listener = {
+    &_resources[0],
+    sizeof(_resources) / sizeof(_resources[0]),
+    NULL
+};
+
+static _client_t _clients[OBSERVERS];
+/* 0 is kept for no notification */
+static uint32_t _value = 1;
+
+static ssize_t _obs_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                            void *ctx)
+{
+    (void)ctx;
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    size_t payload_len = snprintf((char *)pdu->payload, PAYLOAD_LEN,
+                                  "%lu", (unsigned long)_value);
+    return gcoap_finish(pdu, payload_len, COAP_FORMAT_TEXT);
+}
+
+/* value of the notification received by a client, or 0 if none */
+static uint32_t _receive(_client_t *client, uint32_t timeout)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    ssize_t len = sock_udp_recv(&client->sock, buf, sizeof(buf) - 1, timeout,
+                                NULL);
+
+    if ((len <= 0) || (coap_parse(&pdu, buf, len) < 0) ||
+        (coap_get_token_len(&pdu) != GCOAP_TOKENLEN) ||
+        (memcmp(pdu.token, client->token, GCOAP_TOKENLEN) != 0) ||
+        !coap_has_observe(&pdu) || (pdu.payload_len == 0)) {
+        return 0;
+    }
+    /* a client drops a notification with an older Observe value, see
+     * RFC 7641, section 3.4 */
+    if (client->observed &&
+        (((coap_get_observe(&pdu) - client->observe_value) & 0xFFFFFF) >
+         0x7FFFFF)) {
+        puts("error: notification out of order");
+        return 0;
+    }
+    client->observe_value = coap_get_observe(&pdu);
+    client->observed = true;
+    buf[len] = '\0';
+    return strtoul((char *)pdu.payload, NULL, 10);
+}
+
+static int _register(void)
+{
+    sock_udp_ep_t server = SOCK_IPV6_EP_ANY;
+
+    server.port = GCOAP_PORT;
+    ipv6_addr_set_loopback((ipv6_addr_t *)&server.addr.ipv6);
+
+    for (unsigned i = 0; i < OBSERVERS; i++) {
+        _client_t *client = &_clients[i];
+        uint8_t buf[GCOAP_PDU_BUF_SIZE];
+        coap_pkt_t pdu;
+
+        gcoap_req_init(&pdu, buf, sizeof(buf), COAP_METHOD_GET, NULL);
+        coap_hdr_set_type(pdu.hdr, COAP_TYPE_NON);
+        coap_opt_add_uint(&pdu, COAP_OPT_OBSERVE, COAP_OBS_REGISTER);
+        coap_opt_add_string(&pdu, COAP_OPT_URI_PATH, "/obs", '/');
+        memcpy(client->token, pdu.token, GCOAP_TOKENLEN);
+        ssize_t len = gcoap_finish(&pdu, 0, COAP_FORMAT_NONE);
+
+        if ((sock_udp_send(&client->sock, buf, len, &server) <= 0) ||
+            (_receive(client, RECV_TIMEOUT_US) != _value)) {
+            printf("error: registration of observer %u failed\n", i);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static unsigned _notify(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+
+    _value++;
+    if (gcoap_obs_init_all(&pdu, buf, sizeof(buf),
+                           &_resources[0]) != GCOAP_OBS_INIT_OK) {
+        return 0;
+    }
+    size_t payload_len = snprintf((char *)pdu.payload, PAYLOAD_LEN,
+                                  "%lu", (unsigned long)_value);
+    ssize_t len = gcoap_finish(&pdu, payload_len, COAP_FORMAT_TEXT);
+    unsigned sent = gcoap_obs_send_all(buf, len, &_resources[0]);
+
+    printf("notify %lu: sent to %u observers\n", (unsigned long)_value, sent);
+    return sent;
+}
+
+/* number of clients, which received a notification with value */
+static unsigned _receive_all(uint32_t value, uint32_t timeout)
+{
+    unsigned received = 0;
+
+    for (unsigned i = 0; i < OBSERVERS; i++) {
+        if (_receive(&_clients[i], timeout) == value) {
+            received++;
+        }
+    }
+    return received;
+}
+
+static int _test(void)
+{
+    if (_register() < 0) {
+        return -1;
+    }
+    /* the first notification to each client is not delayed */
+    if ((_notify() != OBSERVERS) ||
+        (_receive_all(_value, RECV_TIMEOUT_US) != OBSERVERS)) {
+        puts("error: first notification not received");
+        return -1;
+    }
+    /* within the interval, only the latest state is kept for the clients */
+    if ((_notify() != 0) || (_notify() != 0)) {
+        puts("error: notification sent within the interval");
+        return -1;
+    }
+    unsigned received = _receive_all(_value, PENDING_TIMEOUT_US);
+
+    printf("pending: received %lu by %u observers\n", (unsigned long)_value,
+           received);
+    if (received != OBSERVERS) {
+        puts("error: pending notification not received");
+        return -1;
+    }
+    /* the pending notification is sent only once */
+    if (_receive_all(_value, PENDING_TIMEOUT_US) != 0) {
+        puts("error: pending notification received twice");
+        return -1;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+
+    gcoap_register_listener(&_listener);
+    for (unsigned i = 0; i < OBSERVERS; i++) {
+        local.port = CLIENT_PORT + i;
+        if (sock_udp_create(&_clients[i].sock, &local, NULL, 0) < 0) {
+            printf("error: unable to create client %u\n", i);
+            return 1;
+        }
+    }
+
+    puts("gcoap observe pacing test");
+    puts((_test() == 0) ? "[SUCCESS]" : "[FAILED]");
+
+    return 0;
+}
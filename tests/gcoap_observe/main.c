@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark for gcoap Observe notifications to many observers
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "net/gcoap.h"
+#include "net/sock/udp.h"
+#include "shell.h"
+#include "xtimer.h"
+
+#define CLIENT_PORT         (10000U)
+#define REFERENCE_PORT      (GCOAP_PORT + 1)
+#define RECV_TIMEOUT_US     (100U * US_PER_MS)
+#define PAYLOAD_LEN         (16U)
+
+typedef struct {
+    sock_udp_t sock;
+    uint8_t token[GCOAP_TOKENLEN];
+    bool registered;
+} _client_t;
+
+static ssize_t _obs_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                            void *ctx);
+
+static const coap_resource_t _resources[] = {
+    { "/obs", COAP_GET, _obs_handler, NULL },
+};
+
+static gcoap_listener_t _listener = {
+    &_resources[0],
+    sizeof(_resources) / sizeof(_resources[0]),
+    NULL
+};
+
+static _client_t _clients[OBSERVERS];
+static sock_udp_t _reference_sock;
+static uint32_t _value;
+
+static ssize_t _obs_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                            void *ctx)
+{
+    (void)ctx;
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    size_t payload_len = snprintf((char *)pdu->payload, PAYLOAD_LEN,
+                                  "%015lu", (unsigned long)_value);
+    return gcoap_finish(pdu, payload_len, COAP_FORMAT_TEXT);
+}
+
+/* number of clients, which received a notification */
+static unsigned _receive_all(void)
+{
+    unsigned received = 0;
+
+    for (unsigned i = 0; i < OBSERVERS; i++) {
+        uint8_t buf[GCOAP_PDU_BUF_SIZE];
+
+        if (sock_udp_recv(&_clients[i].sock, buf, sizeof(buf),
+                          RECV_TIMEOUT_US, NULL) > 0) {
+            received++;
+        }
+    }
+    return received;
+}
+
+static int _register(void)
+{
+    sock_udp_ep_t server = SOCK_IPV6_EP_ANY;
+
+    server.port = GCOAP_PORT;
+    ipv6_addr_set_loopback((ipv6_addr_t *)&server.addr.ipv6);
+
+    for (unsigned i = 0; i < OBSERVERS; i++) {
+        _client_t *client = &_clients[i];
+        uint8_t buf[GCOAP_PDU_BUF_SIZE];
+        coap_pkt_t pdu;
+
+        if (client->registered) {
+            continue;
+        }
+        gcoap_req_init(&pdu, buf, sizeof(buf), COAP_METHOD_GET, NULL);
+        coap_opt_add_uint(&pdu, COAP_OPT_OBSERVE, COAP_OBS_REGISTER);
+        coap_opt_add_string(&pdu, COAP_OPT_URI_PATH, "/obs", '/');
+        memcpy(client->token, pdu.token, GCOAP_TOKENLEN);
+        ssize_t len = gcoap_finish(&pdu, 0, COAP_FORMAT_NONE);
+
+        if ((sock_udp_send(&client->sock, buf, len, &server) <= 0) ||
+            (sock_udp_recv(&client->sock, buf, sizeof(buf), RECV_TIMEOUT_US,
+                           NULL) <= 0)) {
+            printf("error: registration of observer %u failed\n", i);
+            return -1;
+        }
+        client->registered = true;
+    }
+    return 0;
+}
+
+/* sends a notification encoded once to all observers */
+static unsigned _notify_shared(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+
+    if (gcoap_obs_init_all(&pdu, buf, sizeof(buf),
+                           &_resources[0]) != GCOAP_OBS_INIT_OK) {
+        return 0;
+    }
+    size_t payload_len = snprintf((char *)pdu.payload, PAYLOAD_LEN,
+                                  "%015lu", (unsigned long)_value);
+    ssize_t len = gcoap_finish(&pdu, payload_len, COAP_FORMAT_TEXT);
+
+    return gcoap_obs_send_all(buf, len, &_resources[0]);
+}
+
+/* encodes the notification again for each observer, as gcoap_obs_init() and
+ * gcoap_obs_send() do for a single one */
+static unsigned _notify_reference(void)
+{
+    unsigned sent = 0;
+
+    for (unsigned i = 0; i < OBSERVERS; i++) {
+        sock_udp_ep_t remote;
+        uint8_t buf[GCOAP_PDU_BUF_SIZE];
+        coap_pkt_t pdu;
+
+        sock_udp_get_local(&_clients[i].sock, &remote);
+        ipv6_addr_set_loopback((ipv6_addr_t *)&remote.addr.ipv6);
+        pdu.hdr = (coap_hdr_t *)buf;
+        ssize_t hdrlen = coap_build_hdr(pdu.hdr, COAP_TYPE_NON,
+                                        _clients[i].token, GCOAP_TOKENLEN,
+                                        COAP_CODE_CONTENT, i);
+        coap_pkt_init(&pdu, buf, sizeof(buf), hdrlen);
+        coap_opt_add_uint(&pdu, COAP_OPT_OBSERVE,
+                          (xtimer_now_usec() >> GCOAP_OBS_TICK_EXPONENT)
+                          & 0xFFFFFF);
+        size_t payload_len = snprintf((char *)pdu.payload, PAYLOAD_LEN,
+                                      "%015lu", (unsigned long)_value);
+        ssize_t len = gcoap_finish(&pdu, payload_len, COAP_FORMAT_TEXT);
+
+        if (sock_udp_send(&_reference_sock, buf, len, &remote) > 0) {
+            sent++;
+        }
+    }
+    return sent;
+}
+
+static void _run(const char *name, unsigned (*notify)(void), unsigned rounds)
+{
+    uint32_t send_us = 0;
+    unsigned sent = 0, received = 0;
+
+    for (unsigned i = 0; i < rounds; i++) {
+        _value++;
+        uint32_t start = xtimer_now_usec();
+        sent += notify();
+        send_us += xtimer_now_usec() - start;
+        received += _receive_all();
+    }
+    printf("{ \"mode\" : \"%s\", \"observers\" : %u, \"rounds\" : %u, "
+           "\"sent\" : %u, \"received\" : %u, \"send_us_per_round\" : %lu, "
+           "\"send_us_per_notification\" : %lu }\n", name, OBSERVERS, rounds,
+           sent, received, (unsigned long)(send_us / rounds),
+           (unsigned long)(sent ? send_us / sent : 0));
+}
+
+static int _bench(int argc, char **argv)
+{
+    unsigned rounds = (argc > 1) ? (unsigned)atoi(argv[1]) : 10;
+
+    if (rounds == 0) {
+        printf("usage: %s [<rounds>]\n", argv[0]);
+        return 1;
+    }
+    if (_register() < 0) {
+        return 1;
+    }
+    _run("shared", _notify_shared, rounds);
+    _run("reference", _notify_reference, rounds);
+    return 0;
+}
+
+static const shell_command_t _commands[] = {
+    { "bench", "notify all observers of /obs", _bench },
+    { NULL, NULL, NULL }
+};
+
+int main(void)
+{
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+
+    gcoap_register_listener(&_listener);
+    for (unsigned i = 0; i < OBSERVERS; i++) {
+        local.port = CLIENT_PORT + i;
+        if (sock_udp_create(&_clients[i].sock, &local, NULL, 0) < 0) {
+            printf("error: unable to create client %u\n", i);
+            return 1;
+        }
+    }
+    local.port = REFERENCE_PORT;
+    sock_udp_create(&_reference_sock, &local, NULL, 0);
+    puts("gcoap observe benchmark");
+
+    char line_buf[SHELL_DEFAULT_BUFSIZE];
+    shell_run(_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
+
+    return 0;
+}
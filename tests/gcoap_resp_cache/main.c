@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark for the gcoap response cache
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "net/gcoap.h"
+#include "net/sock/udp.h"
+#include "shell.h"
+#include "xtimer.h"
+
+#define CLIENT_PORT         (GCOAP_PORT + 1)
+#define RECV_TIMEOUT_US     (1U * US_PER_SEC)
+#define MAX_AGE             (60U)
+#define MAX_KEYS            (64U)
+
+static ssize_t _data_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             void *ctx);
+
+static const coap_resource_t _resources[] = {
+    { "/data", COAP_GET, _data_handler, NULL },
+};
+
+static gcoap_listener_t _listener = {
+    &_resources[0],
+    sizeof(_resources) / sizeof(_resources[0]),
+    NULL
+};
+
+static sock_udp_t _client;
+static unsigned _handled;
+
+static unsigned _get_id(coap_pkt_t *pdu)
+{
+    uint8_t query[NANOCOAP_QS_MAX];
+    char *id;
+
+    if ((coap_get_uri_query(pdu, query) <= 0) ||
+        ((id = strstr((char *)query, "id=")) == NULL)) {
+        return 0;
+    }
+    return atoi(id + 3);
+}
+
+static ssize_t _data_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             void *ctx)
+{
+    (void)ctx;
+    unsigned id = _get_id(pdu);
+
+    _handled++;
+    /* e.g. reading a sensor or formatting a larger representation */
+    xtimer_spin(xtimer_ticks_from_usec(HANDLER_US));
+
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    coap_opt_add_uint(pdu, COAP_OPT_ETAG, id + 1);
+    coap_opt_add_uint(pdu, COAP_OPT_CONTENT_FORMAT, COAP_FORMAT_TEXT);
+    coap_opt_add_uint(pdu, COAP_OPT_MAX_AGE, MAX_AGE);
+    size_t payload_len = sprintf((char *)pdu->payload, "value of %u", id);
+    return gcoap_finish(pdu, payload_len, COAP_FORMAT_NONE);
+}
+
+/* sends a GET for /data?id=<id> and returns the response code, 0 on error */
+static unsigned _get(const sock_udp_ep_t *server, unsigned id, bool etag)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    char val[8];
+
+    gcoap_req_init(&pdu, buf, sizeof(buf), COAP_METHOD_GET, NULL);
+    if (etag) {
+        coap_opt_add_uint(&pdu, COAP_OPT_ETAG, id + 1);
+    }
+    coap_opt_add_string(&pdu, COAP_OPT_URI_PATH, "/data", '/');
+    sprintf(val, "%u", id);
+    gcoap_add_qstring(&pdu, "id", val);
+    ssize_t len = gcoap_finish(&pdu, 0, COAP_FORMAT_NONE);
+
+    if (sock_udp_send(&_client, buf, len, server) <= 0) {
+        return 0;
+    }
+    len = sock_udp_recv(&_client, buf, sizeof(buf), RECV_TIMEOUT_US, NULL);
+    if ((len <= 0) || (coap_parse(&pdu, buf, len) < 0)) {
+        return 0;
+    }
+    return coap_get_code_raw(&pdu);
+}
+
+static int _bench(int argc, char **argv)
+{
+    sock_udp_ep_t server = SOCK_IPV6_EP_ANY;
+    unsigned count, keys, content = 0, valid = 0, failed = 0;
+    bool etag;
+    uint32_t start, duration;
+
+    if (argc < 3) {
+        printf("usage: %s <count> <keys> [etag]\n", argv[0]);
+        return 1;
+    }
+    count = atoi(argv[1]);
+    keys = atoi(argv[2]);
+    etag = (argc > 3) && (strcmp(argv[3], "etag") == 0);
+    if ((count == 0) || (keys == 0) || (keys > MAX_KEYS)) {
+        printf("error: keys must be between 1 and %u\n", MAX_KEYS);
+        return 1;
+    }
+    server.port = GCOAP_PORT;
+    ipv6_addr_set_loopback((ipv6_addr_t *)&server.addr.ipv6);
+
+#ifdef MODULE_GCOAP_RESP_CACHE
+    gcoap_resp_cache_stats_t before, after;
+
+    gcoap_resp_cache_invalidate(NULL);
+    gcoap_resp_cache_get_stats(&before);
+#endif
+    _handled = 0;
+    start = xtimer_now_usec();
+    for (unsigned i = 0; i < count; i++) {
+        switch (_get(&server, i % keys, etag)) {
+            case COAP_CODE_CONTENT:
+                content++;
+                break;
+            case COAP_CODE_VALID:
+                valid++;
+                break;
+            default:
+                failed++;
+                break;
+        }
+    }
+    duration = xtimer_now_usec() - start;
+
+    printf("{ \"requests\" : %u, \"keys\" : %u, \"content\" : %u, "
+           "\"valid\" : %u, \"failed\" : %u, \"handled\" : %u, "
+           "\"req_per_s\" : %lu, \"avg_us\" : %lu", count, keys, content,
+           valid, failed, _handled,
+           (unsigned long)(((uint64_t)count * US_PER_SEC)
+                           / (duration ? duration : 1)),
+           (unsigned long)(duration / count));
+#ifdef MODULE_GCOAP_RESP_CACHE
+    gcoap_resp_cache_get_stats(&after);
+    uint32_t hits = after.hits - before.hits;
+    uint32_t misses = after.misses - before.misses;
+    printf(", \"hits\" : %lu, \"misses\" : %lu, \"evictions\" : %lu, "
+           "\"hit_rate_pct\" : %lu", (unsigned long)hits,
+           (unsigned long)misses,
+           (unsigned long)(after.evictions - before.evictions),
+           (unsigned long)((hits * 100) / ((hits + misses) ? hits + misses : 1)));
+#endif
+    puts(" }");
+    return 0;
+}
+
+static const shell_command_t _commands[] = {
+    { "bench", "send GET requests for /data to the local server", _bench },
+    { NULL, NULL, NULL }
+};
+
+int main(void)
+{
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+
+    gcoap_register_listener(&_listener);
+    local.port = CLIENT_PORT;
+    sock_udp_create(&_client, &local, NULL, 0);
+    puts("gcoap response cache benchmark");
+
+    char line_buf[SHELL_DEFAULT_BUFSIZE];
+    shell_run(_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
+
+    return 0;
+}
@@ -24,25 +24,19 @@
  */
 
 #include <stdio.h>
-#include <string.h>
 
-#include "thread.h"
 #include "shell.h"
-#include "shell_commands.h"
 
-#include "net/gnrc/pktdump.h"
-#include "net/gnrc.h"
+#include "mac_bench.h"
 
 int main(void)
 {
     puts("LWMAC test application");
 
-    gnrc_netreg_entry_t dump = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
-                                                          gnrc_pktdump_pid);
-    gnrc_netreg_register(GNRC_NETTYPE_UNDEF, &dump);
+    mac_bench_init();
 
     char line_buf[SHELL_DEFAULT_BUFSIZE];
-    shell_run(NULL, line_buf, SHELL_DEFAULT_BUFSIZE);
+    shell_run(mac_bench_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
 
     return 0;
 }
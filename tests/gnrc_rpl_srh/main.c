@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test for the source routes a non-storing mode RPL root learns
+ *              from the DAOs of RIOT nodes
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "net/ethernet.h"
+#include "net/icmpv6.h"
+#include "net/ipv6/hdr.h"
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/ethernet.h"
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/dodag.h"
+#include "net/gnrc/rpl/of_manager.h"
+#include "net/gnrc/rpl/srh.h"
+#include "net/netdev_test.h"
+#include "xtimer.h"
+
+#define INSTANCE_ID         (42U)
+/* number of nodes in a chain below the root */
+#define NODES_NUMOF         (3U)
+#define DAO_MAX_LEN         (128U)
+#define DAO_TIMEOUT_US      (100U * US_PER_MS)
+#define MSG_QUEUE_SIZE      (8U)
+
+typedef struct {
+    ipv6_addr_t src;
+    uint16_t len;
+    uint8_t icmpv6[DAO_MAX_LEN];
+} _dao_t;
+
+static char _netif_stack[THREAD_STACKSIZE_DEFAULT];
+static netdev_test_t _dev;
+static msg_t _msg_queue[MSG_QUEUE_SIZE];
+static _dao_t _daos[NODES_NUMOF];
+static uint8_t _srh_buf[GNRC_RPL_SRH_MAX_LEN];
+static const ipv6_addr_t _prefix = { .u8 = { 0x20, 0x01, 0x0d, 0xb8 } };
+/* the root is node 0 */
+static ipv6_addr_t _dodag_id;
+static gnrc_netreg_entry_t _entry;
+
+static int _get_netdev_device_type(netdev_t *netdev, void *value, size_t max_len)
+{
+    assert(max_len == sizeof(uint16_t));
+    (void)netdev;
+
+    *((uint16_t *)value) = NETDEV_TYPE_ETHERNET;
+    return sizeof(uint16_t);
+}
+
+static int _get_netdev_max_packet_size(netdev_t *netdev, void *value,
+                                       size_t max_len)
+{
+    assert(max_len == sizeof(uint16_t));
+    (void)netdev;
+
+    *((uint16_t *)value) = ETHERNET_DATA_LEN;
+    return sizeof(uint16_t);
+}
+
+static gnrc_netif_t *_init_interface(void)
+{
+    gnrc_netif_t *netif;
+
+    netdev_test_setup(&_dev, NULL);
+    netdev_test_set_get_cb(&_dev, NETOPT_DEVICE_TYPE,
+                           _get_netdev_device_type);
+    netdev_test_set_get_cb(&_dev, NETOPT_MAX_PACKET_SIZE,
+                           _get_netdev_max_packet_size);
+    netif = gnrc_netif_ethernet_create(
+            _netif_stack, sizeof(_netif_stack), GNRC_NETIF_PRIO,
+            "dummy_netif", (netdev_t *)&_dev);
+    xtimer_usleep(500); /* wait for thread to start */
+    return netif;
+}
+
+/* 2001:db8::/64 or fe80::/64 with the interface identifier of node i */
+static void _node_addr(ipv6_addr_t *addr, unsigned i, bool link_local)
+{
+    if (link_local) {
+        ipv6_addr_set_link_local_prefix(addr);
+    }
+    else {
+        ipv6_addr_init_prefix(addr, &_prefix, 64);
+    }
+    addr->u8[8] = 0x02;
+    memset(&addr->u8[9], 0, 6);
+    addr->u8[15] = (uint8_t)(i + 1);
+}
+
+/* only the address of the current role of the interface is configured */
+static int _set_addr(gnrc_netif_t *netif, unsigned old, unsigned new)
+{
+    ipv6_addr_t addr;
+
+    _node_addr(&addr, old, false);
+    gnrc_netapi_set(netif->pid, NETOPT_IPV6_ADDR_REMOVE, 0, &addr,
+                    sizeof(addr));
+    _node_addr(&addr, new, false);
+    if (gnrc_netapi_set(netif->pid, NETOPT_IPV6_ADDR, 64U << 8U, &addr,
+                        sizeof(addr)) < 0) {
+        printf("error: unable to add address of node %u\n", new);
+        return -1;
+    }
+    return 0;
+}
+
+/* copies the next DAO sent to the root */
+static int _capture_dao(_dao_t *dao)
+{
+    msg_t msg;
+
+    while (xtimer_msg_receive_timeout(&msg, DAO_TIMEOUT_US) >= 0) {
+        gnrc_pktsnip_t *pkt = msg.content.ptr;
+        gnrc_pktsnip_t *ipv6;
+        icmpv6_hdr_t *icmpv6;
+        int res = -1;
+
+        if (msg.type != GNRC_NETAPI_MSG_TYPE_SND) {
+            continue;
+        }
+        ipv6 = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_IPV6);
+        if ((ipv6 == NULL) || (ipv6->next == NULL)) {
+            gnrc_pktbuf_release(pkt);
+            continue;
+        }
+        icmpv6 = ipv6->next->data;
+        if ((icmpv6->type == ICMPV6_RPL_CTRL) &&
+            (icmpv6->code == GNRC_RPL_ICMPV6_CODE_DAO) &&
+            ipv6_addr_equal(&((ipv6_hdr_t *)ipv6->data)->dst, &_dodag_id) &&
+            (gnrc_pkt_len(ipv6->next) <= sizeof(dao->icmpv6))) {
+            dao->src = ((ipv6_hdr_t *)ipv6->data)->src;
+            dao->len = 0;
+            for (gnrc_pktsnip_t *snip = ipv6->next; snip != NULL;
+                 snip = snip->next) {
+                memcpy(&dao->icmpv6[dao->len], snip->data, snip->size);
+                dao->len += snip->size;
+            }
+            res = 0;
+        }
+        gnrc_pktbuf_release(pkt);
+        if (res == 0) {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int _send_daos(gnrc_netif_t *netif, gnrc_rpl_instance_t *inst)
+{
+    gnrc_rpl_dodag_t *dodag = &inst->dodag;
+
+    for (unsigned i = 1; i <= NODES_NUMOF; i++) {
+        gnrc_rpl_parent_t *parent;
+        ipv6_addr_t addr;
+
+        if (_set_addr(netif, i - 1, i) < 0) {
+            return -1;
+        }
+        /* the preferred parent is the previous node of the chain */
+        gnrc_rpl_dodag_remove_all_parents(dodag);
+        _node_addr(&addr, i - 1, true);
+        gnrc_rpl_parent_add_by_addr(dodag, &addr, &parent);
+        gnrc_rpl_send_DAO(inst, NULL, dodag->default_lifetime);
+        if (_capture_dao(&_daos[i - 1]) < 0) {
+            printf("error: node %u sent no DAO to the root\n", i);
+            return -1;
+        }
+        printf("node %u: DAO to root sent\n", i);
+    }
+    gnrc_rpl_dodag_remove_all_parents(dodag);
+    return _set_addr(netif, NODES_NUMOF, 0);
+}
+
+static int _test(gnrc_netif_t *netif)
+{
+    gnrc_rpl_instance_t *inst;
+    ipv6_addr_t dst, first_hop, via;
+    int res;
+
+    if (!gnrc_rpl_instance_add(INSTANCE_ID, &inst)) {
+        puts("error: unable to create RPL instance");
+        return -1;
+    }
+    inst->of = gnrc_rpl_get_of_for_ocp(GNRC_RPL_DEFAULT_OCP);
+    inst->mop = GNRC_RPL_MOP_NON_STORING_MODE;
+    gnrc_rpl_dodag_init(inst, &_dodag_id, netif->pid);
+    if (_send_daos(netif, inst) < 0) {
+        return -1;
+    }
+
+    /* the interface is the root now */
+    inst->dodag.node_status = GNRC_RPL_ROOT_NODE;
+    for (unsigned i = 0; i < NODES_NUMOF; i++) {
+        gnrc_rpl_recv_DAO((gnrc_rpl_dao_t *)&_daos[i].icmpv6[sizeof(icmpv6_hdr_t)],
+                          netif->pid, &_daos[i].src, &_dodag_id, _daos[i].len);
+    }
+    _node_addr(&dst, 1, false);
+    if (gnrc_rpl_srh_build(&dst, &first_hop, NULL, 0) != 0) {
+        puts("error: node 1 is not a child of the root");
+        return -1;
+    }
+    _node_addr(&dst, NODES_NUMOF, false);
+    _node_addr(&via, 1, false);
+    res = gnrc_rpl_srh_build(&dst, &first_hop, (gnrc_rpl_srh_t *)_srh_buf,
+                             sizeof(_srh_buf));
+    if ((res <= 0) || !ipv6_addr_equal(&first_hop, &via)) {
+        printf("error: no route to node %u via node 1 (%d)\n",
+               NODES_NUMOF, res);
+        return -1;
+    }
+    printf("route to node %u via node 1\n", NODES_NUMOF);
+    return 0;
+}
+
+int main(void)
+{
+    gnrc_netif_t *netif;
+
+    puts("RPL source routes learned from DAOs test");
+    msg_init_queue(_msg_queue, MSG_QUEUE_SIZE);
+    _node_addr(&_dodag_id, 0, false);
+    netif = _init_interface();
+    gnrc_rpl_init(netif->pid);
+    /* capture the packets RPL sends */
+    gnrc_netreg_entry_init_pid(&_entry, GNRC_NETREG_DEMUX_CTX_ALL,
+                               thread_getpid());
+    gnrc_netreg_register(GNRC_NETTYPE_IPV6, &_entry);
+
+    puts((_test(netif) == 0) ? "[SUCCESS]" : "[FAILURE]");
+    return 0;
+}
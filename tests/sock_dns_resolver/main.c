@@ -0,0 +1,318 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test of the caching DNS resolver against a local stub server
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "mutex.h"
+#include "net/ipv6/addr.h"
+#include "net/sock/dns.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define STUB_PORT           (5353U)
+/* nobody listens here */
+#define DEAD_PORT           (5300U)
+#define STUB_PRIO           (THREAD_PRIORITY_MAIN - 1)
+#define STUB_QUEUE_SIZE     (8U)
+/* the stub answers queries for AAAA records this late */
+#define AAAA_DELAY_US       (50U * US_PER_MS)
+#define HOST_TTL            (2U)
+#define REQ_NUMOF           (4U)
+#define BUF_LEN             (128U)
+
+/* an answer of the stub server, sent when it is due */
+typedef struct {
+    uint32_t due;
+    sock_udp_ep_t remote;
+    uint8_t data[BUF_LEN];
+    uint8_t len;
+} _delayed_t;
+
+typedef struct {
+    sock_dns_req_t req;
+    mutex_t done;
+    int res;
+    uint8_t addr[16];
+} _result_t;
+
+static char _stub_stack[THREAD_STACKSIZE_DEFAULT];
+/* queries received by the stub server */
+static unsigned _queries;
+
+static const uint8_t _host6[] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+                                  0, 0, 0, 0, 0, 0, 0, 1 };
+static const uint8_t _host4[] = { 192, 0, 2, 1 };
+static const uint8_t _v4[] = { 192, 0, 2, 2 };
+
+static size_t _put_rr(uint8_t *pos, uint16_t type, uint32_t ttl,
+                      const void *rdata, uint16_t rdlen)
+{
+    /* the name refers to the question */
+    byteorder_htobebufs(pos, 0xc00c);
+    byteorder_htobebufs(pos + 2, type);
+    byteorder_htobebufs(pos + 4, DNS_CLASS_IN);
+    byteorder_htobebufs(pos + 6, ttl >> 16);
+    byteorder_htobebufs(pos + 8, ttl & 0xffff);
+    byteorder_htobebufs(pos + 10, rdlen);
+    memcpy(pos + 12, rdata, rdlen);
+    return 12 + rdlen;
+}
+
+static size_t _put_soa(uint8_t *pos)
+{
+    /* "ns.test", "admin.test", serial, refresh, retry, expire, minimum */
+    static const uint8_t soa[] = { 2, 'n', 's', 4, 't', 'e', 's', 't', 0,
+                                   5, 'a', 'd', 'm', 'i', 'n',
+                                   4, 't', 'e', 's', 't', 0,
+                                   0, 0, 0, 1, 0, 0, 0x0e, 0x10,
+                                   0, 0, 0x0e, 0x10, 0, 0, 0x0e, 0x10,
+                                   0, 0, 0, 30 };
+
+    return _put_rr(pos, 6, 3600, soa, sizeof(soa));
+}
+
+/* builds the answer to the query in buf, returns its length */
+static size_t _answer(uint8_t *buf, size_t len, bool *aaaa)
+{
+    uint8_t *pos = buf + sizeof(sock_dns_hdr_t);
+    char name[SOCK_DNS_MAX_NAME_LEN + 1];
+    size_t name_len = 0;
+    uint16_t rcode = 0, ancount = 0, nscount = 0;
+
+    /* "\4host\4test\0" to "host.test" */
+    while ((pos < (buf + len)) && *pos &&
+           ((name_len + *pos + 1) < sizeof(name))) {
+        if (name_len) {
+            name[name_len++] = '.';
+        }
+        memcpy(&name[name_len], pos + 1, *pos);
+        name_len += *pos;
+        pos += *pos + 1;
+    }
+    name[name_len] = '\0';
+    pos++;
+    uint16_t type = byteorder_bebuftohs(pos);
+    pos += 4;
+
+    *aaaa = (type == DNS_TYPE_AAAA);
+    if (strcmp(name, "host.test") == 0) {
+        if (type == DNS_TYPE_AAAA) {
+            pos += _put_rr(pos, type, HOST_TTL, _host6, sizeof(_host6));
+        }
+        else {
+            pos += _put_rr(pos, type, HOST_TTL, _host4, sizeof(_host4));
+        }
+        ancount = 1;
+    }
+    else if ((strcmp(name, "v4.test") == 0) && (type == DNS_TYPE_A)) {
+        pos += _put_rr(pos, type, 60, _v4, sizeof(_v4));
+        ancount = 1;
+    }
+    else if (strcmp(name, "nosoa.test") == 0) {
+        /* a negative answer without an SOA record */
+        rcode = 3;
+    }
+    else {
+        /* "v4.test" has no AAAA record, other names do not exist */
+        rcode = (strcmp(name, "v4.test") == 0) ? 0 : 3;
+        pos += _put_soa(pos);
+        nscount = 1;
+    }
+    /* response, recursion desired and available */
+    byteorder_htobebufs(&buf[2], 0x8180 | rcode);
+    byteorder_htobebufs(&buf[6], ancount);
+    byteorder_htobebufs(&buf[8], nscount);
+    byteorder_htobebufs(&buf[10], 0);
+    return pos - buf;
+}
+
+/* a minimal DNS server for the zone "test", answers for AAAA records are
+ * delayed by AAAA_DELAY_US */
+static void *_stub_thread(void *arg)
+{
+    (void)arg;
+    static _delayed_t queue[STUB_QUEUE_SIZE];
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+    sock_udp_t sock;
+
+    local.port = STUB_PORT;
+    if (sock_udp_create(&sock, &local, NULL, 0) < 0) {
+        puts("error: unable to create stub server socket");
+        return NULL;
+    }
+
+    while (1) {
+        uint32_t timeout = SOCK_NO_TIMEOUT;
+        uint32_t now = xtimer_now_usec();
+        sock_udp_ep_t remote;
+        uint8_t buf[BUF_LEN];
+        _delayed_t *free_slot = NULL;
+
+        for (unsigned i = 0; i < STUB_QUEUE_SIZE; i++) {
+            _delayed_t *d = &queue[i];
+
+            if (d->len == 0) {
+                free_slot = d;
+                continue;
+            }
+            int32_t left = (int32_t)(d->due - now);
+            if (left <= 0) {
+                sock_udp_send(&sock, d->data, d->len, &d->remote);
+                d->len = 0;
+                free_slot = d;
+            }
+            else if ((uint32_t)left < timeout) {
+                timeout = left;
+            }
+        }
+
+        /* leaves room for the answer */
+        ssize_t len = sock_udp_recv(&sock, buf, sizeof(buf) / 2, timeout,
+                                    &remote);
+        if ((len <= (ssize_t)sizeof(sock_dns_hdr_t)) || (free_slot == NULL)) {
+            continue;
+        }
+        _queries++;
+
+        bool aaaa;
+        free_slot->len = _answer(buf, len, &aaaa);
+        memcpy(free_slot->data, buf, free_slot->len);
+        free_slot->remote = remote;
+        free_slot->due = xtimer_now_usec() + (aaaa ? AAAA_DELAY_US : 0);
+    }
+    return NULL;
+}
+
+static void _on_result(sock_dns_req_t *req, int res, const void *addr)
+{
+    _result_t *r = req->arg;
+
+    r->res = res;
+    if (res > 0) {
+        memcpy(r->addr, addr, res);
+    }
+    mutex_unlock(&r->done);
+}
+
+static bool _check(const char *test, int res, int exp_res, const void *addr,
+                   const void *exp_addr, unsigned queries,
+                   unsigned exp_queries, uint32_t start)
+{
+    uint32_t duration = xtimer_now_usec() - start;
+    bool ok = (res == exp_res) && (queries == exp_queries) &&
+              ((res <= 0) || (memcmp(addr, exp_addr, res) == 0));
+
+    printf("{ \"test\" : \"%s\", \"res\" : %d, \"queries\" : %u, "
+           "\"us\" : %lu }\n", test, res, queries, (unsigned long)duration);
+    if (!ok) {
+        printf("error: expected res %d and %u queries\n", exp_res,
+               exp_queries);
+    }
+    return ok;
+}
+
+/* resolves name, checks the result and the queries the stub server got */
+static bool _query(const char *test, const char *name, int family,
+                   int exp_res, const void *exp_addr, unsigned exp_queries)
+{
+    uint8_t addr[16];
+    unsigned queries = _queries;
+    uint32_t start = xtimer_now_usec();
+    int res = sock_dns_query(name, addr, family);
+
+    return _check(test, res, exp_res, addr, exp_addr, _queries - queries,
+                  exp_queries, start);
+}
+
+static bool _parallel(void)
+{
+    static _result_t results[REQ_NUMOF];
+    unsigned queries = _queries;
+    uint32_t start = xtimer_now_usec();
+    bool ok = true;
+
+    /* the requests wait for the same two queries */
+    for (unsigned i = 0; i < REQ_NUMOF; i++) {
+        mutex_init(&results[i].done);
+        mutex_lock(&results[i].done);
+        if (sock_dns_query_async(&results[i].req, "host.test", AF_UNSPEC,
+                                 _on_result, &results[i]) < 0) {
+            puts("error: unable to start query");
+            return false;
+        }
+    }
+    for (unsigned i = 0; i < REQ_NUMOF; i++) {
+        mutex_lock(&results[i].done);
+        ok = _check("parallel", results[i].res, sizeof(_host6),
+                    results[i].addr, _host6, _queries - queries, 2,
+                    start) && ok;
+    }
+    /* the AAAA record is preferred, though the A record came first */
+    return ok && ((xtimer_now_usec() - start) >= AAAA_DELAY_US);
+}
+
+int main(void)
+{
+    bool ok = true;
+
+    puts("DNS resolver test");
+    thread_create(_stub_stack, sizeof(_stub_stack), STUB_PRIO,
+                  THREAD_CREATE_STACKTEST, _stub_thread, NULL, "stub");
+
+    sock_dns_server.family = AF_INET6;
+    sock_dns_server.port = STUB_PORT;
+    memcpy(sock_dns_server.addr.ipv6, &ipv6_addr_loopback,
+           sizeof(ipv6_addr_t));
+
+    ok = _parallel() && ok;
+    /* answered from the cache */
+    ok = _query("cached", "host.test", AF_UNSPEC, 16, _host6, 0) && ok;
+    ok = _query("cached", "HOST.test.", AF_INET, 4, _host4, 0) && ok;
+    /* no AAAA record */
+    ok = _query("nodata", "v4.test", AF_UNSPEC, 4, _v4, 2) && ok;
+    ok = _query("nodata", "v4.test", AF_UNSPEC, 4, _v4, 0) && ok;
+    ok = _query("nodata", "v4.test", AF_INET6, -ENOENT, NULL, 0) && ok;
+    /* no such name */
+    ok = _query("nxdomain", "nx.test", AF_INET6, -ENOENT, NULL, 1) && ok;
+    ok = _query("nxdomain", "nx.test", AF_INET6, -ENOENT, NULL, 0) && ok;
+    /* not cached without an SOA record */
+    ok = _query("nosoa", "nosoa.test", AF_INET6, -ENOENT, NULL, 1) && ok;
+    ok = _query("nosoa", "nosoa.test", AF_INET6, -ENOENT, NULL, 1) && ok;
+    /* the answers for "host.test" expire */
+    xtimer_sleep(HOST_TTL + 1);
+    ok = _query("expired", "host.test", AF_INET6, 16, _host6, 1) && ok;
+
+    /* the first server does not answer, the fallback does */
+    sock_dns_fallback[0] = sock_dns_server;
+    sock_dns_server.port = DEAD_PORT;
+    sock_dns_cache_flush();
+    uint32_t start = xtimer_now_usec();
+    ok = _query("fallback", "host.test", AF_INET6, 16, _host6, 1) && ok;
+    ok = ok && ((xtimer_now_usec() - start) >= SOCK_DNS_TIMEOUT);
+
+    /* no server answers */
+    sock_dns_fallback[0].port = DEAD_PORT;
+    ok = _query("timeout", "nx.test", AF_INET6, -ETIMEDOUT, NULL, 0) && ok;
+
+    puts(ok ? "[SUCCESS]" : "[FAILURE]");
+    return 0;
+}
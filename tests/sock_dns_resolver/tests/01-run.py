@@ -0,0 +1,25 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+TESTS = ["parallel"] * 4 + ["cached"] * 2 + ["nodata"] * 3 + \
+        ["nxdomain"] * 2 + ["nosoa"] * 2 + ["expired", "fallback", "timeout"]
+
+
+def testfunc(child):
+    for test in TESTS:
+        child.expect(r"{ \"test\" : \"%s\", \"res\" : -?\d+, "
+                     r"\"queries\" : \d+, \"us\" : \d+ }" % test)
+    child.expect_exact("[SUCCESS]")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc, timeout=30))
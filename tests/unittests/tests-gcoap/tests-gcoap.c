@@ -365,6 +365,132 @@ static void test_gcoap__server_get_resource_list(void)
     TEST_ASSERT_EQUAL_STRING(resource_list_str, (char *)res);
 }
 
+static size_t _block_size = 100;
+static size_t _block_offset;
+static size_t _block_len;
+static bool _block_more;
+
+static ssize_t _block_read(void *arg, size_t offset, uint8_t *buf, size_t len)
+{
+    size_t size = *(size_t *)arg;
+
+    if (offset >= size) {
+        return 0;
+    }
+    if (len > size - offset) {
+        len = size - offset;
+    }
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (uint8_t)(offset + i);
+    }
+    return len;
+}
+
+static int _block_write(void *arg, size_t offset, const uint8_t *data,
+                        size_t len, bool more)
+{
+    (void)arg;
+    (void)data;
+    _block_offset = offset;
+    _block_len = len;
+    _block_more = more;
+    return 0;
+}
+
+static ssize_t _block2_req(uint8_t *buf, coap_pkt_t *pdu, int blknum)
+{
+    gcoap_req_init(pdu, buf, GCOAP_PDU_BUF_SIZE, COAP_METHOD_GET, "/file");
+    if (blknum >= 0) {
+        coap_opt_add_uint(pdu, COAP_OPT_BLOCK2, (blknum << 4) | 2);
+    }
+    ssize_t len = coap_opt_finish(pdu, COAP_OPT_FINISH_NONE);
+    coap_parse(pdu, buf, len);
+
+    len = gcoap_block2_resp(pdu, buf, GCOAP_PDU_BUF_SIZE, COAP_FORMAT_OCTET,
+                            _block_read, &_block_size);
+    coap_parse(pdu, buf, len);
+    return len;
+}
+
+/*
+ * Server GET response of a block of a representation, which is read from a
+ * callback
+ */
+static void test_gcoap__server_block2_resp(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    coap_block1_t block;
+
+    /* without Block2 option, the first block */
+    _block2_req(buf, &pdu, -1);
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CONTENT, coap_get_code_raw(&pdu));
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block2(&pdu, &block));
+    TEST_ASSERT_EQUAL_INT(0, block.blknum);
+    TEST_ASSERT_EQUAL_INT(1, block.more);
+    TEST_ASSERT_EQUAL_INT(64, pdu.payload_len);
+    TEST_ASSERT_EQUAL_INT(0, pdu.payload[0]);
+
+    _block2_req(buf, &pdu, 1);
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CONTENT, coap_get_code_raw(&pdu));
+    TEST_ASSERT_EQUAL_INT(COAP_FORMAT_OCTET, coap_get_content_type(&pdu));
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block2(&pdu, &block));
+    TEST_ASSERT_EQUAL_INT(1, block.blknum);
+    TEST_ASSERT_EQUAL_INT(0, block.more);
+    TEST_ASSERT_EQUAL_INT(36, pdu.payload_len);
+    TEST_ASSERT_EQUAL_INT(64, pdu.payload[0]);
+
+    /* past the end */
+    _block2_req(buf, &pdu, 2);
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_BAD_OPTION, coap_get_code_raw(&pdu));
+}
+
+/*
+ * Server PUT response to blocks of a request, which are written to a
+ * callback
+ */
+static void test_gcoap__server_block1_resp(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    coap_block1_t block;
+    ssize_t len;
+
+    gcoap_req_init(&pdu, buf, GCOAP_PDU_BUF_SIZE, COAP_METHOD_PUT, "/file");
+    coap_opt_add_uint(&pdu, COAP_OPT_BLOCK1, (1 << 4) | 0x8 | 2);
+    coap_opt_finish(&pdu, COAP_OPT_FINISH_PAYLOAD);
+    memset(pdu.payload, 0, 64);
+    len = (pdu.payload - buf) + 64;
+    coap_parse(&pdu, buf, len);
+
+    len = gcoap_block1_resp(&pdu, buf, GCOAP_PDU_BUF_SIZE, COAP_CODE_CHANGED,
+                            _block_write, NULL);
+    TEST_ASSERT_EQUAL_INT(64, _block_offset);
+    TEST_ASSERT_EQUAL_INT(64, _block_len);
+    TEST_ASSERT(_block_more);
+
+    coap_parse(&pdu, buf, len);
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CONTINUE, coap_get_code_raw(&pdu));
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block1(&pdu, &block));
+    TEST_ASSERT_EQUAL_INT(1, block.blknum);
+
+    /* last block */
+    gcoap_req_init(&pdu, buf, GCOAP_PDU_BUF_SIZE, COAP_METHOD_PUT, "/file");
+    coap_opt_add_uint(&pdu, COAP_OPT_BLOCK1, (2 << 4) | 2);
+    coap_opt_finish(&pdu, COAP_OPT_FINISH_PAYLOAD);
+    len = (pdu.payload - buf) + 10;
+    coap_parse(&pdu, buf, len);
+
+    len = gcoap_block1_resp(&pdu, buf, GCOAP_PDU_BUF_SIZE, COAP_CODE_CHANGED,
+                            _block_write, NULL);
+    TEST_ASSERT_EQUAL_INT(128, _block_offset);
+    TEST_ASSERT_EQUAL_INT(10, _block_len);
+    TEST_ASSERT(!_block_more);
+
+    coap_parse(&pdu, buf, len);
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CHANGED, coap_get_code_raw(&pdu));
+}
+
 Test *tests_gcoap_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -377,7 +503,9 @@ Test *tests_gcoap_tests(void)
         new_TestFixture(test_gcoap__server_get_resp),
         new_TestFixture(test_gcoap__server_con_req),
         new_TestFixture(test_gcoap__server_con_resp),
-        new_TestFixture(test_gcoap__server_get_resource_list)
+        new_TestFixture(test_gcoap__server_get_resource_list),
+        new_TestFixture(test_gcoap__server_block2_resp),
+        new_TestFixture(test_gcoap__server_block1_resp)
     };
 
     EMB_UNIT_TESTCALLER(gcoap_tests, NULL, NULL, fixtures);
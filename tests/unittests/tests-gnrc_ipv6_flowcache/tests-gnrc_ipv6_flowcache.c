@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/gnrc/ipv6/flowcache.h"
+#include "net/protnum.h"
+#include "net/udp.h"
+
+#include "tests-gnrc_ipv6_flowcache.h"
+
+#define TEST_IFACE      (5)
+#define TEST_SPORT      (0x1234)
+#define TEST_DPORT      (0x5678)
+
+static ipv6_hdr_t hdr;
+static udp_hdr_t udp;
+static gnrc_netif_hdr_t netif_hdr;
+
+static void set_up(void)
+{
+    memset(&hdr, 0, sizeof(hdr));
+    memset(&udp, 0, sizeof(udp));
+    ipv6_hdr_set_version(&hdr);
+    hdr.nh = PROTNUM_UDP;
+    hdr.src.u8[0] = 0x20;
+    hdr.src.u8[1] = 0x01;
+    hdr.src.u8[15] = 0x01;
+    hdr.dst.u8[0] = 0x20;
+    hdr.dst.u8[1] = 0x01;
+    hdr.dst.u8[15] = 0x02;
+    udp.src_port = byteorder_htons(TEST_SPORT);
+    udp.dst_port = byteorder_htons(TEST_DPORT);
+    gnrc_netif_hdr_init(&netif_hdr, 0, 0);
+    /* make sure no entry of a previous test is valid */
+    gnrc_ipv6_flowcache_invalidate();
+}
+
+static void test_flowcache_key__udp(void)
+{
+    gnrc_ipv6_flowcache_key_t key;
+
+    gnrc_ipv6_flowcache_key(&key, &hdr, &udp, sizeof(udp));
+    TEST_ASSERT(ipv6_addr_equal(&hdr.src, &key.src));
+    TEST_ASSERT(ipv6_addr_equal(&hdr.dst, &key.dst));
+    TEST_ASSERT_EQUAL_INT(PROTNUM_UDP, key.nh);
+    TEST_ASSERT_EQUAL_INT(udp.src_port.u16, key.sport);
+    TEST_ASSERT_EQUAL_INT(udp.dst_port.u16, key.dport);
+}
+
+static void test_flowcache_key__no_ports(void)
+{
+    gnrc_ipv6_flowcache_key_t key;
+
+    /* truncated UDP header */
+    gnrc_ipv6_flowcache_key(&key, &hdr, &udp, 2);
+    TEST_ASSERT_EQUAL_INT(0, key.sport);
+    TEST_ASSERT_EQUAL_INT(0, key.dport);
+    /* no transport protocol with ports */
+    hdr.nh = PROTNUM_ICMPV6;
+    gnrc_ipv6_flowcache_key(&key, &hdr, &udp, sizeof(udp));
+    TEST_ASSERT_EQUAL_INT(PROTNUM_ICMPV6, key.nh);
+    TEST_ASSERT_EQUAL_INT(0, key.sport);
+    TEST_ASSERT_EQUAL_INT(0, key.dport);
+}
+
+static void test_flowcache_get__empty(void)
+{
+    gnrc_ipv6_flowcache_key_t key;
+
+    gnrc_ipv6_flowcache_key(&key, &hdr, &udp, sizeof(udp));
+    TEST_ASSERT_NULL(gnrc_ipv6_flowcache_get(&key));
+}
+
+static void test_flowcache_add__success(void)
+{
+    gnrc_ipv6_flowcache_key_t key, other;
+    const gnrc_ipv6_flowcache_entry_t *entry;
+
+    gnrc_ipv6_flowcache_key(&key, &hdr, &udp, sizeof(udp));
+    gnrc_ipv6_flowcache_add(&key, TEST_IFACE, &netif_hdr, sizeof(netif_hdr));
+    TEST_ASSERT_NOT_NULL((entry = gnrc_ipv6_flowcache_get(&key)));
+    TEST_ASSERT_EQUAL_INT(TEST_IFACE, entry->iface);
+    TEST_ASSERT_EQUAL_INT(sizeof(netif_hdr), entry->netif_hdr_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&netif_hdr, entry->netif_hdr,
+                                    sizeof(netif_hdr)));
+    /* a different port is a different flow */
+    udp.src_port = byteorder_htons(TEST_SPORT + 1);
+    gnrc_ipv6_flowcache_key(&other, &hdr, &udp, sizeof(udp));
+    TEST_ASSERT_NULL(gnrc_ipv6_flowcache_get(&other));
+}
+
+static void test_flowcache_invalidate(void)
+{
+    gnrc_ipv6_flowcache_key_t key;
+
+    gnrc_ipv6_flowcache_key(&key, &hdr, &udp, sizeof(udp));
+    gnrc_ipv6_flowcache_add(&key, TEST_IFACE, &netif_hdr, sizeof(netif_hdr));
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_flowcache_get(&key));
+    gnrc_ipv6_flowcache_invalidate();
+    TEST_ASSERT_NULL(gnrc_ipv6_flowcache_get(&key));
+}
+
+static void test_flowcache_add__stale_key(void)
+{
+    gnrc_ipv6_flowcache_key_t key;
+
+    gnrc_ipv6_flowcache_key(&key, &hdr, &udp, sizeof(udp));
+    /* e.g. a route changed while the packet was forwarded */
+    gnrc_ipv6_flowcache_invalidate();
+    gnrc_ipv6_flowcache_add(&key, TEST_IFACE, &netif_hdr, sizeof(netif_hdr));
+    gnrc_ipv6_flowcache_key(&key, &hdr, &udp, sizeof(udp));
+    TEST_ASSERT_NULL(gnrc_ipv6_flowcache_get(&key));
+}
+
+static Test *tests_gnrc_ipv6_flowcache_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_flowcache_key__udp),
+        new_TestFixture(test_flowcache_key__no_ports),
+        new_TestFixture(test_flowcache_get__empty),
+        new_TestFixture(test_flowcache_add__success),
+        new_TestFixture(test_flowcache_invalidate),
+        new_TestFixture(test_flowcache_add__stale_key),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_ipv6_flowcache_tests, set_up, NULL, fixtures);
+
+    return (Test *)&gnrc_ipv6_flowcache_tests;
+}
+
+void tests_gnrc_ipv6_flowcache(void)
+{
+    TESTS_RUN(tests_gnrc_ipv6_flowcache_tests());
+}
+/** @} */
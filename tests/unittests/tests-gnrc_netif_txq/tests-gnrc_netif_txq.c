@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/gnrc.h"
+#include "net/gnrc/netif/internal.h"
+#include "net/ipv6/hdr.h"
+#include "net/protnum.h"
+#include "thread.h"
+
+#include "tests-gnrc_netif_txq.h"
+
+#define SENT_NUMOF          (GNRC_NETIF_TXQ_SIZE + 2)
+
+static int _send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt);
+static int _send_raw(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt);
+
+static const gnrc_netif_ops_t _ops = {
+    .send = _send,
+};
+
+static const gnrc_netif_ops_t _raw_ops = {
+    .send = _send_raw,
+};
+
+static gnrc_netif_t _netif;
+static gnrc_pktsnip_t *_sent[SENT_NUMOF];
+static unsigned _sent_numof;
+static int _send_res;
+
+static int _send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
+{
+    (void)netif;
+    if (_send_res >= 0) {
+        _sent[_sent_numof++] = pkt;
+    }
+    gnrc_pktbuf_release(pkt);
+    return _send_res;
+}
+
+/* removes the netif header before sending, as gnrc_netif_raw does */
+static int _send_raw(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
+{
+    if (pkt->type == GNRC_NETTYPE_NETIF) {
+        pkt = gnrc_pktbuf_remove_snip(pkt, pkt);
+    }
+    return _send(netif, pkt);
+}
+
+static gnrc_pktsnip_t *_pkt(uint8_t nh, uint8_t tc)
+{
+    ipv6_hdr_t hdr;
+
+    memset(&hdr, 0, sizeof(hdr));
+    ipv6_hdr_set_version(&hdr);
+    ipv6_hdr_set_tc(&hdr, tc);
+    hdr.nh = nh;
+    return gnrc_pktbuf_add(NULL, &hdr, sizeof(hdr), GNRC_NETTYPE_IPV6);
+}
+
+static gnrc_pktsnip_t *_netif_pkt(void)
+{
+    gnrc_pktsnip_t *netif_hdr = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+
+    netif_hdr->next = _pkt(PROTNUM_UDP, 0);
+    return netif_hdr;
+}
+
+static void _send_all(void)
+{
+    while (gnrc_netif_txq_ready(&_netif)) {
+        gnrc_netif_txq_send(&_netif);
+    }
+}
+
+static void set_up(void)
+{
+    gnrc_pktbuf_init();
+    memset(&_netif, 0, sizeof(_netif));
+    _netif.ops = &_ops;
+    _netif.pid = thread_getpid();
+    gnrc_netif_txq_init(&_netif);
+    memset(_sent, 0, sizeof(_sent));
+    _sent_numof = 0;
+    _send_res = 0;
+}
+
+static void tear_down(void)
+{
+    xtimer_remove(&_netif.txq.retry_timer);
+}
+
+static void test_txq_fifo(void)
+{
+    gnrc_pktsnip_t *pkt1 = _pkt(PROTNUM_UDP, 0);
+    gnrc_pktsnip_t *pkt2 = _pkt(PROTNUM_UDP, 0);
+
+    TEST_ASSERT(!gnrc_netif_txq_ready(&_netif));
+    gnrc_netif_txq_push(&_netif, pkt1);
+    gnrc_netif_txq_push(&_netif, pkt2);
+    TEST_ASSERT(gnrc_netif_txq_ready(&_netif));
+    TEST_ASSERT_EQUAL_INT(2, _netif.txq.stats.depth);
+    _send_all();
+    TEST_ASSERT_EQUAL_INT(2, _sent_numof);
+    TEST_ASSERT(pkt1 == _sent[0]);
+    TEST_ASSERT(pkt2 == _sent[1]);
+    TEST_ASSERT_EQUAL_INT(0, _netif.txq.stats.depth);
+    TEST_ASSERT_EQUAL_INT(2, _netif.txq.stats.depth_max);
+    TEST_ASSERT_EQUAL_INT(2, _netif.txq.stats.enqueued);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_txq_priority(void)
+{
+    gnrc_pktsnip_t *low = _pkt(PROTNUM_UDP, 0x08 << 2);
+    gnrc_pktsnip_t *normal = _pkt(PROTNUM_UDP, 0);
+    gnrc_pktsnip_t *icmpv6 = _pkt(PROTNUM_ICMPV6, 0);
+
+    gnrc_netif_txq_push(&_netif, low);
+    gnrc_netif_txq_push(&_netif, normal);
+    gnrc_netif_txq_push(&_netif, icmpv6);
+    _send_all();
+    TEST_ASSERT_EQUAL_INT(3, _sent_numof);
+    TEST_ASSERT(icmpv6 == _sent[0]);
+    TEST_ASSERT(normal == _sent[1]);
+    TEST_ASSERT(low == _sent[2]);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+/* 6LoWPAN compresses the IPv6 header before the packet is queued */
+static gnrc_pktsnip_t *_compressed_pkt(uint8_t flags)
+{
+    static const uint8_t iphc[] = { 0x7a, 0x33, 0x3a };
+    gnrc_pktsnip_t *netif_hdr = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+
+    ((gnrc_netif_hdr_t *)netif_hdr->data)->flags = flags;
+    netif_hdr->next = gnrc_pktbuf_add(NULL, iphc, sizeof(iphc),
+                                      GNRC_NETTYPE_UNDEF);
+    return netif_hdr;
+}
+
+static void test_txq_priority_netif_hdr(void)
+{
+    gnrc_pktsnip_t *low = _compressed_pkt(GNRC_NETIF_HDR_FLAGS_PRIO_LOW);
+    gnrc_pktsnip_t *normal = _compressed_pkt(0);
+    gnrc_pktsnip_t *high = _compressed_pkt(GNRC_NETIF_HDR_FLAGS_PRIO_HIGH);
+
+    gnrc_netif_txq_push(&_netif, low);
+    gnrc_netif_txq_push(&_netif, normal);
+    gnrc_netif_txq_push(&_netif, high);
+    _send_all();
+    TEST_ASSERT_EQUAL_INT(3, _sent_numof);
+    TEST_ASSERT(high == _sent[0]);
+    TEST_ASSERT(normal == _sent[1]);
+    TEST_ASSERT(low == _sent[2]);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_txq_overflow(void)
+{
+    gnrc_pktsnip_t *pkt;
+
+    for (unsigned i = 0; i < GNRC_NETIF_TXQ_SIZE; i++) {
+        gnrc_netif_txq_push(&_netif, _pkt(PROTNUM_UDP, 0));
+    }
+    /* same priority: new packet is rejected */
+    gnrc_netif_txq_push(&_netif, _pkt(PROTNUM_UDP, 0));
+    TEST_ASSERT_EQUAL_INT(1, _netif.txq.stats.overflows);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETIF_TXQ_SIZE, _netif.txq.stats.depth);
+    /* higher priority: last packet is dropped instead */
+    pkt = _pkt(PROTNUM_ICMPV6, 0);
+    gnrc_netif_txq_push(&_netif, pkt);
+    TEST_ASSERT_EQUAL_INT(2, _netif.txq.stats.overflows);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETIF_TXQ_SIZE, _netif.txq.stats.depth);
+    _send_all();
+    TEST_ASSERT_EQUAL_INT(GNRC_NETIF_TXQ_SIZE, _sent_numof);
+    TEST_ASSERT(pkt == _sent[0]);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_txq_busy(void)
+{
+    gnrc_pktsnip_t *pkt = _pkt(PROTNUM_UDP, 0);
+
+    gnrc_netif_txq_push(&_netif, pkt);
+    _send_res = -EBUSY;
+    gnrc_netif_txq_send(&_netif);
+    /* packet is kept until the retry timer fires */
+    TEST_ASSERT(!gnrc_netif_txq_ready(&_netif));
+    TEST_ASSERT_EQUAL_INT(1, _netif.txq.stats.depth);
+    TEST_ASSERT_EQUAL_INT(1, _netif.txq.stats.retries);
+    gnrc_netif_txq_retry(&_netif);
+    TEST_ASSERT(gnrc_netif_txq_ready(&_netif));
+    _send_res = 0;
+    _send_all();
+    TEST_ASSERT_EQUAL_INT(1, _sent_numof);
+    TEST_ASSERT(pkt == _sent[0]);
+    TEST_ASSERT_EQUAL_INT(0, _netif.txq.stats.depth);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_txq_busy_give_up(void)
+{
+    gnrc_netif_txq_push(&_netif, _pkt(PROTNUM_UDP, 0));
+    _send_res = -EBUSY;
+    for (unsigned i = 0; i < GNRC_NETIF_TXQ_RETRIES; i++) {
+        gnrc_netif_txq_send(&_netif);
+        gnrc_netif_txq_retry(&_netif);
+    }
+    TEST_ASSERT_EQUAL_INT(1, _netif.txq.stats.depth);
+    gnrc_netif_txq_send(&_netif);
+    TEST_ASSERT(!gnrc_netif_txq_ready(&_netif));
+    TEST_ASSERT_EQUAL_INT(0, _netif.txq.stats.depth);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETIF_TXQ_RETRIES, _netif.txq.stats.retries);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_txq_raw(void)
+{
+    gnrc_pktsnip_t *pkt = _netif_pkt();
+    gnrc_pktsnip_t *payload = pkt->next;
+
+    _netif.ops = &_raw_ops;
+    gnrc_netif_txq_push(&_netif, pkt);
+    _send_all();
+    TEST_ASSERT_EQUAL_INT(1, _sent_numof);
+    TEST_ASSERT(payload == _sent[0]);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_txq_raw_busy(void)
+{
+    gnrc_pktsnip_t *pkt = _netif_pkt();
+    gnrc_pktsnip_t *payload = pkt->next;
+
+    _netif.ops = &_raw_ops;
+    gnrc_netif_txq_push(&_netif, pkt);
+    _send_res = -EBUSY;
+    gnrc_netif_txq_send(&_netif);
+    /* the queued packet still has its header and payload */
+    TEST_ASSERT(pkt == gnrc_priority_pktqueue_head(&_netif.txq.queue));
+    TEST_ASSERT(payload == pkt->next);
+    TEST_ASSERT_EQUAL_INT(1, pkt->users);
+    TEST_ASSERT_EQUAL_INT(1, payload->users);
+    gnrc_netif_txq_retry(&_netif);
+    _send_res = 0;
+    _send_all();
+    TEST_ASSERT_EQUAL_INT(1, _sent_numof);
+    TEST_ASSERT(payload == _sent[0]);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+Test *tests_gnrc_netif_txq_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_txq_fifo),
+        new_TestFixture(test_txq_priority),
+        new_TestFixture(test_txq_priority_netif_hdr),
+        new_TestFixture(test_txq_overflow),
+        new_TestFixture(test_txq_busy),
+        new_TestFixture(test_txq_busy_give_up),
+        new_TestFixture(test_txq_raw),
+        new_TestFixture(test_txq_raw_busy),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_netif_txq_tests, set_up, tear_down, fixtures);
+
+    return (Test *)&gnrc_netif_txq_tests;
+}
+
+void tests_gnrc_netif_txq(void)
+{
+    TESTS_RUN(tests_gnrc_netif_txq_tests());
+}
+/** @} */
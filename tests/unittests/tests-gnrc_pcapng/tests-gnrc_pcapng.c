@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/gnrc/pcapng.h"
+
+#include "tests-gnrc_pcapng.h"
+
+#define SHB_LEN     (28U)
+#define IDB_LEN     (20U)
+#define EPB_LEN     (32U)
+#define TEST_PID    (7)
+
+static uint8_t _out[GNRC_PCAPNG_BUFSIZE + SHB_LEN];
+static size_t _out_len;
+
+static ssize_t _write(const void *data, size_t len)
+{
+    if ((_out_len + len) > sizeof(_out)) {
+        return -1;
+    }
+    memcpy(&_out[_out_len], data, len);
+    _out_len += len;
+    return len;
+}
+
+static uint16_t _u16(size_t offset)
+{
+    uint16_t val;
+
+    memcpy(&val, &_out[offset], sizeof(val));
+    return val;
+}
+
+static uint32_t _u32(size_t offset)
+{
+    uint32_t val;
+
+    memcpy(&val, &_out[offset], sizeof(val));
+    return val;
+}
+
+static void set_up(void)
+{
+    _out_len = 0;
+    gnrc_pcapng_set_output(_write);
+}
+
+static void tear_down(void)
+{
+    gnrc_pcapng_set_output(NULL);
+}
+
+static void test_pcapng_format(void)
+{
+    static const char data[] = "abcde";
+
+    TEST_ASSERT_EQUAL_INT(0, gnrc_pcapng_capture_buf(TEST_PID,
+                                                     GNRC_PCAPNG_LINKTYPE_IEEE802_15_4_NOFCS,
+                                                     data, 5));
+    gnrc_pcapng_flush();
+    TEST_ASSERT_EQUAL_INT(SHB_LEN + IDB_LEN + EPB_LEN + 8, _out_len);
+    /* section header */
+    TEST_ASSERT_EQUAL_INT(0x0a0d0d0a, _u32(0));
+    TEST_ASSERT_EQUAL_INT(SHB_LEN, _u32(4));
+    TEST_ASSERT_EQUAL_INT(0x1a2b3c4d, _u32(8));
+    TEST_ASSERT_EQUAL_INT(1, _u16(12));
+    TEST_ASSERT_EQUAL_INT(0, _u16(14));
+    TEST_ASSERT_EQUAL_INT(SHB_LEN, _u32(SHB_LEN - 4));
+    /* interface description */
+    TEST_ASSERT_EQUAL_INT(1, _u32(SHB_LEN));
+    TEST_ASSERT_EQUAL_INT(IDB_LEN, _u32(SHB_LEN + 4));
+    TEST_ASSERT_EQUAL_INT(GNRC_PCAPNG_LINKTYPE_IEEE802_15_4_NOFCS,
+                          _u16(SHB_LEN + 8));
+    TEST_ASSERT_EQUAL_INT(0, _u16(SHB_LEN + 10));
+    TEST_ASSERT_EQUAL_INT(GNRC_PCAPNG_SNAPLEN, _u32(SHB_LEN + 12));
+    TEST_ASSERT_EQUAL_INT(IDB_LEN, _u32(SHB_LEN + 16));
+    /* enhanced packet */
+    size_t epb = SHB_LEN + IDB_LEN;
+    TEST_ASSERT_EQUAL_INT(6, _u32(epb));
+    TEST_ASSERT_EQUAL_INT(EPB_LEN + 8, _u32(epb + 4));
+    TEST_ASSERT_EQUAL_INT(0, _u32(epb + 8));
+    TEST_ASSERT_EQUAL_INT(5, _u32(epb + 20));
+    TEST_ASSERT_EQUAL_INT(5, _u32(epb + 24));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(data, &_out[epb + 28], 5));
+    TEST_ASSERT_EQUAL_INT(0, _out[epb + 28 + 5]);
+    TEST_ASSERT_EQUAL_INT(EPB_LEN + 8, _u32(epb + EPB_LEN + 8 - 4));
+}
+
+static void test_pcapng_interfaces(void)
+{
+    static const uint8_t data[4] = { 0 };
+    size_t offset = SHB_LEN;
+
+    gnrc_pcapng_capture_buf(TEST_PID, GNRC_PCAPNG_LINKTYPE_ETHERNET,
+                            data, sizeof(data));
+    gnrc_pcapng_capture_buf(TEST_PID, GNRC_PCAPNG_LINKTYPE_ETHERNET,
+                            data, sizeof(data));
+    gnrc_pcapng_capture_buf(TEST_PID, GNRC_PCAPNG_LINKTYPE_IPV6,
+                            data, sizeof(data));
+    gnrc_pcapng_flush();
+    /* IDB 0, EPB on 0, EPB on 0, IDB 1, EPB on 1 */
+    TEST_ASSERT_EQUAL_INT(1, _u32(offset));
+    offset += IDB_LEN;
+    TEST_ASSERT_EQUAL_INT(6, _u32(offset));
+    TEST_ASSERT_EQUAL_INT(0, _u32(offset + 8));
+    offset += EPB_LEN + sizeof(data);
+    TEST_ASSERT_EQUAL_INT(6, _u32(offset));
+    TEST_ASSERT_EQUAL_INT(0, _u32(offset + 8));
+    offset += EPB_LEN + sizeof(data);
+    TEST_ASSERT_EQUAL_INT(1, _u32(offset));
+    TEST_ASSERT_EQUAL_INT(GNRC_PCAPNG_LINKTYPE_IPV6, _u32(offset + 8));
+    offset += IDB_LEN;
+    TEST_ASSERT_EQUAL_INT(6, _u32(offset));
+    TEST_ASSERT_EQUAL_INT(1, _u32(offset + 8));
+    offset += EPB_LEN + sizeof(data);
+    TEST_ASSERT_EQUAL_INT(offset, _out_len);
+}
+
+static void test_pcapng_snaplen(void)
+{
+    static uint8_t data[GNRC_PCAPNG_SNAPLEN];
+    iolist_t second = { .iol_base = data, .iol_len = sizeof(data) };
+    iolist_t first = { .iol_next = &second, .iol_base = data, .iol_len = 3 };
+    size_t epb = SHB_LEN + IDB_LEN;
+
+    TEST_ASSERT_EQUAL_INT(0, gnrc_pcapng_capture(TEST_PID,
+                                                 GNRC_PCAPNG_LINKTYPE_USER0,
+                                                 &first));
+    gnrc_pcapng_flush();
+    TEST_ASSERT_EQUAL_INT(EPB_LEN + GNRC_PCAPNG_SNAPLEN, _u32(epb + 4));
+    TEST_ASSERT_EQUAL_INT(GNRC_PCAPNG_SNAPLEN, _u32(epb + 20));
+    TEST_ASSERT_EQUAL_INT(GNRC_PCAPNG_SNAPLEN + 3, _u32(epb + 24));
+}
+
+static void test_pcapng_full(void)
+{
+    static const uint8_t data[64] = { 0 };
+    gnrc_pcapng_stats_t before, after;
+    unsigned captured = 0;
+
+    gnrc_pcapng_get_stats(&before);
+    while (gnrc_pcapng_capture_buf(TEST_PID, GNRC_PCAPNG_LINKTYPE_USER0,
+                                   data, sizeof(data)) == 0) {
+        captured++;
+        TEST_ASSERT(captured <= (GNRC_PCAPNG_BUFSIZE / sizeof(data)));
+    }
+    gnrc_pcapng_get_stats(&after);
+    TEST_ASSERT_EQUAL_INT(captured, after.captured - before.captured);
+    TEST_ASSERT_EQUAL_INT(1, after.dropped - before.dropped);
+    /* after writing the buffer to the output there is space again */
+    gnrc_pcapng_flush();
+    TEST_ASSERT_EQUAL_INT(0, gnrc_pcapng_capture_buf(TEST_PID,
+                                                     GNRC_PCAPNG_LINKTYPE_USER0,
+                                                     data, sizeof(data)));
+}
+
+static void test_pcapng_no_output(void)
+{
+    static const uint8_t data[4] = { 0 };
+
+    gnrc_pcapng_set_output(NULL);
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS,
+                          gnrc_pcapng_capture_buf(TEST_PID,
+                                                  GNRC_PCAPNG_LINKTYPE_USER0,
+                                                  data, sizeof(data)));
+    gnrc_pcapng_flush();
+    TEST_ASSERT_EQUAL_INT(0, _out_len);
+}
+
+Test *tests_gnrc_pcapng_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_pcapng_format),
+        new_TestFixture(test_pcapng_interfaces),
+        new_TestFixture(test_pcapng_snaplen),
+        new_TestFixture(test_pcapng_full),
+        new_TestFixture(test_pcapng_no_output),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_pcapng_tests, set_up, tear_down, fixtures);
+
+    return (Test *)&gnrc_pcapng_tests;
+}
+
+void tests_gnrc_pcapng(void)
+{
+    TESTS_RUN(tests_gnrc_pcapng_tests());
+}
+/** @} */
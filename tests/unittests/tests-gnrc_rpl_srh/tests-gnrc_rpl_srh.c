@@ -14,6 +14,7 @@
  * @author Cenk Gündoğan <mail@cgundogan.de>
  * @author Martine Lenders <m.lenders@fu-berlin.de>
  */
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 #include "embUnit.h"
@@ -39,6 +40,10 @@
                                0x00, 0x00, 0x00, 0x00, \
                                0x00, 0x00, 0x00, 0x00, \
                                0x00, 0x00, 0x00, 0x03 }}
+#define IPV6_ADDR3          {{ 0x20, 0x01, 0xab, 0xcd, \
+                               0x00, 0x00, 0x00, 0x01, \
+                               0x00, 0x00, 0x00, 0x00, \
+                               0x00, 0x00, 0x00, 0x03 }}
 #define IPV6_MCAST_ADDR     {{ 0xff, 0x05, 0xab, 0xcd, \
                                0x00, 0x00, 0x00, 0x00, \
                                0x00, 0x00, 0x00, 0x00, \
@@ -58,6 +63,7 @@ static void set_up(void)
 {
     memset(&hdr, 0, sizeof(hdr));
     memset(buf, 0, sizeof(buf));
+    gnrc_rpl_srh_table_flush();
 }
 
 static inline void _init_hdrs(gnrc_rpl_srh_t **srh, uint8_t **vec,
@@ -188,6 +194,117 @@ static void test_rpl_srh_nexthop_prefix_elided(void)
     TEST_ASSERT(ipv6_addr_equal(&hdr.dst, &expected2));
 }
 
+static void test_rpl_srh_build_unknown(void)
+{
+    static const ipv6_addr_t dst = IPV6_DST;
+    uint8_t srh_buf[GNRC_RPL_SRH_MAX_LEN];
+    ipv6_addr_t first_hop;
+
+    TEST_ASSERT_EQUAL_INT(-ENOENT, gnrc_rpl_srh_build(&dst, &first_hop,
+                                                      (gnrc_rpl_srh_t *)srh_buf,
+                                                      sizeof(srh_buf)));
+}
+
+static void test_rpl_srh_build_child(void)
+{
+    static const ipv6_addr_t dst = IPV6_DST;
+    uint8_t srh_buf[GNRC_RPL_SRH_MAX_LEN];
+    ipv6_addr_t first_hop;
+
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_table_add(&dst, NULL));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_build(&dst, &first_hop,
+                                                (gnrc_rpl_srh_t *)srh_buf,
+                                                sizeof(srh_buf)));
+    TEST_ASSERT(ipv6_addr_equal(&dst, &first_hop));
+}
+
+static void test_rpl_srh_build_route(void)
+{
+    static const ipv6_addr_t a1 = IPV6_ADDR1, a2 = IPV6_ADDR2, dst = IPV6_DST;
+    uint8_t srh_buf[GNRC_RPL_SRH_MAX_LEN];
+    gnrc_rpl_srh_t *srh = (gnrc_rpl_srh_t *)srh_buf;
+    void *err_ptr;
+    int res;
+
+    /* root -> a1 -> a2 -> dst, added in arbitrary order */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_table_add(&dst, &a2));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_table_add(&a1, NULL));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, gnrc_rpl_srh_build(&dst, &hdr.dst, srh,
+                                                      sizeof(srh_buf)));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_table_add(&a2, &a1));
+
+    res = gnrc_rpl_srh_build(&dst, &hdr.dst, NULL, 0);
+    /* header + 2 addresses with 15 octets elided + 6 octets padding */
+    TEST_ASSERT_EQUAL_INT(sizeof(gnrc_rpl_srh_t) + 8, res);
+    TEST_ASSERT_EQUAL_INT(res, gnrc_rpl_srh_build(&dst, &hdr.dst, srh,
+                                                  sizeof(srh_buf)));
+    TEST_ASSERT(ipv6_addr_equal(&hdr.dst, &a1));
+    TEST_ASSERT_EQUAL_INT(SRH_SEG_LEFT, srh->seg_left);
+    TEST_ASSERT_EQUAL_INT((15 << 4) | 15, srh->compr);
+    /* cached route must be identical */
+    TEST_ASSERT_EQUAL_INT(res, gnrc_rpl_srh_build(&dst, &hdr.dst, srh,
+                                                  sizeof(srh_buf)));
+
+    /* first hop */
+    res = gnrc_rpl_srh_process(&hdr, srh, &err_ptr);
+    TEST_ASSERT_EQUAL_INT(GNRC_IPV6_EXT_RH_FORWARDED, res);
+    TEST_ASSERT(ipv6_addr_equal(&hdr.dst, &a2));
+
+    /* second hop */
+    res = gnrc_rpl_srh_process(&hdr, srh, &err_ptr);
+    TEST_ASSERT_EQUAL_INT(GNRC_IPV6_EXT_RH_FORWARDED, res);
+    TEST_ASSERT_EQUAL_INT(0, srh->seg_left);
+    TEST_ASSERT(ipv6_addr_equal(&hdr.dst, &dst));
+
+    /* removing a2 makes dst unreachable */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_table_del(&a2));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, gnrc_rpl_srh_build(&dst, &hdr.dst, srh,
+                                                      sizeof(srh_buf)));
+}
+
+static void test_rpl_srh_build_route_prefixes(void)
+{
+    static const ipv6_addr_t a1 = IPV6_ADDR1, a3 = IPV6_ADDR3, dst = IPV6_DST;
+    uint8_t srh_buf[GNRC_RPL_SRH_MAX_LEN];
+    gnrc_rpl_srh_t *srh = (gnrc_rpl_srh_t *)srh_buf;
+    void *err_ptr;
+    int res;
+
+    /* root -> a1 -> a3 -> dst: dst shares 15 prefix octets with a1, but only
+     * 7 with a3, which restores its prefix */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_table_add(&a1, NULL));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_table_add(&a3, &a1));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_table_add(&dst, &a3));
+
+    res = gnrc_rpl_srh_build(&dst, &hdr.dst, srh, sizeof(srh_buf));
+    /* header + 2 addresses with 7 octets elided + 6 octets padding */
+    TEST_ASSERT_EQUAL_INT(sizeof(gnrc_rpl_srh_t) + 24, res);
+    TEST_ASSERT(ipv6_addr_equal(&hdr.dst, &a1));
+    TEST_ASSERT_EQUAL_INT((7 << 4) | 7, srh->compr);
+
+    res = gnrc_rpl_srh_process(&hdr, srh, &err_ptr);
+    TEST_ASSERT_EQUAL_INT(GNRC_IPV6_EXT_RH_FORWARDED, res);
+    TEST_ASSERT(ipv6_addr_equal(&hdr.dst, &a3));
+
+    res = gnrc_rpl_srh_process(&hdr, srh, &err_ptr);
+    TEST_ASSERT_EQUAL_INT(GNRC_IPV6_EXT_RH_FORWARDED, res);
+    TEST_ASSERT_EQUAL_INT(0, srh->seg_left);
+    TEST_ASSERT(ipv6_addr_equal(&hdr.dst, &dst));
+}
+
+static void test_rpl_srh_build_loop(void)
+{
+    static const ipv6_addr_t a1 = IPV6_ADDR1, a2 = IPV6_ADDR2;
+    uint8_t srh_buf[GNRC_RPL_SRH_MAX_LEN];
+    ipv6_addr_t first_hop;
+
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_table_add(&a1, &a2));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_table_add(&a2, &a1));
+    TEST_ASSERT_EQUAL_INT(-ELOOP, gnrc_rpl_srh_build(&a1, &first_hop,
+                                                     (gnrc_rpl_srh_t *)srh_buf,
+                                                     sizeof(srh_buf)));
+}
+
 static Test *tests_rpl_srh_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -196,6 +313,11 @@ static Test *tests_rpl_srh_tests(void)
         new_TestFixture(test_rpl_srh_too_many_seg_left),
         new_TestFixture(test_rpl_srh_nexthop_no_prefix_elided),
         new_TestFixture(test_rpl_srh_nexthop_prefix_elided),
+        new_TestFixture(test_rpl_srh_build_unknown),
+        new_TestFixture(test_rpl_srh_build_child),
+        new_TestFixture(test_rpl_srh_build_route),
+        new_TestFixture(test_rpl_srh_build_route_prefixes),
+        new_TestFixture(test_rpl_srh_build_loop),
     };
 
     EMB_UNIT_TESTCALLER(rpl_srh_tests, set_up, NULL, fixtures);
@@ -21,6 +21,30 @@
 #include "unittests-constants.h"
 #include "tests-inet_csum.h"
 
+#define LONG_DATA_LEN   (67U)
+
+/* byte-wise reference implementation of the 1's complement sum */
+static uint16_t _ref_sum(const uint8_t *buf, size_t len)
+{
+    uint32_t sum = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        sum += (i & 1) ? buf[i] : (uint16_t)(buf[i] << 8);
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return sum;
+}
+
+static void _fill_long_data(uint8_t *buf, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        /* many carries */
+        buf[i] = (uint8_t)(0xff - (i * 7));
+    }
+}
+
 static void test_inet_csum__rfc_example(void)
 {
     /* source: https://tools.ietf.org/html/rfc1071#section-3 */
@@ -165,6 +189,59 @@ static void test_inet_csum__empty_app_buffer(void)
     TEST_ASSERT_EQUAL_INT(hdr_expected, pyld_sum);
 }
 
+static void test_inet_csum__alignments(void)
+{
+    uint8_t data[LONG_DATA_LEN + 8];
+
+    for (unsigned off = 0; off < 8; off++) {
+        for (unsigned len = 0; len <= LONG_DATA_LEN; len++) {
+            _fill_long_data(&data[off], len);
+            TEST_ASSERT_EQUAL_INT(_ref_sum(&data[off], len),
+                                  inet_csum(0, &data[off], len));
+        }
+    }
+}
+
+static void test_inet_csum__slices(void)
+{
+    uint8_t data[LONG_DATA_LEN];
+    uint16_t exp;
+
+    _fill_long_data(data, sizeof(data));
+    exp = _ref_sum(data, sizeof(data));
+    for (unsigned split = 0; split <= sizeof(data); split++) {
+        uint16_t sum = inet_csum_slice(0, data, split, 0);
+
+        sum = inet_csum_slice(sum, &data[split], sizeof(data) - split, split);
+        TEST_ASSERT_EQUAL_INT(exp, sum);
+    }
+}
+
+static void test_inet_csum__update_rfc_example(void)
+{
+    /* source: https://tools.ietf.org/html/rfc1624#section-4 */
+    TEST_ASSERT_EQUAL_INT(0x0000, inet_csum_update(0xdd2f, 0x5555, 0x3285));
+}
+
+static void test_inet_csum__update(void)
+{
+    uint8_t data[LONG_DATA_LEN + 1];
+    uint16_t csum;
+
+    _fill_long_data(data, sizeof(data));
+    csum = ~inet_csum(0, data, sizeof(data));
+    for (unsigned i = 0; i < sizeof(data); i += 2) {
+        uint16_t old_word = (data[i] << 8) | data[i + 1];
+        uint16_t new_word = old_word + (i * 0x0f0f);
+
+        data[i] = new_word >> 8;
+        data[i + 1] = new_word & 0xff;
+        csum = inet_csum_update(csum, old_word, new_word);
+        TEST_ASSERT_EQUAL_INT((uint16_t)~inet_csum(0, data, sizeof(data)),
+                              csum);
+    }
+}
+
 Test *tests_inet_csum_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -176,6 +253,10 @@ Test *tests_inet_csum_tests(void)
         new_TestFixture(test_inet_csum__odd_len),
         new_TestFixture(test_inet_csum__two_app_snips),
         new_TestFixture(test_inet_csum__empty_app_buffer),
+        new_TestFixture(test_inet_csum__alignments),
+        new_TestFixture(test_inet_csum__slices),
+        new_TestFixture(test_inet_csum__update_rfc_example),
+        new_TestFixture(test_inet_csum__update),
     };
 
     EMB_UNIT_TESTCALLER(inet_csum_tests, NULL, NULL, fixtures);
@@ -0,0 +1,352 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/mqttsn_topics.h"
+
+#include "tests-mqttsn_topics.h"
+
+static mqttsn_tid_map_t _map;
+static mqttsn_trie_t _trie;
+static int _ctx[8];
+
+static void set_up(void)
+{
+    mqttsn_tid_map_init(&_map);
+    mqttsn_trie_init(&_trie);
+}
+
+static void *_match(const char *name)
+{
+    return mqttsn_trie_match(&_trie, name, strlen(name));
+}
+
+static unsigned _free_nodes(void)
+{
+    unsigned res = 0;
+
+    for (unsigned i = 1; i < MQTTSN_TRIE_SIZE; i++) {
+        if (_trie.nodes[i].level == NULL) {
+            res++;
+        }
+    }
+    return res;
+}
+
+/* home slot of a topic ID, i.e. the slot it takes in an empty map */
+static unsigned _home(uint16_t id)
+{
+    mqttsn_tid_map_t map;
+
+    mqttsn_tid_map_init(&map);
+    mqttsn_tid_map_add(&map, id, &_ctx[0]);
+    for (unsigned i = 0; i < MQTTSN_TID_MAP_SIZE; i++) {
+        if (map.slots[i].id == id) {
+            return i;
+        }
+    }
+    return MQTTSN_TID_MAP_SIZE;
+}
+
+/* smallest topic ID with the home slot */
+static uint16_t _id_with_home(unsigned home)
+{
+    uint16_t id = 1;
+
+    while (_home(id) != home) {
+        id++;
+    }
+    return id;
+}
+
+static void test_tid_map_add_get(void)
+{
+    TEST_ASSERT_NULL(mqttsn_tid_map_get(&_map, 1));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_tid_map_add(&_map, 1, &_ctx[0]));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_tid_map_add(&_map, 2, &_ctx[1]));
+    TEST_ASSERT(&_ctx[0] == mqttsn_tid_map_get(&_map, 1));
+    TEST_ASSERT(&_ctx[1] == mqttsn_tid_map_get(&_map, 2));
+    TEST_ASSERT_NULL(mqttsn_tid_map_get(&_map, 3));
+    TEST_ASSERT_NULL(mqttsn_tid_map_get(&_map, 0));
+    /* adding a mapped topic ID replaces its context */
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_tid_map_add(&_map, 1, &_ctx[2]));
+    TEST_ASSERT(&_ctx[2] == mqttsn_tid_map_get(&_map, 1));
+}
+
+static void test_tid_map_full(void)
+{
+    for (unsigned i = 0; i < MQTTSN_TID_MAP_SIZE; i++) {
+        /* topic IDs that share home slots */
+        uint16_t id = (i + 1) * MQTTSN_TID_MAP_SIZE;
+
+        TEST_ASSERT_EQUAL_INT(0, mqttsn_tid_map_add(&_map, id, &_ctx[i % 8]));
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, mqttsn_tid_map_add(&_map, 7, &_ctx[0]));
+    for (unsigned i = 0; i < MQTTSN_TID_MAP_SIZE; i++) {
+        uint16_t id = (i + 1) * MQTTSN_TID_MAP_SIZE;
+
+        TEST_ASSERT(&_ctx[i % 8] == mqttsn_tid_map_get(&_map, id));
+    }
+}
+
+static void test_tid_map_del_ctx(void)
+{
+    unsigned numof = MQTTSN_TID_MAP_SIZE - 1;
+
+    for (unsigned i = 0; i < numof; i++) {
+        TEST_ASSERT_EQUAL_INT(0, mqttsn_tid_map_add(&_map, i + 1,
+                                                    &_ctx[i % 3]));
+    }
+    mqttsn_tid_map_del_ctx(&_map, &_ctx[1]);
+    for (unsigned i = 0; i < numof; i++) {
+        void *exp = ((i % 3) == 1) ? NULL : &_ctx[i % 3];
+
+        TEST_ASSERT(exp == mqttsn_tid_map_get(&_map, i + 1));
+    }
+    /* the freed slots can be used again */
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_tid_map_add(&_map, 1000, &_ctx[4]));
+    TEST_ASSERT(&_ctx[4] == mqttsn_tid_map_get(&_map, 1000));
+    mqttsn_tid_map_del_ctx(&_map, &_ctx[0]);
+    mqttsn_tid_map_del_ctx(&_map, &_ctx[2]);
+    mqttsn_tid_map_del_ctx(&_map, &_ctx[4]);
+    for (unsigned i = 0; i < MQTTSN_TID_MAP_SIZE; i++) {
+        TEST_ASSERT_EQUAL_INT(0, _map.slots[i].id);
+    }
+}
+
+static void test_tid_map_del_chain(void)
+{
+    /* topic IDs that share home slot 0 form a chain in slots 0 to 3 */
+    uint16_t chain[] = { MQTTSN_TID_MAP_SIZE, 2 * MQTTSN_TID_MAP_SIZE,
+                         3 * MQTTSN_TID_MAP_SIZE, 4 * MQTTSN_TID_MAP_SIZE };
+    /* displaced behind the chain into slot 4 */
+    uint16_t other = _id_with_home(1);
+
+    for (unsigned i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_INT(0, mqttsn_tid_map_add(&_map, chain[i],
+                                                    &_ctx[i]));
+    }
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_tid_map_add(&_map, other, &_ctx[4]));
+    TEST_ASSERT_EQUAL_INT(other, _map.slots[4].id);
+    /* the entries behind a deleted one in the chain are found */
+    mqttsn_tid_map_del_ctx(&_map, &_ctx[1]);
+    TEST_ASSERT_NULL(mqttsn_tid_map_get(&_map, chain[1]));
+    TEST_ASSERT(&_ctx[0] == mqttsn_tid_map_get(&_map, chain[0]));
+    TEST_ASSERT(&_ctx[2] == mqttsn_tid_map_get(&_map, chain[2]));
+    TEST_ASSERT(&_ctx[3] == mqttsn_tid_map_get(&_map, chain[3]));
+    TEST_ASSERT(&_ctx[4] == mqttsn_tid_map_get(&_map, other));
+    /* the head of the chain */
+    mqttsn_tid_map_del_ctx(&_map, &_ctx[0]);
+    TEST_ASSERT_NULL(mqttsn_tid_map_get(&_map, chain[0]));
+    TEST_ASSERT(&_ctx[2] == mqttsn_tid_map_get(&_map, chain[2]));
+    TEST_ASSERT(&_ctx[3] == mqttsn_tid_map_get(&_map, chain[3]));
+    TEST_ASSERT(&_ctx[4] == mqttsn_tid_map_get(&_map, other));
+    /* re-adding after the deletion */
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_tid_map_add(&_map, chain[1], &_ctx[5]));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_tid_map_add(&_map, chain[0], &_ctx[6]));
+    TEST_ASSERT(&_ctx[6] == mqttsn_tid_map_get(&_map, chain[0]));
+    TEST_ASSERT(&_ctx[5] == mqttsn_tid_map_get(&_map, chain[1]));
+    TEST_ASSERT(&_ctx[2] == mqttsn_tid_map_get(&_map, chain[2]));
+    TEST_ASSERT(&_ctx[3] == mqttsn_tid_map_get(&_map, chain[3]));
+    TEST_ASSERT(&_ctx[4] == mqttsn_tid_map_get(&_map, other));
+}
+
+static void test_tid_map_del_chain_wrap(void)
+{
+    /* a chain from the last slot wraps around to slot 0 */
+    uint16_t last = _id_with_home(MQTTSN_TID_MAP_SIZE - 1);
+    uint16_t wrapped = last + MQTTSN_TID_MAP_SIZE;
+    uint16_t first = MQTTSN_TID_MAP_SIZE;
+
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_tid_map_add(&_map, last, &_ctx[0]));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_tid_map_add(&_map, wrapped, &_ctx[1]));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_tid_map_add(&_map, first, &_ctx[2]));
+    TEST_ASSERT_EQUAL_INT(wrapped, _map.slots[0].id);
+    TEST_ASSERT_EQUAL_INT(first, _map.slots[1].id);
+    mqttsn_tid_map_del_ctx(&_map, &_ctx[0]);
+    TEST_ASSERT_NULL(mqttsn_tid_map_get(&_map, last));
+    TEST_ASSERT(&_ctx[1] == mqttsn_tid_map_get(&_map, wrapped));
+    TEST_ASSERT(&_ctx[2] == mqttsn_tid_map_get(&_map, first));
+    TEST_ASSERT_EQUAL_INT(wrapped, _map.slots[MQTTSN_TID_MAP_SIZE - 1].id);
+    TEST_ASSERT_EQUAL_INT(first, _map.slots[0].id);
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_tid_map_add(&_map, last, &_ctx[3]));
+    TEST_ASSERT(&_ctx[3] == mqttsn_tid_map_get(&_map, last));
+    TEST_ASSERT(&_ctx[1] == mqttsn_tid_map_get(&_map, wrapped));
+    TEST_ASSERT(&_ctx[2] == mqttsn_tid_map_get(&_map, first));
+}
+
+static void test_trie_exact(void)
+{
+    TEST_ASSERT_NULL(_match("a/b"));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "a/b", &_ctx[0]));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "a/c", &_ctx[1]));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "/a", &_ctx[2]));
+    TEST_ASSERT(&_ctx[0] == _match("a/b"));
+    TEST_ASSERT(&_ctx[1] == _match("a/c"));
+    TEST_ASSERT(&_ctx[2] == _match("/a"));
+    TEST_ASSERT_NULL(_match("a"));
+    TEST_ASSERT_NULL(_match("a/b/c"));
+    TEST_ASSERT_NULL(_match("a/"));
+    TEST_ASSERT_NULL(_match("a/bc"));
+    /* only len bytes of the name count */
+    TEST_ASSERT(&_ctx[0] == mqttsn_trie_match(&_trie, "a/bc", 3));
+    TEST_ASSERT_EQUAL_INT(-EALREADY, mqttsn_trie_add(&_trie, "a/b", &_ctx[0]));
+    TEST_ASSERT_EQUAL_INT(-EEXIST, mqttsn_trie_add(&_trie, "a/b", &_ctx[3]));
+}
+
+static void test_trie_wildcards(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "s/+/t", &_ctx[0]));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "s/#", &_ctx[1]));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "s/k/t", &_ctx[2]));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "#", &_ctx[3]));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "+/+", &_ctx[4]));
+
+    /* the most specific filter wins */
+    TEST_ASSERT(&_ctx[2] == _match("s/k/t"));
+    TEST_ASSERT(&_ctx[0] == _match("s/x/t"));
+    TEST_ASSERT(&_ctx[1] == _match("s/x/u"));
+    TEST_ASSERT(&_ctx[1] == _match("s/x"));
+    TEST_ASSERT(&_ctx[1] == _match("s/x/t/u"));
+    /* "s/#" matches its parent level */
+    TEST_ASSERT(&_ctx[1] == _match("s"));
+    TEST_ASSERT(&_ctx[4] == _match("x/y"));
+    TEST_ASSERT(&_ctx[3] == _match("x/y/z"));
+    TEST_ASSERT(&_ctx[3] == _match("x"));
+    /* wildcards on the first level do not match names starting with '$' */
+    TEST_ASSERT_NULL(_match("$SYS/x"));
+}
+
+static void test_trie_del(void)
+{
+    unsigned free_nodes = _free_nodes();
+
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "a/b/c", &_ctx[0]));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "a/b", &_ctx[1]));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "a/+/d", &_ctx[2]));
+    TEST_ASSERT_EQUAL_INT(free_nodes - 5, _free_nodes());
+    mqttsn_trie_del(&_trie, "a/b/c");
+    TEST_ASSERT_NULL(_match("a/b/c"));
+    TEST_ASSERT(&_ctx[1] == _match("a/b"));
+    TEST_ASSERT(&_ctx[2] == _match("a/b/d"));
+    TEST_ASSERT_EQUAL_INT(free_nodes - 4, _free_nodes());
+    /* removing a filter that is not in the trie changes nothing */
+    mqttsn_trie_del(&_trie, "a/x");
+    mqttsn_trie_del(&_trie, "a");
+    TEST_ASSERT_EQUAL_INT(free_nodes - 4, _free_nodes());
+    mqttsn_trie_del(&_trie, "a/b");
+    mqttsn_trie_del(&_trie, "a/+/d");
+    TEST_ASSERT_NULL(_match("a/b/d"));
+    TEST_ASSERT_EQUAL_INT(free_nodes, _free_nodes());
+}
+
+static void test_trie_del_shared_level(void)
+{
+    char first[] = "a/b";
+    char second[] = "a/c";
+
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, first, &_ctx[0]));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, second, &_ctx[1]));
+    mqttsn_trie_del(&_trie, first);
+    /* the trie must not refer to a removed filter */
+    memset(first, 'x', sizeof(first) - 1);
+    TEST_ASSERT(&_ctx[1] == _match("a/c"));
+    TEST_ASSERT_NULL(_match("a/b"));
+}
+
+static void test_trie_del_wildcard(void)
+{
+    unsigned free_nodes = _free_nodes();
+
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "a/b/c", &_ctx[0]));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "a/+/c", &_ctx[1]));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "a/#", &_ctx[2]));
+    TEST_ASSERT(&_ctx[1] == _match("a/x/c"));
+    /* the literal filter with the same prefix stays */
+    mqttsn_trie_del(&_trie, "a/+/c");
+    TEST_ASSERT(&_ctx[0] == _match("a/b/c"));
+    TEST_ASSERT(&_ctx[2] == _match("a/x/c"));
+    mqttsn_trie_del(&_trie, "a/#");
+    TEST_ASSERT(&_ctx[0] == _match("a/b/c"));
+    TEST_ASSERT_NULL(_match("a/x/c"));
+    TEST_ASSERT_NULL(_match("a/b"));
+    TEST_ASSERT_EQUAL_INT(free_nodes - 3, _free_nodes());
+    /* re-adding after the deletion */
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "a/+/c", &_ctx[3]));
+    TEST_ASSERT(&_ctx[3] == _match("a/x/c"));
+    TEST_ASSERT(&_ctx[0] == _match("a/b/c"));
+    TEST_ASSERT_EQUAL_INT(free_nodes - 5, _free_nodes());
+    mqttsn_trie_del(&_trie, "a/b/c");
+    /* the wildcard now matches the name of the deleted literal filter */
+    TEST_ASSERT(&_ctx[3] == _match("a/b/c"));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "a/b/c", &_ctx[4]));
+    TEST_ASSERT(&_ctx[4] == _match("a/b/c"));
+    mqttsn_trie_del(&_trie, "a/b/c");
+    mqttsn_trie_del(&_trie, "a/+/c");
+    TEST_ASSERT_NULL(_match("a/b/c"));
+    TEST_ASSERT_EQUAL_INT(free_nodes, _free_nodes());
+}
+
+static void test_trie_full(void)
+{
+    char filters[MQTTSN_TRIE_SIZE][sizeof("f/00")];
+    unsigned i;
+
+    /* "f" and one node per filter */
+    for (i = 0; i < (MQTTSN_TRIE_SIZE - 3); i++) {
+        sprintf(filters[i], "f/%02u", i);
+        TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, filters[i],
+                                                 &_ctx[i % 8]));
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, mqttsn_trie_add(&_trie, "g/h", &_ctx[0]));
+    /* a failed add leaves no nodes behind */
+    TEST_ASSERT_EQUAL_INT(1, _free_nodes());
+    TEST_ASSERT_NULL(_match("g"));
+    TEST_ASSERT_EQUAL_INT(0, mqttsn_trie_add(&_trie, "f/#", &_ctx[0]));
+    TEST_ASSERT_EQUAL_INT(0, _free_nodes());
+    for (i = 0; i < (MQTTSN_TRIE_SIZE - 3); i++) {
+        TEST_ASSERT(&_ctx[i % 8] == _match(filters[i]));
+    }
+}
+
+Test *tests_mqttsn_topics_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_tid_map_add_get),
+        new_TestFixture(test_tid_map_full),
+        new_TestFixture(test_tid_map_del_ctx),
+        new_TestFixture(test_tid_map_del_chain),
+        new_TestFixture(test_tid_map_del_chain_wrap),
+        new_TestFixture(test_trie_exact),
+        new_TestFixture(test_trie_wildcards),
+        new_TestFixture(test_trie_del),
+        new_TestFixture(test_trie_del_shared_level),
+        new_TestFixture(test_trie_del_wildcard),
+        new_TestFixture(test_trie_full),
+    };
+
+    EMB_UNIT_TESTCALLER(mqttsn_topics_tests, set_up, NULL, fixtures);
+
+    return (Test *)&mqttsn_topics_tests;
+}
+
+void tests_mqttsn_topics(void)
+{
+    TESTS_RUN(tests_mqttsn_topics_tests());
+}
+/** @} */
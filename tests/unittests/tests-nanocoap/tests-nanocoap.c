@@ -433,6 +433,134 @@ static void test_nanocoap__server_reply_simple_con(void)
     TEST_ASSERT_EQUAL_INT(COAP_TYPE_ACK, coap_get_type(&pkt));
 }
 
+/*
+ * Parses a request with repeated options and reads them from the option
+ * index.
+ */
+static void test_nanocoap__option_index(void)
+{
+    uint8_t buf[_BUF_SIZE];
+    coap_pkt_t pkt;
+    uint8_t *value;
+    uint32_t observe;
+    const coap_optpos_t *opt;
+
+    size_t len = coap_build_hdr((coap_hdr_t *)&buf[0], COAP_TYPE_NON, NULL, 0,
+                                COAP_METHOD_GET, 0xABCD);
+    coap_pkt_init(&pkt, &buf[0], sizeof(buf), len);
+    coap_opt_add_uint(&pkt, COAP_OPT_OBSERVE, 0);
+    coap_opt_add_string(&pkt, COAP_OPT_URI_PATH, "/ab/c", '/');
+    coap_opt_add_uint(&pkt, COAP_OPT_CONTENT_FORMAT, COAP_FORMAT_JSON);
+    coap_opt_add_string(&pkt, COAP_OPT_URI_QUERY, "x=1&y=22", '&');
+    coap_opt_add_uint(&pkt, COAP_OPT_BLOCK2, 0x12);
+    len = coap_opt_finish(&pkt, COAP_OPT_FINISH_NONE);
+
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pkt, &buf[0], len));
+    TEST_ASSERT_EQUAL_INT(7, pkt.options_len);
+
+    opt = coap_opt_find(&pkt, COAP_OPT_URI_QUERY);
+    TEST_ASSERT_NOT_NULL(opt);
+    TEST_ASSERT_EQUAL_INT(3, opt->len);
+    TEST_ASSERT(memcmp("x=1", coap_opt_value(&pkt, opt), 3) == 0);
+    opt = coap_opt_next(&pkt, opt);
+    TEST_ASSERT_NOT_NULL(opt);
+    TEST_ASSERT_EQUAL_INT(4, opt->len);
+    TEST_ASSERT(memcmp("y=22", coap_opt_value(&pkt, opt), 4) == 0);
+    TEST_ASSERT_NULL(coap_opt_next(&pkt, opt));
+
+    TEST_ASSERT_EQUAL_INT(0, coap_opt_get_opaque(&pkt, COAP_OPT_OBSERVE,
+                                                 &value));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, coap_opt_get_opaque(&pkt, COAP_OPT_ETAG,
+                                                       &value));
+    TEST_ASSERT_EQUAL_INT(COAP_FORMAT_JSON, coap_get_content_type(&pkt));
+    TEST_ASSERT_EQUAL_INT(0, coap_get_option_uint(&pkt, COAP_OPT_OBSERVE,
+                                                  &observe));
+    TEST_ASSERT_EQUAL_INT(COAP_OBS_REGISTER, observe);
+
+    TEST_ASSERT_EQUAL_INT(0, coap_cmp_uri_path(&pkt, "/ab/c"));
+    TEST_ASSERT(coap_cmp_uri_path(&pkt, "/ab") > 0);
+    TEST_ASSERT(coap_cmp_uri_path(&pkt, "/ab/b") > 0);
+    TEST_ASSERT(coap_cmp_uri_path(&pkt, "/ab/d") < 0);
+    TEST_ASSERT(coap_cmp_uri_path(&pkt, "/ab/c/") < 0);
+    TEST_ASSERT(coap_cmp_uri_path(&pkt, "/abc") < 0);
+}
+
+/*
+ * Matches the path of a request with resources that handle their subtree.
+ */
+static void test_nanocoap__match_subtree(void)
+{
+    uint8_t buf[_BUF_SIZE];
+    coap_pkt_t pkt;
+    coap_resource_t res = { .path = "/ab", .methods = COAP_GET };
+
+    size_t len = coap_build_hdr((coap_hdr_t *)&buf[0], COAP_TYPE_NON, NULL, 0,
+                                COAP_METHOD_GET, 0xABCD);
+    coap_pkt_init(&pkt, &buf[0], sizeof(buf), len);
+    coap_opt_add_string(&pkt, COAP_OPT_URI_PATH, "/ab/c", '/');
+    len = coap_opt_finish(&pkt, COAP_OPT_FINISH_NONE);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pkt, &buf[0], len));
+
+    TEST_ASSERT(coap_match_path(&pkt, &res) > 0);
+    res.methods |= COAP_MATCH_SUBTREE;
+    TEST_ASSERT_EQUAL_INT(0, coap_match_path(&pkt, &res));
+    res.path = "/ab/c";
+    TEST_ASSERT_EQUAL_INT(0, coap_match_path(&pkt, &res));
+    res.path = "/a";
+    TEST_ASSERT(coap_match_path(&pkt, &res) > 0);
+    res.path = "/ab/c/d";
+    TEST_ASSERT(coap_match_path(&pkt, &res) < 0);
+    res.path = "/ab-c";
+    TEST_ASSERT(coap_match_path(&pkt, &res) > 0);
+}
+
+/*
+ * Parses a request with a path and a query of many segments, each of which
+ * takes an option.
+ */
+static void test_nanocoap__get_many_segments(void)
+{
+    uint8_t buf[_BUF_SIZE];
+    coap_pkt_t pkt;
+    char path[] = "/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p";
+    char query[] = "a=1&b=2&c=3&d=4&e=5&f=6&g=7&h=8";
+    char uri[NANOCOAP_URI_MAX];
+
+    size_t len = coap_build_hdr((coap_hdr_t *)&buf[0], COAP_TYPE_NON, NULL, 0,
+                                COAP_METHOD_GET, 0xABCD);
+    coap_pkt_init(&pkt, &buf[0], sizeof(buf), len);
+    coap_opt_add_string(&pkt, COAP_OPT_URI_PATH, &path[0], '/');
+    coap_opt_add_string(&pkt, COAP_OPT_URI_QUERY, &query[0], '&');
+    len = coap_opt_finish(&pkt, COAP_OPT_FINISH_NONE);
+
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pkt, &buf[0], len));
+    TEST_ASSERT_EQUAL_INT(24, pkt.options_len);
+    TEST_ASSERT_EQUAL_INT(0, coap_cmp_uri_path(&pkt, path));
+    TEST_ASSERT_EQUAL_INT(sizeof(path), coap_get_uri_path(&pkt, (uint8_t *)uri));
+    TEST_ASSERT_EQUAL_STRING((char *)path, (char *)uri);
+}
+
+/*
+ * Parses a message with more options than fit into the option index.
+ */
+static void test_nanocoap__option_index_full(void)
+{
+    uint8_t buf[_BUF_SIZE];
+    coap_pkt_t pkt;
+
+    size_t len = coap_build_hdr((coap_hdr_t *)&buf[0], COAP_TYPE_NON, NULL, 0,
+                                COAP_METHOD_GET, 0xABCD);
+    len += coap_put_option(&buf[len], 0, COAP_OPT_ETAG, (uint8_t *)"e", 1);
+    for (unsigned i = 0; i < NANOCOAP_NOPTS_MAX; i++) {
+        len += coap_put_option(&buf[len], COAP_OPT_ETAG, COAP_OPT_ETAG,
+                               (uint8_t *)"e", 1);
+    }
+
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, coap_parse(&pkt, &buf[0], len));
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pkt, &buf[0], len - 2));
+    TEST_ASSERT_EQUAL_INT(NANOCOAP_NOPTS_MAX, pkt.options_len);
+}
+
 Test *tests_nanocoap_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -450,6 +578,10 @@ Test *tests_nanocoap_tests(void)
         new_TestFixture(test_nanocoap__server_reply_simple),
         new_TestFixture(test_nanocoap__server_get_req_con),
         new_TestFixture(test_nanocoap__server_reply_simple_con),
+        new_TestFixture(test_nanocoap__option_index),
+        new_TestFixture(test_nanocoap__match_subtree),
+        new_TestFixture(test_nanocoap__get_many_segments),
+        new_TestFixture(test_nanocoap__option_index_full),
     };
 
     EMB_UNIT_TESTCALLER(nanocoap_tests, NULL, NULL, fixtures);
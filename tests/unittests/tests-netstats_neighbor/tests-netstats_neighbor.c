@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/netstats/neighbor.h"
+
+#include "tests-netstats_neighbor.h"
+
+static netstats_nb_t _table[NETSTATS_NB_SIZE];
+static const uint8_t _addr1[] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 };
+static const uint8_t _addr2[] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 };
+
+static void set_up(void)
+{
+    netstats_nb_init(_table);
+}
+
+static void test_nb_get_empty(void)
+{
+    TEST_ASSERT_NULL(netstats_nb_get(_table, _addr1, sizeof(_addr1)));
+}
+
+static void test_nb_update_rx(void)
+{
+    netstats_nb_t *entry;
+
+    entry = netstats_nb_update_rx(_table, _addr1, sizeof(_addr1), -60, 200);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT(entry == netstats_nb_get(_table, _addr1, sizeof(_addr1)));
+    TEST_ASSERT_NULL(netstats_nb_get(_table, _addr2, sizeof(_addr2)));
+    TEST_ASSERT_EQUAL_INT(-60, entry->rssi);
+    TEST_ASSERT_EQUAL_INT(200, entry->lqi);
+    TEST_ASSERT_EQUAL_INT(1, entry->rx_count);
+    netstats_nb_update_rx(_table, _addr1, sizeof(_addr1), -70, 100);
+    /* moving average lies between old value and sample */
+    TEST_ASSERT(entry->rssi < -60);
+    TEST_ASSERT(entry->rssi > -70);
+    TEST_ASSERT(entry->lqi < 200);
+    TEST_ASSERT(entry->lqi > 100);
+    TEST_ASSERT_EQUAL_INT(2, entry->rx_count);
+    /* no ETX samples from receptions */
+    TEST_ASSERT_EQUAL_INT(0, entry->etx);
+    TEST_ASSERT(!netstats_nb_isfresh(entry));
+}
+
+static void test_nb_update_tx(void)
+{
+    netstats_nb_t *entry;
+
+    entry = netstats_nb_update_tx(_table, _addr1, sizeof(_addr1),
+                                  NETSTATS_NB_SUCCESS, 1);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL_INT(NETSTATS_NB_ETX_DIVISOR, entry->etx);
+    TEST_ASSERT(!netstats_nb_isfresh(entry));
+    for (unsigned i = 1; i < NETSTATS_NB_FRESHNESS_TARGET; i++) {
+        netstats_nb_update_tx(_table, _addr1, sizeof(_addr1),
+                              NETSTATS_NB_SUCCESS, 1);
+    }
+    TEST_ASSERT(netstats_nb_isfresh(entry));
+    TEST_ASSERT_EQUAL_INT(NETSTATS_NB_ETX_DIVISOR, entry->etx);
+    netstats_nb_update_tx(_table, _addr1, sizeof(_addr1), NETSTATS_NB_NOACK, 0);
+    TEST_ASSERT(entry->etx > NETSTATS_NB_ETX_DIVISOR);
+    TEST_ASSERT_EQUAL_INT(NETSTATS_NB_FRESHNESS_TARGET + 1, entry->tx_count);
+    TEST_ASSERT_EQUAL_INT(1, entry->tx_failed);
+}
+
+static void test_nb_replace_oldest(void)
+{
+    uint8_t addr[sizeof(_addr1)];
+
+    memcpy(addr, _addr1, sizeof(addr));
+    for (unsigned i = 0; i < NETSTATS_NB_SIZE; i++) {
+        addr[0] = i;
+        TEST_ASSERT_NOT_NULL(netstats_nb_update_rx(_table, addr, sizeof(addr),
+                                                   -50, 255));
+    }
+    addr[0] = NETSTATS_NB_SIZE;
+    TEST_ASSERT_NOT_NULL(netstats_nb_update_rx(_table, addr, sizeof(addr),
+                                               -50, 255));
+    TEST_ASSERT_NOT_NULL(netstats_nb_get(_table, addr, sizeof(addr)));
+    for (unsigned i = 0, found = 0; i < NETSTATS_NB_SIZE; i++) {
+        addr[0] = i;
+        if (netstats_nb_get(_table, addr, sizeof(addr)) != NULL) {
+            found++;
+        }
+        if (i == (NETSTATS_NB_SIZE - 1)) {
+            /* one of the old neighbors was replaced */
+            TEST_ASSERT_EQUAL_INT(NETSTATS_NB_SIZE - 1, found);
+        }
+    }
+}
+
+static void test_nb_addr_too_long(void)
+{
+    uint8_t addr[NETSTATS_NB_L2ADDR_MAXLEN + 1] = { 0 };
+
+    TEST_ASSERT_NULL(netstats_nb_update_rx(_table, addr, sizeof(addr), 0, 0));
+    TEST_ASSERT_NULL(netstats_nb_update_tx(_table, addr, sizeof(addr),
+                                           NETSTATS_NB_SUCCESS, 1));
+}
+
+Test *tests_netstats_neighbor_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_nb_get_empty),
+        new_TestFixture(test_nb_update_rx),
+        new_TestFixture(test_nb_update_tx),
+        new_TestFixture(test_nb_replace_oldest),
+        new_TestFixture(test_nb_addr_too_long),
+    };
+
+    EMB_UNIT_TESTCALLER(netstats_neighbor_tests, set_up, NULL, fixtures);
+
+    return (Test *)&netstats_neighbor_tests;
+}
+
+void tests_netstats_neighbor(void)
+{
+    TESTS_RUN(tests_netstats_neighbor_tests());
+}
+/** @} */